@@ -189,6 +189,17 @@ class Fam_Descriptor {
     char *get_name();
     // get memory server id
     uint64_t get_memserver_id();
+    // set stripe layout of a data item interleaved across memory servers.
+    void set_interleave_info(uint64_t interleaveSize, uint64_t memsrvCnt,
+                             uint64_t *memServerIds, uint64_t *keys,
+                             uint64_t *bases);
+    // get stripe size (0 if not interleaved), memory server count and the
+    // memory server id, key and base address of each memory server.
+    uint64_t get_interleave_size();
+    uint64_t get_used_memsrv_cnt();
+    uint64_t *get_memserver_ids();
+    uint64_t *get_keys();
+    uint64_t *get_base_addresses();
 
   private:
     class FamDescriptorImpl_;
@@ -261,7 +272,7 @@ typedef struct {
     /** OpenFAM model to be used; default is memory_server, Other option is
      * shared_memory */
     char *openFamModel;
-    /** FAM context model - Default, Region*/
+    /** FAM context model - Default, Region, Thread*/
     char *famContextModel;
     /** Number of consumer threads for shared memory model **/
     char *numConsumer;
@@ -416,6 +427,48 @@ class fam {
      */
     void fam_deallocate(Fam_Descriptor *descriptor);
 
+    /**
+     * Allocate several data items within a region with a single request.
+     * Either all data items are allocated or none is.
+     * @param names - names of the data items; NULL, or a NULL entry, for
+     * unnamed data items
+     * @param nbytes - size of each data item in bytes
+     * @param count - number of data items
+     * @param accessPermissions - permissions associated with the data items
+     * @param region - descriptor of the region within which the data items
+     * are allocated
+     * @param descriptors - array of count entries that receives the
+     * descriptors
+     * @return - none
+     * @see #fam_deallocate_batch()
+     */
+    void fam_allocate_batch(const char **names, const uint64_t *nbytes,
+                            uint64_t count, mode_t accessPermissions,
+                            Fam_Region_Descriptor *region,
+                            Fam_Descriptor **descriptors);
+
+    /**
+     * Deallocate several data items with a single request.
+     * @param descriptors - descriptors of the data items
+     * @param count - number of data items
+     * @return - none
+     * @see #fam_allocate_batch()
+     */
+    void fam_deallocate_batch(Fam_Descriptor **descriptors, uint64_t count);
+
+    /**
+     * Look up several data items of a region with a single request.
+     * @param itemNames - names of the data items
+     * @param regionName - name of the region containing the data items
+     * @param count - number of data items
+     * @param descriptors - array of count entries that receives the
+     * descriptors
+     * @return - none
+     * @see #fam_lookup()
+     */
+    void fam_lookup_batch(const char **itemNames, const char *regionName,
+                          uint64_t count, Fam_Descriptor **descriptors);
+
     /**
      * Change permissions associated with a data item descriptor.
      * @param descriptor - descriptor associated with some data item
@@ -715,8 +768,30 @@ class fam {
      * Wait for copy operation correspond to the wait object passed to complete
      * @param waitObj - unique tag to copy operation
      * @return - none
+     * @throws Fam_Exception - exceptionObj->fam_error() returns
+     *         FAM_ERR_CANCELED if the copy was cancelled by fam_copy_cancel
+     *         before all its bytes were copied
      */
     void fam_copy_wait(void *waitObj);
+
+    /**
+     * Number of bytes copied so far by a copy operation. The wait object
+     * must not have been waited on yet.
+     * @param waitObj - unique tag to copy operation
+     * @return - number of bytes copied
+     * @see #fam_copy_wait
+     */
+    uint64_t fam_copy_progress(void *waitObj);
+
+    /**
+     * Cancel a copy operation. The copy stops before its next chunk; the
+     * bytes already copied are left in place. fam_copy_wait must still be
+     * called on the wait object, and reports the copy as cancelled.
+     * @param waitObj - unique tag to copy operation
+     * @return - none
+     * @see #fam_copy_wait
+     */
+    void fam_copy_cancel(void *waitObj);
     // ATOMICS Group
 
     // NON fetching routines
@@ -740,7 +815,8 @@ class fam {
 
     /**
      * add group - atomically add a value to the value at a given offset within
-     * a data item in FAM
+     * a data item in FAM. Like all non-fetching atomics, this does not wait
+     * for the update to complete; fam_quiet waits for it.
      * @param descriptor - valid descriptor to data item in FAM
      * @param offset - byte offset within the data item of the value to be
      * updated
@@ -936,6 +1012,39 @@ class fam {
     double fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                          double value);
 
+    /**
+     * fetch and add nonblocking group - initiate an atomic add of the given
+     * value to the value at the given offset within a data item in FAM. Do
+     * not wait until the operation is finished; the old value is stored in
+     * result once fam_quiet returns.
+     * @param descriptor - valid descriptor to data item in FAM
+     * @param offset - byte offset within the data item of the value to be
+     * updated
+     * @param value - value to be added to the existing value at the given
+     * location
+     * @param result - location receiving the old value; must remain valid
+     * until fam_quiet returns
+     * @return - none
+     */
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, int32_t value,
+                                   int32_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, int64_t value,
+                                   int64_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, uint32_t value,
+                                   uint32_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, uint64_t value,
+                                   uint64_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, float value,
+                                   float *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, double value,
+                                   double *result);
+
     /**
      * fetch and subtract group - atomically subtract the given value from the
      * value at the given offset within a data item in FAM, and return the old
@@ -64,7 +64,8 @@ enum Fam_Error {
     FAM_ERR_ATL_QUEUE_FULL,
     FAM_ERR_ATL_QUEUE_INSERT,
     FAM_ERR_ATL_NOT_ENABLED,
-    FAM_ERR_ATL
+    FAM_ERR_ATL,
+    FAM_ERR_CANCELED
 };
 
 class Fam_Exception : public std::exception {
@@ -31,12 +31,20 @@
 #include <iostream>
 #include <stdint.h>   // needed
 #include <sys/stat.h> // needed for mode_t
+#include <time.h>
 
 #include "allocator/fam_allocator_client.h"
 
 using namespace std;
 
 namespace openfam {
+
+static inline uint64_t lease_clock_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 Fam_Allocator_Client::Fam_Allocator_Client(const char *name, uint64_t port) {
     try {
         famCIS = new Fam_CIS_Client(name, port);
@@ -46,15 +54,142 @@ Fam_Allocator_Client::Fam_Allocator_Client(const char *name, uint64_t port) {
     }
     uid = (uint32_t)getuid();
     gid = (uint32_t)getgid();
+    leaseTimeNs = FAM_DEFAULT_LOOKUP_LEASE_TIME * 1000000ULL;
+    leaseEpoch = 0;
+    pthread_mutex_init(&leaseLock, NULL);
 }
 
 Fam_Allocator_Client::Fam_Allocator_Client(bool isSharedMemory) {
     famCIS = new Fam_CIS_Direct(NULL, true, isSharedMemory);
     uid = (uint32_t)getuid();
     gid = (uint32_t)getgid();
+    leaseTimeNs = FAM_DEFAULT_LOOKUP_LEASE_TIME * 1000000ULL;
+    leaseEpoch = 0;
+    pthread_mutex_init(&leaseLock, NULL);
+}
+
+Fam_Allocator_Client::~Fam_Allocator_Client() {
+    delete famCIS;
+    pthread_mutex_destroy(&leaseLock);
+}
+
+void Fam_Allocator_Client::set_lookup_lease_time(uint64_t leaseTimeMs) {
+    pthread_mutex_lock(&leaseLock);
+    leaseTimeNs = leaseTimeMs * 1000000ULL;
+    itemNameCache.clear();
+    regionNameCache.clear();
+    itemInfoCache.clear();
+    regionInfoCache.clear();
+    pthread_mutex_unlock(&leaseLock);
+}
+
+template <typename Cache>
+bool Fam_Allocator_Client::lease_get(Cache &cache,
+                                     const typename Cache::key_type &key,
+                                     Fam_Region_Item_Info &info,
+                                     uint64_t &epoch) {
+    bool found = false;
+    pthread_mutex_lock(&leaseLock);
+    epoch = leaseEpoch;
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        if (it->second.expiry > lease_clock_ns()) {
+            info = it->second.info;
+            found = true;
+        } else {
+            cache.erase(it);
+        }
+    }
+    pthread_mutex_unlock(&leaseLock);
+    return found;
+}
+
+template <typename Cache>
+void Fam_Allocator_Client::lease_put(Cache &cache,
+                                     const typename Cache::key_type &key,
+                                     const Fam_Region_Item_Info &info,
+                                     uint64_t epoch) {
+    pthread_mutex_lock(&leaseLock);
+    if (leaseTimeNs == 0 || epoch != leaseEpoch) {
+        pthread_mutex_unlock(&leaseLock);
+        return;
+    }
+    uint64_t now = lease_clock_ns();
+    if (cache.size() >= FAM_LOOKUP_CACHE_MAX_ENTRIES) {
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (it->second.expiry <= now)
+                it = cache.erase(it);
+            else
+                ++it;
+        }
+        // Every entry is still live; start over rather than grow unbounded
+        if (cache.size() >= FAM_LOOKUP_CACHE_MAX_ENTRIES)
+            cache.clear();
+    }
+    Fam_Info_Lease &lease = cache[key];
+    lease.info = info;
+    lease.expiry = now + leaseTimeNs;
+    pthread_mutex_unlock(&leaseLock);
+}
+
+/*
+ * Drop every cached result that refers to the region or to an item in it.
+ */
+void Fam_Allocator_Client::invalidate_region_leases(uint64_t regionId) {
+    regionId &= REGIONID_MASK;
+    pthread_mutex_lock(&leaseLock);
+    leaseEpoch++;
+    for (auto it = itemNameCache.begin(); it != itemNameCache.end();) {
+        if ((it->second.info.regionId & REGIONID_MASK) == regionId)
+            it = itemNameCache.erase(it);
+        else
+            ++it;
+    }
+    for (auto it = regionNameCache.begin(); it != regionNameCache.end();) {
+        if ((it->second.info.regionId & REGIONID_MASK) == regionId)
+            it = regionNameCache.erase(it);
+        else
+            ++it;
+    }
+    for (auto it = itemInfoCache.begin(); it != itemInfoCache.end();) {
+        if (std::get<0>(it->first) == regionId)
+            it = itemInfoCache.erase(it);
+        else
+            ++it;
+    }
+    for (auto it = regionInfoCache.begin(); it != regionInfoCache.end();) {
+        if (it->first.first == regionId)
+            it = regionInfoCache.erase(it);
+        else
+            ++it;
+    }
+    pthread_mutex_unlock(&leaseLock);
 }
 
-Fam_Allocator_Client::~Fam_Allocator_Client() { delete famCIS; }
+/*
+ * Drop every cached result that refers to the data item at the given offset.
+ */
+void Fam_Allocator_Client::invalidate_item_leases(uint64_t regionId,
+                                                  uint64_t offset) {
+    regionId &= REGIONID_MASK;
+    pthread_mutex_lock(&leaseLock);
+    leaseEpoch++;
+    for (auto it = itemNameCache.begin(); it != itemNameCache.end();) {
+        if ((it->second.info.regionId & REGIONID_MASK) == regionId &&
+            it->second.info.offset == offset)
+            it = itemNameCache.erase(it);
+        else
+            ++it;
+    }
+    for (auto it = itemInfoCache.begin(); it != itemInfoCache.end();) {
+        if (std::get<0>(it->first) == regionId &&
+            std::get<2>(it->first) == offset)
+            it = itemInfoCache.erase(it);
+        else
+            ++it;
+    }
+    pthread_mutex_unlock(&leaseLock);
+}
 
 void Fam_Allocator_Client::allocator_initialize() {}
 
@@ -89,7 +224,10 @@ void Fam_Allocator_Client::destroy_region(Fam_Region_Descriptor *descriptor) {
     uint64_t regionId = globalDescriptor.regionId;
     uint64_t memoryServerId = descriptor->get_memserver_id();
     descriptor->set_desc_status(DESC_INVALID);
-        famCIS->destroy_region(regionId, memoryServerId, uid, gid);
+    invalidate_region_leases(regionId);
+    famCIS->destroy_region(regionId, memoryServerId, uid, gid);
+    // A lookup on another thread may have cached the old info meanwhile
+    invalidate_region_leases(regionId);
 }
 
 void Fam_Allocator_Client::resize_region(Fam_Region_Descriptor *descriptor,
@@ -98,7 +236,10 @@ void Fam_Allocator_Client::resize_region(Fam_Region_Descriptor *descriptor,
         descriptor->get_global_descriptor();
     uint64_t regionId = globalDescriptor.regionId;
     uint64_t memoryServerId = descriptor->get_memserver_id();
-        famCIS->resize_region(regionId, nbytes, memoryServerId, uid, gid);
+    invalidate_region_leases(regionId);
+    famCIS->resize_region(regionId, nbytes, memoryServerId, uid, gid);
+    // A lookup on another thread may have cached the old info meanwhile
+    invalidate_region_leases(regionId);
 }
 
 Fam_Descriptor *Fam_Allocator_Client::allocate(const char *name,
@@ -111,12 +252,18 @@ Fam_Descriptor *Fam_Allocator_Client::allocate(const char *name,
     Fam_Region_Item_Info info;
     info = famCIS->allocate(name, nbytes, accessPermissions, regionId,
                             memoryServerId, uid, gid);
+    // The offset may have been freed and reused since it was last cached
+    invalidate_item_leases(info.regionId, info.offset);
     globalDescriptor.regionId =
         info.regionId | (info.memoryServerId << MEMSERVERID_SHIFT);
     globalDescriptor.offset = info.offset;
     Fam_Descriptor *dataItem = new Fam_Descriptor(globalDescriptor, nbytes);
     dataItem->bind_key(info.key);
     dataItem->set_base_address(info.base);
+    if (info.interleaveSize)
+        dataItem->set_interleave_info(info.interleaveSize,
+                                      info.used_memsrv_cnt, info.memServerIds,
+                                      info.keys, info.bases);
     dataItem->set_name((char *)name);
     dataItem->set_perm(accessPermissions);
     dataItem->set_desc_status(DESC_INIT_DONE);
@@ -130,7 +277,10 @@ void Fam_Allocator_Client::deallocate(Fam_Descriptor *descriptor) {
     uint64_t offset = globalDescriptor.offset;
     uint64_t memoryServerId = descriptor->get_memserver_id();
     descriptor->set_desc_status(DESC_INVALID);
-        famCIS->deallocate(regionId, offset, memoryServerId, uid, gid);
+    invalidate_item_leases(regionId, offset);
+    famCIS->deallocate(regionId, offset, memoryServerId, uid, gid);
+    // A lookup on another thread may have cached the old info meanwhile
+    invalidate_item_leases(regionId, offset);
 }
 
 void Fam_Allocator_Client::change_permission(Fam_Region_Descriptor *descriptor,
@@ -139,8 +289,11 @@ void Fam_Allocator_Client::change_permission(Fam_Region_Descriptor *descriptor,
         descriptor->get_global_descriptor();
     uint64_t regionId = globalDescriptor.regionId;
     uint64_t memoryServerId = descriptor->get_memserver_id();
-        famCIS->change_region_permission(regionId, accessPermissions,
-                                         memoryServerId, uid, gid);
+    invalidate_region_leases(regionId);
+    famCIS->change_region_permission(regionId, accessPermissions,
+                                     memoryServerId, uid, gid);
+    // A lookup on another thread may have cached the old info meanwhile
+    invalidate_region_leases(regionId);
 }
 
 void Fam_Allocator_Client::change_permission(Fam_Descriptor *descriptor,
@@ -150,13 +303,20 @@ void Fam_Allocator_Client::change_permission(Fam_Descriptor *descriptor,
     uint64_t regionId = globalDescriptor.regionId & REGIONID_MASK;
     uint64_t offset = globalDescriptor.offset;
     uint64_t memoryServerId = descriptor->get_memserver_id();
-        famCIS->change_dataitem_permission(regionId, offset, accessPermissions,
-                                           memoryServerId, uid, gid);
+    invalidate_item_leases(regionId, offset);
+    famCIS->change_dataitem_permission(regionId, offset, accessPermissions,
+                                       memoryServerId, uid, gid);
+    // A lookup on another thread may have cached the old info meanwhile
+    invalidate_item_leases(regionId, offset);
 }
 
 Fam_Region_Descriptor *Fam_Allocator_Client::lookup_region(const char *name) {
     Fam_Region_Item_Info info;
-    info = famCIS->lookup_region(name, uid, gid);
+    uint64_t epoch;
+    if (!lease_get(regionNameCache, string(name), info, epoch)) {
+        info = famCIS->lookup_region(name, uid, gid);
+        lease_put(regionNameCache, string(name), info, epoch);
+    }
     Fam_Global_Descriptor globalDescriptor;
     globalDescriptor.regionId = info.regionId;
     globalDescriptor.offset = info.offset;
@@ -172,7 +332,12 @@ Fam_Region_Descriptor *Fam_Allocator_Client::lookup_region(const char *name) {
 Fam_Descriptor *Fam_Allocator_Client::lookup(const char *itemName,
                                              const char *regionName) {
     Fam_Region_Item_Info info;
-    info = famCIS->lookup(itemName, regionName, uid, gid);
+    pair<string, string> nameKey(regionName, itemName);
+    uint64_t epoch;
+    if (!lease_get(itemNameCache, nameKey, info, epoch)) {
+        info = famCIS->lookup(itemName, regionName, uid, gid);
+        lease_put(itemNameCache, nameKey, info, epoch);
+    }
     Fam_Global_Descriptor globalDescriptor;
     globalDescriptor.regionId =
         info.regionId | (info.memoryServerId << MEMSERVERID_SHIFT);
@@ -186,14 +351,134 @@ Fam_Descriptor *Fam_Allocator_Client::lookup(const char *itemName,
     return dataItem;
 }
 
+/*
+ * Allocate count data items in region with one request to the CIS. names may
+ * be NULL, or hold NULL entries, for unnamed data items. The descriptors are
+ * returned in items.
+ */
+void Fam_Allocator_Client::allocate_batch(const char **names,
+                                          const uint64_t *nbytes,
+                                          uint64_t count,
+                                          mode_t accessPermissions,
+                                          Fam_Region_Descriptor *region,
+                                          Fam_Descriptor **items) {
+    Fam_Global_Descriptor globalDescriptor = region->get_global_descriptor();
+    uint64_t regionId = globalDescriptor.regionId;
+    uint64_t memoryServerId = region->get_memserver_id();
+    std::vector<std::string> nameList;
+    std::vector<size_t> sizeList(nbytes, nbytes + count);
+    for (uint64_t i = 0; i < count; i++)
+        nameList.push_back((names && names[i]) ? names[i] : "");
+
+    std::vector<Fam_Region_Item_Info> infos =
+        famCIS->allocate_batch(nameList, sizeList, accessPermissions, regionId,
+                               memoryServerId, uid, gid);
+    for (uint64_t i = 0; i < count; i++) {
+        Fam_Region_Item_Info &info = infos[i];
+        // The offset may have been freed and reused since it was last cached
+        invalidate_item_leases(info.regionId, info.offset);
+        globalDescriptor.regionId =
+            info.regionId | (info.memoryServerId << MEMSERVERID_SHIFT);
+        globalDescriptor.offset = info.offset;
+        Fam_Descriptor *dataItem =
+            new Fam_Descriptor(globalDescriptor, nbytes[i]);
+        dataItem->bind_key(info.key);
+        dataItem->set_base_address(info.base);
+        if (info.interleaveSize)
+            dataItem->set_interleave_info(
+                info.interleaveSize, info.used_memsrv_cnt, info.memServerIds,
+                info.keys, info.bases);
+        // The descriptor keeps the name pointer, so hand it the caller's
+        dataItem->set_name((char *)((names && names[i]) ? names[i] : ""));
+        dataItem->set_perm(accessPermissions);
+        dataItem->set_desc_status(DESC_INIT_DONE);
+        items[i] = dataItem;
+    }
+}
+
+/*
+ * Deallocate count data items with one request to the CIS.
+ */
+void Fam_Allocator_Client::deallocate_batch(Fam_Descriptor **items,
+                                            uint64_t count) {
+    std::vector<uint64_t> regionIds, offsets, memoryServerIds;
+    for (uint64_t i = 0; i < count; i++) {
+        Fam_Global_Descriptor globalDescriptor =
+            items[i]->get_global_descriptor();
+        regionIds.push_back(globalDescriptor.regionId & REGIONID_MASK);
+        offsets.push_back(globalDescriptor.offset);
+        memoryServerIds.push_back(items[i]->get_memserver_id());
+        items[i]->set_desc_status(DESC_INVALID);
+        invalidate_item_leases(regionIds.back(), offsets.back());
+    }
+    famCIS->deallocate_batch(regionIds, offsets, memoryServerIds, uid, gid);
+}
+
+/*
+ * Look up count data items of one region. Names with a valid lease are
+ * served from the cache; the others are looked up with one request to the
+ * CIS. The descriptors are returned in items.
+ */
+void Fam_Allocator_Client::lookup_batch(const char **itemNames,
+                                        const char *regionName, uint64_t count,
+                                        Fam_Descriptor **items) {
+    std::vector<Fam_Region_Item_Info> infos(count);
+    std::vector<std::string> missNames;
+    std::vector<uint64_t> missIndex;
+    uint64_t epoch = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        pair<string, string> nameKey(regionName, itemNames[i]);
+        uint64_t missEpoch;
+        if (!lease_get(itemNameCache, nameKey, infos[i], missEpoch)) {
+            // Keep the epoch of the first miss for the batch
+            if (missNames.empty())
+                epoch = missEpoch;
+            missNames.push_back(itemNames[i]);
+            missIndex.push_back(i);
+        }
+    }
+    if (!missNames.empty()) {
+        std::vector<Fam_Region_Item_Info> missInfos =
+            famCIS->lookup_batch(missNames, regionName, uid, gid);
+        for (size_t j = 0; j < missIndex.size(); j++) {
+            infos[missIndex[j]] = missInfos[j];
+            lease_put(itemNameCache,
+                      pair<string, string>(regionName, missNames[j]),
+                      missInfos[j], epoch);
+        }
+    }
+
+    for (uint64_t i = 0; i < count; i++) {
+        Fam_Region_Item_Info &info = infos[i];
+        Fam_Global_Descriptor globalDescriptor;
+        globalDescriptor.regionId =
+            info.regionId | (info.memoryServerId << MEMSERVERID_SHIFT);
+        globalDescriptor.offset = info.offset;
+        Fam_Descriptor *dataItem = new Fam_Descriptor(globalDescriptor);
+        dataItem->bind_key(FAM_KEY_UNINITIALIZED);
+        dataItem->set_size(info.size);
+        dataItem->set_perm(info.perm);
+        dataItem->set_name((char *)itemNames[i]);
+        dataItem->set_desc_status(DESC_INIT_DONE_BUT_KEY_NOT_VALID);
+        items[i] = dataItem;
+    }
+}
+
 Fam_Region_Item_Info Fam_Allocator_Client::check_permission_get_info(
     Fam_Region_Descriptor *descriptor) {
     Fam_Global_Descriptor globalDescriptor =
         descriptor->get_global_descriptor();
     uint64_t regionId = globalDescriptor.regionId & REGIONID_MASK;
     uint64_t memoryServerId = descriptor->get_memserver_id();
-        Fam_Region_Item_Info info = famCIS->check_permission_get_region_info(
-            regionId, memoryServerId, uid, gid);
+    pair<uint64_t, uint64_t> infoKey(regionId, memoryServerId);
+    Fam_Region_Item_Info info;
+    uint64_t epoch;
+    if (!lease_get(regionInfoCache, infoKey, info, epoch)) {
+        info = famCIS->check_permission_get_region_info(regionId,
+                                                        memoryServerId, uid,
+                                                        gid);
+        lease_put(regionInfoCache, infoKey, info, epoch);
+    }
         descriptor->set_desc_status(DESC_INIT_DONE);
         return info;
 }
@@ -205,14 +490,25 @@ Fam_Allocator_Client::check_permission_get_info(Fam_Descriptor *descriptor) {
     uint64_t regionId = globalDescriptor.regionId & REGIONID_MASK;
     uint64_t offset = globalDescriptor.offset;
     uint64_t memoryServerId = descriptor->get_memserver_id();
-        Fam_Region_Item_Info info = famCIS->check_permission_get_item_info(
-            regionId, offset, memoryServerId, uid, gid);
+    tuple<uint64_t, uint64_t, uint64_t> infoKey(regionId, memoryServerId,
+                                                offset);
+    Fam_Region_Item_Info info;
+    uint64_t epoch;
+    if (!lease_get(itemInfoCache, infoKey, info, epoch)) {
+        info = famCIS->check_permission_get_item_info(regionId, offset,
+                                                      memoryServerId, uid, gid);
+        lease_put(itemInfoCache, infoKey, info, epoch);
+    }
         descriptor->set_desc_status(DESC_INIT_DONE);
         descriptor->bind_key(info.key);
         descriptor->set_name(info.name);
         descriptor->set_perm(info.perm);
         descriptor->set_size(info.size);
         descriptor->set_base_address(info.base);
+        if (info.interleaveSize)
+            descriptor->set_interleave_info(
+                info.interleaveSize, info.used_memsrv_cnt, info.memServerIds,
+                info.keys, info.bases);
         return info;
 }
 
@@ -270,6 +566,14 @@ void Fam_Allocator_Client::wait_for_copy(void *waitObj) {
     return famCIS->wait_for_copy(waitObj);
 }
 
+uint64_t Fam_Allocator_Client::copy_progress(void *waitObj) {
+    return famCIS->copy_progress(waitObj);
+}
+
+void Fam_Allocator_Client::cancel_copy(void *waitObj) {
+    return famCIS->cancel_copy(waitObj);
+}
+
 void *Fam_Allocator_Client::fam_map(Fam_Descriptor *descriptor) {
     Fam_Global_Descriptor globalDescriptor =
         descriptor->get_global_descriptor();
@@ -305,6 +609,18 @@ void Fam_Allocator_Client::release_CAS_lock(Fam_Descriptor *descriptor) {
     return famCIS->release_CAS_lock(offset, memoryServerId);
 }
 
+int128_t Fam_Allocator_Client::atomic_int128(uint32_t op,
+                                             Fam_Descriptor *descriptor,
+                                             uint64_t offset, int128_t operand,
+                                             int128_t compare) {
+    Fam_Global_Descriptor globalDescriptor =
+        descriptor->get_global_descriptor();
+    uint64_t regionId = globalDescriptor.regionId & REGIONID_MASK;
+    uint64_t memoryServerId = descriptor->get_memserver_id();
+    return famCIS->atomic_int128(op, regionId, globalDescriptor.offset, offset,
+                                 operand, compare, memoryServerId, uid, gid);
+}
+
 int Fam_Allocator_Client::get_addr_size(size_t *addrSize,
                                         uint64_t memoryServerId = 0) {
     if ((*addrSize = famCIS->get_addr_size(memoryServerId)) <= 0)
@@ -30,9 +30,22 @@
 #ifndef FAM_ALLOCATOR_CLIENT_H_
 #define FAM_ALLOCATOR_CLIENT_H_
 
+#include <map>
+#include <pthread.h>
+#include <string>
+#include <tuple>
+
 #include "cis/fam_cis_client.h"
 #include "cis/fam_cis_direct.h"
 
+/*
+ * Default lease (in milliseconds) for which lookup and permission results
+ * are served from the client cache before the CIS is asked again.
+ */
+#define FAM_DEFAULT_LOOKUP_LEASE_TIME 1000
+/* Number of cached results per cache beyond which expired ones are dropped */
+#define FAM_LOOKUP_CACHE_MAX_ENTRIES 65536
+
 namespace openfam {
 
 class Fam_Allocator_Client {
@@ -65,6 +78,12 @@ class Fam_Allocator_Client {
                            mode_t accessPermissions);
     Fam_Region_Descriptor *lookup_region(const char *name);
     Fam_Descriptor *lookup(const char *itemName, const char *regionName);
+    void allocate_batch(const char **names, const uint64_t *nbytes,
+                        uint64_t count, mode_t accessPermissions,
+                        Fam_Region_Descriptor *region, Fam_Descriptor **items);
+    void deallocate_batch(Fam_Descriptor **items, uint64_t count);
+    void lookup_batch(const char **itemNames, const char *regionName,
+                      uint64_t count, Fam_Descriptor **items);
     Fam_Region_Item_Info
     check_permission_get_info(Fam_Region_Descriptor *descriptor);
 
@@ -77,6 +96,8 @@ class Fam_Allocator_Client {
                uint64_t nbytes);
 
     void wait_for_copy(void *waitObj);
+    uint64_t copy_progress(void *waitObj);
+    void cancel_copy(void *waitObj);
 
     /**
      * fam_map - Map a data item in FAM to the process address space.
@@ -107,6 +128,19 @@ class Fam_Allocator_Client {
      * @param descriptor - Descriptor associated with the data item in FAM
      */
     void release_CAS_lock(Fam_Descriptor *descriptor);
+    /**
+     * atomic_int128 - Perform a 128-bit atomic operation on the memory
+     * server holding the value, in a single request.
+     * @param op - Fam_Int128_Atomic_Op to perform
+     * @param descriptor - Descriptor of the data item holding the value
+     * @param offset - offset of the value within the data item
+     * @param operand - value to be stored by set and compare-and-swap
+     * @param compare - value compared against by compare-and-swap
+     * @return - value found before the operation
+     */
+    int128_t atomic_int128(uint32_t op, Fam_Descriptor *descriptor,
+                           uint64_t offset, int128_t operand,
+                           int128_t compare);
 
     int get_addr_size(size_t *addrSize, uint64_t nodeId);
 
@@ -116,10 +150,59 @@ class Fam_Allocator_Client {
 
     int get_memserverinfo(void *memServerInfoBuffer);
 
+    /**
+     * set_lookup_lease_time - Set how long results of lookup and permission
+     * checks are reused without contacting the CIS.
+     * @param leaseTimeMs - lease in milliseconds; 0 disables the cache
+     */
+    void set_lookup_lease_time(uint64_t leaseTimeMs);
+
   private:
+    /*
+     * Cached CIS response, valid until expiry. Changes made through this
+     * client invalidate the entries they affect; changes made by other PEs
+     * become visible once the lease runs out.
+     */
+    struct Fam_Info_Lease {
+        Fam_Region_Item_Info info;
+        uint64_t expiry;
+    };
+    // (region name, item name) -> lookup()
+    typedef std::map<std::pair<std::string, std::string>, Fam_Info_Lease>
+        Fam_Item_Name_Cache;
+    // region name -> lookup_region()
+    typedef std::map<std::string, Fam_Info_Lease> Fam_Region_Name_Cache;
+    // (region id, memory server id, offset) -> check_permission_get_info()
+    typedef std::map<std::tuple<uint64_t, uint64_t, uint64_t>, Fam_Info_Lease>
+        Fam_Item_Info_Cache;
+    // (region id, memory server id) -> check_permission_get_info()
+    typedef std::map<std::pair<uint64_t, uint64_t>, Fam_Info_Lease>
+        Fam_Region_Info_Cache;
+
+    /*
+     * lease_get returns the invalidation epoch along with a miss; lease_put
+     * drops the result if an invalidation ran since, as the CIS may have
+     * answered before the change it reported.
+     */
+    template <typename Cache>
+    bool lease_get(Cache &cache, const typename Cache::key_type &key,
+                   Fam_Region_Item_Info &info, uint64_t &epoch);
+    template <typename Cache>
+    void lease_put(Cache &cache, const typename Cache::key_type &key,
+                   const Fam_Region_Item_Info &info, uint64_t epoch);
+    void invalidate_region_leases(uint64_t regionId);
+    void invalidate_item_leases(uint64_t regionId, uint64_t offset);
+
     Fam_CIS *famCIS;
     uint32_t uid;
     uint32_t gid;
+    uint64_t leaseTimeNs;
+    pthread_mutex_t leaseLock;
+    uint64_t leaseEpoch;
+    Fam_Item_Name_Cache itemNameCache;
+    Fam_Region_Name_Cache regionNameCache;
+    Fam_Item_Info_Cache itemInfoCache;
+    Fam_Region_Info_Cache regionInfoCache;
 };
 
 } // namespace openfam
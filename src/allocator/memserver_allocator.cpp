@@ -31,8 +31,13 @@
 #include "allocator/memserver_allocator.h"
 #include <boost/atomic.hpp>
 #include <chrono>
+#include <fcntl.h>
 #include <iomanip>
+#include <sched.h>
 #include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "common/atomic_queue.h"
@@ -82,10 +87,11 @@ Memserver_Allocator::Memserver_Allocator(uint64_t delayed_free_threads,
         StartNVMM(fam_path);
 
     num_delayed_free_threads = delayed_free_threads;
-    heapMap = new HeapMap();
+    heapTable = new std::atomic<Heap *>[REGIONID_MASK + 1];
+    for (uint64_t i = 0; i <= REGIONID_MASK; i++)
+        heapTable[i].store(NULL);
     memoryManager = MemoryManager::GetInstance();
     em = EpochManager::GetInstance();
-    (void)pthread_mutex_init(&heapMapLock, NULL);
     for (uint64_t i = 0; i < num_delayed_free_threads; i++) {
         delayed_free_thread_array.push_back(gc_th_struct_t());
         delayed_free_thread_array[i].pthread_running = true;
@@ -99,11 +105,32 @@ Memserver_Allocator::Memserver_Allocator(uint64_t delayed_free_threads,
         itr->delayed_free_thread =
             std::thread(&Memserver_Allocator::delayed_free_th, this, i);
     }
+
+    numMagazineShards = std::thread::hardware_concurrency();
+    if (numMagazineShards == 0)
+        numMagazineShards = 1;
+    magazineShards = new Fam_Magazine_Shard_t[numMagazineShards];
+    cachedBytes = new std::atomic<uint64_t>[REGIONID_MASK + 1];
+    for (uint64_t i = 0; i <= REGIONID_MASK; i++)
+        cachedBytes[i].store(0);
+    open_magazine_journal(fam_path);
+
+    mergeThreadRunning = true;
+    mergeThread = std::thread(&Memserver_Allocator::merge_th, this);
 }
 
 Memserver_Allocator::~Memserver_Allocator() {
-    delete heapMap;
-    pthread_mutex_destroy(&heapMapLock);
+    {
+        std::lock_guard<std::mutex> guard(mergeQueueLock);
+        mergeThreadRunning = false;
+    }
+    mergeCond.notify_one();
+    if (mergeThread.joinable())
+        mergeThread.join();
+    delete[] magazineShards;
+    delete[] cachedBytes;
+    close_magazine_journal();
+    delete[] heapTable;
     for (uint64_t i = 0; i < num_delayed_free_threads; i++) {
         delayed_free_thread_array[i].pthread_running = false;
         if (delayed_free_thread_array[i].delayed_free_thread.joinable()) {
@@ -113,14 +140,13 @@ Memserver_Allocator::~Memserver_Allocator() {
 }
 
 void Memserver_Allocator::memserver_allocator_finalize() {
-    HeapMap::iterator it = heapMap->begin();
-    Heap *heap = 0;
-
-    while (it != heapMap->end()) {
-        heap = it->second;
-        if (heap->IsOpen())
+    for (uint64_t regionId = 0; regionId <= REGIONID_MASK; regionId++) {
+        Heap *heap = get_heap(regionId);
+        if (heap && heap->IsOpen()) {
+            // Give the cached offsets back before closing the heap
+            drain_magazines(regionId, heap);
             heap->Close();
-        it++;
+        }
     }
 }
 
@@ -154,6 +180,229 @@ void Memserver_Allocator::delayed_free_th(uint64_t thread_index) {
     }
 }
 
+/*
+ * Merges the heaps queued by request_merge, so that allocations do not
+ * have to wait for Merge() of a fragmented heap.
+ */
+void Memserver_Allocator::merge_th() {
+    std::unique_lock<std::mutex> lk(mergeQueueLock);
+    while (mergeThreadRunning) {
+        if (mergeRegions.empty()) {
+            mergeCond.wait(lk);
+            continue;
+        }
+        uint64_t regionId = *mergeRegions.begin();
+        mergeRegions.erase(mergeRegions.begin());
+        lk.unlock();
+        {
+            // destroy_region takes mergeHeapLock before removing the heap
+            // from the map, so the heap stays open during the merge
+            std::lock_guard<std::mutex> guard(mergeHeapLock);
+            Heap *heap = get_heap(regionId);
+            if (heap) {
+                try {
+                    NVMM_PROFILE_START_OPS()
+                    heap->Merge();
+                    NVMM_PROFILE_END_OPS(Heap_Merge)
+                } catch (...) {
+                    // Allocation merges the heap again if it runs out
+                }
+            }
+        }
+        lk.lock();
+    }
+}
+
+void Memserver_Allocator::request_merge(uint64_t regionId) {
+    {
+        std::lock_guard<std::mutex> guard(mergeQueueLock);
+        mergeRegions.insert(regionId);
+    }
+    mergeCond.notify_one();
+}
+
+/*
+ * Returns the magazine shard of the CPU the caller runs on.
+ */
+Fam_Magazine_Shard_t &Memserver_Allocator::get_magazine_shard() {
+    int cpu = sched_getcpu();
+    size_t idx = (cpu >= 0)
+                     ? (size_t)cpu
+                     : std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return magazineShards[idx % numMagazineShards];
+}
+
+/*
+ * Removes the cached offsets of a region from all the magazines. If heap
+ * is given and still in the map, the offsets are freed back to it.
+ */
+void Memserver_Allocator::drain_magazines(uint64_t regionId, Heap *heap) {
+    for (size_t i = 0; i < numMagazineShards; i++) {
+        std::lock_guard<std::mutex> guard(magazineShards[i].lock);
+        auto obj = magazineShards[i].regions.find(regionId);
+        if (obj == magazineShards[i].regions.end())
+            continue;
+        // destroy_region removes the heap from the map before draining, so
+        // a heap found here is not closed before the shard lock is dropped.
+        bool release = heap && get_heap(regionId) == heap;
+        for (int cls = 0; cls < MAGAZINE_NUM_CLASSES; cls++) {
+            std::vector<Fam_Magazine_Entry_t> &magazine =
+                obj->second.offsets[cls];
+            cachedBytes[regionId].fetch_sub(magazine.size() *
+                                            (MIN_OBJ_SIZE << cls));
+            for (auto entry : magazine) {
+                set_journal_slot(regionId, entry.slot, 0);
+                if (!release)
+                    continue;
+                obj->second.freeSlots.push_back(entry.slot);
+                if (num_delayed_free_threads > 0) {
+                    EpochOp op(em);
+                    heap->Free(op, entry.offset);
+                } else {
+                    heap->Free(entry.offset);
+                }
+            }
+            magazine.clear();
+        }
+        // Keep the free count of a live region, only its offsets go away
+        if (!release)
+            magazineShards[i].regions.erase(obj);
+    }
+}
+
+/*
+ * Counts a free in the region and queues a background merge of its heap
+ * once MERGE_FREE_WATERMARK frees were seen by this shard.
+ */
+void Memserver_Allocator::note_free(uint64_t regionId) {
+    Fam_Magazine_Shard_t &shard = get_magazine_shard();
+    bool merge = false;
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        Fam_Region_Magazine_t &magazine = shard.regions[regionId];
+        if (++magazine.freesSinceMerge >= MERGE_FREE_WATERMARK) {
+            magazine.freesSinceMerge = 0;
+            merge = true;
+        }
+    }
+    if (merge)
+        request_merge(regionId);
+}
+
+/*
+ * Maps the magazine journal from the directory of the heaps, or from
+ * /dev/shm if fam_path is not given. Offsets are only cached in the
+ * magazines if this process holds the lock on the journal file, since the
+ * processes of the shared memory model share the heaps.
+ */
+void Memserver_Allocator::open_magazine_journal(const char *fam_path) {
+    magazineJournal = NULL;
+    ownsMagazineJournal = false;
+    std::string path;
+    if (fam_path == NULL || (strcmp(fam_path, "") == 0))
+        path = "/dev/shm/fam_magazine_journal." + std::to_string(getuid());
+    else
+        path = std::string(fam_path) + "/fam_magazine_journal";
+    size_t size =
+        (REGIONID_MASK + 1) * MAGAZINE_JOURNAL_SLOTS * sizeof(uint64_t);
+
+    magazineJournalFd = open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (magazineJournalFd < 0)
+        return;
+    struct stat st;
+    if ((fstat(magazineJournalFd, &st) != 0) ||
+        (((size_t)st.st_size < size) &&
+         (ftruncate(magazineJournalFd, size) != 0))) {
+        close_magazine_journal();
+        return;
+    }
+    void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      magazineJournalFd, 0);
+    if (addr == MAP_FAILED) {
+        close_magazine_journal();
+        return;
+    }
+    magazineJournal = (uint64_t *)addr;
+    ownsMagazineJournal = (flock(magazineJournalFd, LOCK_EX | LOCK_NB) == 0);
+}
+
+void Memserver_Allocator::close_magazine_journal() {
+    if (magazineJournal)
+        munmap(magazineJournal, (REGIONID_MASK + 1) * MAGAZINE_JOURNAL_SLOTS *
+                                    sizeof(uint64_t));
+    magazineJournal = NULL;
+    ownsMagazineJournal = false;
+    if (magazineJournalFd >= 0)
+        close(magazineJournalFd);
+    magazineJournalFd = -1;
+}
+
+/*
+ * Gives a magazine the journal slots of its shard. The slots of a region
+ * are split evenly between the shards.
+ */
+void Memserver_Allocator::init_journal_slots(size_t shardIdx,
+                                             Fam_Region_Magazine_t &magazine) {
+    size_t perShard = MAGAZINE_JOURNAL_SLOTS / numMagazineShards;
+    size_t first = shardIdx * perShard;
+    if (perShard == 0 && shardIdx < MAGAZINE_JOURNAL_SLOTS) {
+        first = shardIdx;
+        perShard = 1;
+    }
+    for (size_t slot = first + perShard; slot > first; slot--)
+        magazine.freeSlots.push_back((uint32_t)(slot - 1));
+    magazine.hasSlots = true;
+}
+
+/*
+ * Records offset in a journal slot of the region, 0 marks the slot free.
+ */
+void Memserver_Allocator::set_journal_slot(uint64_t regionId, uint32_t slot,
+                                           uint64_t offset) {
+    uint64_t *entry =
+        &magazineJournal[regionId * MAGAZINE_JOURNAL_SLOTS + slot];
+    __atomic_store_n(entry, offset, __ATOMIC_RELEASE);
+    openfam_persist(entry, sizeof(uint64_t));
+}
+
+/*
+ * Frees back to the heap the offsets left in the journal of the region by
+ * a process which cached them and did not give them back. Called before
+ * the heap is added to the heap table.
+ */
+void Memserver_Allocator::reclaim_magazine_journal(uint64_t regionId,
+                                                   Heap *heap) {
+    if (!ownsMagazineJournal)
+        return;
+    for (uint32_t slot = 0; slot < MAGAZINE_JOURNAL_SLOTS; slot++) {
+        uint64_t *entry =
+            &magazineJournal[regionId * MAGAZINE_JOURNAL_SLOTS + slot];
+        uint64_t offset = __atomic_exchange_n(entry, 0, __ATOMIC_ACQ_REL);
+        if (!offset)
+            continue;
+        // Clear the slot before the free, so that a crash in between leaks
+        // the offset rather than freeing it twice
+        openfam_persist(entry, sizeof(uint64_t));
+        if (num_delayed_free_threads > 0) {
+            EpochOp op(em);
+            heap->Free(op, offset);
+        } else {
+            heap->Free(offset);
+        }
+    }
+}
+
+/*
+ * Clears the journal of a region whose heap is created or destroyed.
+ */
+void Memserver_Allocator::clear_magazine_journal(uint64_t regionId) {
+    if (!magazineJournal)
+        return;
+    uint64_t *entries = &magazineJournal[regionId * MAGAZINE_JOURNAL_SLOTS];
+    memset(entries, 0, MAGAZINE_JOURNAL_SLOTS * sizeof(uint64_t));
+    openfam_persist(entries, MAGAZINE_JOURNAL_SLOTS * sizeof(uint64_t));
+}
+
 /*
 
  * Create a new region.
@@ -199,6 +448,8 @@ void Memserver_Allocator::create_region(uint64_t regionId, size_t nbytes) {
         THROW_ERRNO_MSG(Memory_Service_Exception, HEAP_NOT_CREATED,
                         message.str().c_str());
     }
+    // Offsets left in the journal belong to an earlier heap of the region
+    clear_magazine_journal(regionId);
     Heap *heap = 0;
     NVMM_PROFILE_START_OPS()
     ret = memoryManager->FindHeap((PoolId)regionId, &heap);
@@ -218,25 +469,8 @@ void Memserver_Allocator::create_region(uint64_t regionId, size_t nbytes) {
         THROW_ERRNO_MSG(Memory_Service_Exception, HEAP_NOT_OPENED,
                         message.str().c_str());
     }
-    if (num_delayed_free_threads != 0) {
-        uint64_t idx = regionId % num_delayed_free_threads;
-        pthread_rwlock_wrlock(&delayed_free_thread_array[idx].rwLock);
-        Fam_Heap_Info_t *heapInfo = new Fam_Heap_Info_t();
-        heapInfo->heap = heap;
-        heapInfo->isValid = true;
-        pthread_rwlock_init(&heapInfo->rwLock, NULL);
-        delayed_free_thread_array[idx].heap_list->insert({regionId, heapInfo});
-        pthread_rwlock_unlock(&delayed_free_thread_array[idx].rwLock);
-    }
-    NVMM_PROFILE_START_OPS()
-    pthread_mutex_lock(&heapMapLock);
-
-    auto heapObj = heapMap->find(regionId);
-    if (heapObj == heapMap->end()) {
-        heapMap->insert({regionId, heap});
-    } else {
+    if (!insert_heap(regionId, heap)) {
         message << "Can not insert heap. regionId already found in map";
-        pthread_mutex_unlock(&heapMapLock);
         delete heap;
         NVMM_PROFILE_START_OPS()
         ret = memoryManager->DestroyHeap((PoolId)regionId);
@@ -247,10 +481,25 @@ void Memserver_Allocator::create_region(uint64_t regionId, size_t nbytes) {
         THROW_ERRNO_MSG(Memory_Service_Exception, HEAPMAP_INSERT_FAILED,
                         message.str().c_str());
     }
+    add_heap_to_list(regionId, heap);
+}
 
-    pthread_mutex_unlock(&heapMapLock);
-    NVMM_PROFILE_END_OPS(HeapMapInsertOp);
+/*
+ * Registers an open heap with its delayed free thread.
+ */
+void Memserver_Allocator::add_heap_to_list(uint64_t regionId, Heap *heap) {
+    if (num_delayed_free_threads != 0) {
+        uint64_t idx = regionId % num_delayed_free_threads;
+        pthread_rwlock_wrlock(&delayed_free_thread_array[idx].rwLock);
+        Fam_Heap_Info_t *heapInfo = new Fam_Heap_Info_t();
+        heapInfo->heap = heap;
+        heapInfo->isValid = true;
+        pthread_rwlock_init(&heapInfo->rwLock, NULL);
+        delayed_free_thread_array[idx].heap_list->insert({regionId, heapInfo});
+        pthread_rwlock_unlock(&delayed_free_thread_array[idx].rwLock);
+    }
 }
+
 Fam_Heap_Info_t *Memserver_Allocator::remove_heap_from_list(uint64_t regionId) {
     if (num_delayed_free_threads != 0) {
         uint64_t idx = regionId % num_delayed_free_threads;
@@ -281,15 +530,16 @@ void Memserver_Allocator::destroy_region(uint64_t regionId) {
     // destroy region using NVMM
     // Even if heap is not found in map, continue with DestroyHeap
     Heap *heap = 0;
+    {
+        std::lock_guard<std::mutex> guard(mergeHeapLock);
+        heap = remove_heap(regionId);
+    }
 
-    HeapMap::iterator it = get_heap(regionId, heap);
-
-    if (it != heapMap->end()) {
+    if (heap) {
         Fam_Heap_Info_t *heapInfo;
         NVMM_PROFILE_START_OPS()
-        pthread_mutex_lock(&heapMapLock);
-        heapMap->erase(it);
-        pthread_mutex_unlock(&heapMapLock);
+        // The heap is destroyed below, drop its cached offsets
+        drain_magazines(regionId, NULL);
         heapInfo = remove_heap_from_list(regionId);
         NVMM_PROFILE_END_OPS(HeapMapEraseOp)
         if (heapInfo) {
@@ -312,6 +562,7 @@ void Memserver_Allocator::destroy_region(uint64_t regionId) {
         delete heap;
     }
 
+    clear_magazine_journal(regionId);
     NVMM_PROFILE_START_OPS()
     ret = memoryManager->DestroyHeap((PoolId)regionId);
     NVMM_PROFILE_END_OPS(DestroyHeap)
@@ -332,13 +583,12 @@ void Memserver_Allocator::resize_region(uint64_t regionId, size_t nbytes) {
     message << "Error while resizing the region";
     int ret;
     // Get the heap and open it if not open already
-    Heap *heap = 0;
-    HeapMap::iterator it = get_heap(regionId, heap);
+    Heap *heap = get_heap(regionId);
 
-    if (it == heapMap->end()) {
+    if (!heap) {
         open_heap(regionId);
-        it = get_heap(regionId, heap);
-        if (it == heapMap->end()) {
+        heap = get_heap(regionId);
+        if (!heap) {
             message << "Can not find heap in map";
             THROW_ERRNO_MSG(Memory_Service_Exception, HEAPMAP_HEAP_NOT_FOUND,
                             message.str().c_str());
@@ -369,15 +619,13 @@ uint64_t Memserver_Allocator::allocate(uint64_t regionId, size_t nbytes) {
     ostringstream message;
     message << "Error While allocating dataitem : ";
     size_t tmpSize;
-    uint64_t offset;
     // Call NVMM to create a new data item
-    Heap *heap = 0;
+    Heap *heap = get_heap(regionId);
 
-    HeapMap::iterator it = get_heap(regionId, heap);
-    if (it == heapMap->end()) {
+    if (!heap) {
         open_heap(regionId);
-        it = get_heap(regionId, heap);
-        if (it == heapMap->end()) {
+        heap = get_heap(regionId);
+        if (!heap) {
             message << "Can not find heap in map";
             THROW_ERRNO_MSG(Memory_Service_Exception, HEAPMAP_HEAP_NOT_FOUND,
                             message.str().c_str());
@@ -390,8 +638,41 @@ uint64_t Memserver_Allocator::allocate(uint64_t regionId, size_t nbytes) {
         tmpSize = MIN_OBJ_SIZE;
     else
         tmpSize = nbytes;
+
+    if (ownsMagazineJournal && tmpSize <= MAGAZINE_MAX_OBJ_SIZE)
+        return allocate_small(regionId, heap, tmpSize);
+    return allocate_or_drain(regionId, heap, tmpSize);
+}
+
+/*
+ * Allocates nbytes from the heap. If the heap is full, the offsets cached
+ * in the magazines of the region are given back to it and the allocation
+ * is retried.
+ */
+uint64_t Memserver_Allocator::allocate_or_drain(uint64_t regionId, Heap *heap,
+                                                size_t nbytes) {
+    try {
+        return allocate_from_heap(heap, nbytes);
+    } catch (Memory_Service_Exception &e) {
+        if (e.fam_error() != HEAP_ALLOCATE_FAILED ||
+            !cachedBytes[regionId].load())
+            throw;
+    }
+    drain_magazines(regionId, heap);
+    return allocate_from_heap(heap, nbytes);
+}
+
+/*
+ * Allocates nbytes from the heap, merging the heap if it can not satisfy
+ * the allocation.
+ */
+uint64_t Memserver_Allocator::allocate_from_heap(Heap *heap, size_t nbytes) {
+    ostringstream message;
+    message << "Error While allocating dataitem : ";
+    uint64_t offset;
+
     NVMM_PROFILE_START_OPS()
-    offset = heap->AllocOffset(tmpSize);
+    offset = heap->AllocOffset(nbytes);
     NVMM_PROFILE_END_OPS(Heap_AllocOffset)
     if (!offset) {
         try {
@@ -407,7 +688,7 @@ uint64_t Memserver_Allocator::allocate(uint64_t regionId, size_t nbytes) {
         }
         {
             NVMM_PROFILE_START_OPS()
-            offset = heap->AllocOffset(tmpSize);
+            offset = heap->AllocOffset(nbytes);
             NVMM_PROFILE_END_OPS(Heap_AllocOffset)
         }
         if (!offset) {
@@ -420,6 +701,79 @@ uint64_t Memserver_Allocator::allocate(uint64_t regionId, size_t nbytes) {
     return offset;
 }
 
+/*
+ * Allocates a small data item from the magazine of its size class in the
+ * shard of the current CPU. An empty magazine is refilled with up to
+ * MAGAZINE_SIZE offsets from the heap, as long as the magazines of the
+ * region hold less than 1/MAGAZINE_CACHE_FRACTION of its size and the
+ * shard has free journal slots. Every cached offset is recorded in the
+ * magazine journal until it is handed out.
+ */
+uint64_t Memserver_Allocator::allocate_small(uint64_t regionId, Heap *heap,
+                                             size_t nbytes) {
+    int cls = 0;
+    size_t classSize = MIN_OBJ_SIZE;
+    while (classSize < nbytes) {
+        classSize <<= 1;
+        cls++;
+    }
+
+    Fam_Magazine_Shard_t &shard = get_magazine_shard();
+    size_t shardIdx = &shard - magazineShards;
+    uint64_t offset = 0;
+    bool merge = false;
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto obj = shard.regions.find(regionId);
+        if (obj == shard.regions.end() || obj->second.offsets[cls].empty()) {
+            // Only cache offsets of a heap which is still in the map;
+            // destroy_region drains the magazines after removing it.
+            if (get_heap(regionId) == heap) {
+                if (obj == shard.regions.end())
+                    obj = shard.regions.insert({regionId, {}}).first;
+                std::vector<Fam_Magazine_Entry_t> &magazine =
+                    obj->second.offsets[cls];
+                std::vector<uint32_t> &freeSlots = obj->second.freeSlots;
+                if (!obj->second.hasSlots)
+                    init_journal_slots(shardIdx, obj->second);
+                uint64_t limit = heap->Size() / MAGAZINE_CACHE_FRACTION;
+                for (int i = 0; i < MAGAZINE_SIZE; i++) {
+                    if (freeSlots.empty() ||
+                        cachedBytes[regionId].load() + classSize > limit)
+                        break;
+                    uint64_t refill;
+                    NVMM_PROFILE_START_OPS()
+                    refill = heap->AllocOffset(classSize);
+                    NVMM_PROFILE_END_OPS(Heap_AllocOffset)
+                    if (!refill) {
+                        merge = true;
+                        break;
+                    }
+                    uint32_t slot = freeSlots.back();
+                    freeSlots.pop_back();
+                    set_journal_slot(regionId, slot, refill);
+                    magazine.push_back({refill, slot});
+                    cachedBytes[regionId].fetch_add(classSize);
+                }
+            }
+        }
+        if (obj != shard.regions.end() && !obj->second.offsets[cls].empty()) {
+            Fam_Magazine_Entry_t entry = obj->second.offsets[cls].back();
+            obj->second.offsets[cls].pop_back();
+            cachedBytes[regionId].fetch_sub(classSize);
+            // The caller records the offset in the metadata of the item
+            set_journal_slot(regionId, entry.slot, 0);
+            obj->second.freeSlots.push_back(entry.slot);
+            offset = entry.offset;
+        }
+    }
+    if (merge)
+        request_merge(regionId);
+    if (offset)
+        return offset;
+    return allocate_or_drain(regionId, heap, classSize);
+}
+
 /*
  *
  * Deallocates a dataitem in a region at the given offset.
@@ -428,10 +782,9 @@ void Memserver_Allocator::deallocate(uint64_t regionId, uint64_t offset) {
     ostringstream message;
     message << "Error While deallocating dataitem : ";
     // call NVMM to destroy the data item
-    Heap *heap = 0;
+    Heap *heap = get_heap(regionId);
 
-    HeapMap::iterator it = get_heap(regionId, heap);
-    if (it != heapMap->end()) {
+    if (heap) {
         NVMM_PROFILE_START_OPS()
         if (num_delayed_free_threads > 0) {
             EpochOp op(em);
@@ -440,11 +793,12 @@ void Memserver_Allocator::deallocate(uint64_t regionId, uint64_t offset) {
             heap->Free(offset);
         }
         NVMM_PROFILE_END_OPS(Heap_Free)
+        note_free(regionId);
     } else {
         // Heap not found in map. Get the heap from NVMM
         open_heap(regionId);
-        it = get_heap(regionId, heap);
-        if (it == heapMap->end()) {
+        heap = get_heap(regionId);
+        if (!heap) {
             message << "Can not find heap in map";
             THROW_ERRNO_MSG(Memory_Service_Exception, HEAPMAP_HEAP_NOT_FOUND,
                             message.str().c_str());
@@ -457,6 +811,7 @@ void Memserver_Allocator::deallocate(uint64_t regionId, uint64_t offset) {
             heap->Free(offset);
         }
         NVMM_PROFILE_END_OPS(Heap_Free)
+        note_free(regionId);
     }
 }
 
@@ -466,20 +821,22 @@ void Memserver_Allocator::copy(uint64_t srcRegionId, uint64_t srcOffset,
     void *src = get_local_pointer(srcRegionId, srcOffset);
     void *dest = get_local_pointer(destRegionId, destOffset);
 
-    fam_memcpy(dest, src, size);
+    // The destination is not read back by the memory server, write it
+    // around the cache and persist it once.
+    openfam_memcpy_nontemporal(dest, src, size);
+    openfam_persist(dest, size);
 }
 
 void *Memserver_Allocator::get_local_pointer(uint64_t regionId,
                                              uint64_t offset) {
     ostringstream message;
     message << "Error While getting localpointer to dataitem : ";
-    Heap *heap = 0;
+    Heap *heap = get_heap(regionId);
 
-    HeapMap::iterator it = get_heap(regionId, heap);
-    if (it == heapMap->end()) {
+    if (!heap) {
         open_heap(regionId);
-        it = get_heap(regionId, heap);
-        if (it == heapMap->end()) {
+        heap = get_heap(regionId);
+        if (!heap) {
             message << "Can not find heap in map";
             THROW_ERRNO_MSG(Memory_Service_Exception, NO_LOCAL_POINTER,
                             message.str().c_str());
@@ -495,73 +852,104 @@ void *Memserver_Allocator::get_local_pointer(uint64_t regionId,
 void Memserver_Allocator::open_heap(uint64_t regionId) {
     ostringstream message;
     message << "Error While opening heap : ";
-    Heap *heap = 0;
 
+    if (!try_open_heap(regionId)) {
+        message << "heap not found";
+        THROW_ERRNO_MSG(Memory_Service_Exception, HEAP_NOT_OPENED,
+                        message.str().c_str());
+    }
+}
+
+/*
+ * Opens the heap of regionId, if it is not open already, and adds it to
+ * the heap table. Returns false if there is no such heap.
+ */
+bool Memserver_Allocator::try_open_heap(uint64_t regionId) {
     // Check if the heap is already open
+    if (get_heap(regionId))
+        return true;
+    std::lock_guard<std::mutex> guard(
+        openHeapLocks[regionId % numOpenHeapLocks]);
+    if (get_heap(regionId))
+        return true;
 
-    get_heap(regionId, heap);
-    if (heap == NULL) {
+    // Heap is not open, open it now
+    Heap *heap = 0;
+    int ret;
+    NVMM_PROFILE_START_OPS()
+    ret = memoryManager->FindHeap((PoolId)regionId, &heap);
+    NVMM_PROFILE_END_OPS(FindHeap)
+    if (ret != NO_ERROR) {
+        delete heap;
+        return false;
+    }
+    NVMM_PROFILE_START_OPS()
+    heap->Open(NVMM_NO_BG_THREAD);
+    NVMM_PROFILE_END_OPS(Heap_Open)
+    reclaim_magazine_journal(regionId, heap);
 
-        // Heap is not open, open it now
-        int ret;
-        NVMM_PROFILE_START_OPS()
-        ret = memoryManager->FindHeap((PoolId)regionId, &heap);
-        NVMM_PROFILE_END_OPS(FindHeap)
-        if (ret != NO_ERROR) {
-            message << "heap not found";
-            delete heap;
-            THROW_ERRNO_MSG(Memory_Service_Exception, HEAP_NOT_OPENED,
-                            message.str().c_str());
-        }
-        NVMM_PROFILE_START_OPS()
-        heap->Open(NVMM_NO_BG_THREAD);
-        NVMM_PROFILE_END_OPS(Heap_Open)
-
-        if (num_delayed_free_threads != 0) {
-            uint64_t idx = regionId % num_delayed_free_threads;
-            pthread_rwlock_wrlock(&delayed_free_thread_array[idx].rwLock);
-            Fam_Heap_Info_t *heapInfo = new Fam_Heap_Info_t();
-            heapInfo->heap = heap;
-            heapInfo->isValid = true;
-            pthread_rwlock_init(&heapInfo->rwLock, NULL);
-            delayed_free_thread_array[idx].heap_list->insert(
-                {regionId, heapInfo});
-            pthread_rwlock_unlock(&delayed_free_thread_array[idx].rwLock);
-        }
+    // Heap opened now, Add this into table for future references.
+    if (insert_heap(regionId, heap)) {
+        add_heap_to_list(regionId, heap);
+    } else {
+        // Someone else opened it first
         NVMM_PROFILE_START_OPS()
-        pthread_mutex_lock(&heapMapLock);
+        heap->Close();
+        NVMM_PROFILE_END_OPS(Heap_Close)
+        delete heap;
+    }
+    return true;
+}
 
-        // Heap opened now, Add this into map for future references.
-        auto heapObj = heapMap->find(regionId);
-        if (heapObj == heapMap->end()) {
-            heapMap->insert({regionId, heap});
-            pthread_mutex_unlock(&heapMapLock);
-        } else {
-            pthread_mutex_unlock(&heapMapLock);
-            message << "Can not insert heap. regionId already found in map";
-            NVMM_PROFILE_START_OPS()
-            heap->Close();
-            NVMM_PROFILE_END_OPS(Heap_Close)
-            delete heap;
-        }
-        NVMM_PROFILE_END_OPS(HeapMapFindOp)
+/*
+ * Opens all the heaps present on this memory server, using numThreads
+ * threads, instead of opening each heap on its first use after a restart.
+ */
+void Memserver_Allocator::open_heaps(uint64_t numThreads) {
+    std::atomic<uint64_t> nextId(MEMSERVER_REGIONID_START);
+    std::vector<std::thread> threads;
+    for (uint64_t i = 0; i < numThreads; i++) {
+        threads.push_back(std::thread([this, &nextId] {
+            uint64_t regionId;
+            while ((regionId = nextId++) <= REGIONID_MASK)
+                try_open_heap(regionId);
+        }));
     }
+    for (auto &thread : threads)
+        thread.join();
 }
 
-HeapMap::iterator Memserver_Allocator::get_heap(uint64_t regionId,
-                                                Heap *&heap) {
-    HeapMap::iterator heapObj;
+Heap *Memserver_Allocator::get_heap(uint64_t regionId) {
+    Heap *heap = NULL;
     NVMM_PROFILE_START_OPS()
-    pthread_mutex_lock(&heapMapLock);
+    if (regionId <= REGIONID_MASK)
+        heap = heapTable[regionId].load(std::memory_order_acquire);
+    NVMM_PROFILE_END_OPS(HeapMapFindOp)
+    return heap;
+}
 
-    heapObj = heapMap->find(regionId);
-    if (heapObj != heapMap->end()) {
-        heap = heapObj->second;
-    }
+/*
+ * Adds an open heap to the heap table. Returns false if the region
+ * already has a heap.
+ */
+bool Memserver_Allocator::insert_heap(uint64_t regionId, Heap *heap) {
+    Heap *expected = NULL;
+    bool ret = false;
+    NVMM_PROFILE_START_OPS()
+    if (regionId <= REGIONID_MASK)
+        ret = heapTable[regionId].compare_exchange_strong(
+            expected, heap, std::memory_order_acq_rel);
+    NVMM_PROFILE_END_OPS(HeapMapInsertOp)
+    return ret;
+}
 
-    pthread_mutex_unlock(&heapMapLock);
-    NVMM_PROFILE_END_OPS(HeapMapFindOp)
-    return heapObj;
+/*
+ * Removes the heap of a region from the heap table and returns it.
+ */
+Heap *Memserver_Allocator::remove_heap(uint64_t regionId) {
+    if (regionId > REGIONID_MASK)
+        return NULL;
+    return heapTable[regionId].exchange(NULL, std::memory_order_acq_rel);
 }
 
 /*
@@ -618,15 +1006,8 @@ void Memserver_Allocator::create_ATL_root(size_t nbytes) {
     }
 
     uint64_t regionId = (uint64_t)poolId;
-    NVMM_PROFILE_START_OPS()
-    pthread_mutex_lock(&heapMapLock);
-
-    auto heapObj = heapMap->find(regionId);
-    if (heapObj == heapMap->end()) {
-        heapMap->insert({regionId, heap});
-    } else {
+    if (!insert_heap(regionId, heap)) {
         message << "Can not insert heap. regionId already found in map";
-        pthread_mutex_unlock(&heapMapLock);
         delete heap;
         NVMM_PROFILE_START_OPS()
         ret = memoryManager->DestroyHeap((PoolId)regionId);
@@ -638,9 +1019,6 @@ void Memserver_Allocator::create_ATL_root(size_t nbytes) {
                         message.str().c_str());
     }
 
-    pthread_mutex_unlock(&heapMapLock);
-    NVMM_PROFILE_END_OPS(HeapMapInsertOp);
-
     if (!regionATLexists) {
         ATLroot = heap->Alloc(sizeof(uint64_t) * MAX_ATOMIC_THREADS);
         assert(ATLroot.IsValid() == true);
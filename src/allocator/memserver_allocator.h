@@ -31,8 +31,12 @@
 #ifndef MEMSERVER_ALLOCATOR_H_
 #define MEMSERVER_ALLOCATOR_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <pthread.h>
+#include <set>
 #include <sys/types.h> // needed for mode_t
 #include <thread>
 
@@ -51,6 +55,21 @@
 
 #define MIN_OBJ_SIZE 128
 #define MIN_REGION_SIZE (1UL << 20)
+// Data items up to MAGAZINE_MAX_OBJ_SIZE are served from per-CPU magazines
+// of pre-allocated offsets, one per power of two size class
+#define MAGAZINE_MAX_OBJ_SIZE 4096
+#define MAGAZINE_NUM_CLASSES 6
+#define MAGAZINE_SIZE 32
+// The magazines of all the CPUs cache at most 1/MAGAZINE_CACHE_FRACTION of
+// the size of a region
+#define MAGAZINE_CACHE_FRACTION 64
+// The offsets cached in the magazines are recorded in a persistent journal
+// of MAGAZINE_JOURNAL_SLOTS offsets per region, and freed back to the heap
+// when it is opened again after a crash
+#define MAGAZINE_JOURNAL_SLOTS 1024
+// Number of frees in a region, seen by one magazine shard, after which the
+// heap of the region is merged in the background
+#define MERGE_FREE_WATERMARK 4096
 
 using namespace std;
 using namespace nvmm;
@@ -62,7 +81,22 @@ typedef struct Fam_Heap_Info {
     pthread_rwlock_t rwLock;
 } Fam_Heap_Info_t;
 using HeapInfo = std::map<uint64_t, Fam_Heap_Info_t *>;
-using HeapMap = std::map<uint64_t, Heap *>;
+typedef struct Fam_Magazine_Entry {
+    uint64_t offset;
+    // Slot of the offset in the magazine journal of the region
+    uint32_t slot;
+} Fam_Magazine_Entry_t;
+typedef struct Fam_Region_Magazine {
+    std::vector<Fam_Magazine_Entry_t> offsets[MAGAZINE_NUM_CLASSES];
+    // Journal slots of the shard which do not hold an offset
+    std::vector<uint32_t> freeSlots;
+    bool hasSlots;
+    uint64_t freesSinceMerge;
+} Fam_Region_Magazine_t;
+typedef struct Fam_Magazine_Shard {
+    std::mutex lock;
+    std::map<uint64_t, Fam_Region_Magazine_t> regions;
+} Fam_Magazine_Shard_t;
 typedef struct gc_th_struct {
     std::thread delayed_free_thread;
     // int num_heaps;
@@ -88,22 +122,67 @@ class Memserver_Allocator {
               uint64_t destOffset, uint64_t size);
     void *get_local_pointer(uint64_t regionId, uint64_t offset);
     void open_heap(uint64_t regionId);
+    void open_heaps(uint64_t numThreads);
     void create_ATL_root(size_t nbytes);
+    void add_heap_to_list(uint64_t regionId, Heap *heap);
     Fam_Heap_Info_t *remove_heap_from_list(uint64_t regionId);
     void delayed_free_th(uint64_t thread_index);
 
   private:
     MemoryManager *memoryManager;
     EpochManager *em;
-    HeapMap *heapMap;
-    pthread_mutex_t heapMapLock;
-    HeapMap::iterator get_heap(uint64_t regionId, Heap *&heap);
+    // Open heaps indexed by regionId. Lookups are lock free; a slot only
+    // changes from NULL to a heap when it is opened and back when the
+    // region is destroyed.
+    std::atomic<Heap *> *heapTable;
+    Heap *get_heap(uint64_t regionId);
+    bool insert_heap(uint64_t regionId, Heap *heap);
+    Heap *remove_heap(uint64_t regionId);
+    bool try_open_heap(uint64_t regionId);
+    // Heaps are opened under one of these locks, so that the magazine
+    // journal of a region is reclaimed once
+    static uint64_t const numOpenHeapLocks = 64;
+    std::mutex openHeapLocks[numOpenHeapLocks];
     PoolId get_free_poolId();
     bitmap *bmap;
     void init_poolId_bmap();
     uint64_t num_delayed_free_threads;
     static uint64_t const delayed_free_th_sleep_MicroSeconds = 1000;
     std::vector<gc_th_struct_t> delayed_free_thread_array;
+
+    size_t numMagazineShards;
+    Fam_Magazine_Shard_t *magazineShards;
+    // Bytes cached in the magazines, indexed by regionId
+    std::atomic<uint64_t> *cachedBytes;
+    Fam_Magazine_Shard_t &get_magazine_shard();
+    uint64_t allocate_from_heap(Heap *heap, size_t nbytes);
+    uint64_t allocate_small(uint64_t regionId, Heap *heap, size_t nbytes);
+    uint64_t allocate_or_drain(uint64_t regionId, Heap *heap, size_t nbytes);
+    void drain_magazines(uint64_t regionId, Heap *heap);
+    void note_free(uint64_t regionId);
+
+    // Journal of the offsets cached in the magazines, mapped from a file
+    // next to the heaps. Only the process holding the lock on the file
+    // caches offsets, the others allocate from the heaps directly.
+    uint64_t *magazineJournal;
+    int magazineJournalFd;
+    bool ownsMagazineJournal;
+    void open_magazine_journal(const char *fam_path);
+    void close_magazine_journal();
+    void init_journal_slots(size_t shardIdx, Fam_Region_Magazine_t &magazine);
+    void set_journal_slot(uint64_t regionId, uint32_t slot, uint64_t offset);
+    void reclaim_magazine_journal(uint64_t regionId, Heap *heap);
+    void clear_magazine_journal(uint64_t regionId);
+
+    // Background merge of fragmented heaps
+    std::thread mergeThread;
+    bool mergeThreadRunning;
+    std::set<uint64_t> mergeRegions;
+    std::mutex mergeQueueLock;
+    std::condition_variable mergeCond;
+    std::mutex mergeHeapLock;
+    void request_merge(uint64_t regionId);
+    void merge_th();
 };
 
 } // namespace openfam
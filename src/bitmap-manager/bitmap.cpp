@@ -36,6 +36,19 @@ static bool get(uint64_t, uint64_t);
 static void set(uint64_t *, uint64_t);
 static void reset(uint64_t *, uint64_t);
 
+/* word level search helpers */
+static uint64_t bitmap_words(bitmap *bmap);
+static uint64_t word_match(bitmap *bmap, uint64_t word, uint64_t value,
+                           bool val);
+static void bitmap_mark_full(bitmap *bmap, uint64_t word);
+static void bitmap_mark_free(bitmap *bmap, uint64_t word);
+static uint64_t bitmap_scan(bitmap *bmap, bool val, uint64_t start,
+                            bool reserve, bool useHints);
+
+#define HINT_WORD(hint) ((hint)&0xFFFFFFFFUL)
+#define HINT_VERSION(hint) ((hint) >> 32)
+#define MAKE_HINT(version, word) (((version) << 32) | (word))
+
 /* Registers the bitmap with fam_atomic and initialize the bitmap to 0*/
 int bitmap_init(bitmap *bmap) {
     uint64_t size = bmap->size;
@@ -53,9 +66,31 @@ int bitmap_init(bitmap *bmap) {
     return 0;
 }
 
+/*
+ * Allocates the summary level of the bitmap, one bit per bitmap word set
+ * when that word is full, so that searches for a free bit skip 64 full
+ * words at a time. Useful for large bitmaps.
+ */
+int bitmap_enable_summary(bitmap *bmap) {
+    uint64_t words = bitmap_words(bmap);
+    uint64_t *summary =
+        (uint64_t *)calloc((words + BITSIZE - 1) / BITSIZE, sizeof(uint64_t));
+    if (!summary)
+        return -1;
+    bmap->summary = summary;
+    for (uint64_t i = 0; i < words; i++) {
+        if (!word_match(bmap, i, fam_atomic_64_read((int64_t *)bmap->map + i),
+                        0))
+            bitmap_mark_full(bmap, i);
+    }
+    return 0;
+}
+
 void bitmap_free(bitmap *bmap) {
 
     fam_atomic_unregister_region(bmap->map, bmap->size);
+    free(bmap->summary);
+    bmap->summary = NULL;
 }
 
 /* Returns the value of the @n'th bit of the bitmap */
@@ -124,6 +159,7 @@ void bitmap_reset(bitmap *bmap, uint64_t n) {
         }
     } while (retry);
 
+    bitmap_mark_free(bmap, offset);
 }
 
 /* Check the n'th bit value and then sets the n'th bit 
@@ -171,6 +207,8 @@ int bitmap_reserve(bitmap *bmap, bool val, uint64_t n) {
         }
     } while (retry);
 
+    if (val)
+        bitmap_mark_free(bmap, offset);
     return 0;
 }
 
@@ -180,37 +218,153 @@ int bitmap_reserve(bitmap *bmap, bool val, uint64_t n) {
  * will be reset to 0 and bit position will be returned.
  */
 uint64_t bitmap_find_and_reserve(bitmap *bmap, bool val, uint64_t start) {
-    uint64_t i;
-    uint64_t size = bmap->size;
-
-    /* size is now the Bitmap size in bits */
-    for (i = start, size *= 8; i < size; i++) {
-        if (bitmap_get(bmap, i) == val) {
-            // If bitmap_reserve() fails to reserve the bit,
-            // try next available bit.
-            if (bitmap_reserve(bmap, val, i) == 0) {
-                return i; 
-            }
-        }
-    }
-
-    return BITMAP_NOTFOUND;
+    uint64_t pos = bitmap_scan(bmap, val, start, true, true);
+    // The hints are local to this process; bits freed by others may have
+    // been skipped, so look at the whole bitmap before giving up.
+    if (pos == (uint64_t)BITMAP_NOTFOUND)
+        pos = bitmap_scan(bmap, val, start, true, false);
+    return pos;
 }
 
 /* Finds the first n value in bitmap after start */
 /* size is the Bitmap size in bytes */
 uint64_t bitmap_find(bitmap *bmap, bool n, uint64_t start) {
-    uint64_t i;
-    uint64_t size = bmap->size;
+    return bitmap_scan(bmap, n, start, false, false);
+}
+
+/*
+ * Scans the bitmap a word at a time for the first "val" bit at or after
+ * start and optionally reserves it. With useHints, a search for a free (0)
+ * bit starts at the hint cursor and skips the words the summary level
+ * marks as full.
+ */
+static uint64_t bitmap_scan(bitmap *bmap, bool val, uint64_t start,
+                            bool reserve, bool useHints) {
+    uint64_t words = bitmap_words(bmap);
+    uint64_t startWord = start / BITSIZE;
+    uint64_t hint = 0;
+    uint64_t w = startWord;
+
+    useHints = useHints && !val;
+    if (useHints) {
+        hint = __atomic_load_n(&bmap->hint, __ATOMIC_SEQ_CST);
+        if (HINT_WORD(hint) > w)
+            w = HINT_WORD(hint);
+    }
 
-    /* size is now the Bitmap size in bits */
-    for (i = start, size *= 8; i < size; i++) {
-        if (bitmap_get(bmap, i) == n)
-            return i;
+    while (w < words) {
+        // Skip the words the summary level knows to be full.
+        if (useHints && bmap->summary) {
+            uint64_t sw = w / BITSIZE;
+            uint64_t notFull =
+                ~__atomic_load_n(&bmap->summary[sw], __ATOMIC_SEQ_CST) &
+                (~0UL << (w % BITSIZE));
+            if (!notFull) {
+                w = (sw + 1) * BITSIZE;
+                continue;
+            }
+            w = sw * BITSIZE + __builtin_ctzl(notFull);
+            if (w >= words)
+                break;
+        }
+
+        int64_t *addr = (int64_t *)bmap->map + w;
+        uint64_t value = fam_atomic_64_read(addr);
+        uint64_t match = word_match(bmap, w, value, val);
+        if (w == startWord)
+            match &= ~0UL << (start % BITSIZE);
+
+        while (match) {
+            uint64_t pos = __builtin_ctzl(match);
+            if (!reserve)
+                return w * BITSIZE + pos;
+
+            uint64_t newValue = value;
+            if (val)
+                reset(&newValue, pos);
+            else
+                set(&newValue, pos);
+            uint64_t result =
+                fam_atomic_64_compare_store(addr, value, newValue);
+            if (result == value) {
+                if (val)
+                    bitmap_mark_free(bmap, w);
+                if (useHints && startWord <= HINT_WORD(hint) &&
+                    w > HINT_WORD(hint)) {
+                    // All the words between the hint and w were full.
+                    // Fails if a bit was freed since the hint was read.
+                    __atomic_compare_exchange_n(
+                        &bmap->hint, &hint, MAKE_HINT(HINT_VERSION(hint), w),
+                        false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+                }
+                return w * BITSIZE + pos;
+            }
+            // Someone else changed this word, look at it again.
+            value = result;
+            match = word_match(bmap, w, value, val);
+            if (w == startWord)
+                match &= ~0UL << (start % BITSIZE);
+        }
+
+        if (useHints && !word_match(bmap, w, value, 0))
+            bitmap_mark_full(bmap, w);
+        w++;
     }
     return BITMAP_NOTFOUND;
 }
 
+/* Returns the number of 64-bit words in the bitmap */
+static uint64_t bitmap_words(bitmap *bmap) {
+    return (bmap->size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+/*
+ * Returns the bits of value, the content of bitmap word "word", which are
+ * "val", leaving out the bits past the end of the bitmap.
+ */
+static uint64_t word_match(bitmap *bmap, uint64_t word, uint64_t value,
+                           bool val) {
+    uint64_t match = val ? value : ~value;
+    uint64_t bits = bmap->size * 8;
+    if ((word + 1) * BITSIZE > bits)
+        match &= (1UL << (bits - word * BITSIZE)) - 1;
+    return match;
+}
+
+/*
+ * Marks a word as full in the summary level. The word is checked again
+ * afterwards, so that a bit freed concurrently is not hidden.
+ */
+static void bitmap_mark_full(bitmap *bmap, uint64_t word) {
+    if (!bmap->summary)
+        return;
+    uint64_t bit = 1UL << (word % BITSIZE);
+    __atomic_fetch_or(&bmap->summary[word / BITSIZE], bit, __ATOMIC_SEQ_CST);
+    if (word_match(bmap, word, fam_atomic_64_read((int64_t *)bmap->map + word),
+                   0))
+        __atomic_fetch_and(&bmap->summary[word / BITSIZE], ~bit,
+                           __ATOMIC_SEQ_CST);
+}
+
+/*
+ * Records that a bit of word was freed: clears the word in the summary
+ * level and moves the hint cursor back to it. The hint version is bumped
+ * so that a concurrent search does not move the cursor past the word.
+ */
+static void bitmap_mark_free(bitmap *bmap, uint64_t word) {
+    if (bmap->summary)
+        __atomic_fetch_and(&bmap->summary[word / BITSIZE],
+                           ~(1UL << (word % BITSIZE)), __ATOMIC_SEQ_CST);
+    uint64_t hint = __atomic_load_n(&bmap->hint, __ATOMIC_SEQ_CST);
+    uint64_t newHint;
+    do {
+        newHint = MAKE_HINT(HINT_VERSION(hint) + 1,
+                            HINT_WORD(hint) < word ? HINT_WORD(hint) : word);
+    } while (!__atomic_compare_exchange_n(&bmap->hint, &hint, newHint, false,
+                                          __ATOMIC_SEQ_CST,
+                                          __ATOMIC_SEQ_CST));
+}
+
 /* Returns the value of byte at bit position*/
 static bool get(uint64_t byte, uint64_t bit) { return (byte >> bit) & 1UL; }
 
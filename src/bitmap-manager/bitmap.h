@@ -44,9 +44,21 @@
 typedef struct bitmap {
     void *map;
     uint64_t size;
+    /*
+     * Search state local to this process. Both are only hints for
+     * bitmap_find_and_reserve; a search that finds nothing with them falls
+     * back to a plain scan of the bitmap.
+     * hint - reset version in the upper 32 bits and, in the lower 32 bits,
+     *        the lowest word which may still have a free (0) bit.
+     * summary - optional, one bit per bitmap word, set when the word is
+     *           known to be full. See bitmap_enable_summary.
+     */
+    uint64_t hint;
+    uint64_t *summary;
 } bitmap;
 
 int bitmap_init(bitmap *bmap);
+int bitmap_enable_summary(bitmap *bmap);
 void bitmap_free(bitmap *bmap);
 
 bool bitmap_get(bitmap *bmap, uint64_t pos);
@@ -32,6 +32,7 @@
 
 #include <string>
 #include <sys/types.h>
+#include <vector>
 
 #include <grpc/impl/codegen/log.h>
 #include <grpcpp/grpcpp.h>
@@ -65,6 +66,10 @@ typedef struct {
 
     uint64_t memServerId;
 
+    // Id naming the copy on the memory server, and its size
+    uint64_t copyId;
+    uint64_t size;
+
     std::unique_ptr< ::grpc::ClientAsyncResponseReader<Fam_Copy_Response> >
     responseReader;
 
@@ -200,6 +205,49 @@ class Fam_CIS {
     virtual Fam_Region_Item_Info lookup(string itemName, string regionName,
                                         uint32_t uid, uint32_t gid) = 0;
 
+    /**
+     * Allocate several data items within the specified region. Either all
+     * data items are allocated or none is.
+     * @param names - names of the data items ("" for an unnamed item)
+     * @param sizes - size of each data item
+     * @param permission - permission of the data items
+     * @param regionId - region Id of the region
+     * @param memoryServerId - Memory server Id
+     * @param uid - uid of user
+     * @param gid - gid of user
+     * @return - Fam_Region_Item_Info of each data item, in request order
+     **/
+    virtual std::vector<Fam_Region_Item_Info>
+    allocate_batch(const std::vector<std::string> &names,
+                   const std::vector<size_t> &sizes, mode_t permission,
+                   uint64_t regionId, uint64_t memoryServerId, uint32_t uid,
+                   uint32_t gid) = 0;
+
+    /**
+     * deallocates several data items
+     * @param regionIds - region Id of each data item
+     * @param offsets - offset of each data item within its region
+     * @param memoryServerIds - Memory server Id of each data item
+     * @param uid - uid of user
+     * @param gid - gid of user
+     **/
+    virtual void deallocate_batch(const std::vector<uint64_t> &regionIds,
+                                  const std::vector<uint64_t> &offsets,
+                                  const std::vector<uint64_t> &memoryServerIds,
+                                  uint32_t uid, uint32_t gid) = 0;
+
+    /**
+     * look for several dataitems of one region
+     * @param itemNames - names of the dataitems
+     * @param regionName - name of the region
+     * @param uid - uid of user
+     * @param gid - gid of user
+     * @return - Fam_Region_Item_Info of each dataitem, in request order
+     **/
+    virtual std::vector<Fam_Region_Item_Info>
+    lookup_batch(const std::vector<std::string> &itemNames, string regionName,
+                 uint32_t uid, uint32_t gid) = 0;
+
     /**
      * check permission for region access and returns region information
      * @param regionId - region Id of region
@@ -256,6 +304,8 @@ class Fam_CIS {
      * @param destMemoryServerId - Memory server Id
      * @param uid - uid of user
      * @param gid - gid of user
+     * @param progress - if given, names the copy with its copyId and gets
+     * the bytes copied by a synchronous copy
      **/
     virtual void *copy(uint64_t srcRegionId, uint64_t srcOffset,
                        uint64_t srcCopyStart, uint64_t srcKey,
@@ -263,7 +313,8 @@ class Fam_CIS {
                        uint64_t destRegionId, uint64_t destOffset,
                        uint64_t destCopyStar, uint64_t nbytes,
                        uint64_t srcMemoryServerId, uint64_t destMemoryServerId,
-                       uint32_t uid, uint32_t gid) = 0;
+                       uint32_t uid, uint32_t gid,
+                       Fam_Copy_Progress *progress = NULL) = 0;
 
     /**
      * wait for particular copy issued earlier corresponding to wait object
@@ -271,6 +322,19 @@ class Fam_CIS {
      **/
     virtual void wait_for_copy(void *waitObj) = 0;
 
+    /**
+     * Number of bytes copied so far by the copy of a wait object
+     * @param waitObj - wait object
+     **/
+    virtual uint64_t copy_progress(void *waitObj) = 0;
+
+    /**
+     * Stop the copy of a wait object before its next chunk; wait_for_copy
+     * then reports it as cancelled
+     * @param waitObj - wait object
+     **/
+    virtual void cancel_copy(void *waitObj) = 0;
+
     /**
      * Map a data item in FAM to the local virtual address space, and return its
      * pointer.
@@ -302,6 +366,11 @@ class Fam_CIS {
 
     virtual void acquire_CAS_lock(uint64_t offset, uint64_t memoryServerId) = 0;
     virtual void release_CAS_lock(uint64_t offset, uint64_t memoryServerId) = 0;
+    virtual int128_t atomic_int128(uint32_t op, uint64_t regionId,
+                                   uint64_t offset, uint64_t valueOffset,
+                                   int128_t operand, int128_t compare,
+                                   uint64_t memoryServerId, uint32_t uid,
+                                   uint32_t gid) = 0;
 
     virtual size_t get_addr_size(uint64_t memoryServerId) = 0;
     virtual void get_addr(void *memServerFabricAddr,
@@ -338,13 +407,13 @@ class Fam_CIS {
 
     virtual int scatter_indexed_atomic(
         uint64_t regionId, uint64_t offset, uint64_t nElements,
-        const void *elementIndex, uint64_t elementSize, uint64_t key,
+        const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
         const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
         uint32_t uid, uint32_t gid) = 0;
 
     virtual int gather_indexed_atomic(
         uint64_t regionId, uint64_t offset, uint64_t nElements,
-        const void *elementIndex, uint64_t elementSize, uint64_t key,
+        const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
         const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
         uint32_t uid, uint32_t gid) = 0;
 };
@@ -31,8 +31,27 @@
 #include "cis/fam_cis_client.h"
 #include "common/atomic_queue.h"
 
+#include <algorithm>
+
 namespace openfam {
 
+/*
+ * Copy the stripe layout of an interleaved dataitem from the response message.
+ */
+static void get_interleave_info(const Fam_Dataitem_Response &res,
+                                Fam_Region_Item_Info &info) {
+    int cnt = std::min(res.memsrv_list_size(), res.key_list_size());
+    cnt = std::min(cnt, res.base_list_size());
+    cnt = std::min(cnt, MAX_INTERLEAVE_MEMSERVERS_CNT);
+    info.interleaveSize = res.interleave_size();
+    info.used_memsrv_cnt = (uint64_t)cnt;
+    for (int i = 0; i < cnt; i++) {
+        info.memServerIds[i] = res.memsrv_list(i);
+        info.keys[i] = res.key_list(i);
+        info.bases[i] = res.base_list(i);
+    }
+}
+
 Fam_CIS_Client::Fam_CIS_Client(const char *name, uint64_t port) {
     std::ostringstream message;
 
@@ -184,6 +203,7 @@ Fam_Region_Item_Info Fam_CIS_Client::allocate(string name, size_t nbytes,
     info.offset = res.offset();
     info.key = res.key();
     info.base = (void *)res.base();
+    get_interleave_info(res, info);
     return info;
 }
 
@@ -294,6 +314,97 @@ Fam_Region_Item_Info Fam_CIS_Client::lookup(string itemName, string regionName,
     return info;
 }
 
+std::vector<Fam_Region_Item_Info> Fam_CIS_Client::allocate_batch(
+    const std::vector<std::string> &names, const std::vector<size_t> &sizes,
+    mode_t permission, uint64_t regionId, uint64_t memoryServerId,
+    uint32_t uid, uint32_t gid) {
+    Fam_Dataitem_Batch_Request req;
+    Fam_Dataitem_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    for (size_t i = 0; i < names.size(); i++) {
+        Fam_Dataitem_Request *item = req.add_items();
+        item->set_name(names[i]);
+        item->set_size(i < sizes.size() ? sizes[i] : 0);
+    }
+    req.set_regionid(regionId);
+    req.set_perm(permission);
+    req.set_uid(uid);
+    req.set_gid(gid);
+    req.set_memserver_id(memoryServerId);
+
+    ::grpc::Status status = stub->allocate_batch(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+    std::vector<Fam_Region_Item_Info> infos(res.items_size());
+    for (int i = 0; i < res.items_size(); i++) {
+        const Fam_Dataitem_Response &item = res.items(i);
+        infos[i].regionId = item.regionid();
+        infos[i].memoryServerId = item.memserver_id();
+        infos[i].offset = item.offset();
+        infos[i].key = item.key();
+        infos[i].base = (void *)item.base();
+        get_interleave_info(item, infos[i]);
+    }
+    return infos;
+}
+
+void Fam_CIS_Client::deallocate_batch(
+    const std::vector<uint64_t> &regionIds,
+    const std::vector<uint64_t> &offsets,
+    const std::vector<uint64_t> &memoryServerIds, uint32_t uid,
+    uint32_t gid) {
+    Fam_Dataitem_Batch_Request req;
+    Fam_Dataitem_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    size_t count = std::min(regionIds.size(), offsets.size());
+    count = std::min(count, memoryServerIds.size());
+    for (size_t i = 0; i < count; i++) {
+        Fam_Dataitem_Request *item = req.add_items();
+        item->set_regionid(regionIds[i]);
+        item->set_offset(offsets[i]);
+        item->set_memserver_id(memoryServerIds[i]);
+    }
+    req.set_uid(uid);
+    req.set_gid(gid);
+
+    ::grpc::Status status = stub->deallocate_batch(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+}
+
+std::vector<Fam_Region_Item_Info>
+Fam_CIS_Client::lookup_batch(const std::vector<std::string> &itemNames,
+                             string regionName, uint32_t uid, uint32_t gid) {
+    Fam_Dataitem_Batch_Request req;
+    Fam_Dataitem_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    for (auto &name : itemNames)
+        req.add_items()->set_name(name);
+    req.set_regionname(regionName);
+    req.set_uid(uid);
+    req.set_gid(gid);
+
+    ::grpc::Status status = stub->lookup_batch(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+
+    std::vector<Fam_Region_Item_Info> infos(res.items_size());
+    for (int i = 0; i < res.items_size(); i++) {
+        const Fam_Dataitem_Response &item = res.items(i);
+        infos[i].regionId = item.regionid();
+        infos[i].offset = item.offset();
+        infos[i].key = FAM_KEY_UNINITIALIZED;
+        infos[i].size = item.size();
+        infos[i].perm = (mode_t)item.perm();
+        infos[i].memoryServerId = item.memserver_id();
+        strncpy(infos[i].name, (item.name()).c_str(), item.maxnamelen());
+    }
+    return infos;
+}
+
 Fam_Region_Item_Info Fam_CIS_Client::check_permission_get_region_info(
     uint64_t regionId, uint64_t memoryServerId, uint32_t uid, uint32_t gid) {
     Fam_Region_Request req;
@@ -341,6 +452,7 @@ Fam_Region_Item_Info Fam_CIS_Client::check_permission_get_item_info(
     info.size = res.size();
     info.perm = (mode_t)res.perm();
     strncpy(info.name, (res.name()).c_str(), res.maxnamelen());
+    get_interleave_info(res, info);
     return info;
 }
 
@@ -376,7 +488,7 @@ void *Fam_CIS_Client::copy(uint64_t srcRegionId, uint64_t srcOffset,
                            uint64_t destCopyStar, uint64_t nbytes,
                            uint64_t srcMemoryServerId,
                            uint64_t destMemoryServerId, uint32_t uid,
-                           uint32_t gid) {
+                           uint32_t gid, Fam_Copy_Progress *progress) {
     Fam_Copy_Request req;
     Fam_Copy_Response res;
     ::grpc::ClientContext ctx;
@@ -400,6 +512,9 @@ void *Fam_CIS_Client::copy(uint64_t srcRegionId, uint64_t srcOffset,
 
     waitObj->isCompleted = false;
     waitObj->memServerId = destMemoryServerId;
+    waitObj->copyId = (progress ? progress->copyId : openfam_new_copy_id());
+    waitObj->size = nbytes;
+    req.set_copyid(waitObj->copyId);
 
     waitObj->responseReader = stub->PrepareAsynccopy(&waitObj->ctx, req, cq);
 
@@ -475,6 +590,53 @@ void Fam_CIS_Client::wait_for_copy(void *waitObj) {
     }
 }
 
+/*
+ * The copy runs on the memory server, which is asked for its progress until
+ * the response of the copy has been received.
+ */
+uint64_t Fam_CIS_Client::copy_progress(void *waitObj) {
+    Fam_Copy_Wait_Object *obj = static_cast<Fam_Copy_Wait_Object *>(waitObj);
+
+    if (!obj) {
+        throw CIS_Exception(FAM_ERR_INVALID, "Copy waitObj is null");
+    }
+    if (obj->isCompleted)
+        return (obj->status.ok() ? obj->res.bytescopied() : 0);
+
+    Fam_Copy_Control_Request req;
+    Fam_Copy_Control_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_copyid(obj->copyId);
+    req.set_memserver_id(obj->memServerId);
+
+    ::grpc::Status status = stub->copy_progress(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+    return res.bytescopied();
+}
+
+void Fam_CIS_Client::cancel_copy(void *waitObj) {
+    Fam_Copy_Wait_Object *obj = static_cast<Fam_Copy_Wait_Object *>(waitObj);
+
+    if (!obj) {
+        throw CIS_Exception(FAM_ERR_INVALID, "Copy waitObj is null");
+    }
+    if (obj->isCompleted)
+        return;
+
+    Fam_Copy_Control_Request req;
+    Fam_Copy_Control_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_copyid(obj->copyId);
+    req.set_memserver_id(obj->memServerId);
+
+    ::grpc::Status status = stub->cancel_copy(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+}
+
 void *Fam_CIS_Client::fam_map(uint64_t regionId, uint64_t offset,
                               uint64_t memoryServerId, uint32_t uid,
                               uint32_t gid) {
@@ -515,6 +677,36 @@ void Fam_CIS_Client::release_CAS_lock(uint64_t offset,
     STATUS_CHECK(CIS_Exception)
 }
 
+int128_t Fam_CIS_Client::atomic_int128(uint32_t op, uint64_t regionId,
+                                       uint64_t offset, uint64_t valueOffset,
+                                       int128_t operand, int128_t compare,
+                                       uint64_t memoryServerId, uint32_t uid,
+                                       uint32_t gid) {
+    Fam_Int128_Atomic_Request req;
+    Fam_Int128_Atomic_Response res;
+    ::grpc::ClientContext ctx;
+    uint64_t lo, hi;
+
+    req.set_op(op);
+    req.set_regionid(regionId);
+    req.set_offset(offset);
+    req.set_valueoffset(valueOffset);
+    int128_to_words(operand, &lo, &hi);
+    req.set_operand_lo(lo);
+    req.set_operand_hi(hi);
+    int128_to_words(compare, &lo, &hi);
+    req.set_compare_lo(lo);
+    req.set_compare_hi(hi);
+    req.set_memserver_id(memoryServerId);
+    req.set_uid(uid);
+    req.set_gid(gid);
+
+    ::grpc::Status status = stub->atomic_int128(&ctx, req, &res);
+
+    STATUS_CHECK(CIS_Exception)
+    return words_to_int128(res.result_lo(), res.result_hi());
+}
+
 size_t Fam_CIS_Client::get_addr_size(uint64_t memoryServerId) {
     Fam_Address_Request req;
     Fam_Address_Response res;
@@ -690,7 +882,7 @@ int Fam_CIS_Client::gather_strided_atomic(
 
 int Fam_CIS_Client::scatter_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
     uint32_t uid, uint32_t gid) {
     Fam_Atomic_SG_Indexed_Request req;
@@ -699,7 +891,10 @@ int Fam_CIS_Client::scatter_indexed_atomic(
     req.set_regionid(regionId & REGIONID_MASK);
     req.set_offset(offset);
     req.set_nelements(nElements);
-    req.set_elementindex(elementIndex, strlen((char *)elementIndex));
+    std::string indexStr;
+    req.set_indexencoding(
+        encode_index_array(elementIndex, nElements, &indexStr));
+    req.set_elementindex(indexStr);
     req.set_elementsize(elementSize);
     req.set_key(key);
     req.set_nodeaddr(nodeAddr, nodeAddrSize);
@@ -715,7 +910,7 @@ int Fam_CIS_Client::scatter_indexed_atomic(
 
 int Fam_CIS_Client::gather_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
     uint32_t uid, uint32_t gid) {
     Fam_Atomic_SG_Indexed_Request req;
@@ -724,7 +919,10 @@ int Fam_CIS_Client::gather_indexed_atomic(
     req.set_regionid(regionId & REGIONID_MASK);
     req.set_offset(offset);
     req.set_nelements(nElements);
-    req.set_elementindex(elementIndex, strlen((char *)elementIndex));
+    std::string indexStr;
+    req.set_indexencoding(
+        encode_index_array(elementIndex, nElements, &indexStr));
+    req.set_elementindex(indexStr);
     req.set_elementsize(elementSize);
     req.set_key(key);
     req.set_nodeaddr(nodeAddr, nodeAddrSize);
@@ -101,6 +101,18 @@ class Fam_CIS_Client : public Fam_CIS {
     Fam_Region_Item_Info lookup_region(string name, uint32_t uid, uint32_t gid);
     Fam_Region_Item_Info lookup(string itemName, string regionName,
                                 uint32_t uid, uint32_t gid);
+    std::vector<Fam_Region_Item_Info>
+    allocate_batch(const std::vector<std::string> &names,
+                   const std::vector<size_t> &sizes, mode_t permission,
+                   uint64_t regionId, uint64_t memoryServerId, uint32_t uid,
+                   uint32_t gid);
+    void deallocate_batch(const std::vector<uint64_t> &regionIds,
+                          const std::vector<uint64_t> &offsets,
+                          const std::vector<uint64_t> &memoryServerIds,
+                          uint32_t uid, uint32_t gid);
+    std::vector<Fam_Region_Item_Info>
+    lookup_batch(const std::vector<std::string> &itemNames, string regionName,
+                 uint32_t uid, uint32_t gid);
     Fam_Region_Item_Info
     check_permission_get_region_info(uint64_t regionId, uint64_t memoryServerId,
                                      uint32_t uid, uint32_t gid);
@@ -119,9 +131,12 @@ class Fam_CIS_Client : public Fam_CIS {
                uint64_t destRegionId, uint64_t destOffset,
                uint64_t destCopyStar, uint64_t nbytes,
                uint64_t srcMemoryServerId, uint64_t destMemoryServerId,
-               uint32_t uid, uint32_t gid);
+               uint32_t uid, uint32_t gid,
+               Fam_Copy_Progress *progress = NULL);
 
     void wait_for_copy(void *waitObj);
+    uint64_t copy_progress(void *waitObj);
+    void cancel_copy(void *waitObj);
 
     void *fam_map(uint64_t regionId, uint64_t offset, uint64_t memoryServerId,
                   uint32_t uid, uint32_t gid);
@@ -130,6 +145,10 @@ class Fam_CIS_Client : public Fam_CIS {
 
     void acquire_CAS_lock(uint64_t offset, uint64_t memoryServerId);
     void release_CAS_lock(uint64_t offset, uint64_t memoryServerId);
+    int128_t atomic_int128(uint32_t op, uint64_t regionId, uint64_t offset,
+                           uint64_t valueOffset, int128_t operand,
+                           int128_t compare, uint64_t memoryServerId,
+                           uint32_t uid, uint32_t gid);
 
     size_t get_addr_size(uint64_t memoryServerId);
     void get_addr(void *memServerFabricAddr, uint64_t memoryServerId);
@@ -162,14 +181,14 @@ class Fam_CIS_Client : public Fam_CIS {
                               uint32_t uid, uint32_t gid);
 
     int scatter_indexed_atomic(uint64_t regionId, uint64_t offset,
-                               uint64_t nElements, const void *elementIndex,
+                               uint64_t nElements, const uint64_t *elementIndex,
                                uint64_t elementSize, uint64_t key,
                                const char *nodeAddr, uint32_t nodeAddrSize,
                                uint64_t memoryServerId, uint32_t uid,
                                uint32_t gid);
 
     int gather_indexed_atomic(uint64_t regionId, uint64_t offset,
-                              uint64_t nElements, const void *elementIndex,
+                              uint64_t nElements, const uint64_t *elementIndex,
                               uint64_t elementSize, uint64_t key,
                               const char *nodeAddr, uint32_t nodeAddrSize,
                               uint64_t memoryServerId, uint32_t uid,
@@ -34,13 +34,16 @@
 
 #include <boost/atomic.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <iomanip>
+#include <map>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #define MIN_REGION_SIZE (1UL << 20)
+#define MIN_INTERLEAVE_SIZE 4096
 using namespace std;
 using namespace chrono;
 namespace openfam {
@@ -105,6 +108,24 @@ Fam_CIS_Direct::Fam_CIS_Direct(char *cisName, bool useAsyncCopy_,
         cisName = strdup("127.0.0.1");
     }
 
+    interleaveSize = 0;
+    if (!config_options.empty()) {
+        try {
+            interleaveSize = stoull(config_options["interleave_size"]);
+        }
+        catch (...) {
+            message << "Invalid value specified for Fam config "
+                       "option:interleave_size.";
+            THROW_ERR_MSG(Fam_InvalidOption_Exception, message.str().c_str());
+        }
+        if (interleaveSize % MIN_INTERLEAVE_SIZE) {
+            message << "Fam config option:interleave_size must be a multiple "
+                       "of "
+                    << MIN_INTERLEAVE_SIZE;
+            THROW_ERR_MSG(Fam_InvalidOption_Exception, message.str().c_str());
+        }
+    }
+
     if (useAsyncCopy) {
         asyncQHandler = new Fam_Async_QHandler(1);
     }
@@ -463,6 +484,8 @@ Fam_CIS_Direct::create_region(string name, size_t nbytes, mode_t permission,
     region.used_memsrv_cnt = used_memsrv_cnt;
     memcpy(region.memServerIds, memServerIds,
            used_memsrv_cnt * sizeof(uint64_t));
+    // Data items of the region are placed with the same policy
+    region.placementPolicy = user_policy;
     try {
         metadataService->metadata_insert_region(regionId, name, &region);
     }
@@ -585,6 +608,172 @@ void Fam_CIS_Direct::resize_region(uint64_t regionId, size_t nbytes,
     return;
 }
 
+/*
+ * Number of bytes of an interleaved data item placed on the idx-th of its
+ * memsrvCnt memory servers. Stripe i lives on memory server (i % memsrvCnt)
+ * at offset (i / memsrvCnt) * stripeSize within that server's extent.
+ */
+static inline uint64_t interleave_extent_size(uint64_t nbytes,
+                                              uint64_t stripeSize,
+                                              uint64_t memsrvCnt,
+                                              uint64_t idx) {
+    uint64_t numStripes = (nbytes + stripeSize - 1) / stripeSize;
+    return ((numStripes - idx + memsrvCnt - 1) / memsrvCnt) * stripeSize;
+}
+
+/*
+ * Select the memory servers a data item of nbytes is interleaved across:
+ * the memory servers of the region, starting with firstId, with at most one
+ * memory server per stripe.
+ */
+std::vector<uint64_t> Fam_CIS_Direct::get_interleave_memory_servers(
+    Fam_Metadata_Service *metadataService, uint64_t regionId,
+    uint64_t firstId, size_t nbytes) {
+    std::list<int> memserverList =
+        metadataService->get_memory_server_list(regionId);
+    std::vector<uint64_t> regionList(memserverList.begin(),
+                                     memserverList.end());
+    std::vector<uint64_t> interleaveList;
+
+    uint64_t numStripes = (nbytes + interleaveSize - 1) / interleaveSize;
+    uint64_t cnt = std::min((uint64_t)regionList.size(), numStripes);
+    cnt = std::min(cnt, (uint64_t)MAX_INTERLEAVE_MEMSERVERS_CNT);
+
+    size_t start = 0;
+    for (size_t i = 0; i < regionList.size(); i++) {
+        if (regionList[i] == firstId) {
+            start = i;
+            break;
+        }
+    }
+    for (uint64_t i = 0; i < cnt; i++)
+        interleaveList.push_back(regionList[(start + i) % regionList.size()]);
+    return interleaveList;
+}
+
+/*
+ * Allocate the stripes of an interleaved data item on each of the memory
+ * servers in interleaveList and record the layout in dataitem. On failure the
+ * stripes already allocated are released and an exception is thrown.
+ */
+void Fam_CIS_Direct::allocate_interleaved(
+    uint64_t regionId, size_t nbytes, std::vector<uint64_t> &interleaveList,
+    Fam_DataItem_Metadata &dataitem, uint64_t *bases) {
+    uint64_t cnt = interleaveList.size();
+    std::vector<std::shared_future<Fam_Region_Item_Info> > resultList;
+
+    // Invoke each memory service asynchronously.
+    for (uint64_t i = 0; i < cnt; i++) {
+        Fam_Memory_Service *memoryService =
+            get_memory_service(interleaveList[i]);
+        size_t size =
+            (size_t)interleave_extent_size(nbytes, interleaveSize, cnt, i);
+        std::future<Fam_Region_Item_Info> result(std::async(
+            std::launch::async, &openfam::Fam_Memory_Service::allocate,
+            memoryService, regionId, size));
+        resultList.push_back(result.share());
+    }
+
+    std::vector<uint64_t> allocatedList;
+    bool allocateSuccess = true;
+    for (uint64_t i = 0; i < cnt; i++) {
+        try {
+            const Fam_Region_Item_Info &stripeInfo = resultList[i].get();
+            dataitem.memServerIds[i] = interleaveList[i];
+            dataitem.offsets[i] = stripeInfo.offset;
+            bases[i] = (uint64_t)stripeInfo.base;
+            allocatedList.push_back(i);
+        }
+        catch (...) {
+            allocateSuccess = false;
+        }
+    }
+
+    if (!allocateSuccess) {
+        ostringstream message;
+        for (auto i : allocatedList) {
+            try {
+                get_memory_service(interleaveList[i])
+                    ->deallocate(regionId, dataitem.offsets[i]);
+            }
+            catch (...) {
+                // Nothing more can be done; the stripe is leaked.
+            }
+        }
+        message << "Failed to allocate interleaved dataitem in all memory "
+                   "servers";
+        THROW_ERRNO_MSG(CIS_Exception, DATAITEM_NOT_CREATED,
+                        message.str().c_str());
+    }
+    dataitem.interleaveSize = interleaveSize;
+    dataitem.used_memsrv_cnt = cnt;
+}
+
+/*
+ * Release the stripes of an interleaved data item on all its memory servers.
+ */
+void Fam_CIS_Direct::deallocate_interleaved(uint64_t regionId,
+                                            Fam_DataItem_Metadata &dataitem) {
+    std::list<std::shared_future<void> > resultList;
+    for (uint64_t i = 0; i < dataitem.used_memsrv_cnt; i++) {
+        Fam_Memory_Service *memoryService =
+            get_memory_service(dataitem.memServerIds[i]);
+        std::future<void> result(std::async(
+            std::launch::async, &openfam::Fam_Memory_Service::deallocate,
+            memoryService, regionId, dataitem.offsets[i]));
+        resultList.push_back(result.share());
+    }
+
+    // Wait for all the memory servers, then report the first failure.
+    bool deallocateSuccess = true;
+    Fam_Exception ex;
+    for (auto result : resultList) {
+        try {
+            result.get();
+        }
+        catch (Fam_Exception &e) {
+            if (deallocateSuccess)
+                ex = e;
+            deallocateSuccess = false;
+        }
+    }
+    if (!deallocateSuccess) {
+        THROW_ERRNO_MSG(CIS_Exception, (Fam_Error)ex.fam_error(),
+                        ex.fam_error_msg());
+    }
+}
+
+/*
+ * Fill the stripe layout of an interleaved data item, with the access key of
+ * each stripe extent, into info. bases holds the base address of each extent
+ * if already known, NULL otherwise.
+ */
+void Fam_CIS_Direct::get_interleave_info(Fam_DataItem_Metadata &dataitem,
+                                         bool rwFlag, uint64_t *bases,
+                                         Fam_Region_Item_Info &info) {
+    uint64_t cnt = dataitem.used_memsrv_cnt;
+    info.interleaveSize = dataitem.interleaveSize;
+    info.used_memsrv_cnt = cnt;
+    for (uint64_t i = 0; i < cnt; i++) {
+        uint64_t memsrvId = dataitem.memServerIds[i];
+        Fam_Memory_Service *memoryService = get_memory_service(memsrvId);
+        uint64_t size = interleave_extent_size(
+            dataitem.size, dataitem.interleaveSize, cnt, i);
+        info.memServerIds[i] = memsrvId;
+        info.offsets[i] = dataitem.offsets[i];
+        info.keys[i] = memoryService->get_key(dataitem.regionId,
+                                              dataitem.offsets[i], size,
+                                              rwFlag);
+        info.bases[i] =
+            (bases ? bases[i]
+                   : (uint64_t)get_local_pointer(dataitem.regionId,
+                                                 dataitem.offsets[i],
+                                                 memsrvId));
+    }
+    info.key = info.keys[0];
+    info.base = (void *)info.bases[0];
+}
+
 Fam_Region_Item_Info Fam_CIS_Direct::allocate(string name, size_t nbytes,
                                               mode_t permission,
                                               uint64_t regionId,
@@ -604,36 +793,57 @@ Fam_Region_Item_Info Fam_CIS_Direct::allocate(string name, size_t nbytes,
                                                              uid, gid, &id);
     Fam_Memory_Service *memoryService = get_memory_service((uint64_t)id);
     Fam_DataItem_Metadata dataitem;
+    uint64_t bases[MAX_INTERLEAVE_MEMSERVERS_CNT];
+
+    // Data items larger than the interleave size are striped across the
+    // memory servers of the region, starting with the one picked above.
+    std::vector<uint64_t> interleaveList;
+    if (interleaveSize && (nbytes > interleaveSize))
+        interleaveList = get_interleave_memory_servers(metadataService,
+                                                       regionId, id, nbytes);
 
     bool rwFlag, allocateSuccess = true;
-    try {
-        info = memoryService->allocate(regionId, nbytes);
-    }
-    catch (...) {
-        std::list<int> memserverList =
-            metadataService->get_memory_server_list(regionId);
-        allocateSuccess = false;
-        for (const auto &item : memserverList) {
-            if ((uint64_t)item == id) {
-                continue;
-            }
-            try {
-                memoryService = get_memory_service((uint64_t)item);
-                info = memoryService->allocate(regionId, nbytes);
-            }
-            catch (...) {
-                continue;
+    if (interleaveList.size() > 1) {
+        // Throws if any memory server fails to allocate its stripes
+        allocate_interleaved(regionId, nbytes, interleaveList, dataitem, bases);
+        id = dataitem.memServerIds[0];
+        info.offset = dataitem.offsets[0];
+        info.base = (void *)bases[0];
+    } else {
+        try {
+            info = memoryService->allocate(regionId, nbytes);
+        }
+        catch (...) {
+            std::list<int> memserverList =
+                metadataService->get_memory_server_list(regionId);
+            allocateSuccess = false;
+            for (const auto &item : memserverList) {
+                if ((uint64_t)item == id) {
+                    continue;
+                }
+                try {
+                    memoryService = get_memory_service((uint64_t)item);
+                    info = memoryService->allocate(regionId, nbytes);
+                }
+                catch (...) {
+                    continue;
+                }
+                allocateSuccess = true;
+                id = (uint64_t)item;
+                break;
             }
-            allocateSuccess = true;
-            id = (uint64_t)item;
-            break;
         }
-    }
 
-    if (!allocateSuccess) {
-        message << "Failed to allocate dataitem in any memory server";
-        THROW_ERRNO_MSG(CIS_Exception, DATAITEM_NOT_CREATED,
-                        message.str().c_str());
+        if (!allocateSuccess) {
+            message << "Failed to allocate dataitem in any memory server";
+            THROW_ERRNO_MSG(CIS_Exception, DATAITEM_NOT_CREATED,
+                            message.str().c_str());
+        }
+
+        dataitem.interleaveSize = 0;
+        dataitem.used_memsrv_cnt = 1;
+        dataitem.memServerIds[0] = id;
+        dataitem.offsets[0] = info.offset;
     }
 
     uint64_t dataitemId = get_dataitem_id(info.offset, id);
@@ -662,9 +872,14 @@ Fam_Region_Item_Info Fam_CIS_Direct::allocate(string name, size_t nbytes,
         message << "Not permitted to use this dataitem";
         THROW_ERRNO_MSG(CIS_Exception, FAM_ERR_NOPERM, message.str().c_str());
     }
-    uint64_t key =
-        memoryService->get_key(regionId, info.offset, nbytes, rwFlag);
-    info.key = key;
+    if (dataitem.interleaveSize) {
+        get_interleave_info(dataitem, rwFlag, bases, info);
+    } else {
+        info.key =
+            memoryService->get_key(regionId, info.offset, nbytes, rwFlag);
+        info.interleaveSize = 0;
+        info.used_memsrv_cnt = 0;
+    }
     info.regionId = regionId;
     info.memoryServerId = id;
     info.size = nbytes;
@@ -683,11 +898,16 @@ void Fam_CIS_Direct::deallocate(uint64_t regionId, uint64_t offset,
     // Check with metadata service if data item with the requested name can be
     // deallocated.
     uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
+    Fam_DataItem_Metadata dataitem;
     metadataService->metadata_validate_and_deallocate_dataitem(
-        regionId, dataitemId, uid, gid);
-    Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
+        regionId, dataitemId, uid, gid, dataitem);
 
-    memoryService->deallocate(regionId, offset);
+    if (dataitem.interleaveSize) {
+        deallocate_interleaved(regionId, dataitem);
+    } else {
+        Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
+        memoryService->deallocate(regionId, offset);
+    }
 
     CIS_DIRECT_PROFILE_END_OPS(cis_deallocate);
 
@@ -769,10 +989,9 @@ void Fam_CIS_Direct::change_dataitem_permission(uint64_t regionId,
 /*
  * Check if the given uid/gid has read or rw permissions.
  */
-bool Fam_CIS_Direct::check_region_permission(Fam_Region_Metadata region,
-                                             bool op,
-                                             uint64_t metadataServiceId,
-                                             uint32_t uid, uint32_t gid) {
+bool Fam_CIS_Direct::check_region_permission(
+    const Fam_Region_Metadata &region, bool op, uint64_t metadataServiceId,
+    uint32_t uid, uint32_t gid) {
     metadata_region_item_op_t opFlag;
     Fam_Metadata_Service *metadataService =
         get_metadata_service(metadataServiceId);
@@ -789,10 +1008,9 @@ bool Fam_CIS_Direct::check_region_permission(Fam_Region_Metadata region,
  * Check if the given uid/gid has read or rw permissions for
  * a given dataitem.
  */
-bool Fam_CIS_Direct::check_dataitem_permission(Fam_DataItem_Metadata dataitem,
-                                               bool op,
-                                               uint64_t metadataServiceId,
-                                               uint32_t uid, uint32_t gid) {
+bool Fam_CIS_Direct::check_dataitem_permission(
+    const Fam_DataItem_Metadata &dataitem, bool op, uint64_t metadataServiceId,
+    uint32_t uid, uint32_t gid) {
 
     metadata_region_item_op_t opFlag;
 
@@ -876,6 +1094,277 @@ Fam_Region_Item_Info Fam_CIS_Direct::lookup(string itemName, string regionName,
     return info;
 }
 
+/*
+ * Allocate the data items of sizes on memory server id with a single request,
+ * falling back to the other memory servers of the region if it fails.
+ * Returns the memory server the data items were allocated on.
+ */
+uint64_t Fam_CIS_Direct::allocate_on_memory_server(
+    Fam_Metadata_Service *metadataService, uint64_t regionId, uint64_t id,
+    const std::vector<size_t> &sizes, bool rwFlag,
+    std::vector<Fam_Region_Item_Info> &infos) {
+    ostringstream message;
+    try {
+        infos = get_memory_service(id)->allocate_batch(regionId, sizes, rwFlag);
+        return id;
+    }
+    catch (...) {
+    }
+
+    std::list<int> memserverList =
+        metadataService->get_memory_server_list(regionId);
+    for (const auto &item : memserverList) {
+        if ((uint64_t)item == id) {
+            continue;
+        }
+        try {
+            infos = get_memory_service((uint64_t)item)
+                        ->allocate_batch(regionId, sizes, rwFlag);
+        }
+        catch (...) {
+            continue;
+        }
+        return (uint64_t)item;
+    }
+    message << "Failed to allocate dataitem in any memory server";
+    THROW_ERRNO_MSG(CIS_Exception, DATAITEM_NOT_CREATED, message.str().c_str());
+}
+
+/*
+ * Allocate several data items of a region. The metadata service validates
+ * all of them in one call, the data items are then allocated and registered
+ * with one request per memory server, and their metadata is inserted in one
+ * call. Data items large enough to be interleaved use the single item path.
+ * On failure every data item allocated by this call is released.
+ */
+std::vector<Fam_Region_Item_Info> Fam_CIS_Direct::allocate_batch(
+    const std::vector<std::string> &names, const std::vector<size_t> &sizes,
+    mode_t permission, uint64_t regionId, uint64_t memoryServerId,
+    uint32_t uid, uint32_t gid) {
+    std::vector<Fam_Region_Item_Info> infos(names.size());
+    CIS_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+    if (names.size() != sizes.size()) {
+        message << "Number of dataitem names and sizes do not match";
+        THROW_ERRNO_MSG(CIS_Exception, FAM_ERR_INVALID, message.str().c_str());
+    }
+
+    uint64_t metadataServiceId = 0;
+    Fam_Metadata_Service *metadataService =
+        get_metadata_service(metadataServiceId);
+    // Check with metadata service if all the data items can be allocated.
+    std::vector<uint64_t> ids;
+    metadataService->metadata_validate_and_allocate_dataitem_batch(
+        names, regionId, uid, gid, ids);
+
+    // The data items are registered as they are allocated, so the access
+    // they are registered for is decided up front.
+    Fam_DataItem_Metadata owner;
+    owner.perm = permission;
+    owner.uid = uid;
+    owner.gid = gid;
+    bool rwFlag;
+    if (check_dataitem_permission(owner, 1, metadataServiceId, uid, gid)) {
+        rwFlag = 1;
+    } else if (check_dataitem_permission(owner, 0, metadataServiceId, uid,
+                                         gid)) {
+        rwFlag = 0;
+    } else {
+        message << "Not permitted to use this dataitem";
+        THROW_ERRNO_MSG(CIS_Exception, FAM_ERR_NOPERM, message.str().c_str());
+    }
+
+    std::map<uint64_t, std::vector<size_t> > groups;
+    std::vector<size_t> interleaved;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (interleaveSize && (sizes[i] > interleaveSize))
+            interleaved.push_back(i);
+        else
+            groups[ids[i]].push_back(i);
+    }
+
+    std::vector<std::pair<uint64_t, std::vector<uint64_t> > > allocated;
+    std::vector<Fam_DataItem_Metadata> dataitems;
+    std::vector<uint64_t> dataitemIds;
+    size_t done = 0;
+    try {
+        for (auto &group : groups) {
+            std::vector<size_t> groupSizes;
+            for (auto i : group.second)
+                groupSizes.push_back(sizes[i]);
+            std::vector<Fam_Region_Item_Info> groupInfos;
+            uint64_t id = allocate_on_memory_server(
+                metadataService, regionId, group.first, groupSizes, rwFlag,
+                groupInfos);
+            allocated.push_back({id, std::vector<uint64_t>()});
+            for (size_t j = 0; j < group.second.size(); j++) {
+                size_t i = group.second[j];
+                Fam_DataItem_Metadata dataitem;
+                dataitem.regionId = regionId;
+                strncpy(dataitem.name, names[i].c_str(), metadataMaxKeyLen);
+                dataitem.offset = groupInfos[j].offset;
+                dataitem.perm = permission;
+                dataitem.gid = gid;
+                dataitem.uid = uid;
+                dataitem.size = sizes[i];
+                dataitem.memoryServerId = id;
+                dataitem.interleaveSize = 0;
+                dataitem.used_memsrv_cnt = 1;
+                dataitem.memServerIds[0] = id;
+                dataitem.offsets[0] = groupInfos[j].offset;
+                dataitems.push_back(dataitem);
+                dataitemIds.push_back(
+                    get_dataitem_id(groupInfos[j].offset, id));
+                allocated.back().second.push_back(groupInfos[j].offset);
+
+                infos[i] = groupInfos[j];
+                infos[i].regionId = regionId;
+                infos[i].memoryServerId = id;
+                infos[i].size = sizes[i];
+                infos[i].interleaveSize = 0;
+                infos[i].used_memsrv_cnt = 0;
+            }
+        }
+        if (!dataitems.empty())
+            metadataService->metadata_insert_dataitem_batch(
+                dataitemIds, regionId, dataitems);
+    }
+    catch (...) {
+        for (auto &server : allocated) {
+            try {
+                get_memory_service(server.first)
+                    ->deallocate_batch(regionId, server.second);
+            }
+            catch (...) {
+                // Nothing more can be done; the data items are leaked.
+            }
+        }
+        throw;
+    }
+
+    try {
+        for (; done < interleaved.size(); done++) {
+            size_t i = interleaved[done];
+            infos[i] = allocate(names[i], sizes[i], permission, regionId,
+                                memoryServerId, uid, gid);
+        }
+    }
+    catch (...) {
+        std::vector<uint64_t> regionIds, offsets, memoryServerIds;
+        for (size_t d = 0; d < done; d++) {
+            Fam_Region_Item_Info &info = infos[interleaved[d]];
+            regionIds.push_back(regionId);
+            offsets.push_back(info.offset);
+            memoryServerIds.push_back(info.memoryServerId);
+        }
+        for (auto &dataitem : dataitems) {
+            regionIds.push_back(regionId);
+            offsets.push_back(dataitem.offset);
+            memoryServerIds.push_back(dataitem.memoryServerId);
+        }
+        try {
+            deallocate_batch(regionIds, offsets, memoryServerIds, uid, gid);
+        }
+        catch (...) {
+            // Nothing more can be done; the data items are leaked.
+        }
+        throw;
+    }
+    CIS_DIRECT_PROFILE_END_OPS(cis_allocate_batch);
+    return infos;
+}
+
+/*
+ * Deallocate several data items. The data items of each region are validated
+ * and removed from the metadata service in one call and released with one
+ * request per memory server. If a region fails, the data items of the
+ * regions processed before it stay deallocated.
+ */
+void Fam_CIS_Direct::deallocate_batch(
+    const std::vector<uint64_t> &regionIds,
+    const std::vector<uint64_t> &offsets,
+    const std::vector<uint64_t> &memoryServerIds, uint32_t uid,
+    uint32_t gid) {
+    CIS_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+    if ((regionIds.size() != offsets.size()) ||
+        (regionIds.size() != memoryServerIds.size())) {
+        message << "Number of dataitem regions, offsets and memory servers "
+                   "do not match";
+        THROW_ERRNO_MSG(CIS_Exception, FAM_ERR_INVALID, message.str().c_str());
+    }
+
+    uint64_t metadataServiceId = 0;
+    Fam_Metadata_Service *metadataService =
+        get_metadata_service(metadataServiceId);
+    std::map<uint64_t, std::vector<size_t> > regions;
+    for (size_t i = 0; i < regionIds.size(); i++)
+        regions[regionIds[i]].push_back(i);
+
+    for (auto &region : regions) {
+        uint64_t regionId = region.first;
+        std::vector<uint64_t> dataitemIds;
+        for (auto i : region.second)
+            dataitemIds.push_back(
+                get_dataitem_id(offsets[i], memoryServerIds[i]));
+        std::vector<Fam_DataItem_Metadata> dataitems;
+        metadataService->metadata_validate_and_deallocate_dataitem_batch(
+            regionId, dataitemIds, uid, gid, dataitems);
+
+        std::map<uint64_t, std::vector<uint64_t> > servers;
+        for (size_t j = 0; j < region.second.size(); j++) {
+            size_t i = region.second[j];
+            if (dataitems[j].interleaveSize)
+                deallocate_interleaved(regionId, dataitems[j]);
+            else
+                servers[memoryServerIds[i]].push_back(offsets[i]);
+        }
+        for (auto &server : servers)
+            get_memory_service(server.first)
+                ->deallocate_batch(regionId, server.second);
+    }
+
+    CIS_DIRECT_PROFILE_END_OPS(cis_deallocate_batch);
+}
+
+std::vector<Fam_Region_Item_Info>
+Fam_CIS_Direct::lookup_batch(const std::vector<std::string> &itemNames,
+                             string regionName, uint32_t uid, uint32_t gid) {
+    std::vector<Fam_Region_Item_Info> infos(itemNames.size());
+    CIS_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+
+    uint64_t metadataServiceId = 0;
+    Fam_Metadata_Service *metadataService =
+        get_metadata_service(metadataServiceId);
+    std::vector<Fam_DataItem_Metadata> dataitems;
+    try {
+        metadataService->metadata_find_dataitem_and_check_permissions_batch(
+            META_REGION_ITEM_READ_ALLOW_OWNER, itemNames, regionName, uid, gid,
+            dataitems);
+    }
+    catch (Fam_Exception &e) {
+        if (e.fam_error() == NO_PERMISSION) {
+            message << "Not permitted to access the dataitem";
+            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
+                            message.str().c_str());
+        }
+        throw;
+    }
+
+    for (size_t i = 0; i < itemNames.size(); i++) {
+        infos[i].regionId = dataitems[i].regionId;
+        infos[i].offset = dataitems[i].offset;
+        infos[i].size = dataitems[i].size;
+        infos[i].perm = dataitems[i].perm;
+        strncpy(infos[i].name, dataitems[i].name, metadataMaxKeyLen);
+        infos[i].memoryServerId = dataitems[i].memoryServerId;
+        infos[i].maxNameLen = metadataMaxKeyLen;
+    }
+    CIS_DIRECT_PROFILE_END_OPS(cis_lookup_batch);
+    return infos;
+}
+
 Fam_Region_Item_Info Fam_CIS_Direct::check_permission_get_region_info(
     uint64_t regionId, uint64_t memoryServerId, uint32_t uid, uint32_t gid) {
 
@@ -941,8 +1430,15 @@ Fam_Region_Item_Info Fam_CIS_Direct::check_permission_get_item_info(
         THROW_ERRNO_MSG(CIS_Exception, FAM_ERR_NOPERM, message.str().c_str());
     }
 
-    uint64_t key =
-        memoryService->get_key(regionId, offset, dataitem.size, rwFlag);
+    if (dataitem.interleaveSize) {
+        get_interleave_info(dataitem, rwFlag, NULL, info);
+    } else {
+        info.key =
+            memoryService->get_key(regionId, offset, dataitem.size, rwFlag);
+        info.base = get_local_pointer(regionId, offset, memoryServerId);
+        info.interleaveSize = 0;
+        info.used_memsrv_cnt = 0;
+    }
 
     info.regionId = dataitem.regionId;
     info.offset = dataitem.offset;
@@ -950,8 +1446,6 @@ Fam_Region_Item_Info Fam_CIS_Direct::check_permission_get_item_info(
     info.perm = dataitem.perm;
     strncpy(info.name, dataitem.name, metadataMaxKeyLen);
     info.maxNameLen = metadataMaxKeyLen;
-    info.key = key;
-    info.base = get_local_pointer(regionId, offset, memoryServerId);
     info.memoryServerId = dataitem.memoryServerId;
 
     CIS_DIRECT_PROFILE_END_OPS(cis_check_permission_get_item_info);
@@ -1018,6 +1512,10 @@ void *Fam_CIS_Direct::fam_map(uint64_t regionId, uint64_t offset,
         THROW_ERRNO_MSG(CIS_Exception, DATAITEM_NOT_FOUND,
                         message.str().c_str());
     }
+    if (dataitem.interleaveSize) {
+        THROW_ERRNO_MSG(CIS_Exception, UNIMPLEMENTED,
+                        "fam_map of an interleaved dataitem is not supported");
+    }
     if (check_dataitem_permission(dataitem, 1, metadataServiceId, uid, gid) |
         check_dataitem_permission(dataitem, 0, metadataServiceId, uid, gid)) {
         localPointer = get_local_pointer(regionId, offset, memoryServerId);
@@ -1042,7 +1540,7 @@ void *Fam_CIS_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
                            uint64_t destCopyStart, uint64_t nbytes,
                            uint64_t srcMemoryServerId,
                            uint64_t destMemoryServerId, uint32_t uid,
-                           uint32_t gid) {
+                           uint32_t gid, Fam_Copy_Progress *progress) {
     ostringstream message;
     message << "Error While copying from dataitem : ";
     Fam_DataItem_Metadata srcDataitem;
@@ -1089,6 +1587,11 @@ void *Fam_CIS_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
         throw;
     }
 
+    if (srcDataitem.interleaveSize || destDataitem.interleaveSize) {
+        message << "Copy of interleaved dataitems is not supported";
+        THROW_ERRNO_MSG(CIS_Exception, UNIMPLEMENTED, message.str().c_str());
+    }
+
     if (!((srcCopyStart + nbytes) < srcDataitem.size)) {
         message << "Source offset or size is beyond dataitem boundary";
         THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE, message.str().c_str());
@@ -1099,9 +1602,14 @@ void *Fam_CIS_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
         THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE, message.str().c_str());
     }
 
+    waitObj->copyId = (progress ? progress->copyId : openfam_new_copy_id());
+    waitObj->size = nbytes;
     if (useAsyncCopy) {
         Fam_Copy_Tag *tag = new Fam_Copy_Tag();
         tag->copyDone.store(false, boost::memory_order_seq_cst);
+        tag->progress.bytesCopied.store(0);
+        tag->progress.cancelled.store(false);
+        tag->progress.copyId = waitObj->copyId;
         tag->memoryService = memoryService;
         tag->srcRegionId = srcRegionId;
         tag->srcOffset = (srcOffset + srcCopyStart);
@@ -1114,14 +1622,15 @@ void *Fam_CIS_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
         tag->srcAddrLen = srcAddrLen;
         tag->srcMemserverId = srcMemoryServerId;
         tag->destMemserverId = destMemoryServerId;
-        Fam_Ops_Info opsInfo = { COPY, NULL, NULL, 0, 0, 0, 0, 0, tag };
+        Fam_Ops_Info opsInfo = { COPY, NULL, NULL, 0,    0,   0,
+                                 0,    0,    tag,  NULL, NULL };
         asyncQHandler->initiate_operation(opsInfo);
         waitObj->tag = tag;
     } else {
         memoryService->copy(srcRegionId, (srcOffset + srcCopyStart), srcKey,
                             srcCopyStart, srcAddr, srcAddrLen, destRegionId,
                             (destOffset + destCopyStart), nbytes,
-                            srcMemoryServerId, destMemoryServerId);
+                            srcMemoryServerId, destMemoryServerId, progress);
     }
     CIS_DIRECT_PROFILE_END_OPS(cis_copy);
     return (void *)waitObj;
@@ -1130,10 +1639,45 @@ void *Fam_CIS_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
 void Fam_CIS_Direct::wait_for_copy(void *waitObj) {
     CIS_DIRECT_PROFILE_START_OPS()
     Fam_Copy_Wait_Object *obj = (Fam_Copy_Wait_Object *)waitObj;
-    asyncQHandler->wait_for_copy((void *)(obj->tag));
+    Fam_Copy_Tag *tag = obj->tag;
+    delete obj;
+    // A copy without tag was done synchronously
+    if (tag)
+        asyncQHandler->wait_for_copy((void *)tag);
     CIS_DIRECT_PROFILE_END_OPS(cis_wait_for_copy);
 }
 
+uint64_t Fam_CIS_Direct::copy_progress(void *waitObj) {
+    uint64_t bytesCopied;
+    CIS_DIRECT_PROFILE_START_OPS()
+    Fam_Copy_Wait_Object *obj = (Fam_Copy_Wait_Object *)waitObj;
+    if (obj->tag)
+        bytesCopied = asyncQHandler->copy_progress((void *)(obj->tag));
+    else
+        bytesCopied = obj->size;
+    CIS_DIRECT_PROFILE_END_OPS(cis_copy_progress);
+    return bytesCopied;
+}
+
+void Fam_CIS_Direct::cancel_copy(void *waitObj) {
+    CIS_DIRECT_PROFILE_START_OPS()
+    Fam_Copy_Wait_Object *obj = (Fam_Copy_Wait_Object *)waitObj;
+    if (obj->tag)
+        asyncQHandler->cancel_copy((void *)(obj->tag));
+    CIS_DIRECT_PROFILE_END_OPS(cis_cancel_copy);
+}
+
+uint64_t Fam_CIS_Direct::copy_progress(uint64_t copyId,
+                                       uint64_t memoryServerId) {
+    Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
+    return memoryService->copy_progress(copyId);
+}
+
+void Fam_CIS_Direct::cancel_copy(uint64_t copyId, uint64_t memoryServerId) {
+    Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
+    memoryService->cancel_copy(copyId);
+}
+
 void Fam_CIS_Direct::acquire_CAS_lock(uint64_t offset,
                                       uint64_t memoryServerId) {
     CIS_DIRECT_PROFILE_START_OPS()
@@ -1150,6 +1694,66 @@ void Fam_CIS_Direct::release_CAS_lock(uint64_t offset,
     CIS_DIRECT_PROFILE_END_OPS(cis_release_CAS_lock);
 }
 
+int128_t Fam_CIS_Direct::atomic_int128(uint32_t op, uint64_t regionId,
+                                       uint64_t offset, uint64_t valueOffset,
+                                       int128_t operand, int128_t compare,
+                                       uint64_t memoryServerId, uint32_t uid,
+                                       uint32_t gid) {
+    int128_t old;
+    CIS_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+    uint64_t metadataServiceId = 0;
+    Fam_Metadata_Service *metadataService =
+        get_metadata_service(metadataServiceId);
+    message << "Error While accessing dataitem : ";
+    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
+    Fam_DataItem_Metadata dataitem;
+    try {
+        metadataService->metadata_find_dataitem_and_check_permissions(
+            (op == INT128_ATOMIC_FETCH) ? META_REGION_ITEM_READ
+                                        : META_REGION_ITEM_WRITE,
+            dataitemId, regionId, uid, gid, dataitem);
+    }
+    catch (Fam_Exception &e) {
+        if (e.fam_error() == NO_PERMISSION) {
+            message << "Not permitted to access the dataitem";
+            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
+                            message.str().c_str());
+        }
+        throw;
+    }
+
+    if ((valueOffset > dataitem.size) ||
+        (dataitem.size - valueOffset < sizeof(int128_t))) {
+        message << "Offset is beyond dataitem boundary";
+        THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE, message.str().c_str());
+    }
+
+    // Find the extent holding the value; it must not span two of them.
+    uint64_t extentOffset = valueOffset;
+    uint64_t extentServerId = dataitem.memoryServerId;
+    uint64_t extentBase = dataitem.offset;
+    if (dataitem.interleaveSize) {
+        uint64_t stripeSize = dataitem.interleaveSize;
+        uint64_t cnt = dataitem.used_memsrv_cnt;
+        uint64_t stripe = valueOffset / stripeSize;
+        if (valueOffset % stripeSize + sizeof(int128_t) > stripeSize) {
+            message << "Value spans two interleave stripes";
+            THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE,
+                            message.str().c_str());
+        }
+        extentOffset = (stripe / cnt) * stripeSize + valueOffset % stripeSize;
+        extentServerId = dataitem.memServerIds[stripe % cnt];
+        extentBase = dataitem.offsets[stripe % cnt];
+    }
+
+    Fam_Memory_Service *memoryService = get_memory_service(extentServerId);
+    old = memoryService->atomic_int128(op, regionId, extentBase + extentOffset,
+                                       operand, compare);
+    CIS_DIRECT_PROFILE_END_OPS(cis_atomic_int128);
+    return old;
+}
+
 uint64_t Fam_CIS_Direct::get_dataitem_id(uint64_t offset,
                                          uint64_t memoryServerId) {
     return ((memoryServerId << 32) + offset / MIN_OBJ_SIZE);
@@ -1246,29 +1850,37 @@ configFileParams Fam_CIS_Direct::get_config_info(std::string filename) {
             // If parameter is not present, then set the default.
             options["metadata_list"] = (char *)strdup("0:127.0.0.1:8787");
         }
+
+        try {
+            options["interleave_size"] = (char *)strdup(
+                (info->get_key_value("interleave_size")).c_str());
+        }
+        catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, data items are not interleaved.
+            options["interleave_size"] = (char *)strdup("0");
+        }
     }
     return options;
 }
-int Fam_CIS_Direct::get_atomic(uint64_t regionId, uint64_t srcOffset,
-                               uint64_t dstOffset, uint64_t nbytes,
-                               uint64_t key, const char *nodeAddr,
-                               uint32_t nodeAddrSize, uint64_t memoryServerId,
-                               uint32_t uid, uint32_t gid) {
-    CIS_DIRECT_PROFILE_START_OPS()
+/*
+ * Finds the data item an ATL operation targets and checks that the caller
+ * may access it for op. ATL operations are not supported on interleaved
+ * data items.
+ */
+void Fam_CIS_Direct::find_atl_dataitem(uint64_t regionId, uint64_t offset,
+                                       uint64_t memoryServerId,
+                                       metadata_region_item_op_t op,
+                                       uint32_t uid, uint32_t gid,
+                                       Fam_DataItem_Metadata &dataitem) {
     ostringstream message;
-    uint64_t metadataServiceId = 0;
-
-    Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
     message << "Error While accessing dataitem : ";
+    Fam_Metadata_Service *metadataService = get_metadata_service(0);
     // Check with metadata service if region with the requested Id
     // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(srcOffset, memoryServerId);
-    Fam_DataItem_Metadata dataitem;
+    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
     try {
         metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_READ, dataitemId, regionId, uid, gid, dataitem);
+            op, dataitemId, regionId, uid, gid, dataitem);
     }
     catch (Fam_Exception &e) {
         if (e.fam_error() == NO_PERMISSION) {
@@ -1279,6 +1891,26 @@ int Fam_CIS_Direct::get_atomic(uint64_t regionId, uint64_t srcOffset,
         throw;
     }
 
+    if (dataitem.interleaveSize) {
+        THROW_ERRNO_MSG(CIS_Exception, UNIMPLEMENTED,
+                        "ATL operation on an interleaved dataitem is not "
+                        "supported");
+    }
+}
+
+int Fam_CIS_Direct::get_atomic(uint64_t regionId, uint64_t srcOffset,
+                               uint64_t dstOffset, uint64_t nbytes,
+                               uint64_t key, const char *nodeAddr,
+                               uint32_t nodeAddrSize, uint64_t memoryServerId,
+                               uint32_t uid, uint32_t gid) {
+    CIS_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+    Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
+    message << "Error While accessing dataitem : ";
+    Fam_DataItem_Metadata dataitem;
+    find_atl_dataitem(regionId, srcOffset, memoryServerId,
+                      META_REGION_ITEM_READ, uid, gid, dataitem);
+
     if (!((dstOffset + nbytes) <= dataitem.size)) {
         message << "Source offset or size is beyond dataitem boundary";
         THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE, message.str().c_str());
@@ -1298,28 +1930,11 @@ int Fam_CIS_Direct::put_atomic(uint64_t regionId, uint64_t srcOffset,
                                uint32_t gid) {
     CIS_DIRECT_PROFILE_START_OPS()
     ostringstream message;
-    uint64_t metadataServiceId = 0;
-
     Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
     message << "Error While accessing dataitem : ";
-    // Check with metadata service if region with the requested Id
-    // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(srcOffset, memoryServerId);
     Fam_DataItem_Metadata dataitem;
-    try {
-        metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_WRITE, dataitemId, regionId, uid, gid, dataitem);
-    }
-    catch (Fam_Exception &e) {
-        if (e.fam_error() == NO_PERMISSION) {
-            message << "Not permitted to access the region";
-            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
-                            message.str().c_str());
-        }
-        throw;
-    }
+    find_atl_dataitem(regionId, srcOffset, memoryServerId,
+                      META_REGION_ITEM_WRITE, uid, gid, dataitem);
 
     if (!((dstOffset + nbytes) <= dataitem.size)) {
         message << "Source offset or size is beyond dataitem boundary";
@@ -1338,29 +1953,10 @@ int Fam_CIS_Direct::scatter_strided_atomic(
     uint32_t uid, uint32_t gid) {
 
     CIS_DIRECT_PROFILE_START_OPS()
-    ostringstream message;
-    uint64_t metadataServiceId = 0;
-
     Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
-    message << "Error While accessing dataitem : ";
-    // Check with metadata service if region with the requested Id
-    // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
     Fam_DataItem_Metadata dataitem;
-    try {
-        metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_WRITE, dataitemId, regionId, uid, gid, dataitem);
-    }
-    catch (Fam_Exception &e) {
-        if (e.fam_error() == NO_PERMISSION) {
-            message << "Not permitted to access the region";
-            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
-                            message.str().c_str());
-        }
-        throw;
-    }
+    find_atl_dataitem(regionId, offset, memoryServerId,
+                      META_REGION_ITEM_WRITE, uid, gid, dataitem);
 
     memoryService->scatter_strided_atomic(regionId, offset, nElements,
                                           firstElement, stride, elementSize,
@@ -1376,30 +1972,10 @@ int Fam_CIS_Direct::gather_strided_atomic(
     uint32_t uid, uint32_t gid) {
 
     CIS_DIRECT_PROFILE_START_OPS()
-    ostringstream message;
-    uint64_t metadataServiceId = 0;
-
     Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
-
-    message << "Error While accessing dataitem : ";
-    // Check with metadata service if region with the requested Id
-    // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
     Fam_DataItem_Metadata dataitem;
-    try {
-        metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_WRITE, dataitemId, regionId, uid, gid, dataitem);
-    }
-    catch (Fam_Exception &e) {
-        if (e.fam_error() == NO_PERMISSION) {
-            message << "Not permitted to access the region";
-            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
-                            message.str().c_str());
-        }
-        throw;
-    }
+    find_atl_dataitem(regionId, offset, memoryServerId,
+                      META_REGION_ITEM_WRITE, uid, gid, dataitem);
 
     memoryService->gather_strided_atomic(regionId, offset, nElements,
                                          firstElement, stride, elementSize, key,
@@ -1410,33 +1986,15 @@ int Fam_CIS_Direct::gather_strided_atomic(
 
 int Fam_CIS_Direct::scatter_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
     uint32_t uid, uint32_t gid) {
 
     CIS_DIRECT_PROFILE_START_OPS()
-    ostringstream message;
-    uint64_t metadataServiceId = 0;
     Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
-    message << "Error While accessing dataitem : ";
-    // Check with metadata service if region with the requested Id
-    // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
     Fam_DataItem_Metadata dataitem;
-    try {
-        metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_WRITE, dataitemId, regionId, uid, gid, dataitem);
-    }
-    catch (Fam_Exception &e) {
-        if (e.fam_error() == NO_PERMISSION) {
-            message << "Not permitted to access the region";
-            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
-                            message.str().c_str());
-        }
-        throw;
-    }
+    find_atl_dataitem(regionId, offset, memoryServerId,
+                      META_REGION_ITEM_WRITE, uid, gid, dataitem);
 
     memoryService->scatter_indexed_atomic(regionId, offset, nElements,
                                           elementIndex, elementSize, key,
@@ -1447,33 +2005,15 @@ int Fam_CIS_Direct::scatter_indexed_atomic(
 
 int Fam_CIS_Direct::gather_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize, uint64_t memoryServerId,
     uint32_t uid, uint32_t gid) {
 
     CIS_DIRECT_PROFILE_START_OPS()
-    ostringstream message;
-    uint64_t metadataServiceId = 0;
     Fam_Memory_Service *memoryService = get_memory_service(memoryServerId);
-    Fam_Metadata_Service *metadataService =
-        get_metadata_service(metadataServiceId);
-    message << "Error While accessing dataitem : ";
-    // Check with metadata service if region with the requested Id
-    // is already exist, if not return error
-    uint64_t dataitemId = get_dataitem_id(offset, memoryServerId);
     Fam_DataItem_Metadata dataitem;
-    try {
-        metadataService->metadata_find_dataitem_and_check_permissions(
-            META_REGION_ITEM_WRITE, dataitemId, regionId, uid, gid, dataitem);
-    }
-    catch (Fam_Exception &e) {
-        if (e.fam_error() == NO_PERMISSION) {
-            message << "Not permitted to access the region";
-            THROW_ERRNO_MSG(CIS_Exception, NO_PERMISSION,
-                            message.str().c_str());
-        }
-        throw;
-    }
+    find_atl_dataitem(regionId, offset, memoryServerId,
+                      META_REGION_ITEM_WRITE, uid, gid, dataitem);
 
     memoryService->gather_indexed_atomic(regionId, offset, nElements,
                                          elementIndex, elementSize, key,
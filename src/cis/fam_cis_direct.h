@@ -87,15 +87,27 @@ class Fam_CIS_Direct : public Fam_CIS {
     void change_dataitem_permission(uint64_t regionId, uint64_t offset,
                                     mode_t permission, uint64_t memoryServerId,
                                     uint32_t uid, uint32_t gid);
-    bool check_region_permission(Fam_Region_Metadata region, bool op,
+    bool check_region_permission(const Fam_Region_Metadata &region, bool op,
                                  uint64_t memoryServerId, uint32_t uid,
                                  uint32_t gid);
-    bool check_dataitem_permission(Fam_DataItem_Metadata dataitem, bool op,
-                                   uint64_t memoryServerId, uint32_t uid,
-                                   uint32_t gid);
+    bool check_dataitem_permission(const Fam_DataItem_Metadata &dataitem,
+                                   bool op, uint64_t memoryServerId,
+                                   uint32_t uid, uint32_t gid);
     Fam_Region_Item_Info lookup_region(string name, uint32_t uid, uint32_t gid);
     Fam_Region_Item_Info lookup(string itemName, string regionName,
                                 uint32_t uid, uint32_t gid);
+    std::vector<Fam_Region_Item_Info>
+    allocate_batch(const std::vector<std::string> &names,
+                   const std::vector<size_t> &sizes, mode_t permission,
+                   uint64_t regionId, uint64_t memoryServerId, uint32_t uid,
+                   uint32_t gid);
+    void deallocate_batch(const std::vector<uint64_t> &regionIds,
+                          const std::vector<uint64_t> &offsets,
+                          const std::vector<uint64_t> &memoryServerIds,
+                          uint32_t uid, uint32_t gid);
+    std::vector<Fam_Region_Item_Info>
+    lookup_batch(const std::vector<std::string> &itemNames, string regionName,
+                 uint32_t uid, uint32_t gid);
     Fam_Region_Item_Info
     check_permission_get_region_info(uint64_t regionId, uint64_t memoryServerId,
                                      uint32_t uid, uint32_t gid);
@@ -114,9 +126,16 @@ class Fam_CIS_Direct : public Fam_CIS {
                uint64_t destRegionId, uint64_t destOffset,
                uint64_t destCopyStar, uint64_t nbytes,
                uint64_t srcMemoryServerId, uint64_t destMemoryServerId,
-               uint32_t uid, uint32_t gid);
+               uint32_t uid, uint32_t gid,
+               Fam_Copy_Progress *progress = NULL);
 
     void wait_for_copy(void *waitObj);
+    uint64_t copy_progress(void *waitObj);
+    void cancel_copy(void *waitObj);
+
+    // Progress and cancel of a copy named copyId, for the CIS server
+    uint64_t copy_progress(uint64_t copyId, uint64_t memoryServerId);
+    void cancel_copy(uint64_t copyId, uint64_t memoryServerId);
 
     void *fam_map(uint64_t regionId, uint64_t offset, uint64_t memoryServerId,
                   uint32_t uid, uint32_t gid);
@@ -125,6 +144,10 @@ class Fam_CIS_Direct : public Fam_CIS {
 
     void acquire_CAS_lock(uint64_t offset, uint64_t memoryServerId);
     void release_CAS_lock(uint64_t offset, uint64_t memoryServerId);
+    int128_t atomic_int128(uint32_t op, uint64_t regionId, uint64_t offset,
+                           uint64_t valueOffset, int128_t operand,
+                           int128_t compare, uint64_t memoryServerId,
+                           uint32_t uid, uint32_t gid);
     uint64_t get_dataitem_id(uint64_t offset, uint64_t memoryServerId);
     size_t get_addr_size(uint64_t memoryServerId);
     void get_addr(void *memServerFabricAddr, uint64_t memoryServerId);
@@ -161,14 +184,14 @@ class Fam_CIS_Direct : public Fam_CIS {
                               uint32_t uid, uint32_t gid);
 
     int scatter_indexed_atomic(uint64_t regionId, uint64_t offset,
-                               uint64_t nElements, const void *elementIndex,
+                               uint64_t nElements, const uint64_t *elementIndex,
                                uint64_t elementSize, uint64_t key,
                                const char *nodeAddr, uint32_t nodeAddrSize,
                                uint64_t memoryServerId, uint32_t uid,
                                uint32_t gid);
 
     int gather_indexed_atomic(uint64_t regionId, uint64_t offset,
-                              uint64_t nElements, const void *elementIndex,
+                              uint64_t nElements, const uint64_t *elementIndex,
                               uint64_t elementSize, uint64_t key,
                               const char *nodeAddr, uint32_t nodeAddrSize,
                               uint64_t memoryServerId, uint32_t uid,
@@ -185,8 +208,31 @@ class Fam_CIS_Direct : public Fam_CIS {
     void *memServerInfoBuffer;
     bool useAsyncCopy;
     size_t metadataMaxKeyLen;
+    // Stripe size of interleaved data items; 0 disables interleaving
+    uint64_t interleaveSize;
     void *get_local_pointer(uint64_t regionId, uint64_t offset,
                             uint64_t memoryServerId);
+    std::vector<uint64_t>
+    get_interleave_memory_servers(Fam_Metadata_Service *metadataService,
+                                  uint64_t regionId, uint64_t firstId,
+                                  size_t nbytes);
+    void allocate_interleaved(uint64_t regionId, size_t nbytes,
+                              std::vector<uint64_t> &interleaveList,
+                              Fam_DataItem_Metadata &dataitem,
+                              uint64_t *bases);
+    void deallocate_interleaved(uint64_t regionId,
+                                Fam_DataItem_Metadata &dataitem);
+    void get_interleave_info(Fam_DataItem_Metadata &dataitem, bool rwFlag,
+                             uint64_t *bases, Fam_Region_Item_Info &info);
+    void find_atl_dataitem(uint64_t regionId, uint64_t offset,
+                           uint64_t memoryServerId,
+                           metadata_region_item_op_t op, uint32_t uid,
+                           uint32_t gid, Fam_DataItem_Metadata &dataitem);
+    uint64_t
+    allocate_on_memory_server(Fam_Metadata_Service *metadataService,
+                              uint64_t regionId, uint64_t id,
+                              const std::vector<size_t> &sizes, bool rwFlag,
+                              std::vector<Fam_Region_Item_Info> &infos);
 
     uint64_t generate_memory_server_id(const char *name) {
         std::uint64_t hashVal = std::hash<std::string> {}
@@ -74,6 +74,19 @@ void cis_server_profile_dump() {
     MEMSERVER_DUMP_PROFILE_SUMMARY(CIS_SERVER)
 }
 
+/*
+ * Copy the stripe layout of an interleaved dataitem to the response message.
+ */
+static void set_interleave_info(::Fam_Dataitem_Response *response,
+                                Fam_Region_Item_Info &info) {
+    response->set_interleave_size(info.interleaveSize);
+    for (uint64_t i = 0; i < info.used_memsrv_cnt; i++) {
+        response->add_memsrv_list(info.memServerIds[i]);
+        response->add_key_list(info.keys[i]);
+        response->add_base_list(info.bases[i]);
+    }
+}
+
 void Fam_CIS_Server::cis_server_initialize(Fam_CIS_Direct *__famCIS) {
     ostringstream message;
     message << "Error while initializing RPC service : ";
@@ -231,6 +244,7 @@ Fam_CIS_Server::resize_region(::grpc::ServerContext *context,
     response->set_offset(info.offset);
     response->set_base((uint64_t)info.base);
     response->set_memserver_id(info.memoryServerId);
+    set_interleave_info(response, info);
     CIS_SERVER_PROFILE_END_OPS(allocate);
 
     // Return status OK
@@ -357,6 +371,105 @@ Fam_CIS_Server::lookup_region(::grpc::ServerContext *context,
     return ::grpc::Status::OK;
 }
 
+::grpc::Status
+Fam_CIS_Server::allocate_batch(::grpc::ServerContext *context,
+                               const ::Fam_Dataitem_Batch_Request *request,
+                               ::Fam_Dataitem_Batch_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    std::vector<std::string> names;
+    std::vector<size_t> sizes;
+    std::vector<Fam_Region_Item_Info> infos;
+    for (auto &item : request->items()) {
+        names.push_back(item.name());
+        sizes.push_back((size_t)item.size());
+    }
+    try {
+        infos = famCIS->allocate_batch(names, sizes, (mode_t)request->perm(),
+                                       request->regionid(),
+                                       request->memserver_id(), request->uid(),
+                                       request->gid());
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    for (auto &info : infos) {
+        ::Fam_Dataitem_Response *item = response->add_items();
+        item->set_key(info.key);
+        item->set_regionid(request->regionid());
+        item->set_offset(info.offset);
+        item->set_base((uint64_t)info.base);
+        item->set_memserver_id(info.memoryServerId);
+        set_interleave_info(item, info);
+    }
+    CIS_SERVER_PROFILE_END_OPS(allocate_batch);
+
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_CIS_Server::deallocate_batch(::grpc::ServerContext *context,
+                                 const ::Fam_Dataitem_Batch_Request *request,
+                                 ::Fam_Dataitem_Batch_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    std::vector<uint64_t> regionIds, offsets, memoryServerIds;
+    for (auto &item : request->items()) {
+        regionIds.push_back(item.regionid());
+        offsets.push_back(item.offset());
+        memoryServerIds.push_back(item.memserver_id());
+    }
+    try {
+        famCIS->deallocate_batch(regionIds, offsets, memoryServerIds,
+                                 request->uid(), request->gid());
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    CIS_SERVER_PROFILE_END_OPS(deallocate_batch);
+
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_CIS_Server::lookup_batch(::grpc::ServerContext *context,
+                             const ::Fam_Dataitem_Batch_Request *request,
+                             ::Fam_Dataitem_Batch_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    std::vector<std::string> itemNames;
+    std::vector<Fam_Region_Item_Info> infos;
+    for (auto &item : request->items())
+        itemNames.push_back(item.name());
+    try {
+        infos = famCIS->lookup_batch(itemNames, request->regionname(),
+                                     request->uid(), request->gid());
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    for (auto &info : infos) {
+        ::Fam_Dataitem_Response *item = response->add_items();
+        item->set_memserver_id(info.memoryServerId);
+        item->set_regionid(info.regionId);
+        item->set_offset(info.offset);
+        item->set_size(info.size);
+        item->set_perm(info.perm);
+        item->set_name(info.name);
+        item->set_maxnamelen(info.maxNameLen);
+    }
+    CIS_SERVER_PROFILE_END_OPS(lookup_batch);
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status Fam_CIS_Server::check_permission_get_region_info(
     ::grpc::ServerContext *context, const ::Fam_Region_Request *request,
     ::Fam_Region_Response *response) {
@@ -407,6 +520,7 @@ Fam_CIS_Server::lookup_region(::grpc::ServerContext *context,
     response->set_name(info.name);
     response->set_maxnamelen(info.maxNameLen);
     response->set_base((uint64_t)info.base);
+    set_interleave_info(response, info);
 
     CIS_SERVER_PROFILE_END_OPS(check_permission_get_item_info);
 
@@ -446,6 +560,68 @@ Fam_CIS_Server::get_stat_info(::grpc::ServerContext *context,
 ::grpc::Status Fam_CIS_Server::copy(::grpc::ServerContext *context,
                                     const ::Fam_Copy_Request *request,
                                     ::Fam_Copy_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    // The copy is named with the id chosen by the client, which it uses to
+    // follow and cancel the copy on the memory server.
+    Fam_Copy_Progress progress;
+    progress.bytesCopied.store(0);
+    progress.cancelled.store(false);
+    progress.copyId = request->copyid();
+    // copy the data from source dataitem to target dataitem
+    try {
+        void *waitObj = famCIS->copy(
+            request->srcregionid(), request->srcoffset(),
+            request->srccopystart(), request->srckey(),
+            request->srcaddr().c_str(), request->srcaddrlen(),
+            request->destregionid(), request->destoffset(),
+            request->destcopystart(), request->copysize(),
+            request->src_memserver_id(), request->dest_memserver_id(),
+            request->uid(), request->gid(), &progress);
+        delete (Fam_Copy_Wait_Object *)waitObj;
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        response->set_bytescopied(progress.bytesCopied.load());
+        return ::grpc::Status::OK;
+    }
+    response->set_bytescopied(progress.bytesCopied.load());
+    CIS_SERVER_PROFILE_END_OPS(copy);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_CIS_Server::copy_progress(::grpc::ServerContext *context,
+                              const ::Fam_Copy_Control_Request *request,
+                              ::Fam_Copy_Control_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    try {
+        response->set_bytescopied(famCIS->copy_progress(
+            request->copyid(), request->memserver_id()));
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    CIS_SERVER_PROFILE_END_OPS(copy_progress);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_CIS_Server::cancel_copy(::grpc::ServerContext *context,
+                            const ::Fam_Copy_Control_Request *request,
+                            ::Fam_Copy_Control_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    try {
+        famCIS->cancel_copy(request->copyid(), request->memserver_id());
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    CIS_SERVER_PROFILE_END_OPS(cancel_copy);
     return ::grpc::Status::OK;
 }
 
@@ -485,6 +661,33 @@ Fam_CIS_Server::release_CAS_lock(::grpc::ServerContext *context,
     return ::grpc::Status::OK;
 }
 
+::grpc::Status
+Fam_CIS_Server::atomic_int128(::grpc::ServerContext *context,
+                              const ::Fam_Int128_Atomic_Request *request,
+                              ::Fam_Int128_Atomic_Response *response) {
+    CIS_SERVER_PROFILE_START_OPS()
+    uint64_t lo = 0, hi = 0;
+    try {
+        int128_t old = famCIS->atomic_int128(
+            request->op(), request->regionid(), request->offset(),
+            request->valueoffset(),
+            words_to_int128(request->operand_lo(), request->operand_hi()),
+            words_to_int128(request->compare_lo(), request->compare_hi()),
+            request->memserver_id(), request->uid(), request->gid());
+        int128_to_words(old, &lo, &hi);
+    }
+    catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    response->set_result_lo(lo);
+    response->set_result_hi(hi);
+    CIS_SERVER_PROFILE_END_OPS(atomic_int128);
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status
 Fam_CIS_Server::get_addr_size(::grpc::ServerContext *context,
                               const ::Fam_Address_Request *request,
@@ -702,9 +905,15 @@ Fam_CIS_Server::put_atomic(::grpc::ServerContext *context,
     CIS_SERVER_PROFILE_START_OPS()
     ostringstream message;
     try {
+        std::vector<uint64_t> elementIndex;
+        if (!decode_index_array(request->elementindex(),
+                                request->indexencoding(), request->nelements(),
+                                &elementIndex))
+            THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE,
+                            "Invalid element index array");
         famCIS->scatter_indexed_atomic(
             request->regionid(), request->offset(), request->nelements(),
-            request->elementindex().c_str(), request->elementsize(),
+            elementIndex.data(), request->elementsize(),
             request->key(), request->nodeaddr().c_str(),
             request->nodeaddrsize(), request->memserver_id(), request->uid(),
             request->gid());
@@ -728,9 +937,15 @@ Fam_CIS_Server::put_atomic(::grpc::ServerContext *context,
     CIS_SERVER_PROFILE_START_OPS()
     ostringstream message;
     try {
+        std::vector<uint64_t> elementIndex;
+        if (!decode_index_array(request->elementindex(),
+                                request->indexencoding(), request->nelements(),
+                                &elementIndex))
+            THROW_ERRNO_MSG(CIS_Exception, OUT_OF_RANGE,
+                            "Invalid element index array");
         famCIS->gather_indexed_atomic(
             request->regionid(), request->offset(), request->nelements(),
-            request->elementindex().c_str(), request->elementsize(),
+            elementIndex.data(), request->elementsize(),
             request->key(), request->nodeaddr().c_str(),
             request->nodeaddrsize(), request->memserver_id(), request->uid(),
             request->gid());
@@ -67,7 +67,7 @@ using grpc::ServerCompletionQueue;
 using grpc::ServerContext;
 using grpc::Status;
 
-class Fam_CIS_Server : public Fam_CIS_Rpc::Service {
+class Fam_CIS_Server : public Fam_CIS_Rpc::AsyncService {
   public:
     Fam_CIS_Server() {}
 
@@ -132,6 +132,21 @@ class Fam_CIS_Server : public Fam_CIS_Rpc::Service {
                           const ::Fam_Dataitem_Request *request,
                           ::Fam_Dataitem_Response *response) override;
 
+    ::grpc::Status
+    allocate_batch(::grpc::ServerContext *context,
+                   const ::Fam_Dataitem_Batch_Request *request,
+                   ::Fam_Dataitem_Batch_Response *response) override;
+
+    ::grpc::Status
+    deallocate_batch(::grpc::ServerContext *context,
+                     const ::Fam_Dataitem_Batch_Request *request,
+                     ::Fam_Dataitem_Batch_Response *response) override;
+
+    ::grpc::Status
+    lookup_batch(::grpc::ServerContext *context,
+                 const ::Fam_Dataitem_Batch_Request *request,
+                 ::Fam_Dataitem_Batch_Response *response) override;
+
     ::grpc::Status
     check_permission_get_region_info(::grpc::ServerContext *context,
                                      const ::Fam_Region_Request *request,
@@ -150,6 +165,15 @@ class Fam_CIS_Server : public Fam_CIS_Rpc::Service {
                         const ::Fam_Copy_Request *request,
                         ::Fam_Copy_Response *response) override;
 
+    ::grpc::Status
+    copy_progress(::grpc::ServerContext *context,
+                  const ::Fam_Copy_Control_Request *request,
+                  ::Fam_Copy_Control_Response *response) override;
+
+    ::grpc::Status cancel_copy(::grpc::ServerContext *context,
+                               const ::Fam_Copy_Control_Request *request,
+                               ::Fam_Copy_Control_Response *response) override;
+
     ::grpc::Status acquire_CAS_lock(::grpc::ServerContext *context,
                                     const ::Fam_Dataitem_Request *request,
                                     ::Fam_Dataitem_Response *response) override;
@@ -158,6 +182,11 @@ class Fam_CIS_Server : public Fam_CIS_Rpc::Service {
                                     const ::Fam_Dataitem_Request *request,
                                     ::Fam_Dataitem_Response *response) override;
 
+    ::grpc::Status
+    atomic_int128(::grpc::ServerContext *context,
+                  const ::Fam_Int128_Atomic_Request *request,
+                  ::Fam_Int128_Atomic_Response *response) override;
+
     ::grpc::Status get_addr_size(grpc::ServerContext *context,
                                  const Fam_Address_Request *request,
                                  Fam_Address_Response *response) override;
@@ -32,10 +32,12 @@
 #include "fam_libfabric.h"
 #include <allocator/memserver_allocator.h>
 #include <atomic>
+#include <cstddef>
 #include <fam/fam.h>
 #include <fam/fam_exception.h>
 #include <map>
 #include <pthread.h>
+#include <thread>
 #include <time.h>
 using namespace std;
 namespace openfam {
@@ -43,223 +45,477 @@ namespace openfam {
 int numAtomicThreads;
 uint64_t memoryPerThread;
 int queueCapacity;
+uint64_t slotPayloadSize;
 Fam_Ops_Libfabric *famOpsLibfabricQ;
 atomicQueue atomicQ[MAX_ATOMIC_THREADS];
 tInfo atomicTInfo[MAX_ATOMIC_THREADS];
 pthread_mutex_t mutex[MAX_ATOMIC_THREADS] = {PTHREAD_MUTEX_INITIALIZER};
 pthread_cond_t empty[MAX_ATOMIC_THREADS] = {PTHREAD_COND_INITIALIZER};
-pthread_mutex_t pushQmutex[MAX_ATOMIC_THREADS] = {PTHREAD_MUTEX_INITIALIZER};
+// Processing threads parked on empty[qId]; push signals only if there is one
+std::atomic<int> numSleepers[MAX_ATOMIC_THREADS];
 pthread_t atid[MAX_ATOMIC_THREADS];
 void *atomicRegionIdRoot;
 std::map<fi_addr_t, fi_addr_t> fiAddrMap;
 pthread_rwlock_t fiAddrLock;
 
-/* Create the queues, called by the memory server */
-int atomicQueue::create(Memserver_Allocator *in_allocator,
-                        const uint32_t in_qid) {
-    void *localPointerQ;
-    uint64_t offsetQ, offsetArray, offsetM, offsetA;
-    bool qExists = true;
-    assert(in_allocator != NULL);
-    allocator = in_allocator;
-    qId = in_qid;
-
-    // find/create the queue data item
-    if (*((uint64_t *)atomicRegionIdRoot + qId) == 0) {
-        // Queue doesn't exist; allocate and update the offset
+/*
+ * Allocate and initialize the ring of the queue : its header, the array of
+ * slots and the slab. A quarter of the ATL data memory of the queue is kept
+ * for the slab; the queue works without one if it can't be allocated.
+ */
+int atomicQueue::create_ring(uint64_t *offsetQ) {
+    struct qRing lcRing;
+    memset(&lcRing, 0, sizeof(lcRing));
+    lcRing.magic = ATL_RING_MAGIC;
+    lcRing.capacity = queueCapacity;
+    lcRing.payloadSize = (uint32_t)slotPayloadSize;
+    lcRing.slotSize = (sizeof(atomicSlot) + slotPayloadSize + ATL_CACHE_LINE -
+                       1) & ~((uint64_t)ATL_CACHE_LINE - 1);
+    lcRing.slabChunkSize = ATL_SLAB_CHUNK_SIZE;
+    try {
+        *offsetQ = allocator->allocate(ATOMIC_REGION_ID, sizeof(qRing));
+        lcRing.offsetSlots = allocator->allocate(
+            ATOMIC_REGION_ID, lcRing.slotSize * lcRing.capacity);
+    } catch (...) {
+        return ALLOCATEERROR;
+    }
+    uint64_t slabChunks = memoryPerThread / 4 / ATL_SLAB_CHUNK_SIZE;
+    if (slabChunks) {
         try {
-            offsetQ = allocator->allocate(ATOMIC_REGION_ID, sizeof(qData));
+            lcRing.offsetSlab = allocator->allocate(
+                ATOMIC_REGION_ID, slabChunks * ATL_SLAB_CHUNK_SIZE);
+            lcRing.slabChunks = slabChunks;
         } catch (...) {
-            return ALLOCATEERROR;
+            std::cout << "No slab for queue " << qId << std::endl;
         }
-        *((uint64_t *)atomicRegionIdRoot + qId) = offsetQ;
-        qExists = false;
-    } else
-        offsetQ = *((uint64_t *)atomicRegionIdRoot + qId);
+    }
     try {
-        localPointerQ = allocator->get_local_pointer(ATOMIC_REGION_ID, offsetQ);
+        // A slot with a zero sequence number holds no message
+        void *localPointerS =
+            allocator->get_local_pointer(ATOMIC_REGION_ID, lcRing.offsetSlots);
+        memset(localPointerS, 0, lcRing.slotSize * lcRing.capacity);
+        openfam_persist(localPointerS, lcRing.slotSize * lcRing.capacity);
+        ring = (struct qRing *)allocator->get_local_pointer(ATOMIC_REGION_ID,
+                                                            *offsetQ);
+        memcpy(ring, &lcRing, sizeof(lcRing));
+        openfam_persist(ring, sizeof(qRing));
     } catch (...) {
         return MAPERROR;
     }
-    if (!qExists)
-        memset(localPointerQ, 0, sizeof(qData));
-    offsetArray = sizeof(struct qData) - sizeof(uint64_t);
-    // if Array and request records doesn't exists create
-    if (*(uint64_t *)((char *)localPointerQ + offsetArray) == 0) {
-        struct qData lcqData;
-        // create the _Array data item to hold the offsets for queued messages
-        try {
-            offsetA = allocator->allocate(ATOMIC_REGION_ID,
-                                          sizeof(uint64_t) * queueCapacity);
-        } catch (...) {
-            return ALLOCATEERROR;
+    return 0;
+}
+
+/*
+ * Apply the writes and scatters in progress in a queue of the layout before
+ * the ring, as its recovery did, so that no acknowledged write is lost when
+ * the queue is replaced. The other requests are dropped; their clients do
+ * not wait for them across a restart. The payloads the requests still hold
+ * are added to payloads.
+ */
+int atomicQueue::recover_legacy(struct qDataV1 *legacy,
+                                std::vector<uint64_t> *payloads) {
+    if ((legacy->capacity == 0) || (legacy->size > legacy->capacity) ||
+        (legacy->front < 0) || (legacy->front >= legacy->capacity))
+        return MAPERROR;
+    try {
+        uint64_t *offsets = (uint64_t *)allocator->get_local_pointer(
+            ATOMIC_REGION_ID, legacy->offsetArray);
+        for (uint32_t i = 0; i < legacy->size; i++) {
+            atomicMsg *msgPointer = (atomicMsg *)allocator->get_local_pointer(
+                ATOMIC_REGION_ID,
+                offsets[(legacy->front + i) % legacy->capacity]);
+            uint64_t function = msgPointer->flag & 0x3F;
+            bool isWrite = (function == ATOMIC_WRITE) ||
+                           (function == ATOMIC_SCATTER_INDEX) ||
+                           (function == ATOMIC_SCATTER_STRIDE);
+            bool inProgress =
+                isWrite && (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS);
+            bool pending = !(msgPointer->flag & ATOMIC_WRITE_COMPLETED);
+
+            // The buffer is flagged once read from the client, except the
+            // eager data which is kept from the push. The index list of a
+            // scatter is kept from the push until its buffer is released.
+            bool buffer = inProgress ||
+                          (msgPointer->flag & ATOMIC_BUFFER_ALLOCATED) ||
+                          (pending && (function == ATOMIC_WRITE) &&
+                           (msgPointer->flag & ATOMIC_CONTAIN_DATA));
+            bool index = (function == ATOMIC_SCATTER_INDEX) &&
+                         (buffer || pending);
+            if (buffer)
+                payloads->push_back(msgPointer->offsetBuffer);
+            if (index)
+                payloads->push_back(msgPointer->offsetIndex);
+            if (!inProgress)
+                continue;
+
+            // Write was incomplete; copy the buffer to the target data item
+            char *localPointerB = (char *)allocator->get_local_pointer(
+                ATOMIC_REGION_ID, msgPointer->offsetBuffer);
+            char *localPointerD = (char *)allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset);
+            if (function == ATOMIC_WRITE) {
+                memcpy(localPointerD + msgPointer->offset, localPointerB,
+                       msgPointer->size);
+                openfam_persist(localPointerD + msgPointer->offset,
+                                msgPointer->size);
+            } else {
+                std::vector<uint64_t> indexArr;
+                uint64_t nElements, elementSize;
+                if (function == ATOMIC_SCATTER_INDEX) {
+                    char *indexStr = (char *)allocator->get_local_pointer(
+                        ATOMIC_REGION_ID, msgPointer->offsetIndex);
+                    nElements = msgPointer->inElements;
+                    elementSize = msgPointer->ielementSize;
+                    while (indexArr.size() < nElements) {
+                        char *end;
+                        indexArr.push_back(strtoull(indexStr, &end, 10));
+                        if (*end != ',')
+                            break;
+                        indexStr = end + 1;
+                    }
+                    if (indexArr.size() < nElements)
+                        return MAPERROR;
+                } else {
+                    nElements = msgPointer->snElements;
+                    elementSize = msgPointer->selementSize;
+                }
+                for (uint64_t numElements = 0; numElements < nElements;
+                     ++numElements) {
+                    uint64_t destIndex =
+                        (indexArr.empty()
+                             ? msgPointer->firstElement +
+                                   msgPointer->stride * numElements
+                             : indexArr[numElements]) *
+                        elementSize;
+                    memcpy(localPointerD + destIndex,
+                           localPointerB + numElements * elementSize,
+                           elementSize);
+                    openfam_persist(localPointerD + destIndex, elementSize);
+                }
+            }
+            msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
+            msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
+            openfam_persist(msgPointer, sizeof(msgPointer->flag));
         }
-        // queue created. Update the queue information
-        lcqData.front = lcqData.rear = 0; // lcqData.size = 0;
-        lcqData.size = 0;
-        lcqData.capacity = queueCapacity;
-        lcqData.offsetArray = offsetA;
-        memcpy(localPointerQ, &lcqData, sizeof(lcqData));
+    } catch (...) {
+        return MAPERROR;
+    }
+    return 0;
+}
+
+/*
+ * Free the allocations of a queue of the layout before the ring, once the
+ * ring replacing it is in the root : the payloads of its requests, the
+ * messages, the array of their offsets and the header. A crash in between
+ * leaks them rather than freeing them twice.
+ */
+void atomicQueue::free_legacy(uint64_t offsetQ, struct qDataV1 *legacy,
+                              const std::vector<uint64_t> &payloads) {
+    try {
+        for (auto offset : payloads)
+            allocator->deallocate(ATOMIC_REGION_ID, offset);
+        uint64_t *offsets = (uint64_t *)allocator->get_local_pointer(
+            ATOMIC_REGION_ID, legacy->offsetArray);
+        for (uint32_t i = 0; i < legacy->capacity; i++) {
+            if (offsets[i])
+                allocator->deallocate(ATOMIC_REGION_ID, offsets[i]);
+        }
+        allocator->deallocate(ATOMIC_REGION_ID, legacy->offsetArray);
+        allocator->deallocate(ATOMIC_REGION_ID, offsetQ);
+    } catch (...) {
+        std::cout << "queue " << qId << " : could not free the queue of the "
+                  << "old layout" << std::endl;
+    }
+}
+
+/* Create the queues, called by the memory server */
+int atomicQueue::create(Memserver_Allocator *in_allocator,
+                        const uint32_t in_qid) {
+    uint64_t offsetQ;
+    assert(in_allocator != NULL);
+    allocator = in_allocator;
+    qId = in_qid;
+    ring = NULL;
+    struct qDataV1 *legacy = NULL;
+    uint64_t legacyOffset = 0;
+    std::vector<uint64_t> legacyPayloads;
+
+    // find/create the ring of the queue
+    uint64_t *rootEntry = (uint64_t *)atomicRegionIdRoot + qId;
+    if (*rootEntry != 0) {
         try {
-            pointerA = allocator->get_local_pointer(ATOMIC_REGION_ID, offsetA);
+            ring = (struct qRing *)allocator->get_local_pointer(
+                ATOMIC_REGION_ID, *rootEntry);
         } catch (...) {
             return MAPERROR;
         }
-        uint32_t msgInd;
-        // Allocate FAM data items for incoming requests and update in Array
-        for (msgInd = 0; msgInd < lcqData.capacity; msgInd++) {
-            try {
-                offsetM =
-                    allocator->allocate(ATOMIC_REGION_ID, sizeof(atomicMsg));
-            } catch (...) {
-                return ALLOCATEERROR;
+        if (ring->magic != ATL_RING_MAGIC) {
+            // Queue of the layout before the ring; recover it before it is
+            // replaced, and keep it if that fails
+            legacy = (struct qDataV1 *)ring;
+            legacyOffset = *rootEntry;
+            ring = NULL;
+            int ret = recover_legacy(legacy, &legacyPayloads);
+            if (ret) {
+                std::cout << "queue " << qId << " : recovery of the old "
+                          << "layout failed" << std::endl;
+                return ret;
             }
-            *((uint64_t *)pointerA + msgInd) = offsetM;
+            std::cout << "queue " << qId << " recovered, replacing it by "
+                      << "a ring" << std::endl;
         }
     }
-    pointerQ = localPointerQ;
-    struct qData *lcqData = (struct qData *)pointerQ;
-    if (qExists)
+    if (ring == NULL) {
+        int ret = create_ring(&offsetQ);
+        if (ret)
+            return ret;
+        *rootEntry = offsetQ;
         try {
-            pointerA = allocator->get_local_pointer(ATOMIC_REGION_ID,
-                                                    lcqData->offsetArray);
+            openfam_persist(rootEntry, sizeof(uint64_t));
         } catch (...) {
-            return MAPERROR;
+            return PERSISTERROR;
         }
-
-    std::cout << "queue creation successfull " << qId << std::endl;
-    std::cout << "queue front " << lcqData->front << std::endl;
-    std::cout << "queue rear " << lcqData->rear << std::endl;
-    std::cout << "queue capacity " << lcqData->capacity << std::endl;
-    std::cout << "queue size " << lcqData->size;
-
+    }
+    if (legacy)
+        free_legacy(legacyOffset, legacy, legacyPayloads);
     try {
-        openfam_persist(pointerQ, sizeof(qData));
-        openfam_persist(pointerA, sizeof(uint64_t) * queueCapacity);
+        slots = (char *)allocator->get_local_pointer(ATOMIC_REGION_ID,
+                                                     ring->offsetSlots);
     } catch (...) {
-        return PERSISTERROR;
+        return MAPERROR;
     }
 
+    // The queue ends at the first slot which doesn't hold the next message
+    uint64_t n = ring->head;
+    while ((n - ring->head < ring->capacity) &&
+           (get_slot(n)->seq == n + 1))
+        n++;
+    head = ring->head;
+    tail = n;
+    pthread_mutex_init(&slabLock, NULL);
+    init_slab();
+
+    std::cout << "queue creation successfull " << qId << std::endl;
+    std::cout << "queue head " << head << std::endl;
+    std::cout << "queue tail " << tail << std::endl;
+    std::cout << "queue capacity " << ring->capacity << std::endl;
+    std::cout << "queue slot payload " << ring->payloadSize << std::endl;
+
     return 0;
 }
 
+atomicSlot *atomicQueue::get_slot(uint64_t n) {
+    return (atomicSlot *)(slots + (n % ring->capacity) * ring->slotSize);
+}
+
+/*
+ * Build the list of free chunks of the slab, leaving out those which hold
+ * payloads of the messages in the queue.
+ */
+void atomicQueue::init_slab() {
+    chunkUsed.assign(ring->slabChunks, false);
+    uint64_t slabEnd =
+        ring->offsetSlab + ring->slabChunks * ring->slabChunkSize;
+    for (uint64_t n = head; n < tail; n++) {
+        atomicMsg *msgPointer = &get_slot(n)->msg;
+        uint64_t offsets[2] = {0, 0};
+        if (msgPointer->flag & ATOMIC_BUFFER_ALLOCATED)
+            offsets[0] = msgPointer->offsetBuffer;
+        if (msgPointer->flag & ATOMIC_INDEX_ALLOCATED)
+            offsets[1] = msgPointer->offsetIndex;
+        for (int i = 0; i < 2; i++) {
+            if (ring->slabChunks && (offsets[i] >= ring->offsetSlab) &&
+                (offsets[i] < slabEnd))
+                chunkUsed[(offsets[i] - ring->offsetSlab) /
+                          ring->slabChunkSize] = true;
+        }
+    }
+    freeChunks.clear();
+    for (uint64_t chunk = ring->slabChunks; chunk > 0; chunk--) {
+        if (!chunkUsed[chunk - 1])
+            freeChunks.push_back(chunk - 1);
+    }
+}
+
+/*
+ * Allocate size bytes for a payload of msgPointer : in its slot if there
+ * is room, else from the slab if it fits in a chunk, else from the heap.
+ * @return - offset of the payload in ATOMIC_REGION
+ */
+uint64_t atomicQueue::alloc_payload(atomicMsg *msgPointer, uint64_t size) {
+    atomicSlot *slot = (atomicSlot *)msgPointer;
+    uint64_t used = slot->payloadUsed;
+    if (size <= ring->payloadSize - used) {
+        slot->payloadUsed = used + ((size + 7) & ~7ULL);
+        return ring->offsetSlots + ((char *)slot - slots) + sizeof(atomicSlot) +
+               used;
+    }
+    if (size <= ring->slabChunkSize) {
+        uint64_t chunk = ring->slabChunks;
+        pthread_mutex_lock(&slabLock);
+        if (!freeChunks.empty()) {
+            chunk = freeChunks.back();
+            freeChunks.pop_back();
+            chunkUsed[chunk] = true;
+        }
+        pthread_mutex_unlock(&slabLock);
+        if (chunk < ring->slabChunks)
+            return ring->offsetSlab + chunk * ring->slabChunkSize;
+    }
+    return allocator->allocate(ATOMIC_REGION_ID, size);
+}
+
+// Free a payload allocated by alloc_payload
+void atomicQueue::free_payload(uint64_t offset) {
+    if ((offset >= ring->offsetSlots) &&
+        (offset < ring->offsetSlots + ring->capacity * ring->slotSize))
+        return;
+    if (ring->slabChunks && (offset >= ring->offsetSlab) &&
+        (offset <
+         ring->offsetSlab + ring->slabChunks * ring->slabChunkSize)) {
+        uint64_t chunk = (offset - ring->offsetSlab) / ring->slabChunkSize;
+        pthread_mutex_lock(&slabLock);
+        if (chunkUsed[chunk]) {
+            chunkUsed[chunk] = false;
+            freeChunks.push_back(chunk);
+        }
+        pthread_mutex_unlock(&slabLock);
+        return;
+    }
+    allocator->deallocate(ATOMIC_REGION_ID, offset);
+}
+
+/*
+ * Free the payloads of msgPointer still allocated. The flags are cleared
+ * first, so that a crash in between leaks the payloads rather than freeing
+ * them twice.
+ */
+void atomicQueue::release_payloads(atomicMsg *msgPointer) {
+    short int allocated = msgPointer->flag & (ATOMIC_BUFFER_ALLOCATED |
+                                              ATOMIC_INDEX_ALLOCATED);
+    if (!allocated)
+        return;
+    msgPointer->flag &= ~allocated;
+    openfam_persist(msgPointer, sizeof(msgPointer->flag));
+    if (allocated & ATOMIC_BUFFER_ALLOCATED)
+        free_payload(msgPointer->offsetBuffer);
+    if (allocated & ATOMIC_INDEX_ALLOCATED)
+        free_payload(msgPointer->offsetIndex);
+}
+
 /* Push element into the queue
- * get the rear pointer and populate the input message
- * In case of queue full throw exception
- * For scatter, gather and when rpc message contains data
- * allocate memory for the specified size
+ * reserve the slot at the tail and populate the input message
+ * In case of queue full return ATL_QUEUE_FULL
+ * When rpc message contains data and for indexed scatter/gather
+ * allocate payload for the specified size
  * @param inpMsg - struct atomicMsg
  * @param inpDataSG - void * (For eager mode it will point to data and for
- * indexed version of scatter/gather it will point to indexes, For others it
+ * indexed version of scatter/gather it will point to the array of uint64
+ * indexes, For others it
  * will point to NULL)
  * @return - {success(0), failure(1), errNo(<0)}
  */
 int atomicQueue::push(atomicMsg *inpMsg, const void *inpDataSG) {
-    uint64_t offsetDSG, qSize;
-    ostringstream message;
-    void *localPointerM, *localPointerDSG;
+    int ret = 0;
+    // Reserve the slot of the next message
+    uint64_t n = tail.load(std::memory_order_relaxed);
+    do {
+        if (n - head.load(std::memory_order_acquire) >= ring->capacity)
+            return ATL_QUEUE_FULL;
+    } while (!tail.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel,
+                                         std::memory_order_relaxed));
 
-    if ((inpMsg->flag & ATOMIC_WRITE) && (inpMsg->size < MAX_DATA_IN_MSG)) {
-        // Atomic write and data is in the rpc message
-        try {
-            // Allocate data item to hold the source data; update the
-            // information in the message
-            offsetDSG = allocator->allocate(ATOMIC_REGION_ID, inpMsg->size);
-            // Only for eager mode offsetBuffer will be populated here
-            // For others it will be populated after fabric_read in
-            // process_queue()
-            inpMsg->offsetBuffer = offsetDSG;
-            localPointerDSG =
-                allocator->get_local_pointer(ATOMIC_REGION_ID, offsetDSG);
+    atomicSlot *slot = get_slot(n);
+    atomicMsg *msgPointer = &slot->msg;
+    memcpy(msgPointer, inpMsg, sizeof(atomicMsg));
+    slot->payloadUsed = 0;
+    try {
+        if (inpMsg->flag & ATOMIC_CONTAIN_DATA) {
+            // Atomic write and data is in the rpc message. Only for eager
+            // mode offsetBuffer will be populated here; for others it will
+            // be populated after fabric_read in process_queue()
+            msgPointer->offsetBuffer = alloc_payload(msgPointer, inpMsg->size);
+            msgPointer->flag |= ATOMIC_BUFFER_ALLOCATED;
+            void *localPointerDSG = allocator->get_local_pointer(
+                ATOMIC_REGION_ID, msgPointer->offsetBuffer);
             memcpy(localPointerDSG, inpDataSG, inpMsg->size);
             openfam_persist(localPointerDSG, inpMsg->size);
-        } catch (Memory_Service_Exception &e) {
-            return PUSHERROR;
         }
-    }
-    if ((inpMsg->flag & ATOMIC_SCATTER_INDEX) ||
-        (inpMsg->flag & ATOMIC_GATHER_INDEX)) {
+        if ((inpMsg->flag & ATOMIC_SCATTER_INDEX) ||
+            (inpMsg->flag & ATOMIC_GATHER_INDEX)) {
+            // Keep the Indexes for indexed version with the message
+            size_t indexSize = inpMsg->inElements * sizeof(uint64_t);
+            msgPointer->offsetIndex = alloc_payload(msgPointer, indexSize);
+            msgPointer->flag |= ATOMIC_INDEX_ALLOCATED;
+            void *localPointerDSG = allocator->get_local_pointer(
+                ATOMIC_REGION_ID, msgPointer->offsetIndex);
+            memcpy(localPointerDSG, inpDataSG, indexSize);
+            openfam_persist(localPointerDSG, indexSize);
+        }
+    } catch (...) {
+        // The slot is reserved; fill it with a request the processing
+        // thread just removes
         try {
-            // Allocate data item to hold the Indexes for indexed version;
-            // update the same in the Message
-            size_t indexStrSize = strlen((char *)inpDataSG);
-            offsetDSG = allocator->allocate(ATOMIC_REGION_ID, indexStrSize);
-            inpMsg->offsetIndex = offsetDSG;
-            localPointerDSG =
-                allocator->get_local_pointer(ATOMIC_REGION_ID, offsetDSG);
-            memcpy(localPointerDSG, inpDataSG, indexStrSize);
-            openfam_persist(localPointerDSG, indexStrSize);
-        } catch (Memory_Service_Exception &e) {
-            return PUSHERROR;
+            release_payloads(msgPointer);
+        } catch (...) {
         }
+        msgPointer->flag = ATOMIC_REQUEST_DONE;
+        ret = PUSHERROR;
     }
-
-    struct qData *lcqData;
-    lcqData = (struct qData *)pointerQ;
-    uint64_t offsetM;
-    pthread_mutex_lock(&pushQmutex[qId]);
-    // Get the offset of the element at the rear
-    offsetM = *((uint64_t *)pointerA + lcqData->rear);
-    // Get the pointer and copy the incoming message
-    if ((qSize = lcqData->size) >= lcqData->capacity) {
-        message << "Atomic Queue " << qId << " Full";
-        pthread_mutex_unlock(&pushQmutex[qId]);
-        return ATL_QUEUE_FULL;
-    }
-    // Increment the rear and size
-    lcqData->rear = (lcqData->rear + 1) % lcqData->capacity;
-    lcqData->size++;
-    pthread_mutex_unlock(&pushQmutex[qId]);
     try {
-        openfam_persist(pointerQ, sizeof(qData));
-        localPointerM = allocator->get_local_pointer(ATOMIC_REGION_ID, offsetM);
-        memcpy(localPointerM, inpMsg, sizeof(atomicMsg));
-        openfam_persist(localPointerM, sizeof(atomicMsg));
+        // The message is taken as written once its sequence number is
+        // set, so set it last
+        openfam_persist(slot, sizeof(atomicSlot));
+        __atomic_store_n(&slot->seq, n + 1, __ATOMIC_RELEASE);
+        openfam_persist(&slot->seq, sizeof(slot->seq));
     } catch (...) {
-        return PUSHERROR;
+        ret = PUSHERROR;
     }
-    if (qSize == 0)
-        pthread_cond_signal(&empty[qId]); // Signal to processing thread that
-                                          // queue is not empty anymore
-    return 0;
+    // Signal to processing thread that queue is not empty anymore, if it is
+    // parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (numSleepers[qId].load(std::memory_order_seq_cst) > 0) {
+        pthread_mutex_lock(&mutex[qId]);
+        pthread_cond_signal(&empty[qId]);
+        pthread_mutex_unlock(&mutex[qId]);
+    }
+    return ret;
 }
 
-/* Pop element from the queue using front pointer
+/* Read the element index places after the head of the queue
  * @param item - Fam_Global_Descriptor
- * @return - {success(0), failure(1),ATOMIC_QUEUE_EMPTY
+ * @param index - position of the element from the head
+ * @return - {success(0), ATOMIC_QUEUE_EMPTY if there is no such element or
+ * it is not written yet}
  */
-int atomicQueue::read(Fam_Global_Descriptor *item) {
-    struct qData *lcqData;
-    lcqData = (struct qData *)pointerQ;
-    if (lcqData->size == 0)
-        return ATOMIC_QUEUE_EMPTY; // array empty
+int atomicQueue::read(Fam_Global_Descriptor *item, uint32_t index) {
+    uint64_t n = head.load(std::memory_order_relaxed) + index;
+    if (n >= tail.load(std::memory_order_acquire))
+        return ATOMIC_QUEUE_EMPTY;
+    atomicSlot *slot = get_slot(n);
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != n + 1)
+        return ATOMIC_QUEUE_EMPTY;
     item->regionId = ATOMIC_REGION_ID;
-    // front should hold the offset of the data to be read
-    item->offset = *((uint64_t *)pointerA + lcqData->front);
+    item->offset = ring->offsetSlots + ((char *)slot - slots);
     return 0;
 }
 
-/* Remove the element from queue which was poped
- * @param item - Fam_Global_Descriptor
+/* Remove the count elements at the head of the queue, which were read.
+ * The slots are left as they are, their sequence numbers no longer match.
+ * The new head is persisted before push can reuse the slots.
+ * @param count - number of elements
  * @return - {success(0), failure(1)}
  */
-int atomicQueue::pop(Fam_Global_Descriptor *item) {
-    void *localPointerM;
-    struct qData *lcqData;
-    lcqData = (struct qData *)pointerQ;
-    // Adjust the front and size
-    lcqData->front = (lcqData->front + 1) % lcqData->capacity;
-    lcqData->size--;
+int atomicQueue::pop(uint32_t count) {
+    uint64_t newHead = head.load(std::memory_order_relaxed) + count;
+    ring->head = newHead;
     try {
-        openfam_persist(pointerQ, sizeof(qData));
-        localPointerM =
-            allocator->get_local_pointer(item->regionId, item->offset);
-        // clear the content of the message
-        memset(localPointerM, 0, sizeof(atomicMsg));
-        openfam_persist(localPointerM, sizeof(atomicMsg));
+        openfam_persist(&ring->head, sizeof(ring->head));
     } catch (...) {
         return POPERROR;
     }
+    head.store(newHead, std::memory_order_release);
     return 0;
 }
 
@@ -267,24 +523,287 @@ int atomicQueue::pop(Fam_Global_Descriptor *item) {
  * return true(1), false(0)
  */
 bool atomicQueue::isQempty() {
-    struct qData *lcqData;
-    lcqData = (struct qData *)pointerQ;
-    return ((lcqData->size == 0) ? true : false);
+    return (head.load(std::memory_order_acquire) ==
+            tail.load(std::memory_order_acquire));
+}
+
+/*
+ * State of a request of the batch being processed by process_queue, carried
+ * from one phase of the batch to the next.
+ */
+typedef struct atlRequest {
+    Fam_Global_Descriptor item;
+    atomicMsg *msgPointer;
+    fi_addr_t fiAddr;
+    // Buffer the fabric transfer reads into or writes from
+    void *localPointerB;
+    uint64_t bufferSize;
+    // The transfer reads from the client memory if true, writes to it if not
+    bool readFromClient;
+    bool transfer;
+    // localPointerB was malloc'ed for the transfer and is freed after it
+    bool freeBuffer;
+    bool respond;
+    int32_t retStatus;
+    int32_t popStatus;
+    fi_context *sendCtx;
+} atlRequest;
+
+/*
+ * Get the fabric address of the client which sent msgPointer, inserting it
+ * in the address vector the first time the client is seen. Each processing
+ * thread caches the addresses it has looked up in addrCache, in front of
+ * fiAddrMap.
+ */
+static int get_client_addr(atomicMsg *msgPointer,
+                           std::map<fi_addr_t, fi_addr_t> *addrCache,
+                           fi_addr_t *fiAddr) {
+    fi_addr_t clientAddr;
+    memcpy(&clientAddr, msgPointer->nodeAddr, sizeof(clientAddr));
+    auto cached = addrCache->find(clientAddr);
+    if (cached != addrCache->end()) {
+        *fiAddr = cached->second;
+        return 0;
+    }
+
+    pthread_rwlock_rdlock(&fiAddrLock);
+    auto it = fiAddrMap.find(clientAddr);
+    bool found = (it != fiAddrMap.end());
+    if (found)
+        *fiAddr = it->second;
+    pthread_rwlock_unlock(&fiAddrLock);
+    if (!found) {
+        pthread_rwlock_wrlock(&fiAddrLock);
+        it = fiAddrMap.find(clientAddr);
+        if (it == fiAddrMap.end()) {
+            std::vector<fi_addr_t> fiAddrV;
+            if (fabric_insert_av(msgPointer->nodeAddr,
+                                 famOpsLibfabricQ->get_av(),
+                                 &fiAddrV) == -1) {
+                pthread_rwlock_unlock(&fiAddrLock);
+                cout << "AV insert error, Remote Address "
+                     << msgPointer->nodeAddr << endl;
+                return AVINSERTERROR;
+            }
+            it = fiAddrMap.insert({clientAddr, fiAddrV[0]}).first;
+        }
+        *fiAddr = it->second;
+        pthread_rwlock_unlock(&fiAddrLock);
+    }
+    addrCache->insert({clientAddr, *fiAddr});
+    return 0;
 }
 
-// Populate string of indexes to array
-uint64_t *parseIndex(char *inpStr, uint64_t nElements) {
-    char delim[2] = ",";
-    char *token;
-    int i = 0;
-    uint64_t *indexArr = NULL;
-    indexArr = (uint64_t *)malloc(nElements * sizeof(uint64_t));
-    token = strtok(inpStr, delim);
-    while (token != NULL) {
-        indexArr[i++] = atoi(token);
-        token = strtok(NULL, delim);
+// Start the fabric transfer of req on ctx, without waiting for it
+static void post_transfer(atlRequest *req, Fam_Context *ctx) {
+    atomicMsg *msgPointer = req->msgPointer;
+    try {
+        if (req->readFromClient)
+            fabric_read_nonblocking(msgPointer->key, req->localPointerB,
+                                    req->bufferSize, 0, req->fiAddr, ctx);
+        else
+            fabric_write_nonblocking(msgPointer->key, req->localPointerB,
+                                     req->bufferSize, 0, req->fiAddr, ctx);
+        req->transfer = true;
+    } catch (...) {
+        req->retStatus = req->readFromClient ? FABRICREADERROR
+                                             : FABRICWRITEERROR;
+    }
+}
+
+/*
+ * Wait for the transfers of the batch. If any of them failed, redo them one
+ * at a time to find out which.
+ */
+static void complete_transfers(atlRequest *reqs, int count,
+                               Fam_Context *ctx) {
+    bool pending = false;
+    for (int i = 0; i < count; i++)
+        pending |= reqs[i].transfer;
+    if (!pending)
+        return;
+
+    try {
+        fabric_quiet(ctx);
+        return;
+    } catch (...) {
+    }
+    for (int i = 0; i < count; i++) {
+        atlRequest *req = &reqs[i];
+        if (!req->transfer)
+            continue;
+        atomicMsg *msgPointer = req->msgPointer;
+        try {
+            if (req->readFromClient)
+                fabric_read(msgPointer->key, req->localPointerB,
+                            req->bufferSize, 0, req->fiAddr, ctx);
+            else
+                fabric_write(msgPointer->key, req->localPointerB,
+                             req->bufferSize, 0, req->fiAddr, ctx);
+        } catch (...) {
+            req->retStatus = req->readFromClient ? FABRICREADERROR
+                                                 : FABRICWRITEERROR;
+        }
+    }
+}
+
+/*
+ * First phase of a request : map the data and start the fabric transfer of
+ * reads and gathers, and of writes and scatters not started yet.
+ */
+static void start_request(atlRequest *req, atomicQueue *queue,
+                          Memserver_Allocator *allocator, Fam_Context *ctx) {
+    atomicMsg *msgPointer = req->msgPointer;
+    uint64_t function = msgPointer->flag & 0x3F;
+    switch (function) {
+    case ATOMIC_READ: {
+        // Write data item to client's memory
+        try {
+            req->localPointerB = allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset + msgPointer->offset);
+            req->bufferSize = msgPointer->size;
+            req->readFromClient = false;
+            post_transfer(req, ctx);
+        } catch (...) {
+            req->retStatus = MAPERROR;
+        }
+        req->respond = true;
+        break;
+    }
+    case ATOMIC_GATHER_INDEX:
+    case ATOMIC_GATHER_STRIDE: {
+        // Gather the elements into a buffer and write it to client's memory
+        const uint64_t *indexArr = NULL;
+        try {
+            char *localPointerD = (char *)allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset);
+            uint64_t nElements, elementSize;
+            if (function == ATOMIC_GATHER_INDEX) {
+                indexArr = (uint64_t *)allocator->get_local_pointer(
+                    ATOMIC_REGION_ID, msgPointer->offsetIndex);
+                nElements = msgPointer->inElements;
+                elementSize = msgPointer->ielementSize;
+            } else {
+                nElements = msgPointer->snElements;
+                elementSize = msgPointer->selementSize;
+            }
+            req->bufferSize = nElements * elementSize;
+            req->localPointerB = malloc(req->bufferSize);
+            req->freeBuffer = true;
+            for (uint64_t numElements = 0; numElements < nElements;
+                 ++numElements) {
+                uint64_t srcIndex =
+                    (indexArr ? indexArr[numElements]
+                              : msgPointer->firstElement +
+                                    msgPointer->stride * numElements) *
+                    elementSize;
+                memcpy((char *)req->localPointerB + numElements * elementSize,
+                       localPointerD + srcIndex, elementSize);
+            }
+            req->readFromClient = false;
+            post_transfer(req, ctx);
+        } catch (...) {
+            req->retStatus = MAPERROR;
+        }
+        req->respond = true;
+        break;
+    }
+    case ATOMIC_WRITE:
+    case ATOMIC_SCATTER_INDEX:
+    case ATOMIC_SCATTER_STRIDE: {
+        // Completed, eager and in progress writes need no transfer
+        if (msgPointer->flag & (ATOMIC_WRITE_COMPLETED | ATOMIC_CONTAIN_DATA |
+                                ATOMIC_WRITE_IN_PROGRESS))
+            break;
+        // New request; allocate buffer and read from client
+        if (function == ATOMIC_WRITE)
+            req->bufferSize = msgPointer->size;
+        else if (function == ATOMIC_SCATTER_INDEX)
+            req->bufferSize = msgPointer->inElements * msgPointer->ielementSize;
+        else
+            req->bufferSize = msgPointer->snElements * msgPointer->selementSize;
+        try {
+            uint64_t offsetB =
+                queue->alloc_payload(msgPointer, req->bufferSize);
+            msgPointer->flag |= ATOMIC_BUFFER_ALLOCATED;
+            // Update the message with the region and offset of buffer
+            msgPointer->offsetBuffer = offsetB;
+            try {
+                req->localPointerB =
+                    allocator->get_local_pointer(ATOMIC_REGION_ID, offsetB);
+                req->readFromClient = true;
+                post_transfer(req, ctx);
+            } catch (...) {
+                req->retStatus = MAPERROR;
+            }
+        } catch (...) {
+            req->retStatus = BUFFERALLOCATEERROR;
+        }
+        req->respond = true;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Copy the buffer of a write or scatter in progress to the target data item
+static void apply_write(atlRequest *req, Memserver_Allocator *allocator,
+                        uint64_t function) {
+    atomicMsg *msgPointer = req->msgPointer;
+    const uint64_t *indexArr = NULL;
+    try {
+        char *localPointerB = (char *)req->localPointerB;
+        if (function == ATOMIC_WRITE) {
+            void *localPointerD = allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset + msgPointer->offset);
+            memcpy(localPointerD, localPointerB, msgPointer->size);
+            openfam_persist(localPointerD, msgPointer->size);
+        } else {
+            char *localPointerD = (char *)allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset);
+            uint64_t nElements, elementSize;
+            if (function == ATOMIC_SCATTER_INDEX) {
+                indexArr = (uint64_t *)allocator->get_local_pointer(
+                    ATOMIC_REGION_ID, msgPointer->offsetIndex);
+                nElements = msgPointer->inElements;
+                elementSize = msgPointer->ielementSize;
+            } else {
+                nElements = msgPointer->snElements;
+                elementSize = msgPointer->selementSize;
+            }
+            // Copy data from buffer to target data item, element by element
+            for (uint64_t numElements = 0; numElements < nElements;
+                 ++numElements) {
+                uint64_t destIndex =
+                    (indexArr ? indexArr[numElements]
+                              : msgPointer->firstElement +
+                                    msgPointer->stride * numElements) *
+                    elementSize;
+                memcpy(localPointerD + destIndex,
+                       localPointerB + numElements * elementSize, elementSize);
+                openfam_persist(localPointerD + destIndex, elementSize);
+            }
+        }
+        // Update the flag to indicate write is completed
+        msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
+        msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
+        openfam_persist(msgPointer, sizeof(msgPointer->flag));
+    } catch (...) {
+        req->popStatus = MAPERROR;
+    }
+}
+
+// Free the buffer and index list of a request
+static void release_buffers(atlRequest *req, atomicQueue *queue) {
+    try {
+        queue->release_payloads(req->msgPointer);
+    } catch (...) {
     }
-    return indexArr;
 }
 
 /* Recover the incomplete transactions during startup
@@ -292,801 +811,315 @@ uint64_t *parseIndex(char *inpStr, uint64_t nElements) {
  * @param - Memserver_Allocator
  */
 int recover_queue(uint32_t qId, Memserver_Allocator *allocator) {
-    Fam_Global_Descriptor item;
-    void *localPointer = NULL, *localPointerB = NULL, *localPointerD = NULL,
-         *localPointerI = NULL;
-    atomicMsg *msgPointer;
+    atomicQueue *queue = &atomicQ[qId];
+    atlRequest req;
+    atomicMsg *msgPointer = NULL;
     int ret = 0;
     int retryCount = 0;
-    uint64_t *indexArr = NULL;
-    while (!atomicQ[qId].isQempty()) {
-        atomicQ[qId].read(&item);
+    while (!queue->isQempty()) {
+        if (queue->read(&req.item) == ATOMIC_QUEUE_EMPTY) {
+            // Being pushed; wait for it to be written
+            std::this_thread::yield();
+            continue;
+        }
         ret = 0;
         try {
-            localPointer =
-                allocator->get_local_pointer(item.regionId, item.offset);
+            msgPointer = (atomicMsg *)allocator->get_local_pointer(
+                req.item.regionId, req.item.offset);
         } catch (...) {
             ret = MAPERROR;
         }
-        msgPointer = (atomicMsg *)localPointer;
+        uint64_t function = ret ? 0 : msgPointer->flag & 0x3F;
         // Recover only Write and In progress requests
-        if ((msgPointer->flag & ATOMIC_WRITE) &&
+        if (((function == ATOMIC_WRITE) || (function == ATOMIC_SCATTER_INDEX) ||
+             (function == ATOMIC_SCATTER_STRIDE)) &&
             (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS)) {
-            // Atomic write and write was incomplete
-            // get the pointer for target and source data items
+            // Write was incomplete; copy the buffer to the target data item
+            // again
+            req.msgPointer = msgPointer;
+            req.popStatus = 0;
             try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset + msgPointer->offset);
-                localPointerB = allocator->get_local_pointer(
+                req.localPointerB = allocator->get_local_pointer(
                     ATOMIC_REGION_ID, msgPointer->offsetBuffer);
+                apply_write(&req, allocator, function);
+                ret = req.popStatus;
             } catch (...) {
                 ret = MAPERROR;
             }
+        }
+        // If error, retry 5 times, then return error
+        if (ret) {
+            retryCount++;
+            if (retryCount < 5)
+                continue;
+            else {
+                break;
+            }
+        }
+        // Remove the message from the queue
+        try {
+            queue->release_payloads(msgPointer);
+        } catch (...) {
+        }
+        queue->pop();
+    }
+    return ret;
+}
 
-            // Copy data from source to destination data item
-            memcpy(localPointerD, localPointerB, msgPointer->size);
+/*
+ * Second phase of a request, once its transfer is done : send the response
+ * and apply writes and scatters to the target data item.
+ */
+static void finish_request(atlRequest *req, atomicQueue *queue,
+                           Memserver_Allocator *allocator, Fam_Context *ctx) {
+    atomicMsg *msgPointer = req->msgPointer;
+    uint64_t function = msgPointer->flag & 0x3F;
+    bool isWrite = (function == ATOMIC_WRITE) ||
+                   (function == ATOMIC_SCATTER_INDEX) ||
+                   (function == ATOMIC_SCATTER_STRIDE);
+
+    if (isWrite && (msgPointer->flag & ATOMIC_WRITE_COMPLETED)) {
+        // last write completed. If buffer is still allocated, deallocate
+        // and remove the entry
+        release_buffers(req, queue);
+        return;
+    }
+
+    if ((function == ATOMIC_WRITE) &&
+        (msgPointer->flag & ATOMIC_CONTAIN_DATA)) {
+        // msg contains data
+        try {
+            // Get the pointer to destination and source
+            void *localPointerD = allocator->get_local_pointer(
+                msgPointer->dstDataGdesc.regionId,
+                msgPointer->dstDataGdesc.offset + msgPointer->offset);
+            void *localPointerInpD = allocator->get_local_pointer(
+                ATOMIC_REGION_ID, msgPointer->offsetBuffer);
+            // Indicate write in progress
+            msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
+            // Copy the data from source to target
+            memcpy(localPointerD, localPointerInpD, msgPointer->size);
             try {
                 openfam_persist(localPointerD, msgPointer->size);
-                // Clear the flags to indicate write is complete
+                // Set the flags
                 msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
                 msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
                 openfam_persist(msgPointer, sizeof(msgPointer->flag));
+                // Free source data
+                release_buffers(req, queue);
             } catch (...) {
-                ret = PERSISTERROR;
-            }
-            // Deallocate source data item
-            try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-            } catch (...) {
-                ret = DEALLOCATEERROR;
+                req->popStatus = PERSISTERROR;
             }
+        } catch (...) {
+            req->popStatus = MAPERROR;
         }
-        if ((msgPointer->flag & ATOMIC_SCATTER_INDEX) &&
-            (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS)) {
-            // Indexed scatter; map desination, buffer and Index array
+        return;
+    }
+
+    if (isWrite) {
+        if (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS) {
+            // Write was incomplete. process similar to recovery operation
             try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset + msgPointer->offset);
-                localPointerB = allocator->get_local_pointer(
+                req->localPointerB = allocator->get_local_pointer(
                     ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-                localPointerI = allocator->get_local_pointer(
-                    ATOMIC_REGION_ID, msgPointer->offsetIndex);
             } catch (...) {
-                ret = MAPERROR;
+                req->popStatus = MAPERROR;
             }
-            indexArr =
-                parseIndex((char *)localPointerI, msgPointer->inElements);
-            // Copy data from source to destination data item using index
-            for (uint64_t numElements = 0; numElements < msgPointer->inElements;
-                 ++numElements) {
-                uint64_t srcIndex = numElements * msgPointer->ielementSize;
-                uint64_t destIndex =
-                    indexArr[numElements] * msgPointer->ielementSize;
-                memcpy((char *)localPointerD + destIndex,
-                       (char *)localPointerB + srcIndex,
-                       msgPointer->ielementSize);
-                try {
-                    openfam_persist((char *)localPointerD + destIndex,
-                                    msgPointer->ielementSize);
-                } catch (...) {
-                    ret = PERSISTERROR;
-                }
-            }
-            // Clear the flags to indicate write is complete
-            msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-            msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
+        } else if (req->retStatus == 0) {
+            // Data is copied to buffer; set the flag to indicate write is in
+            // progress
             try {
+                openfam_persist(req->localPointerB, req->bufferSize);
+                msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
                 openfam_persist(msgPointer, sizeof(msgPointer->flag));
             } catch (...) {
-                ret = PERSISTERROR;
-            }
-            // Deallocate source data item and index array
-            if (indexArr)
-                free(indexArr);
-            try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetIndex);
-            } catch (...) {
-                ret = DEALLOCATEERROR;
+                req->retStatus = PERSISTERROR;
             }
         }
-        if ((msgPointer->flag & ATOMIC_SCATTER_STRIDE) &&
-            (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS)) {
-            // Strided scatter; map destination and source data items
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset + msgPointer->offset);
-                localPointerB = allocator->get_local_pointer(
-                    ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-            } catch (...) {
-                ret = MAPERROR;
-            }
-            // Copy data from source to destination data item
-            for (uint64_t numElements = 0; numElements < msgPointer->snElements;
-                 ++numElements) {
-                uint64_t srcIndex = numElements * msgPointer->selementSize;
-                uint64_t destIndex = (msgPointer->firstElement +
-                                      msgPointer->stride * numElements) *
-                                     msgPointer->selementSize;
-                memcpy((char *)localPointerD + destIndex,
-                       (char *)localPointerB + srcIndex,
-                       msgPointer->selementSize);
-                try {
-                    openfam_persist((char *)localPointerD + destIndex,
-                                    msgPointer->selementSize);
-                } catch (...) {
-                    ret = PERSISTERROR;
-                }
-            }
-            // Clear the flags to indicate write is complete
-            msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-            msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
-            try {
-                openfam_persist(msgPointer, sizeof(msgPointer->flag));
-            } catch (...) {
-                ret = PERSISTERROR;
-            }
-            // Deallocate source data item
-            try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-            } catch (...) {
-                ret = DEALLOCATEERROR;
-            }
+    }
+
+    // Send the status back to client; the responses of the batch are waited
+    // for together
+    if (req->respond) {
+        try {
+            req->sendCtx = fabric_post_send_response(
+                &req->retStatus, req->fiAddr, ctx, sizeof(req->retStatus));
+        } catch (...) {
         }
-        // If error, retry 5 times, then return error
-        if (ret) {
-            retryCount++;
-            if (retryCount < 5)
-                continue;
-            else {
-                break;
-            }
+    }
+
+    if (req->freeBuffer)
+        free(req->localPointerB);
+    if (!isWrite) {
+        // Free the index list of an indexed gather
+        release_buffers(req, queue);
+        return;
+    }
+    if (req->popStatus)
+        return;
+    // Apply the write, unless reading it from the client failed
+    if (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS)
+        apply_write(req, allocator, function);
+    if (req->popStatus == 0)
+        release_buffers(req, queue);
+}
+
+/*
+ * Number of requests at the front of msgs which can be processed in one
+ * batch. Reads and gathers transfer the data item in the first phase of a
+ * batch and writes and scatters are applied in the second one, so a read
+ * or gather which follows a pending write or scatter starts a new batch.
+ */
+int atl_batch_size(atomicMsg *const *msgs, int count) {
+    bool pendingWrite = false;
+    for (int i = 0; i < count; i++) {
+        uint64_t flag = msgs[i]->flag;
+        uint64_t function = flag & 0x3F;
+        if (flag & ATOMIC_REQUEST_DONE)
+            continue;
+        if ((function == ATOMIC_READ) || (function == ATOMIC_GATHER_INDEX) ||
+            (function == ATOMIC_GATHER_STRIDE)) {
+            if (pendingWrite)
+                return i;
+        } else if (((function == ATOMIC_WRITE) ||
+                    (function == ATOMIC_SCATTER_INDEX) ||
+                    (function == ATOMIC_SCATTER_STRIDE)) &&
+                   !(flag & ATOMIC_WRITE_COMPLETED)) {
+            pendingWrite = true;
         }
-        // Remove the message from the queue
-        atomicQ[qId].pop(&item);
     }
-    return ret;
+    return count;
+}
+
+/*
+ * Wait until the queue qId has requests. Spin for a while before parking,
+ * so that a steady stream of requests never goes through the mutex.
+ */
+static void wait_for_requests(uint32_t qId) {
+    for (int i = 0; i < ATL_SPIN_COUNT; i++) {
+        if (!atomicQ[qId].isQempty())
+            return;
+        std::this_thread::yield();
+    }
+    pthread_mutex_lock(&mutex[qId]);
+    numSleepers[qId].fetch_add(1, std::memory_order_seq_cst);
+    while (atomicQ[qId].isQempty())
+        pthread_cond_wait(&empty[qId], &mutex[qId]);
+    numSleepers[qId].fetch_sub(1, std::memory_order_seq_cst);
+    pthread_mutex_unlock(&mutex[qId]);
 }
 
 /* Main processing thread, one for each queue
- * Pops messages from queue and processes
+ * Pops messages from queue and processes them in batches of up to
+ * ATL_BATCH_SIZE : the fabric transfers of a batch are in flight together
+ * on the context of the queue, and so are its responses.
  * Memory server call this with the argument list
  */
 void *process_queue(void *arg) {
     tInfo *lcTInfo = (tInfo *)arg;
-    Fam_Global_Descriptor item;
-    void *localPointer = NULL, *localPointerB = NULL, *localPointerD = NULL,
-         *localPointerInpD = NULL, *localPointerI = NULL;
-    atomicMsg *msgPointer;
+    uint32_t qId = lcTInfo->qId;
     int ret = 0;
-    int32_t retStatus = 0, popStatus = 0;
-    uint64_t *indexArr = NULL;
     Memserver_Allocator *allocator = lcTInfo->allocator;
-    fi_addr_t fiAddr = 0, clientAddr;
-    char *remoteAddr;
-    std::map<fi_addr_t, fi_addr_t>::iterator it;
+    atomicQueue *queue = &atomicQ[qId];
+    std::map<fi_addr_t, fi_addr_t> addrCache;
+    atlRequest reqs[ATL_BATCH_SIZE];
+    atomicMsg *msgs[ATL_BATCH_SIZE];
+    Fam_Context *ctx;
 
     // Recover the incomplete writes if any
-    cout << "Recovering Incomplete transactions for queue" << lcTInfo->qId
-         << endl;
-    ret = recover_queue(lcTInfo->qId, allocator);
+    cout << "Recovering Incomplete transactions for queue" << qId << endl;
+    ret = recover_queue(qId, allocator);
     if (ret) {
         // Recovery failed - Disable ATL
         cout << "Recovery error - Couldn't recover incomplete requests" << endl;
         numAtomicThreads = 0;
         pthread_exit(&ret);
     }
-    cout << "Recovery of Incomplete trasactions completed for queue"
-         << lcTInfo->qId << endl;
-    cout << "processing thread for queue" << lcTInfo->qId << " started" << endl;
+    cout << "Recovery of Incomplete trasactions completed for queue" << qId
+         << endl;
+    try {
+        ctx = famOpsLibfabricQ->get_atl_context(qId);
+    } catch (...) {
+        cout << "Context creation error for queue" << qId << endl;
+        ret = OPS_INIT_FAILED;
+        numAtomicThreads = 0;
+        pthread_exit(&ret);
+    }
+    cout << "processing thread for queue" << qId << " started" << endl;
 
     while (1) {
-        ret = atomicQ[lcTInfo->qId].read(&item);
-        if (ret == ATOMIC_QUEUE_EMPTY) { // queue empty
-            pthread_mutex_lock(&mutex[lcTInfo->qId]);
-            pthread_cond_wait(&empty[lcTInfo->qId], &mutex[lcTInfo->qId]);
-            pthread_mutex_unlock(&mutex[lcTInfo->qId]);
-            continue;
-        }
-        retStatus = 0;
-        popStatus = 0;
-        // get fiAddr of the remote/client node
-        try {
-            localPointer =
-                allocator->get_local_pointer(item.regionId, item.offset);
-        } catch (...) {
-            ret = MAPERROR;
-        }
-        msgPointer = (atomicMsg *)localPointer;
-        remoteAddr = (char *)calloc(1, msgPointer->nodeAddrSize);
-        memcpy(remoteAddr, msgPointer->nodeAddr, msgPointer->nodeAddrSize);
-        clientAddr = *(fi_addr_t *)remoteAddr;
-        pthread_rwlock_rdlock(&fiAddrLock);
-        it = fiAddrMap.find(clientAddr);
-        pthread_rwlock_unlock(&fiAddrLock);
-        if (it == fiAddrMap.end()) {
-           pthread_rwlock_wrlock(&fiAddrLock);
-           it = fiAddrMap.find(clientAddr);
-            if (it == fiAddrMap.end()) {
-                std::vector<fi_addr_t> fiAddrV;
-                if (fabric_insert_av(remoteAddr, famOpsLibfabricQ->get_av(),
-                        &fiAddrV) == -1) {
-                        ret = AVINSERTERROR;
-                        cout << "AV insert error, Remote Address " << remoteAddr
-                             << endl;
-                        ret = atomicQ[lcTInfo->qId].pop(&item);
-                        pthread_rwlock_unlock(&fiAddrLock);
-                        continue;
-                }
-                fiAddr = fiAddrV[0];
-                fiAddrMap.insert(it, std::pair<fi_addr_t, fi_addr_t>(clientAddr,
-                              fiAddr));
-                pthread_rwlock_unlock(&fiAddrLock);
-            } else {
-                fiAddr = it->second;
-                pthread_rwlock_unlock(&fiAddrLock);
-            }
-        } else
-            fiAddr = it->second;
-        uint64_t function = msgPointer->flag & 0x3F;
-        switch (function) {
-        case ATOMIC_READ: { // Read function
-            try {
-                // Get the pointer for the source using the offset
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset + msgPointer->offset);
-                try {
-                    // Write data to client's memory
-                    ret = fabric_write(
-                        msgPointer->key, localPointerD, msgPointer->size, 0,
-                        fiAddr, famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                } catch (...) {
-                    retStatus = FABRICWRITEERROR;
-                }
-            } catch (...) {
-                retStatus = MAPERROR;
-            }
-                // send status (retStatus)  back to client
-            try {
-                fabric_send_response(
-                    &retStatus, fiAddr,
-                    famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                    sizeof(retStatus));
-            } catch (...) {
-                ret = SENDTOCLIENTERROR;
-            }
-
-            break;
-        }
-        case ATOMIC_WRITE: {
-            // Atomic write
-            if (msgPointer->flag & ATOMIC_WRITE_COMPLETED) {
-                // last write completed. If buffer is still allocated,
-                // deallocate and remove the entry
-                if (msgPointer->flag & ATOMIC_BUFFER_ALLOCATED)
-                    try {
-                        allocator->deallocate(ATOMIC_REGION_ID,
-                                              msgPointer->offsetBuffer);
-                        try {
-                            msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                            openfam_persist(msgPointer,
-                                            sizeof(msgPointer->flag));
-                        } catch (...) {
-                            ret = PERSISTERROR;
-                        }
-                    } catch (...) {
-                        ret = DEALLOCATEERROR;
-                    }
-                break;
-            }
-
-            if (msgPointer->flag & ATOMIC_CONTAIN_DATA) {
-                // msg contains data
-                try {
-                    // Get the pointer to destination and source
-                    localPointerD = allocator->get_local_pointer(
-                        msgPointer->dstDataGdesc.regionId,
-                        msgPointer->dstDataGdesc.offset + msgPointer->offset);
-                    localPointerInpD = allocator->get_local_pointer(
-                        ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-                    // Indicate write in progress
-                    msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
-                    // Copy the data from source to target
-                    memcpy(localPointerD, localPointerInpD, msgPointer->size);
-                    try {
-                        openfam_persist(localPointerD, msgPointer->size);
-                        // Set the flags
-                        msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-                        msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
-                        openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                        // Deallocate source data item
-                        try {
-                            allocator->deallocate(ATOMIC_REGION_ID,
-                                                  msgPointer->offsetBuffer);
-                        } catch (...) {
-                            popStatus = DEALLOCATEERROR;
-                        }
-                    } catch (...) {
-                        popStatus = PERSISTERROR;
-                    }
-                } catch (...) {
-                    popStatus = MAPERROR;
-                }
-
-                break;
-            }
-            if (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS) {
-                // Write was incomplete. process similar to recovery operation
-                try {
-                    localPointerB = allocator->get_local_pointer(
-                        ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-                } catch (...) {
-                    popStatus = MAPERROR;
-                }
-            } else {
-                // New write operation
-                // Allocate data item for buffer
-                uint64_t offsetB = 0;
-                try {
-                    offsetB =
-                        allocator->allocate(ATOMIC_REGION_ID, msgPointer->size);
-                    msgPointer->flag |= ATOMIC_BUFFER_ALLOCATED;
-                    // Update the message with the region and offset of buffer
-                    msgPointer->offsetBuffer = offsetB;
-                    try {
-                        localPointerB = allocator->get_local_pointer(
-                            ATOMIC_REGION_ID, offsetB);
-                        // Read from Client's memory into buffer
-                        try {
-                            retStatus = fabric_read(
-                                msgPointer->key, localPointerB,
-                                msgPointer->size, 0, fiAddr,
-                                famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                            try {
-                                openfam_persist(localPointerB,
-                                                msgPointer->size);
-                                // Set the flag to indicate write is in progress
-                                msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
-                                openfam_persist(msgPointer,
-                                                sizeof(msgPointer->flag));
-                            } catch (...) {
-                                retStatus = PERSISTERROR;
-                            }
-                        } catch (...) {
-                            retStatus = FABRICREADERROR;
-                        }
-                    } catch (...) {
-                        retStatus = MAPERROR;
-                    }
-                } catch (Memory_Service_Exception &e) {
-                    retStatus = BUFFERALLOCATEERROR;
-                }
-                // Data is copied to buffer, now send the status back to client
-                try {
-                    fabric_send_response(
-                        &retStatus, fiAddr,
-                        famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                        sizeof(retStatus));
-                } catch (...) {
-                    ret = SENDTOCLIENTERROR;
-                }
-            }
-            // Get the pointer of the target and copy
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset + msgPointer->offset);
-
-                memcpy(localPointerD, localPointerB, msgPointer->size);
-                // Update the flag to indicate write is completed
-                msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-                msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
-                try {
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                    openfam_persist(localPointerD, msgPointer->size);
-                } catch (...) {
-                    popStatus = PERSISTERROR;
-                }
-            } catch (...) {
-                popStatus = MAPERROR;
-            }
-
-            // Deallocate the buffer
-            try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-                try {
-                    msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                } catch (...) {
-                    ret = PERSISTERROR;
-                }
-            } catch (...) {
-                ret = DEALLOCATEERROR;
-            }
-
-            break;
-        }
-
-        case ATOMIC_SCATTER_INDEX:
-            // Atomic scatter - indexed
-            if (msgPointer->flag & ATOMIC_WRITE_COMPLETED) {
-                // last write completed. If buffer is still allocated,
-                // deallocate and  remove the entry
-                if (msgPointer->flag & ATOMIC_BUFFER_ALLOCATED) {
-                    try {
-                        allocator->deallocate(ATOMIC_REGION_ID,
-                                              msgPointer->offsetBuffer);
-                        allocator->deallocate(ATOMIC_REGION_ID,
-                                              msgPointer->offsetIndex);
-                        try {
-                            msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                            openfam_persist(msgPointer,
-                                            sizeof(msgPointer->flag));
-                        } catch (...) {
-                            ret = PERSISTERROR;
-                        }
-                    } catch (...) {
-                        ret = DEALLOCATEERROR;
-                    }
-                }
+        // Take the requests at the front of the queue which are written
+        int count = 0;
+        while (count < ATL_BATCH_SIZE) {
+            atlRequest *req = &reqs[count];
+            if (queue->read(&req->item, count) == ATOMIC_QUEUE_EMPTY)
                 break;
-            }
-            if (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS) {
-                // Indexed scatter- Inprogress; buffer
-                try {
-                    localPointerB = allocator->get_local_pointer(
-                        ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-                } catch (...) {
-                    popStatus = MAPERROR;
-                }
-            } else {
-                // New request; allocate buffer and read from client
-                uint64_t offsetB = 0;
-                uint64_t bufferSize =
-                    msgPointer->inElements * msgPointer->ielementSize;
-                try {
-                    offsetB = allocator->allocate(ATOMIC_REGION_ID, bufferSize);
-                    // Update the message with the region and offset of buffer
-                    msgPointer->offsetBuffer = offsetB;
-                    msgPointer->flag |= ATOMIC_BUFFER_ALLOCATED;
-                    // Read from client into buffer
-                    try {
-                        localPointerB = allocator->get_local_pointer(
-                            ATOMIC_REGION_ID, offsetB);
-                        try {
-                            retStatus = fabric_read(
-                                msgPointer->key, localPointerB, bufferSize, 0,
-                                fiAddr,
-                                famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                            // Set the flag to indicate write is in progress
-                            msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
-                            try {
-                                openfam_persist(localPointerB, bufferSize);
-                                openfam_persist(msgPointer,
-                                                sizeof(msgPointer->flag));
-                            } catch (...) {
-                                retStatus = PERSISTERROR;
-                            }
-                        } catch (...) {
-                            retStatus = FABRICREADERROR;
-                        }
-                    } catch (...) {
-                        retStatus = MAPERROR;
-                    }
-                } catch (...) {
-                    retStatus = ALLOCATEERROR;
-                }
-                // Send status as reponse, back to client
-                try {
-                    fabric_send_response(
-                        &retStatus, fiAddr,
-                        famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                        sizeof(retStatus));
-                } catch (...) {
-                    ret = SENDTOCLIENTERROR;
-                }
-            }
-            // Get the pointer to the target and copy and mentioned in the index
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset);
-                localPointerI = allocator->get_local_pointer(
-                    ATOMIC_REGION_ID, msgPointer->offsetIndex);
-                indexArr =
-                    parseIndex((char *)localPointerI, msgPointer->inElements);
-                // Copy data from source to destination data item using index
-                for (uint64_t numElements = 0;
-                     numElements < msgPointer->inElements; ++numElements) {
-                    uint64_t srcIndex = numElements * msgPointer->ielementSize;
-                    uint64_t destIndex =
-                        indexArr[numElements] * msgPointer->ielementSize;
-                    memcpy((char *)localPointerD + destIndex,
-                           (char *)localPointerB + srcIndex,
-                           msgPointer->ielementSize);
-                    try {
-                        openfam_persist((char *)localPointerD + destIndex,
-                                        msgPointer->ielementSize);
-                    } catch (...) {
-                        popStatus = PERSISTERROR;
-                    }
-                }
-                // Update the flag to indicate write is completed
-                msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-                msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
-                try {
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                } catch (...) {
-                    popStatus = PERSISTERROR;
-                }
-            } catch (...) {
-                popStatus = MAPERROR;
-            }
-            // Deallocate the buffer
             try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetIndex);
-                msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                try {
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                } catch (...) {
-                    ret = PERSISTERROR;
-                }
+                req->msgPointer = (atomicMsg *)allocator->get_local_pointer(
+                    req->item.regionId, req->item.offset);
             } catch (...) {
-                ret = DEALLOCATEERROR;
-            }
-            if (indexArr)
-                free(indexArr);
-            break;
-
-        case ATOMIC_SCATTER_STRIDE:
-            // Atomic scatter - strided
-            if (msgPointer->flag & ATOMIC_WRITE_COMPLETED) {
-                // last write completed. If buffer is still allocated,
-                // deallocate and  remove the entry
-                if (msgPointer->flag & ATOMIC_BUFFER_ALLOCATED) {
-                    try {
-                        allocator->deallocate(ATOMIC_REGION_ID,
-                                              msgPointer->offsetBuffer);
-                        allocator->deallocate(ATOMIC_REGION_ID,
-                                              msgPointer->offsetIndex);
-                        try {
-                            msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                            openfam_persist(msgPointer,
-                                            sizeof(msgPointer->flag));
-                        } catch (...) {
-                            ret = PERSISTERROR;
-                        }
-
-                    } catch (...) {
-                        ret = DEALLOCATEERROR;
-                    }
-                }
                 break;
             }
+            req->localPointerB = NULL;
+            req->bufferSize = 0;
+            req->readFromClient = false;
+            req->transfer = false;
+            req->freeBuffer = false;
+            req->respond = false;
+            req->retStatus = 0;
+            req->popStatus = 0;
+            req->sendCtx = NULL;
+            msgs[count] = req->msgPointer;
+            count++;
+        }
+        count = atl_batch_size(msgs, count);
+        if (count == 0) {
+            wait_for_requests(qId);
+            continue;
+        }
 
-            if (msgPointer->flag & ATOMIC_WRITE_IN_PROGRESS) {
-                // Indexed scatter - Inprogress; map buffer
-                try {
-                    localPointerB = allocator->get_local_pointer(
-                        ATOMIC_REGION_ID, msgPointer->offsetBuffer);
-                } catch (...) {
-                    popStatus = DEALLOCATEERROR;
-                }
-            } else {
-                // New scatter request; allocate buffer and populate it from
-                // client
-                uint64_t offsetB = 0;
-                uint64_t bufferSize =
-                    msgPointer->snElements * msgPointer->selementSize;
-                try {
-                    offsetB = allocator->allocate(ATOMIC_REGION_ID, bufferSize);
-                    msgPointer->flag |= ATOMIC_BUFFER_ALLOCATED;
-                    // Update the message with the region and offset of buffer
-                    msgPointer->offsetBuffer = offsetB;
-                    try {
-                        localPointerB = allocator->get_local_pointer(
-                            ATOMIC_REGION_ID, offsetB);
-                        // Populate buffer from client's memory
-                        localPointerB = allocator->get_local_pointer(
-                            ATOMIC_REGION_ID, offsetB);
-                        try {
-                            retStatus = fabric_read(
-                                msgPointer->key, localPointerB, bufferSize, 0,
-                                fiAddr,
-                                famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                            try {
-                                openfam_persist(localPointerB, bufferSize);
-                                // Set the flag to indicate write is in progress
-                                msgPointer->flag |= ATOMIC_WRITE_IN_PROGRESS;
-                                openfam_persist(msgPointer,
-                                                sizeof(msgPointer->flag));
-                            } catch (...) {
-                                retStatus = PERSISTERROR;
-                            }
-                        } catch (...) {
-                            retStatus = FABRICREADERROR;
-                        }
-                    } catch (...) {
-                        retStatus = MAPERROR;
-                    }
-                } catch (...) {
-                    retStatus = DEALLOCATEERROR;
-                }
-                // Send the status back to client
-                try {
-                    fabric_send_response(
-                        &retStatus, fiAddr,
-                        famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                        sizeof(retStatus));
-                } catch (...) {
-                    retStatus = SENDTOCLIENTERROR;
-                }
-            }
-            // Get the pointer to the target and copy using stride and first
-            // element
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset);
-                for (uint64_t numElements = 0;
-                     numElements < msgPointer->snElements; ++numElements) {
-                    uint64_t srcIndex = numElements * msgPointer->selementSize;
-                    uint64_t destIndex = (msgPointer->firstElement +
-                                          msgPointer->stride * numElements) *
-                                         msgPointer->selementSize;
-                    memcpy((char *)localPointerD + destIndex,
-                           (char *)localPointerB + srcIndex,
-                           msgPointer->selementSize);
-                    try {
-                        openfam_persist((char *)localPointerD + destIndex,
-                                        msgPointer->selementSize);
-                    } catch (...) {
-                        popStatus = PERSISTERROR;
-                    }
-                }
-                // Clear the flags to indicate write is complete
-                msgPointer->flag |= ATOMIC_WRITE_COMPLETED;
-                msgPointer->flag &= ~ATOMIC_WRITE_IN_PROGRESS;
-                try {
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                } catch (...) {
-                    popStatus = PERSISTERROR;
-                }
-            } catch (...) {
-                popStatus = MAPERROR;
-            }
-            // Deallocate source data item and index array
-            try {
-                allocator->deallocate(ATOMIC_REGION_ID,
-                                      msgPointer->offsetBuffer);
-                msgPointer->flag &= ~ATOMIC_BUFFER_ALLOCATED;
-                try {
-                    openfam_persist(msgPointer, sizeof(msgPointer->flag));
-                } catch (...) {
-                    ret = PERSISTERROR;
-                }
-            } catch (...) {
-                ret = DEALLOCATEERROR;
-            }
-
-            break;
+        // Skip the requests already processed, and those whose client can
+        // not be reached
+        bool process[ATL_BATCH_SIZE];
+        for (int i = 0; i < count; i++) {
+            atomicMsg *msgPointer = reqs[i].msgPointer;
+            process[i] =
+                !(msgPointer->flag & ATOMIC_REQUEST_DONE) &&
+                (get_client_addr(msgPointer, &addrCache, &reqs[i].fiAddr) ==
+                 0);
+        }
 
-        case ATOMIC_GATHER_INDEX: {
-            uint64_t bufferSize;
-            void *bufferPtr = NULL;
-            // Gather - Indexed; Map data item and retrieve indexes
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset);
-                localPointerI = allocator->get_local_pointer(
-                    ATOMIC_REGION_ID, msgPointer->offsetIndex);
-                bufferSize = msgPointer->inElements * msgPointer->ielementSize;
-                bufferPtr = malloc(bufferSize);
-                indexArr =
-                    parseIndex((char *)localPointerI, msgPointer->inElements);
-                // Copy data from fam to buffer using indexes
-                for (uint64_t numElements = 0;
-                     numElements < msgPointer->inElements; ++numElements) {
-                    uint64_t srcIndex =
-                        indexArr[numElements] * msgPointer->ielementSize;
-                    uint64_t destIndex = numElements * msgPointer->ielementSize;
-                    memcpy((char *)bufferPtr + destIndex,
-                           (char *)localPointerD + srcIndex,
-                           msgPointer->ielementSize);
-                }
-                // Copy data to client's memory
-                try {
-                    retStatus = fabric_write(
-                        msgPointer->key, bufferPtr, bufferSize, 0, fiAddr,
-                        famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                } catch (...) {
-                    retStatus = FABRICWRITEERROR;
-                }
-            } catch (...) {
-                retStatus = MAPERROR;
-            }
-            // Send the status of the request to client
+        for (int i = 0; i < count; i++)
+            if (process[i])
+                start_request(&reqs[i], queue, allocator, ctx);
+        complete_transfers(reqs, count, ctx);
+        for (int i = 0; i < count; i++)
+            if (process[i])
+                finish_request(&reqs[i], queue, allocator, ctx);
+        for (int i = 0; i < count; i++) {
+            if (!reqs[i].sendCtx)
+                continue;
             try {
-                fabric_send_response(
-                    &retStatus, fiAddr,
-                    famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                    sizeof(retStatus));
+                fabric_send_response_wait(ctx, reqs[i].sendCtx);
             } catch (...) {
-                ret = SENDTOCLIENTERROR;
             }
-            if (bufferPtr)
-                free(bufferPtr);
-            if (indexArr)
-                free(indexArr);
-        } break;
+        }
 
-        case ATOMIC_GATHER_STRIDE: {
-            // Gather - Strided; Map data item
-            uint64_t bufferSize;
-            void *bufferPtr = NULL;
-            try {
-                localPointerD = allocator->get_local_pointer(
-                    msgPointer->dstDataGdesc.regionId,
-                    msgPointer->dstDataGdesc.offset);
-                bufferSize = msgPointer->snElements * msgPointer->selementSize;
-                bufferPtr = malloc(bufferSize);
-                // Copy data from fam to buffer using first element and stride
-                for (uint64_t numElements = 0;
-                     numElements < msgPointer->snElements; ++numElements) {
-                    uint64_t destIndex = numElements * msgPointer->selementSize;
-                    uint64_t srcIndex = (msgPointer->firstElement +
-                                         msgPointer->stride * numElements) *
-                                        msgPointer->selementSize;
-                    memcpy((char *)bufferPtr + destIndex,
-                           (char *)localPointerD + srcIndex,
-                           msgPointer->selementSize);
-                }
-                // Copy data back to client's memory
-                try {
-                    retStatus = fabric_write(
-                        msgPointer->key, bufferPtr, bufferSize, 0, fiAddr,
-                        famOpsLibfabricQ->get_defaultCtx(uint64_t(0)));
-                } catch (...) {
-                    retStatus = FABRICWRITEERROR;
-                }
-            } catch (...) {
-                retStatus = MAPERROR;
-            }
-            // Send return status back to client
-            try {
-                fabric_send_response(
-                    &retStatus, fiAddr,
-                    famOpsLibfabricQ->get_defaultCtx(uint64_t(0)),
-                    sizeof(retStatus));
-            } catch (...) {
-                ret = SENDTOCLIENTERROR;
+        // Pop the requests which are processed successfully (popStatus = 0),
+        // up to the first one which failed; it is retried next. The
+        // requests after it are marked done so that they are not redone.
+        int numDone = 0;
+        while (numDone < count && reqs[numDone].popStatus == 0)
+            numDone++;
+        for (int i = numDone + 1; i < count; i++) {
+            atomicMsg *msgPointer = reqs[i].msgPointer;
+            if (reqs[i].popStatus == 0) {
+                msgPointer->flag |= ATOMIC_REQUEST_DONE;
+                openfam_persist(msgPointer, sizeof(msgPointer->flag));
             }
-            if (bufferPtr)
-                free(bufferPtr);
-        } break;
-
-        default:
-            break;
         }
-        // Remove the element from the queue
-        if (remoteAddr)
-            free(remoteAddr);
-        // Pop the requests which are processed successfully (popStatus = 0)
-        if (popStatus == 0)
-            ret = atomicQ[lcTInfo->qId].pop(&item);
+        if (numDone)
+            queue->pop(numDone);
     }
     return 0;
 }
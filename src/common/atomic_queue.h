@@ -35,6 +35,7 @@
 #include <atomic>
 #include <fam/fam.h>
 #include <fam/fam_exception.h>
+#include <vector>
 
 #define MAX_NODE_ADDR_SIZE 64 //#define FT_MAX_CTRL_MSG 64
 #define MAX_DATA_IN_MSG 128
@@ -42,6 +43,16 @@
 #define ATOMIC_REGION "ATOMIC_REGION"
 #define ATOMIC_REGION_ID 17
 #define MAX_ATOMIC_THREADS 256
+// Maximum number of requests a processing thread takes from its queue at once
+#define ATL_BATCH_SIZE 16
+// Number of polls of an empty queue before its processing thread parks
+#define ATL_SPIN_COUNT 128
+// Identifies a queue in the ring layout ("ATLRING1")
+#define ATL_RING_MAGIC 0x41544c52494e4731ULL
+#define ATL_CACHE_LINE 64
+// Size of the chunks of the slab of a queue, which holds the payloads too
+// large for their slot
+#define ATL_SLAB_CHUNK_SIZE (64 * 1024)
 using namespace std;
 namespace openfam {
 // flag in atomicMsg structure;
@@ -58,6 +69,9 @@ enum flag {
     ATOMIC_WRITE_COMPLETED = 128,
     ATOMIC_BUFFER_ALLOCATED = 256,
     ATOMIC_CONTAIN_DATA = 512,
+    // Processed, but not removed from the queue yet
+    ATOMIC_REQUEST_DONE = 1024,
+    ATOMIC_INDEX_ALLOCATED = 2048,
 };
 /*
  * Atomic request structure
@@ -66,14 +80,14 @@ enum flag {
  * nodeAddrSize: client Node address size
  * dstDataGdesc: target data item global descriptor
  * key: Key of the client memory to read/write
- * offsetBuffer: offset of the buffer data item
+ * offsetBuffer: offset of the buffer (eager data or data read from client)
  * offset: offset to target data item for get/put
  * size: size of target data item for get/put
  * snElements: number of elements for strided scatter/gather
  * firstElement: first element for strided scatter/gather
  * stride: stride for strided scatter/gather
  * selementSize: size of element for strided scatter/gather
- * offsetIndex: offset of the index data item for indexed scatter/gather
+ * offsetIndex: offset of the index list for indexed scatter/gather
  * inElements: index elements for indexed scatter/gather
  * ielementSize: size of element for indexed scatter/gather
  */
@@ -108,36 +122,95 @@ typedef struct threadInfo {
     uint32_t qId;
 } tInfo;
 
-struct qData {
+/*
+ * Slot of the ring of a queue : a message followed by payloadSize bytes in
+ * which its payloads (eager data, index list, buffer) are kept if they fit.
+ * seq: number of the message in the slot plus one, written last by push
+ * payloadUsed: bytes of the payload area in use
+ */
+typedef struct atomicSlot {
+    atomicMsg msg;
+    uint64_t seq;
+    uint64_t payloadUsed;
+} atomicSlot;
+
+/*
+ * Persistent header of a queue. Messages are numbered in the order they are
+ * pushed, message n being in slot n % capacity. head is the number of the
+ * first message not processed yet; the processing thread persists it once
+ * for each batch of messages it removes. The end of the queue is found
+ * again from the sequence numbers of the slots.
+ */
+struct qRing {
+    uint64_t magic;
+    uint32_t capacity;
+    uint32_t payloadSize;
+    uint64_t slotSize;
+    uint64_t offsetSlots;
+    uint64_t offsetSlab;
+    uint64_t slabChunks;
+    uint64_t slabChunkSize;
+    uint64_t head;
+};
+
+/*
+ * Header of a queue in the layout used before the ring : an array of the
+ * offsets of capacity messages, size of them queued from front. The index
+ * list of an indexed scatter is a comma separated string. Such a queue is
+ * recovered and replaced by a ring when it is opened.
+ */
+struct qDataV1 {
     int64_t front;
     int64_t rear;
     uint32_t capacity;
-    atomic_uint size;
+    uint32_t size;
     uint64_t offsetArray;
 };
+
 class atomicQueue {
   private:
     uint32_t qId;
     Memserver_Allocator *allocator;
-    void *pointerA, *pointerQ;
+    struct qRing *ring;
+    char *slots;
+    // Next message to process, and next message to push
+    alignas(ATL_CACHE_LINE) std::atomic<uint64_t> head;
+    alignas(ATL_CACHE_LINE) std::atomic<uint64_t> tail;
+    // Free chunks of the slab
+    alignas(ATL_CACHE_LINE) pthread_mutex_t slabLock;
+    std::vector<uint64_t> freeChunks;
+    std::vector<bool> chunkUsed;
+
+    int create_ring(uint64_t *offsetQ);
+    int recover_legacy(struct qDataV1 *legacy,
+                       std::vector<uint64_t> *payloads);
+    void free_legacy(uint64_t offsetQ, struct qDataV1 *legacy,
+                     const std::vector<uint64_t> &payloads);
+    atomicSlot *get_slot(uint64_t n);
+    void init_slab();
+    void free_payload(uint64_t offset);
 
   public:
     atomicQueue() {}
     int create(Memserver_Allocator *inp_allocator, const uint32_t in_qid);
     int push(atomicMsg *item, const void *inpDataSG);
-    int read(Fam_Global_Descriptor *gitem);
-    int pop(Fam_Global_Descriptor *item);
+    int read(Fam_Global_Descriptor *gitem, uint32_t index = 0);
+    int pop(uint32_t count = 1);
     bool isQempty();
+    uint64_t alloc_payload(atomicMsg *msgPointer, uint64_t size);
+    void release_payloads(atomicMsg *msgPointer);
 };
 
 extern int numAtomicThreads;
 extern uint64_t memoryPerThread;
 extern int queueCapacity;
+extern uint64_t slotPayloadSize;
 extern pthread_t atid[MAX_ATOMIC_THREADS];
 extern atomicQueue atomicQ[MAX_ATOMIC_THREADS];
 extern tInfo atomicTInfo[MAX_ATOMIC_THREADS];
 extern Fam_Ops_Libfabric *famOpsLibfabricQ;
 void *process_queue(void *);
+int atl_batch_size(atomicMsg *const *msgs, int count);
 extern void *atomicRegionIdRoot;
 extern pthread_rwlock_t fiAddrLock;
 
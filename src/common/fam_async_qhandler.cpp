@@ -45,23 +45,46 @@
 #define AQUIRE_MUTEX(mtx) std::unique_lock<std::mutex> lk(mtx);
 #endif
 
+#include <algorithm>
 #include <iostream>
+#include <string.h>
+#include <thread>
 
 #include "common/fam_async_qhandler.h"
 #include "common/fam_internal_exception.h"
+
+// Number of polls of the queue (or of a context's completion counters) made
+// by a consumer (or a quiet) before it parks on a condition variable
+#define FAM_ASYNC_SPIN_COUNT 128
+
 namespace openfam {
 
+/*
+ * A large operation split into chunks. Threads claim chunks by advancing
+ * next; the thread copying the last bytes completes the operation and the
+ * last thread to drop its reference frees it.
+ */
+struct Fam_Chunked_Op {
+    Fam_Ops_Info opsInfo;
+    uint64_t chunkSize;
+    bool nonTemporal;
+    bool blocking;
+    boost::atomic<uint64_t> next;
+    boost::atomic<uint64_t> remaining;
+    boost::atomic<uint64_t> refs;
+    boost::atomic<bool> done;
+};
+
 class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
   public:
     FamAsyncQHandlerImpl_(uint64_t numConsumer) {
-        readCtr = 0;
-        writeCtr = 0;
-        readErrCtr = 0;
-        writeErrCtr = 0;
         run = true;
+        numSleepers = 0;
+        numQuietWaiters = 0;
+        numConsumers = numConsumer;
+        chunkSize = FAM_DEFAULT_SHM_COPY_CHUNK_SIZE;
+        nonTemporalThreshold = 0;
         queue = new boost::lockfree::queue<Fam_Ops_Info>(1024);
-        readCQ = new boost::lockfree::queue<Fam_Async_Err *>(1024);
-        writeCQ = new boost::lockfree::queue<Fam_Async_Err *>(1024);
         for (uint64_t i = 0; i < numConsumer; i++) {
             consumerThreads.create_thread(boost::bind(
                 &FamAsyncQHandlerImpl_::nonblocking_ops_handler, this));
@@ -69,84 +92,77 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
     }
 
     ~FamAsyncQHandlerImpl_() {
-        run = false;
+        {
+            AQUIRE_MUTEX(queueMtx);
+            run = false;
+            queueCond.notify_all();
+        }
         consumerThreads.join_all();
         delete queue;
     }
 
+    void set_chunking(uint64_t chunk, uint64_t nonTemporal) {
+        chunkSize = chunk;
+        nonTemporalThreshold = nonTemporal;
+    }
+
+    /*
+     * Consumers poll the queue for a while before parking, so that a steady
+     * stream of operations never goes through queueMtx.
+     */
     void nonblocking_ops_handler(void) {
         Fam_Ops_Info opsInfo;
 
         while (run) {
-            if (queue->pop(opsInfo))
+            bool found = false;
+            for (int i = 0; i < FAM_ASYNC_SPIN_COUNT; i++) {
+                if (queue->pop(opsInfo)) {
+                    found = true;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if (found) {
                 decode_and_execute(opsInfo);
-            {
-                AQUIRE_MUTEX(queueMtx);
-                while (queue->empty())
-                    queueCond.wait(lk);
+                continue;
             }
+            AQUIRE_MUTEX(queueMtx);
+            numSleepers.fetch_add(1, boost::memory_order_seq_cst);
+            while (run && queue->empty())
+                queueCond.wait(lk);
+            numSleepers.fetch_sub(1, boost::memory_order_seq_cst);
         }
     }
 
     void initiate_operation(Fam_Ops_Info opsInfo) {
         queue->push(opsInfo);
-        {
-            AQUIRE_MUTEX(queueMtx);
-            queueCond.notify_one();
-        }
+        wake_consumers(false);
         return;
     }
 
+    /*
+     * Wait for the operations issued on famCtx to complete, and report the
+     * first error any of them hit.
+     */
     void quiet(Fam_Context *famCtx) {
-
-        qreadCtr = famCtx->get_num_rx_ops();
-        qwriteCtr = famCtx->get_num_tx_ops();
-        write_quiet(famCtx->get_num_tx_ops());
-        read_quiet(famCtx->get_num_rx_ops());
-
+        write_quiet(famCtx);
+        read_quiet(famCtx);
+        int errorCode;
+        std::string errorMsg;
+        if (famCtx->get_async_error(&errorCode, &errorMsg))
+            THROW_ERRNO_MSG(Fam_Datapath_Exception, (Fam_Error)errorCode,
+                            errorMsg.c_str());
         return;
     }
 
-    void write_quiet(uint64_t ctr) {
-        {
-            AQUIRE_MUTEX(writeMtx);
-            while (!(ctr == writeCtr.load(boost::memory_order_seq_cst))) {
-                writeCond.wait(lk);
-            }
-        }
-        if (writeErrCtr.load(boost::memory_order_seq_cst) != 0) {
-            writeErrCtr.store(0, boost::memory_order_seq_cst);
-            Fam_Async_Err *err;
-            while (writeCQ->pop(err)) {
-                if (!(err->get_error_code()))
-                    return;
-                else
-                    THROW_ERRNO_MSG(Fam_Datapath_Exception,
-                                    err->get_error_code(),
-                                    err->get_error_msg());
-            }
-        }
+    void write_quiet(Fam_Context *famCtx) {
+        uint64_t ctr = famCtx->get_num_tx_ops();
+        wait_for_completion(famCtx, ctr, true);
     }
 
-    void read_quiet(uint64_t ctr) {
-        {
-            AQUIRE_MUTEX(readMtx);
-            while (!(ctr == readCtr.load(boost::memory_order_seq_cst))) {
-                readCond.wait(lk);
-            }
-        }
-        if (readErrCtr.load(boost::memory_order_seq_cst) != 0) {
-            readErrCtr.store(0, boost::memory_order_seq_cst);
-            Fam_Async_Err *err;
-            while (readCQ->pop(err)) {
-                if (!(err->get_error_code()))
-                    return;
-                else
-                    THROW_ERRNO_MSG(Fam_Datapath_Exception,
-                                    err->get_error_code(),
-                                    err->get_error_msg());
-            }
-        }
+    void read_quiet(Fam_Context *famCtx) {
+        uint64_t ctr = famCtx->get_num_rx_ops();
+        wait_for_completion(famCtx, ctr, false);
     }
 
     void wait_for_copy(void *waitObj) {
@@ -157,21 +173,57 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
                 copyCond.wait(lk);
             }
         }
+        int errorCode = tag->errorCode;
+        std::string errorMsg = tag->errorMsg;
+        if (!errorCode &&
+            tag->progress.cancelled.load(std::memory_order_acquire) &&
+            (tag->progress.bytesCopied.load(std::memory_order_acquire) <
+             tag->size)) {
+            errorCode = FAM_ERR_CANCELED;
+            errorMsg = "copy was cancelled";
+        }
+        free(tag->srcAddr);
+        delete tag;
+        if (errorCode)
+            THROW_ERRNO_MSG(Fam_Datapath_Exception, (Fam_Error)errorCode,
+                            errorMsg.c_str());
         return;
     }
 
+    /*
+     * A copy run by a memory server reports its progress there; it is only
+     * known locally once the copy is done.
+     */
+    uint64_t copy_progress(void *waitObj) {
+        Fam_Copy_Tag *tag = static_cast<Fam_Copy_Tag *>(waitObj);
+        if (tag->memoryService && tag->progress.copyId &&
+            !tag->copyDone.load(boost::memory_order_seq_cst))
+            return std::max(
+                tag->memoryService->copy_progress(tag->progress.copyId),
+                tag->progress.bytesCopied.load(std::memory_order_acquire));
+        return tag->progress.bytesCopied.load(std::memory_order_acquire);
+    }
+
+    void cancel_copy(void *waitObj) {
+        Fam_Copy_Tag *tag = static_cast<Fam_Copy_Tag *>(waitObj);
+        tag->progress.cancelled.store(true, std::memory_order_release);
+        if (tag->memoryService && tag->progress.copyId &&
+            !tag->copyDone.load(boost::memory_order_seq_cst))
+            tag->memoryService->cancel_copy(tag->progress.copyId);
+    }
+
     void decode_and_execute(Fam_Ops_Info opsInfo) {
         switch (opsInfo.opsType) {
         case WRITE: {
             write_handler(opsInfo.src, opsInfo.dest, opsInfo.nbytes,
                           opsInfo.offset, opsInfo.upperBound, opsInfo.key,
-                          opsInfo.itemSize);
+                          opsInfo.itemSize, opsInfo.famCtx);
             break;
         }
         case READ: {
             read_handler(opsInfo.src, opsInfo.dest, opsInfo.nbytes,
                          opsInfo.offset, opsInfo.upperBound, opsInfo.key,
-                         opsInfo.itemSize);
+                         opsInfo.itemSize, opsInfo.famCtx);
             break;
         }
         case COPY: {
@@ -179,6 +231,11 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
                          opsInfo.tag);
             break;
         }
+        case CHUNK: {
+            copy_chunks(opsInfo.chunkedOp);
+            release_chunked_op(opsInfo.chunkedOp);
+            break;
+        }
         default: {
             THROW_ERRNO_MSG(Fam_Datapath_Exception, FAM_ERR_INVALIDOP,
                             "invalid operation request");
@@ -188,105 +245,285 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
     }
 
     void write_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                       uint64_t upperBound, uint64_t key, uint64_t itemSize) {
-        bool isError = false;
-        Fam_Async_Err *err = new Fam_Async_Err();
+                       uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                       Fam_Context *famCtx) {
         if ((offset > itemSize) || (upperBound > itemSize)) {
-            err->set_error_code(FAM_ERR_OUTOFRANGE);
-            err->set_error_msg("offset or data size is out of bound");
-            writeErrCtr++;
-            isError = true;
+            famCtx->set_async_error(FAM_ERR_OUTOFRANGE,
+                                    "offset or data size is out of bound");
         } else if ((key & FAM_WRITE_KEY_SHM) != FAM_WRITE_KEY_SHM) {
-            err->set_error_code(FAM_ERR_NOPERM);
-            err->set_error_msg("not permitted to write into dataitem");
-            writeErrCtr++;
-            isError = true;
-        }
-
-        if (isError) {
-            writeCQ->push(err);
+            famCtx->set_async_error(FAM_ERR_NOPERM,
+                                    "not permitted to write into dataitem");
         } else {
-            memcpy(dest, src, nbytes);
-            openfam_persist(dest, nbytes);
-            delete err;
-        }
-
-        {
-            AQUIRE_MUTEX(writeMtx);
-            writeCtr++;
+            if (split_operation(WRITE, src, dest, nbytes, NULL, famCtx))
+                return;
+            copy_range(WRITE, src, dest, nbytes, use_nontemporal(nbytes));
         }
-        if (qwriteCtr == writeCtr)
-            writeCond.notify_one();
+        write_done(famCtx);
         return;
     }
 
+    void write_done(Fam_Context *famCtx) {
+        famCtx->inc_num_tx_done();
+        wake_quiet_waiters();
+    }
+
     void read_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                      uint64_t upperBound, uint64_t key, uint64_t itemSize) {
-        bool isError = false;
-        Fam_Async_Err *err = new Fam_Async_Err();
+                      uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                      Fam_Context *famCtx) {
         if ((offset > itemSize) || (upperBound > itemSize)) {
-            err->set_error_code(FAM_ERR_OUTOFRANGE);
-            err->set_error_msg("offset or data size is out of bound");
-            readErrCtr++;
-            isError = true;
+            famCtx->set_async_error(FAM_ERR_OUTOFRANGE,
+                                    "offset or data size is out of bound");
         } else if ((key & FAM_READ_KEY_SHM) != FAM_READ_KEY_SHM) {
-            err->set_error_code(FAM_ERR_NOPERM);
-            err->set_error_msg("not permitted to read from dataitem");
-            readErrCtr++;
-            isError = true;
-        }
-
-        if (isError) {
-            readCQ->push(err);
+            famCtx->set_async_error(FAM_ERR_NOPERM,
+                                    "not permitted to read from dataitem");
         } else {
-            openfam_invalidate(src, nbytes);
-            memcpy(dest, src, nbytes);
-            delete err;
+            if (split_operation(READ, src, dest, nbytes, NULL, famCtx))
+                return;
+            copy_range(READ, src, dest, nbytes, false);
         }
-
-        {
-            AQUIRE_MUTEX(readMtx);
-            readCtr++;
-        }
-        if (qreadCtr == readCtr)
-            readCond.notify_one();
+        read_done(famCtx);
         return;
     }
 
+    void read_done(Fam_Context *famCtx) {
+        famCtx->inc_num_rx_done();
+        wake_quiet_waiters();
+    }
+
     void copy_handler(void *src, void *dest, uint64_t nbytes,
                       Fam_Copy_Tag *tag) {
-        if (tag->memoryService)
-            tag->memoryService->copy(
-                tag->srcRegionId, tag->srcOffset, tag->srcKey,
-                tag->srcCopyStart, tag->srcAddr, tag->srcAddrLen,
-                tag->destRegionId, tag->destOffset, tag->size,
-                tag->srcMemserverId, tag->destMemserverId);
-        else {
-            memcpy(dest, src, nbytes);
-            openfam_persist(dest, nbytes);
+        if (tag->memoryService) {
+            try {
+                tag->memoryService->copy(
+                    tag->srcRegionId, tag->srcOffset, tag->srcKey,
+                    tag->srcCopyStart, tag->srcAddr, tag->srcAddrLen,
+                    tag->destRegionId, tag->destOffset, tag->size,
+                    tag->srcMemserverId, tag->destMemserverId,
+                    &tag->progress);
+            } catch (Fam_Exception &e) {
+                tag->errorCode = e.fam_error();
+                tag->errorMsg = e.fam_error_msg();
+            }
+        } else if (!tag->progress.cancelled.load(std::memory_order_acquire)) {
+            if (split_operation(COPY, src, dest, nbytes, tag, NULL))
+                return;
+            copy_range(COPY, src, dest, nbytes, use_nontemporal(nbytes));
+            tag->progress.bytesCopied.store(nbytes, std::memory_order_release);
         }
+        copy_done(tag);
+        return;
+    }
+
+    void copy_done(Fam_Copy_Tag *tag) {
         {
             AQUIRE_MUTEX(copyMtx)
             tag->copyDone.store(true, boost::memory_order_seq_cst);
         }
         copyCond.notify_one();
-        return;
+    }
+
+    void blocking_copy(Fam_Ops_Type opsType, void *src, void *dest,
+                       uint64_t nbytes) {
+        if (!should_split(nbytes) || (numConsumers == 0)) {
+            copy_range(opsType, src, dest, nbytes, use_nontemporal(nbytes));
+            return;
+        }
+        Fam_Chunked_Op *op =
+            new_chunked_op(opsType, src, dest, nbytes, NULL, NULL, true);
+        start_helpers(op, numConsumers);
+        copy_chunks(op);
+        {
+            AQUIRE_MUTEX(chunkMtx);
+            while (!op->done.load(boost::memory_order_seq_cst))
+                chunkCond.wait(lk);
+        }
+        release_chunked_op(op);
     }
 
   private:
+    // Wake a parked consumer if there is one; all of them if wakeAll.
+    void wake_consumers(bool wakeAll) {
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        if (numSleepers.load(boost::memory_order_seq_cst) == 0)
+            return;
+        AQUIRE_MUTEX(queueMtx);
+        if (wakeAll)
+            queueCond.notify_all();
+        else
+            queueCond.notify_one();
+    }
+
+    void wake_quiet_waiters() {
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        if (numQuietWaiters.load(boost::memory_order_seq_cst) == 0)
+            return;
+        AQUIRE_MUTEX(doneMtx);
+        doneCond.notify_all();
+    }
+
+    bool is_complete(Fam_Context *famCtx, uint64_t ctr, bool tx) {
+        uint64_t done =
+            tx ? famCtx->get_num_tx_done() : famCtx->get_num_rx_done();
+        return done >= ctr;
+    }
+
+    void wait_for_completion(Fam_Context *famCtx, uint64_t ctr, bool tx) {
+        for (int i = 0; i < FAM_ASYNC_SPIN_COUNT; i++) {
+            if (is_complete(famCtx, ctr, tx))
+                return;
+            std::this_thread::yield();
+        }
+        AQUIRE_MUTEX(doneMtx);
+        numQuietWaiters.fetch_add(1, boost::memory_order_seq_cst);
+        while (!is_complete(famCtx, ctr, tx))
+            doneCond.wait(lk);
+        numQuietWaiters.fetch_sub(1, boost::memory_order_seq_cst);
+    }
+
+    bool should_split(uint64_t nbytes) {
+        return (chunkSize != 0) && (nbytes > chunkSize);
+    }
+
+    bool use_nontemporal(uint64_t nbytes) {
+        return (nonTemporalThreshold != 0) && (nbytes >= nonTemporalThreshold);
+    }
+
+    void copy_range(Fam_Ops_Type opsType, void *src, void *dest,
+                    uint64_t nbytes, bool nonTemporal) {
+        if (opsType == READ) {
+            openfam_invalidate(src, nbytes);
+            memcpy(dest, src, nbytes);
+        } else {
+            if (nonTemporal)
+                openfam_memcpy_nontemporal(dest, src, nbytes);
+            else
+                memcpy(dest, src, nbytes);
+            openfam_persist(dest, nbytes);
+        }
+    }
+
+    Fam_Chunked_Op *new_chunked_op(Fam_Ops_Type opsType, void *src,
+                                   void *dest, uint64_t nbytes,
+                                   Fam_Copy_Tag *tag, Fam_Context *famCtx,
+                                   bool blocking) {
+        Fam_Chunked_Op *op = new Fam_Chunked_Op();
+        Fam_Ops_Info opsInfo = {opsType, src, dest, nbytes, 0,   0,
+                                0,       0,   tag,  famCtx, NULL};
+        op->opsInfo = opsInfo;
+        op->chunkSize = chunkSize;
+        op->nonTemporal = use_nontemporal(nbytes);
+        op->blocking = blocking;
+        op->next.store(0, boost::memory_order_seq_cst);
+        op->remaining.store(nbytes, boost::memory_order_seq_cst);
+        op->refs.store(1, boost::memory_order_seq_cst);
+        op->done.store(false, boost::memory_order_seq_cst);
+        return op;
+    }
+
+    /*
+     * Queue up to maxHelpers requests for consumer threads to join the
+     * copy of op; there is no point in more helpers than chunks left.
+     */
+    void start_helpers(Fam_Chunked_Op *op, uint64_t maxHelpers) {
+        uint64_t numChunks =
+            (op->opsInfo.nbytes + op->chunkSize - 1) / op->chunkSize;
+        uint64_t helpers = std::min(maxHelpers, numChunks - 1);
+        op->refs.fetch_add(helpers, boost::memory_order_seq_cst);
+        Fam_Ops_Info opsInfo = {CHUNK, NULL, NULL, 0,    0,
+                                0,     0,    0,    NULL, NULL, op};
+        for (uint64_t i = 0; i < helpers; i++)
+            queue->push(opsInfo);
+        wake_consumers(true);
+    }
+
+    /*
+     * Split a nonblocking operation picked up by this consumer thread across
+     * all consumer threads. Returns false if the operation is not split.
+     */
+    bool split_operation(Fam_Ops_Type opsType, void *src, void *dest,
+                         uint64_t nbytes, Fam_Copy_Tag *tag,
+                         Fam_Context *famCtx) {
+        if (!should_split(nbytes) || (numConsumers < 2))
+            return false;
+        Fam_Chunked_Op *op =
+            new_chunked_op(opsType, src, dest, nbytes, tag, famCtx, false);
+        start_helpers(op, numConsumers - 1);
+        copy_chunks(op);
+        release_chunked_op(op);
+        return true;
+    }
+
+    void copy_chunks(Fam_Chunked_Op *op) {
+        Fam_Ops_Info &opsInfo = op->opsInfo;
+        while (true) {
+            uint64_t start =
+                op->next.fetch_add(op->chunkSize, boost::memory_order_seq_cst);
+            if (start >= opsInfo.nbytes)
+                break;
+            uint64_t len = std::min(op->chunkSize, opsInfo.nbytes - start);
+            // The chunks of a cancelled copy are still claimed, but not
+            // copied, so that the operation completes.
+            Fam_Copy_Tag *tag = opsInfo.tag;
+            if (!tag ||
+                !tag->progress.cancelled.load(std::memory_order_acquire)) {
+                copy_range(opsInfo.opsType,
+                           (void *)((uint64_t)opsInfo.src + start),
+                           (void *)((uint64_t)opsInfo.dest + start), len,
+                           op->nonTemporal);
+                if (tag)
+                    tag->progress.bytesCopied.fetch_add(
+                        len, std::memory_order_acq_rel);
+            }
+            if (op->remaining.fetch_sub(len, boost::memory_order_seq_cst) ==
+                len)
+                complete_chunked_op(op);
+        }
+    }
+
+    void complete_chunked_op(Fam_Chunked_Op *op) {
+        if (op->blocking) {
+            {
+                AQUIRE_MUTEX(chunkMtx);
+                op->done.store(true, boost::memory_order_seq_cst);
+            }
+            chunkCond.notify_all();
+            return;
+        }
+        switch (op->opsInfo.opsType) {
+        case WRITE:
+            write_done(op->opsInfo.famCtx);
+            break;
+        case READ:
+            read_done(op->opsInfo.famCtx);
+            break;
+        case COPY:
+            copy_done(op->opsInfo.tag);
+            break;
+        case CHUNK:
+            break;
+        }
+    }
+
+    void release_chunked_op(Fam_Chunked_Op *op) {
+        if (op->refs.fetch_sub(1, boost::memory_order_seq_cst) == 1)
+            delete op;
+    }
+
     boost::lockfree::queue<Fam_Ops_Info> *queue;
-    boost::lockfree::queue<Fam_Async_Err *> *readCQ, *writeCQ;
     boost::thread_group consumerThreads;
 #ifdef USE_BOOST_FIBER
-    boost::fibers::condition_variable readCond, writeCond, copyCond, queueCond;
-    boost::fibers::mutex readMtx, writeMtx, copyMtx, queueMtx;
+    boost::fibers::condition_variable doneCond, copyCond, queueCond, chunkCond;
+    boost::fibers::mutex doneMtx, copyMtx, queueMtx, chunkMtx;
 #else
-    std::condition_variable readCond, writeCond, copyCond, queueCond;
-    std::mutex readMtx, writeMtx, copyMtx, queueMtx;
+    std::condition_variable doneCond, copyCond, queueCond, chunkCond;
+    std::mutex doneMtx, copyMtx, queueMtx, chunkMtx;
 #endif
-    boost::atomic_uint64_t readCtr, writeCtr, readErrCtr, writeErrCtr,
-        qwriteCtr, qreadCtr;
+    // Parked consumer threads and threads parked in quiet
+    boost::atomic_uint64_t numSleepers, numQuietWaiters;
     boost::atomic<bool> run;
+    uint64_t numConsumers;
+    uint64_t chunkSize;
+    uint64_t nonTemporalThreshold;
 };
 
 Fam_Async_QHandler::Fam_Async_QHandler(uint64_t numConsumer) {
@@ -295,6 +532,11 @@ Fam_Async_QHandler::Fam_Async_QHandler(uint64_t numConsumer) {
 
 Fam_Async_QHandler::~Fam_Async_QHandler() { delete fAsyncQHandler_; }
 
+void Fam_Async_QHandler::set_chunking(uint64_t chunkSize,
+                                      uint64_t nonTemporalThreshold) {
+    fAsyncQHandler_->set_chunking(chunkSize, nonTemporalThreshold);
+}
+
 void Fam_Async_QHandler::nonblocking_ops_handler(void) {
     fAsyncQHandler_->nonblocking_ops_handler();
 }
@@ -307,34 +549,44 @@ void Fam_Async_QHandler::quiet(Fam_Context *famCtx) {
     fAsyncQHandler_->quiet(famCtx);
 }
 
-void Fam_Async_QHandler::write_quiet(uint64_t ctr) {
-    fAsyncQHandler_->write_quiet(ctr);
+void Fam_Async_QHandler::write_quiet(Fam_Context *famCtx) {
+    fAsyncQHandler_->write_quiet(famCtx);
 }
 
-void Fam_Async_QHandler::read_quiet(uint64_t ctr) {
-    fAsyncQHandler_->read_quiet(ctr);
+void Fam_Async_QHandler::read_quiet(Fam_Context *famCtx) {
+    fAsyncQHandler_->read_quiet(famCtx);
 }
 
 void Fam_Async_QHandler::wait_for_copy(void *waitObj) {
     fAsyncQHandler_->wait_for_copy(waitObj);
 }
 
+uint64_t Fam_Async_QHandler::copy_progress(void *waitObj) {
+    return fAsyncQHandler_->copy_progress(waitObj);
+}
+
+void Fam_Async_QHandler::cancel_copy(void *waitObj) {
+    fAsyncQHandler_->cancel_copy(waitObj);
+}
+
 void Fam_Async_QHandler::decode_and_execute(Fam_Ops_Info opsInfo) {
     fAsyncQHandler_->decode_and_execute(opsInfo);
 }
 
 void Fam_Async_QHandler::write_handler(void *src, void *dest, uint64_t nbytes,
                                        uint64_t offset, uint64_t upperBound,
-                                       uint64_t key, uint64_t itemSize) {
+                                       uint64_t key, uint64_t itemSize,
+                                       Fam_Context *famCtx) {
     fAsyncQHandler_->write_handler(src, dest, nbytes, offset, upperBound, key,
-                                   itemSize);
+                                   itemSize, famCtx);
 }
 
 void Fam_Async_QHandler::read_handler(void *src, void *dest, uint64_t nbytes,
                                       uint64_t offset, uint64_t upperBound,
-                                      uint64_t key, uint64_t itemSize) {
+                                      uint64_t key, uint64_t itemSize,
+                                      Fam_Context *famCtx) {
     fAsyncQHandler_->read_handler(src, dest, nbytes, offset, upperBound, key,
-                                  itemSize);
+                                  itemSize, famCtx);
 }
 
 void Fam_Async_QHandler::copy_handler(void *src, void *dest, uint64_t nbytes,
@@ -342,4 +594,9 @@ void Fam_Async_QHandler::copy_handler(void *src, void *dest, uint64_t nbytes,
     fAsyncQHandler_->copy_handler(src, dest, nbytes, tag);
 }
 
+void Fam_Async_QHandler::blocking_copy(Fam_Ops_Type opsType, void *src,
+                                       void *dest, uint64_t nbytes) {
+    fAsyncQHandler_->blocking_copy(opsType, src, dest, nbytes);
+}
+
 } // namespace openfam
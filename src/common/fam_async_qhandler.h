@@ -46,7 +46,16 @@ using namespace std;
 
 namespace openfam {
 
-typedef enum { WRITE = 0, READ, COPY } Fam_Ops_Type;
+typedef enum { WRITE = 0, READ, COPY, CHUNK } Fam_Ops_Type;
+
+/*
+ * Default size of the chunks large memory copies are split into, so that the
+ * consumer threads copy them in parallel. 0 disables splitting.
+ */
+#define FAM_DEFAULT_SHM_COPY_CHUNK_SIZE (1024 * 1024)
+
+// State shared by the threads copying the chunks of a large operation
+struct Fam_Chunked_Op;
 
 typedef struct {
     boost::atomic<bool> copyDone;
@@ -62,6 +71,10 @@ typedef struct {
     uint32_t srcAddrLen;
     uint64_t srcMemserverId;
     uint64_t destMemserverId;
+    Fam_Copy_Progress progress;
+    // Error the copy failed with, reported by wait_for_copy
+    int errorCode;
+    std::string errorMsg;
 } Fam_Copy_Tag;
 
 typedef struct {
@@ -74,40 +87,60 @@ typedef struct {
     uint64_t key;
     uint64_t itemSize;
     Fam_Copy_Tag *tag;
+    // For WRITE and READ: the context whose completion counters are updated
+    Fam_Context *famCtx;
+    // For CHUNK: the split operation whose chunks are to be copied
+    Fam_Chunked_Op *chunkedOp;
 } Fam_Ops_Info;
 
-class Fam_Async_Err {
-  public:
-    Fam_Async_Err() : errorCode(FAM_NO_ERROR) {}
-    void set_error_code(enum Fam_Error code) { errorCode = code; }
-    void set_error_msg(const char *msg) { errorMsg = msg; }
-    Fam_Error get_error_code() { return errorCode; }
-    char const *get_error_msg() { return errorMsg.c_str(); }
-
-  private:
-    enum Fam_Error errorCode;
-    string errorMsg;
-};
-
 class Fam_Async_QHandler {
   public:
     Fam_Async_QHandler(uint64_t numConsumer);
     ~Fam_Async_QHandler();
 
+    /*
+     * Operations larger than chunkSize bytes are split into chunks of that
+     * size, copied in parallel by the consumer threads. Writes of at least
+     * nonTemporalThreshold bytes use non-temporal stores (0 disables).
+     */
+    void set_chunking(uint64_t chunkSize, uint64_t nonTemporalThreshold);
+
     void nonblocking_ops_handler();
 
     void initiate_operation(Fam_Ops_Info opsInfo);
     void quiet(Fam_Context *famCtx);
-    void write_quiet(uint64_t ctr);
-    void read_quiet(uint64_t ctr);
+    void write_quiet(Fam_Context *famCtx);
+    void read_quiet(Fam_Context *famCtx);
+    /*
+     * Wait for the copy of tag waitObj and free the tag. Throws the error
+     * the copy failed with, FAM_ERR_CANCELED if it was cancelled before all
+     * its bytes were copied.
+     */
     void wait_for_copy(void *waitObj);
+    /*
+     * Number of bytes of the copy waitObj copied so far. cancel_copy stops
+     * the copy before its next chunk, on the memory server too if the copy
+     * runs there; wait_for_copy still has to be called to wait for the
+     * chunks in flight.
+     */
+    uint64_t copy_progress(void *waitObj);
+    void cancel_copy(void *waitObj);
     void decode_and_execute(Fam_Ops_Info opsInfo);
     void write_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                       uint64_t upperBound, uint64_t key, uint64_t itemSize);
+                       uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                       Fam_Context *famCtx);
     void read_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                      uint64_t upperBound, uint64_t key, uint64_t itemSize);
+                      uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                      Fam_Context *famCtx);
     void copy_handler(void *src, void *dest, uint64_t nbytes,
                       Fam_Copy_Tag *tag);
+    /*
+     * Copy nbytes from src to dest in the calling thread, with the help of
+     * the consumer threads if the copy is large. opsType is WRITE or COPY
+     * when dest is FAM, READ when src is FAM.
+     */
+    void blocking_copy(Fam_Ops_Type opsType, void *src, void *dest,
+                       uint64_t nbytes);
 
   private:
     class FamAsyncQHandlerImpl_;
@@ -0,0 +1,414 @@
+/*
+ * fam_async_rpc_server.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_ASYNC_RPC_SERVER_H
+#define FAM_ASYNC_RPC_SERVER_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <queue>
+#include <sched.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "grpcpp/grpcpp.h"
+
+namespace openfam {
+
+#define FAM_RPC_DEFAULT_POLLERS 4
+#define FAM_RPC_DEFAULT_WORKERS 4
+
+/*
+ * Where the handler of a method runs. Each class of methods but the inline
+ * one has its own worker pool, so that a class saturating its pool never
+ * delays the methods of another.
+ */
+typedef enum {
+    // On the polling thread; methods answered from local state
+    FAM_RPC_INLINE = -1,
+    // Short methods waiting on other services (lookups, permissions, ...)
+    FAM_RPC_SHORT = 0,
+    // Region create/destroy/resize and the batch calls
+    FAM_RPC_LONG,
+    // Copies
+    FAM_RPC_COPY,
+    FAM_RPC_NUM_POOLS
+} Fam_Rpc_Method_Class;
+
+/*
+ * Threading of an asynchronous RPC server.
+ * numPollers - completion queues, each drained by its own polling thread,
+ *              which runs the FAM_RPC_INLINE methods.
+ * pollerCpus - cores the polling threads are pinned to, round robin; empty
+ *              leaves them unpinned.
+ * numWorkers - threads of the pool of each class of methods, indexed by
+ *              Fam_Rpc_Method_Class.
+ */
+typedef struct {
+    uint64_t numPollers;
+    std::vector<int> pollerCpus;
+    uint64_t numWorkers[FAM_RPC_NUM_POOLS];
+} Fam_Async_Rpc_Options;
+
+inline void init_async_rpc_options(Fam_Async_Rpc_Options &options) {
+    options.numPollers = FAM_RPC_DEFAULT_POLLERS;
+    options.pollerCpus.clear();
+    for (int i = 0; i < FAM_RPC_NUM_POOLS; i++)
+        options.numWorkers[i] = FAM_RPC_DEFAULT_WORKERS;
+}
+
+/*
+ * Parse a comma separated list of cores, with ranges ("0,2,4-7").
+ */
+inline std::vector<int> parse_cpu_list(const char *list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t dash = item.find('-');
+        if (item.empty())
+            continue;
+        int first = std::stoi(item.substr(0, dash));
+        int last = (dash == std::string::npos)
+                       ? first
+                       : std::stoi(item.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/*
+ * Command line options of the RPC threading, common to all the servers.
+ */
+#define FAM_ASYNC_RPC_OPTIONS_USAGE                                            \
+    "\t-t/--rpcthreads      : Number of RPC polling threads (default value "   \
+    "is 4)\n"                                                                  \
+    "\n"                                                                       \
+    "\t-c/--rpccpus         : Cores to pin the RPC polling threads to, e.g. "  \
+    "0,2,4-7 (default is unpinned)\n"                                          \
+    "\n"                                                                       \
+    "\t-s/--rpcshortworkers : Number of threads serving short RPCs waiting "   \
+    "on other services (default value is 4)\n"                                 \
+    "\n"                                                                       \
+    "\t-w/--rpcworkers      : Number of threads serving long RPCs (default "   \
+    "value is 4)\n"                                                            \
+    "\n"                                                                       \
+    "\t-x/--rpccopyworkers  : Number of threads serving copies (default "      \
+    "value is 4)\n"                                                            \
+    "\n"
+
+/*
+ * Consume argv[i], and its value, if it is one of the RPC threading options.
+ * Returns true if it was.
+ */
+inline bool parse_async_rpc_option(int argc, char *argv[], int &i,
+                                   Fam_Async_Rpc_Options &options) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc)
+        return false;
+    if ((arg == "-t") || (arg == "--rpcthreads"))
+        options.numPollers = strtoull(argv[++i], NULL, 0);
+    else if ((arg == "-c") || (arg == "--rpccpus"))
+        options.pollerCpus = parse_cpu_list(argv[++i]);
+    else if ((arg == "-s") || (arg == "--rpcshortworkers"))
+        options.numWorkers[FAM_RPC_SHORT] = strtoull(argv[++i], NULL, 0);
+    else if ((arg == "-w") || (arg == "--rpcworkers"))
+        options.numWorkers[FAM_RPC_LONG] = strtoull(argv[++i], NULL, 0);
+    else if ((arg == "-x") || (arg == "--rpccopyworkers"))
+        options.numWorkers[FAM_RPC_COPY] = strtoull(argv[++i], NULL, 0);
+    else
+        return false;
+    return true;
+}
+
+/*
+ * Fixed pool of threads running the handlers of one class of methods.
+ */
+class Fam_Rpc_Worker_Pool {
+  public:
+    Fam_Rpc_Worker_Pool(uint64_t numWorkers) : stop(false) {
+        for (uint64_t i = 0; i < numWorkers; i++)
+            workers.emplace_back(&Fam_Rpc_Worker_Pool::worker, this);
+    }
+
+    ~Fam_Rpc_Worker_Pool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto &thread : workers)
+            thread.join();
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+  private:
+    void worker() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                cv.wait(guard, [this] { return stop || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()> > tasks;
+    std::mutex lock;
+    std::condition_variable cv;
+    bool stop;
+};
+
+/*
+ * Tag of every event posted on the completion queues.
+ */
+class Fam_Async_Rpc_Call {
+  public:
+    virtual ~Fam_Async_Rpc_Call() {}
+    virtual void proceed(bool ok) = 0;
+};
+
+/*
+ * One outstanding call of a unary method. The call is armed on a completion
+ * queue when created; once a request arrives, a new call is armed in its
+ * place and the synchronous handler of the service is run, either inline on
+ * the polling thread or on the worker pool, before the response is sent.
+ */
+template <class Service, class Request, class Response>
+class Fam_Async_Rpc_Method_Call : public Fam_Async_Rpc_Call {
+  public:
+    typedef ::grpc::Status (Service::*Handler)(::grpc::ServerContext *,
+                                               const Request *, Response *);
+    typedef void (Service::*Requester)(
+        ::grpc::ServerContext *, Request *,
+        ::grpc::ServerAsyncResponseWriter<Response> *,
+        ::grpc::CompletionQueue *, ::grpc::ServerCompletionQueue *, void *);
+
+    Fam_Async_Rpc_Method_Call(Service *service,
+                              ::grpc::ServerCompletionQueue *cq,
+                              Handler handler, Requester requester,
+                              Fam_Rpc_Worker_Pool *pool)
+        : service(service), cq(cq), handler(handler), requester(requester),
+          pool(pool), responder(&ctx), finished(false) {
+        (service->*requester)(&ctx, &request, &responder, cq, cq, this);
+    }
+
+    void proceed(bool ok) {
+        // Not ok: the server is shutting down, or the response was not sent
+        if (!ok || finished) {
+            delete this;
+            return;
+        }
+        new Fam_Async_Rpc_Method_Call(service, cq, handler, requester, pool);
+        finished = true;
+        if (pool)
+            pool->submit([this] { serve(); });
+        else
+            serve();
+    }
+
+  private:
+    void serve() {
+        ::grpc::Status status = (service->*handler)(&ctx, &request, &response);
+        responder.Finish(response, status, this);
+    }
+
+    Service *service;
+    ::grpc::ServerCompletionQueue *cq;
+    Handler handler;
+    Requester requester;
+    Fam_Rpc_Worker_Pool *pool;
+    ::grpc::ServerContext ctx;
+    Request request;
+    Response response;
+    ::grpc::ServerAsyncResponseWriter<Response> responder;
+    bool finished;
+};
+
+template <class Request, class Response, class Service>
+struct Fam_Async_Rpc_Requester {
+    typedef typename Fam_Async_Rpc_Method_Call<Service, Request,
+                                               Response>::Requester type;
+};
+
+/*
+ * Completion queue based server for a service derived from the generated
+ * AsyncService. The service keeps implementing the synchronous methods; each
+ * of them is registered with add_method, which serves it asynchronously.
+ * Every method must be registered before run() is called.
+ */
+template <class Service> class Fam_Async_Rpc_Server {
+  public:
+    Fam_Async_Rpc_Server(Service *service, const Fam_Async_Rpc_Options &options)
+        : service(service), options(options), stopping(false) {
+        if (this->options.numPollers == 0)
+            this->options.numPollers = 1;
+        for (int i = 0; i < FAM_RPC_NUM_POOLS; i++) {
+            if (this->options.numWorkers[i] == 0)
+                this->options.numWorkers[i] = 1;
+        }
+    }
+
+    ~Fam_Async_Rpc_Server() { shutdown(); }
+
+    /*
+     * Serve handler asynchronously, on the polling threads or on the worker
+     * pool of methodClass.
+     */
+    template <class Request, class Response>
+    void add_method(::grpc::Status (Service::*handler)(::grpc::ServerContext *,
+                                                       const Request *,
+                                                       Response *),
+                    typename Fam_Async_Rpc_Requester<Request, Response,
+                                                     Service>::type requester,
+                    Fam_Rpc_Method_Class methodClass) {
+        methods.push_back([this, handler, requester, methodClass](
+                              ::grpc::ServerCompletionQueue *cq) {
+            new Fam_Async_Rpc_Method_Call<Service, Request, Response>(
+                service, cq, handler, requester,
+                (methodClass == FAM_RPC_INLINE)
+                    ? NULL
+                    : workerPools[methodClass].get());
+        });
+    }
+
+    /*
+     * Start listening on address and serve until shutdown() is called.
+     */
+    void run(const std::string &address) {
+        ::grpc::ServerBuilder builder;
+        // Listen on the given address without any authentication mechanism.
+        builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+        builder.RegisterService(service);
+        for (uint64_t i = 0; i < options.numPollers; i++)
+            cqs.push_back(builder.AddCompletionQueue());
+        {
+            std::lock_guard<std::mutex> guard(shutdownLock);
+            server = builder.BuildAndStart();
+        }
+        for (int i = 0; i < FAM_RPC_NUM_POOLS; i++)
+            workerPools[i].reset(
+                new Fam_Rpc_Worker_Pool(options.numWorkers[i]));
+
+        // Arm one call of every method on every completion queue
+        for (auto &cq : cqs)
+            for (auto &arm : methods)
+                arm(cq.get());
+
+        std::vector<std::thread> pollers;
+        for (uint64_t i = 0; i < options.numPollers; i++)
+            pollers.emplace_back(&Fam_Async_Rpc_Server::poll, this, i);
+        for (auto &thread : pollers)
+            thread.join();
+        for (int i = 0; i < FAM_RPC_NUM_POOLS; i++)
+            workerPools[i].reset();
+
+        // Nothing uses the server and the drained queues any more
+        std::lock_guard<std::mutex> guard(shutdownLock);
+        server.reset();
+        cqs.clear();
+        stopped.notify_all();
+    }
+
+    /*
+     * Stop serving and wait for run() to return. Must not be called from a
+     * method handler.
+     */
+    void shutdown() {
+        std::unique_lock<std::mutex> guard(shutdownLock);
+        if (!server)
+            return;
+        if (!stopping) {
+            stopping = true;
+            // Waits for the calls in progress, which the polling threads
+            // and the workers complete meanwhile; the completion queues
+            // are only shut down once no handler can post to them anymore
+            server->Shutdown();
+            for (auto &cq : cqs)
+                cq->Shutdown();
+        }
+        stopped.wait(guard, [this] { return !server; });
+    }
+
+  private:
+    void poll(uint64_t idx) {
+        if (!options.pollerCpus.empty()) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(options.pollerCpus[idx % options.pollerCpus.size()],
+                    &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                   &cpuset);
+        }
+        void *tag;
+        bool ok;
+        while (cqs[idx]->Next(&tag, &ok))
+            static_cast<Fam_Async_Rpc_Call *>(tag)->proceed(ok);
+    }
+
+    Service *service;
+    Fam_Async_Rpc_Options options;
+    std::vector<std::function<void(::grpc::ServerCompletionQueue *)> >
+        methods;
+    std::vector<std::unique_ptr<::grpc::ServerCompletionQueue> > cqs;
+    std::unique_ptr<::grpc::Server> server;
+    std::unique_ptr<Fam_Rpc_Worker_Pool> workerPools[FAM_RPC_NUM_POOLS];
+    std::mutex shutdownLock;
+    std::condition_variable stopped;
+    bool stopping;
+};
+
+/*
+ * Register method of class cls, the service type of server.
+ */
+#define FAM_ASYNC_RPC_METHOD(server, cls, method, methodClass)                 \
+    (server).add_method(&cls::method, &cls::Request##method, methodClass)
+
+} // namespace openfam
+#endif
@@ -30,33 +30,58 @@
 #ifndef FAM_CONTEXT_H
 #define FAM_CONTEXT_H
 
+#include <pthread.h>
+#include <deque>
+#include <map>
 #include <string.h>
+#include <string>
 #include <vector>
 
 #include <rdma/fabric.h>
 #include <rdma/fi_domain.h>
 #include <rdma/fi_endpoint.h>
 
+#include "common/fam_mr_cache.h"
 #include "common/fam_options.h"
 
+// Number of fi_context objects carved out of one slab allocation when the
+// completion context pool of a Fam_Context runs empty
+#define FAM_CTX_POOL_SLAB_SIZE 64
+
+// Number of operands of nonblocking atomics a Fam_Context holds before the
+// next one issued waits for the operations in flight and frees them
+#define FAM_MAX_HELD_ATOMIC_OPERANDS 1024
+
 class Fam_Context {
   public:
     Fam_Context(Fam_Thread_Model famTM)
         : numTxOps(0), numRxOps(0), isNVMM(true) {
+        numTxDone = numRxDone = 0;
+        asyncErrCode = 0;
+        pthread_spin_init(&asyncErrLock, PTHREAD_PROCESS_PRIVATE);
         numLastRxFailCnt = 0;
         numLastTxFailCnt = 0;
+        numCtxPoolHits = numCtxPoolMisses = 0;
+        mrCache = NULL;
         // Initialize ctxRWLock
         famThreadModel = famTM;
-        if (famThreadModel == FAM_THREAD_MULTIPLE)
+        if (famThreadModel == FAM_THREAD_MULTIPLE) {
             pthread_rwlock_init(&ctxRWLock, NULL);
+            pthread_spin_init(&ctxPoolLock, PTHREAD_PROCESS_PRIVATE);
+        }
     }
 
     Fam_Context(struct fi_info *fi, struct fid_domain *domain,
                 Fam_Thread_Model famTM) {
         numTxOps = numRxOps = 0;
+        numTxDone = numRxDone = 0;
+        asyncErrCode = 0;
+        pthread_spin_init(&asyncErrLock, PTHREAD_PROCESS_PRIVATE);
         isNVMM = false;
         numLastRxFailCnt = 0;
         numLastTxFailCnt = 0;
+        numCtxPoolHits = numCtxPoolMisses = 0;
+        mrCache = NULL;
 
         fi->caps = FI_RMA | FI_WRITE | FI_READ | FI_ATOMIC | FI_REMOTE_WRITE |
                    FI_REMOTE_READ;
@@ -67,8 +92,10 @@ class Fam_Context {
 
         // Initialize ctxRWLock
         famThreadModel = famTM;
-        if (famThreadModel == FAM_THREAD_MULTIPLE)
+        if (famThreadModel == FAM_THREAD_MULTIPLE) {
             pthread_rwlock_init(&ctxRWLock, NULL);
+            pthread_spin_init(&ctxPoolLock, PTHREAD_PROCESS_PRIVATE);
+        }
 
         int ret = fi_endpoint(domain, fi, &ep, NULL);
         if (ret < 0) {
@@ -134,6 +161,9 @@ class Fam_Context {
     }
 
     ~Fam_Context() {
+        release_held_resources();
+        for (auto obj : ctxMrs)
+            release_local_mr(obj.second);
         if (!isNVMM) {
             fi_close(&ep->fid);
             fi_close(&txcq->fid);
@@ -141,7 +171,12 @@ class Fam_Context {
             fi_close(&txCntr->fid);
             fi_close(&rxCntr->fid);
         }
+        for (auto slab : ctxPoolSlabs)
+            delete[] slab;
         pthread_rwlock_destroy(&ctxRWLock);
+        if (famThreadModel == FAM_THREAD_MULTIPLE)
+            pthread_spin_destroy(&ctxPoolLock);
+        pthread_spin_destroy(&asyncErrLock);
     }
 
     struct fid_ep *get_ep() {
@@ -178,6 +213,51 @@ class Fam_Context {
 
     uint64_t get_num_rx_ops() { return numRxOps; }
 
+    // Completions of operations executed in the background on behalf of
+    // this context (shared memory model).
+    void inc_num_tx_done() { __sync_fetch_and_add(&numTxDone, (uint64_t)1); }
+
+    void inc_num_rx_done() { __sync_fetch_and_add(&numRxDone, (uint64_t)1); }
+
+    uint64_t get_num_tx_done() {
+        return __atomic_load_n(&numTxDone, __ATOMIC_ACQUIRE);
+    }
+
+    uint64_t get_num_rx_done() {
+        return __atomic_load_n(&numRxDone, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * Record the failure of a background operation; only the first failure
+     * since the last get_async_error() is kept.
+     */
+    void set_async_error(int errorCode, const char *errorMsg) {
+        pthread_spin_lock(&asyncErrLock);
+        if (asyncErrCode == 0) {
+            asyncErrCode = errorCode;
+            asyncErrMsg = errorMsg;
+        }
+        pthread_spin_unlock(&asyncErrLock);
+    }
+
+    /**
+     * Get and clear the failure recorded by set_async_error().
+     * @return - true if a failure was recorded
+     */
+    bool get_async_error(int *errorCode, std::string *errorMsg) {
+        bool failed = false;
+        pthread_spin_lock(&asyncErrLock);
+        if (asyncErrCode != 0) {
+            *errorCode = asyncErrCode;
+            errorMsg->swap(asyncErrMsg);
+            asyncErrCode = 0;
+            asyncErrMsg.clear();
+            failed = true;
+        }
+        pthread_spin_unlock(&asyncErrLock);
+        return failed;
+    }
+
     int initialize_cntr(struct fid_domain *domain, struct fid_cntr **cntr) {
         int ret = 0;
         struct fi_cntr_attr cntrAttr;
@@ -210,6 +290,140 @@ class Fam_Context {
             pthread_rwlock_unlock(&ctxRWLock);
     }
 
+    /**
+     * Get a zeroed fi_context from the completion context pool of this
+     * Fam_Context. A new slab of FAM_CTX_POOL_SLAB_SIZE contexts is
+     * allocated only when the pool is empty.
+     * @return - pointer to fi_context
+     */
+    struct fi_context *get_fi_context() {
+        struct fi_context *ctx;
+        aquire_pool_lock();
+        if (ctxFreeList.empty()) {
+            numCtxPoolMisses++;
+            struct fi_context *slab =
+                new struct fi_context[FAM_CTX_POOL_SLAB_SIZE];
+            ctxPoolSlabs.push_back(slab);
+            for (int i = FAM_CTX_POOL_SLAB_SIZE - 1; i > 0; i--)
+                ctxFreeList.push_back(&slab[i]);
+            ctx = &slab[0];
+        } else {
+            numCtxPoolHits++;
+            ctx = ctxFreeList.back();
+            ctxFreeList.pop_back();
+        }
+        release_pool_lock();
+        memset(ctx, 0, sizeof(struct fi_context));
+        return ctx;
+    }
+
+    /**
+     * Return a fi_context obtained with get_fi_context() to the pool. The
+     * operation using it must have completed.
+     * @param ctx - pointer to fi_context
+     */
+    void put_fi_context(struct fi_context *ctx) {
+        openfam::Fam_MR_Cache_Entry *entry = NULL;
+        aquire_pool_lock();
+        if (!ctxMrs.empty()) {
+            auto obj = ctxMrs.find(ctx);
+            if (obj != ctxMrs.end()) {
+                entry = obj->second;
+                ctxMrs.erase(obj);
+            }
+        }
+        ctxFreeList.push_back(ctx);
+        release_pool_lock();
+        release_local_mr(entry);
+    }
+
+    /**
+     * Set the cache of local buffer registrations used by this context;
+     * NULL (default) if the provider does not need local descriptors.
+     */
+    void set_mr_cache(openfam::Fam_MR_Cache *cache) { mrCache = cache; }
+
+    openfam::Fam_MR_Cache *get_mr_cache() { return mrCache; }
+
+    /**
+     * Get the registration of a local buffer, NULL if no local descriptor is
+     * needed.
+     */
+    openfam::Fam_MR_Cache_Entry *acquire_local_mr(const void *addr,
+                                                  size_t len) {
+        if (mrCache == NULL)
+            return NULL;
+        return mrCache->acquire(addr, len);
+    }
+
+    // Release a registration once the operations using it have completed
+    void release_local_mr(openfam::Fam_MR_Cache_Entry *entry) {
+        if (entry)
+            mrCache->release(entry);
+    }
+
+    // Keep a registration until the next quiet of this context
+    void hold_local_mr(openfam::Fam_MR_Cache_Entry *entry) {
+        if (entry == NULL)
+            return;
+        aquire_pool_lock();
+        heldMrs.push_back(entry);
+        release_pool_lock();
+    }
+
+    // Keep a registration until ctx, used by the operation, is returned
+    // with put_fi_context()
+    void hold_local_mr(struct fi_context *ctx,
+                       openfam::Fam_MR_Cache_Entry *entry) {
+        if (entry == NULL)
+            return;
+        aquire_pool_lock();
+        ctxMrs[ctx] = entry;
+        release_pool_lock();
+    }
+
+    /**
+     * Copy the operand of a nonblocking atomic into storage which stays valid
+     * until the next quiet of this context.
+     * @param value - pointer to the operand
+     * @param size - size of the operand, at most 16 bytes
+     * @return - pointer to the copy
+     */
+    void *hold_atomic_operand(const void *value, size_t size) {
+        aquire_pool_lock();
+        heldOperands.emplace_back();
+        void *operand = heldOperands.back().value;
+        release_pool_lock();
+        memcpy(operand, value, size);
+        return operand;
+    }
+
+    size_t get_num_held_operands() {
+        aquire_pool_lock();
+        size_t cnt = heldOperands.size();
+        release_pool_lock();
+        return cnt;
+    }
+
+    // Release the registrations and operands kept by hold_local_mr() and
+    // hold_atomic_operand(); called once all the operations issued on this
+    // context have completed.
+    void release_held_resources() {
+        std::vector<openfam::Fam_MR_Cache_Entry *> held;
+        aquire_pool_lock();
+        held.swap(heldMrs);
+        heldOperands.clear();
+        release_pool_lock();
+        if (mrCache == NULL)
+            return;
+        for (auto entry : held)
+            mrCache->release(entry);
+    }
+
+    uint64_t get_num_ctx_pool_hits() { return numCtxPoolHits; }
+
+    uint64_t get_num_ctx_pool_misses() { return numCtxPoolMisses; }
+
     uint64_t get_num_tx_fail_cnt() { return numLastTxFailCnt; }
 
     uint64_t get_num_rx_fail_cnt() { return numLastRxFailCnt; }
@@ -223,6 +437,16 @@ class Fam_Context {
     }
 
   private:
+    void aquire_pool_lock() {
+        if (famThreadModel == FAM_THREAD_MULTIPLE)
+            pthread_spin_lock(&ctxPoolLock);
+    }
+
+    void release_pool_lock() {
+        if (famThreadModel == FAM_THREAD_MULTIPLE)
+            pthread_spin_unlock(&ctxPoolLock);
+    }
+
     struct fid_ep *ep;
     struct fid_cq *txcq;
     struct fid_cq *rxcq;
@@ -231,11 +455,33 @@ class Fam_Context {
 
     uint64_t numTxOps;
     uint64_t numRxOps;
+    uint64_t numTxDone;
+    uint64_t numRxDone;
+    // First failure of a background operation, reported by quiet
+    int asyncErrCode;
+    std::string asyncErrMsg;
+    pthread_spinlock_t asyncErrLock;
     bool isNVMM;
     uint64_t numLastTxFailCnt;
     uint64_t numLastRxFailCnt;
     Fam_Thread_Model famThreadModel;
     pthread_rwlock_t ctxRWLock;
+    // Completion context pool
+    std::vector<struct fi_context *> ctxFreeList;
+    std::vector<struct fi_context *> ctxPoolSlabs;
+    uint64_t numCtxPoolHits;
+    uint64_t numCtxPoolMisses;
+    pthread_spinlock_t ctxPoolLock;
+    // Local buffer registrations (FI_MR_LOCAL providers only)
+    openfam::Fam_MR_Cache *mrCache;
+    std::vector<openfam::Fam_MR_Cache_Entry *> heldMrs;
+    // Registrations of sends and receives in flight, by their fi_context
+    std::map<struct fi_context *, openfam::Fam_MR_Cache_Entry *> ctxMrs;
+    // Operands of nonblocking atomics in flight; a deque keeps them in place
+    struct Held_Operand {
+        uint64_t value[2];
+    };
+    std::deque<Held_Operand> heldOperands;
 };
 
 #endif
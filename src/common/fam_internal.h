@@ -64,17 +64,25 @@
 #ifndef FAM_INTERNAL_H_
 #define FAM_INTERNAL_H_
 
+#include <atomic>
 #include <iostream>
 #include <map>
+#include <random>
 #include <stdint.h> // needed for uint64_t etc.
+#include <string.h>
 #include <string>
 #include <sys/stat.h> // needed for mode_t
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "radixtree/kvs.h"
 #include "radixtree/radix_tree.h"
 
 #include "nvmm/epoch_manager.h"
 #include "nvmm/memory_manager.h"
+#include "fam/fam.h"
 #include "fam/fam_exception.h"
 #include <nvmm/fam.h>
 
@@ -119,6 +127,126 @@ namespace openfam {
 
 #define ADDR_SIZE 20
 
+/*
+ * Maximum number of memory servers a single data item can be interleaved
+ * (striped) across.
+ */
+#define MAX_INTERLEAVE_MEMSERVERS_CNT 64
+
+/*
+ * 128-bit atomic operations executed by the memory server on behalf of a
+ * client, under the memory server's CAS lock.
+ */
+typedef enum {
+    INT128_ATOMIC_FETCH = 0,
+    INT128_ATOMIC_SET,
+    INT128_ATOMIC_CSWAP
+} Fam_Int128_Atomic_Op;
+
+// Split a 128-bit value into 64-bit words for RPC messages, and join them.
+inline void int128_to_words(int128_t value, uint64_t *lo, uint64_t *hi) {
+    uint64_t words[2] = {0, 0};
+    memcpy(words, &value, sizeof(int128_t));
+    *lo = words[0];
+    *hi = words[1];
+}
+
+inline int128_t words_to_int128(uint64_t lo, uint64_t hi) {
+    uint64_t words[2] = {lo, hi};
+    int128_t value;
+    memcpy(&value, words, sizeof(int128_t));
+    return value;
+}
+
+/*
+ * Encodings of the element indexes of indexed atomic scatter/gather in RPC
+ * messages : packed little-endian uint64, or the deltas between consecutive
+ * indexes, zigzag encoded, as varints. The encoder picks the smaller.
+ */
+typedef enum {
+    FAM_INDEX_PACKED = 0,
+    FAM_INDEX_DELTA_VARINT
+} Fam_Index_Encoding;
+
+inline uint64_t index_delta(const uint64_t *index, uint64_t i) {
+    int64_t delta = (int64_t)(index[i] - (i ? index[i - 1] : 0));
+    return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+// Encode nElements indexes into out; returns the encoding used
+inline uint32_t encode_index_array(const uint64_t *index, uint64_t nElements,
+                                   std::string *out) {
+    uint64_t varintSize = 0;
+    for (uint64_t i = 0; i < nElements; i++) {
+        uint64_t value = index_delta(index, i);
+        do {
+            varintSize++;
+            value >>= 7;
+        } while (value);
+    }
+    out->clear();
+    if (varintSize < nElements * sizeof(uint64_t)) {
+        out->reserve(varintSize);
+        for (uint64_t i = 0; i < nElements; i++) {
+            uint64_t value = index_delta(index, i);
+            while (value >= 0x80) {
+                out->push_back((char)(value | 0x80));
+                value >>= 7;
+            }
+            out->push_back((char)value);
+        }
+        return FAM_INDEX_DELTA_VARINT;
+    }
+    out->resize(nElements * sizeof(uint64_t));
+    for (uint64_t i = 0; i < nElements; i++) {
+        for (uint32_t b = 0; b < sizeof(uint64_t); b++)
+            (*out)[i * sizeof(uint64_t) + b] = (char)(index[i] >> (8 * b));
+    }
+    return FAM_INDEX_PACKED;
+}
+
+/*
+ * Decode the nElements indexes of in into index. Returns false if in does
+ * not hold exactly nElements indexes.
+ */
+inline bool decode_index_array(const std::string &in, uint32_t encoding,
+                               uint64_t nElements,
+                               std::vector<uint64_t> *index) {
+    const unsigned char *data = (const unsigned char *)in.data();
+    // Each index takes at least a byte
+    if (nElements > in.size())
+        return false;
+    index->resize(nElements);
+    if (encoding == FAM_INDEX_PACKED) {
+        if (in.size() != nElements * sizeof(uint64_t))
+            return false;
+        for (uint64_t i = 0; i < nElements; i++) {
+            uint64_t value = 0;
+            for (uint32_t b = 0; b < sizeof(uint64_t); b++)
+                value |= (uint64_t)data[i * sizeof(uint64_t) + b] << (8 * b);
+            (*index)[i] = value;
+        }
+        return true;
+    }
+    if (encoding != FAM_INDEX_DELTA_VARINT)
+        return false;
+    size_t pos = 0;
+    uint64_t prev = 0;
+    for (uint64_t i = 0; i < nElements; i++) {
+        uint64_t value = 0;
+        uint32_t shift = 0;
+        do {
+            if (pos == in.size() || shift > 63)
+                return false;
+            value |= (uint64_t)(data[pos] & 0x7f) << shift;
+            shift += 7;
+        } while (data[pos++] & 0x80);
+        prev += (value >> 1) ^ (0 - (value & 1));
+        (*index)[i] = prev;
+    }
+    return (pos == in.size());
+}
+
 #define STATUS_CHECK(exception)                                                \
     {                                                                          \
         if (status.ok()) {                                                     \
@@ -146,8 +274,47 @@ typedef struct {
     char name[RadixTree::MAX_KEY_LEN];
     uint64_t memoryServerId;
     size_t maxNameLen;
+    /*
+     * Interleaved data items : size of each stripe (0 if the data item is
+     * placed on memoryServerId alone) and, for each memory server holding
+     * stripes, its id, offset, key and base address. Stripe i is placed on
+     * memServerIds[i % used_memsrv_cnt].
+     */
+    uint64_t interleaveSize;
+    uint64_t used_memsrv_cnt;
+    uint64_t memServerIds[MAX_INTERLEAVE_MEMSERVERS_CNT];
+    uint64_t offsets[MAX_INTERLEAVE_MEMSERVERS_CNT];
+    uint64_t keys[MAX_INTERLEAVE_MEMSERVERS_CNT];
+    uint64_t bases[MAX_INTERLEAVE_MEMSERVERS_CNT];
 } Fam_Region_Item_Info;
 
+/*
+ * Progress of a copy, advanced by the threads doing the copy as each chunk
+ * completes. Setting cancelled stops the copy before its next chunk; the
+ * chunks already copied are left in place. copyId names the copy on the
+ * memory server, so that its progress can be queried and a cancel forwarded
+ * while it runs there; 0 if the copy is not named.
+ */
+typedef struct {
+    std::atomic<uint64_t> bytesCopied;
+    std::atomic<bool> cancelled;
+    uint64_t copyId;
+} Fam_Copy_Progress;
+
+/*
+ * Return a new copy id. Ids are a random per process prefix followed by a
+ * counter, so that the copies of different clients do not collide on a
+ * memory server.
+ */
+inline uint64_t openfam_new_copy_id() {
+    static std::atomic<uint64_t> nextCopyId(
+        (uint64_t)std::random_device()() << 32);
+    uint64_t copyId;
+    while ((copyId = nextCopyId.fetch_add(1)) == 0)
+        ;
+    return copyId;
+}
+
 // Input string contains <node-id>:<ipaddr>:<grpc-port>,<node-id>:...
 inline Server_Map parse_server_list(std::string memServer,
                                     std::string delimiter1,
@@ -200,6 +367,39 @@ inline void openfam_invalidate(void *addr, uint64_t size) {
 #endif
 }
 
+/*
+ * Copy nbytes with non-temporal stores, bypassing the cache for large writes
+ * that will not be read back soon.
+ */
+inline void openfam_memcpy_nontemporal(void *dest, const void *src,
+                                       uint64_t nbytes) {
+#ifdef __SSE2__
+    char *d = (char *)dest;
+    const char *s = (const char *)src;
+    uint64_t head = (16 - ((uint64_t)d & 15)) & 15;
+    if (head > nbytes)
+        head = nbytes;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    nbytes -= head;
+    for (; nbytes >= 64; nbytes -= 64, d += 64, s += 64) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(s + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *)(s + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *)(s + 48));
+        _mm_stream_si128((__m128i *)d, v0);
+        _mm_stream_si128((__m128i *)(d + 16), v1);
+        _mm_stream_si128((__m128i *)(d + 32), v2);
+        _mm_stream_si128((__m128i *)(d + 48), v3);
+    }
+    memcpy(d, s, nbytes);
+    _mm_sfence();
+#else
+    memcpy(dest, src, nbytes);
+#endif
+}
+
 
 } // namespace openfam
 
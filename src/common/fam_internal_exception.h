@@ -107,7 +107,8 @@ enum Internal_Error {
     ATL_QUEUE_FULL,
     ATL_QUEUE_INSERT_ERROR,
     ATL_NOT_ENABLED,
-    LIBFABRIC_ERROR
+    LIBFABRIC_ERROR,
+    COPY_CANCELLED
 };
 
 inline enum Fam_Error convert_to_famerror(enum Internal_Error serverErr) {
@@ -153,6 +154,9 @@ inline enum Fam_Error convert_to_famerror(enum Internal_Error serverErr) {
     case LIBFABRIC_ERROR:
         return FAM_ERR_LIBFABRIC;
 
+    case COPY_CANCELLED:
+        return FAM_ERR_CANCELED;
+
     case REGION_NOT_INSERTED:
     case DATAITEM_NOT_INSERTED:
     case REGION_NOT_REMOVED:
@@ -40,8 +40,10 @@
 #include <atomic>
 #include <boost/atomic.hpp>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <limits.h>
+#include <algorithm>
 #include <list>
 #include <sstream>
 #include <unistd.h>
@@ -56,6 +58,9 @@ using namespace std;
 #define TOTAL_TIMEOUT 3600000 // 1 hour
 #define TIMEOUT_WAIT_RETRY (TOTAL_TIMEOUT / FABRIC_TIMEOUT)
 #define TIMEOUT_RETRY INT_MAX
+#define FABRIC_CQ_BATCH 64       // CQ entries drained per fi_cq_read
+#define FABRIC_SPIN_RETRY 1000   // empty CQ polls before yielding
+#define FABRIC_YIELD_RETRY 100   // yields before blocking on the CQ
 uint64_t one = 1;
 uint64_t zero = 0;
 
@@ -307,6 +312,10 @@ int fabric_initialize(const char *name, const char *service, bool source,
     if ((strncmp(provider, "verbs", 5) == 0)) {
         hints->domain_attr->mr_mode =
             FI_MR_ALLOCATED | FI_MR_PROV_KEY | FI_MR_VIRT_ADDR;
+        // Clients register their local buffers (see Fam_MR_Cache), which
+        // lets the provider transfer them without bounce buffers.
+        if (!source)
+            hints->domain_attr->mr_mode |= FI_MR_LOCAL;
         if (!source)
             hints->domain_attr->data_progress = FI_PROGRESS_AUTO;
     } else
@@ -583,13 +592,36 @@ int fabric_retry(Fam_Context *famCtx, ssize_t ret, uint32_t *retry_cnt) {
 
     return 0;
 }
+/*
+ * Hand the completions read from a CQ to the fi_context that owns them.
+ * @param entries - completion entries read from the CQ
+ * @param count - number of valid entries
+ */
+static inline void fabric_dispatch_completions(struct fi_cq_data_entry *entries,
+                                               ssize_t count) {
+    for (ssize_t i = 0; i < count; i++) {
+        if ((fi_context *)entries[i].op_context != (void *)NULL) {
+            __sync_fetch_and_add(
+                ((uint64_t *)&((fi_context *)entries[i].op_context)
+                     ->internal[0]),
+                one);
+        }
+    }
+}
+
 // ioType: Send (0), Recv (1)
+// Completions are drained from the CQ in batches of FABRIC_CQ_BATCH entries
+// and credited to their owning fi_context, so a thread waiting here also
+// makes progress for the other threads sharing this Fam_Context. While no
+// completion is available the wait spins, then yields the CPU, and finally
+// blocks on the wait object of the CQ.
 int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx, int ioType) {
 
     LIBFABRIC_PROFILE_START_OPS()
     ssize_t ret = 0;
-    struct fi_cq_data_entry entry;
-    int timeout_retry_cnt = 0;
+    struct fi_cq_data_entry entries[FABRIC_CQ_BATCH];
+    int spin_retry_cnt = 0;
+    int yield_retry_cnt = 0;
     int timeout_wait_retry_cnt = 0;
     struct fid_cq *cq = NULL;
     if (ioType == 0)
@@ -601,7 +633,7 @@ int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx, int ioType) {
         success = (uint64_t)ctx->internal[0];
         failure = (uint64_t)ctx->internal[1];
         reqcnt = (uint64_t)ctx->internal[2];
-        if (success == reqcnt) {
+        if (success >= reqcnt) {
             return 0;
         }
         if (failure > 0) {
@@ -615,29 +647,38 @@ int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx, int ioType) {
             THROW_ERRNO_MSG(Fam_Datapath_Exception, get_fam_error(err), errmsg);
         }
 
-        memset(&entry, 0, sizeof(entry));
-        FI_CALL(ret, fi_cq_read, cq, &entry, 1);
-        if (ret > 0) {
-            if ((fi_context *)entry.op_context != (void *)NULL) {
-                __sync_fetch_and_add(
-                    ((uint64_t *)&((fi_context *)entry.op_context)
-                         ->internal[0]),
-                    one);
+        if (spin_retry_cnt < FABRIC_SPIN_RETRY ||
+            yield_retry_cnt < FABRIC_YIELD_RETRY) {
+            FI_CALL(ret, fi_cq_read, cq, entries, FABRIC_CQ_BATCH);
+        } else {
+            FI_CALL(ret, fi_cq_sread, cq, entries, FABRIC_CQ_BATCH, NULL,
+                    FABRIC_TIMEOUT);
+            // CQ without a wait object; fall back to sleeping
+            if (ret == -FI_ENOSYS) {
+                usleep(FABRIC_TIMEOUT * 1000);
+                ret = -FI_EAGAIN;
             }
         }
+        if (ret > 0) {
+            fabric_dispatch_completions(entries, ret);
+            spin_retry_cnt = yield_retry_cnt = 0;
+            continue;
+        }
 
         if (ret == -FI_ETIMEDOUT || ret == -FI_EAGAIN) {
-            if (timeout_retry_cnt < TIMEOUT_RETRY) {
-                timeout_retry_cnt++;
+            if (spin_retry_cnt < FABRIC_SPIN_RETRY) {
+                spin_retry_cnt++;
+                continue;
+            } else if (yield_retry_cnt < FABRIC_YIELD_RETRY) {
+                yield_retry_cnt++;
+                std::this_thread::yield();
                 continue;
             } else if (timeout_wait_retry_cnt < TIMEOUT_WAIT_RETRY) {
                 timeout_wait_retry_cnt++;
-                usleep(FABRIC_TIMEOUT * 1000);
                 continue;
             } else {
-                THROW_ERR_MSG(
-                    Fam_Timeout_Exception,
-                    "fi_cq_read timeout retry count exceeded INT_MAX");
+                THROW_ERR_MSG(Fam_Timeout_Exception,
+                              "fi_cq_read timeout retry count exceeded");
             }
         }
         if (ret < 0) {
@@ -752,16 +793,18 @@ int fabric_completion_wait_multictx(Fam_Context *famCtx, fi_context *ctx,
 int fabric_write(uint64_t key, const void *local, size_t nbytes,
                  uint64_t offset, fi_addr_t fiAddr, Fam_Context *famCtx) {
 
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(local, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
     struct fi_rma_iov rma_iov = {.addr = offset, .len = nbytes, .key = key};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
 
     struct fi_msg_rma msg = {.msg_iov = &iov,
-                             .desc = 0,
+                             .desc = &desc,
                              .iov_count = 1,
                              .addr = fiAddr,
                              .rma_iov = &rma_iov,
@@ -787,6 +830,7 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
         ret = fabric_completion_wait(famCtx, ctx, 0);
     } catch (...) {
         famCtx->inc_num_tx_fail_cnt(incr);
+        famCtx->hold_local_mr(mrEntry);
         // Release Fam_Context read lock
         famCtx->release_lock();
         throw;
@@ -794,7 +838,8 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
 
     // Release Fam_Context read lock
     famCtx->release_lock();
-    delete ctx;
+    famCtx->put_fi_context(ctx);
+    famCtx->release_local_mr(mrEntry);
 
     return (int)ret;
 }
@@ -813,16 +858,18 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
 int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
                 fi_addr_t fiAddr, Fam_Context *famCtx) {
 
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(local, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
     struct fi_rma_iov rma_iov = {.addr = offset, .len = nbytes, .key = key};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
 
     struct fi_msg_rma msg = {.msg_iov = &iov,
-                             .desc = 0,
+                             .desc = &desc,
                              .iov_count = 1,
                              .addr = fiAddr,
                              .rma_iov = &rma_iov,
@@ -847,16 +894,212 @@ int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
         ret = fabric_completion_wait(famCtx, ctx, 0);
     } catch (...) {
         famCtx->inc_num_rx_fail_cnt(incr);
+        famCtx->hold_local_mr(mrEntry);
+        // Release Fam_Context read lock
+        famCtx->release_lock();
+        throw;
+    }
+    // Release Fam_Context read lock
+    famCtx->release_lock();
+    famCtx->put_fi_context(ctx);
+    famCtx->release_local_mr(mrEntry);
+    return (int)ret;
+}
+
+/*
+ * Fabric read or write of a list of segments, each split into chunks of
+ * chunkSize bytes, with at most pipelineDepth chunks in flight at a time.
+ * Segments may target different memory servers, whose transfers then
+ * proceed in parallel.
+ * @param segments - pointer to the array of segments
+ * @param numSegments - number of segments
+ * @param famCtx - Pointer to Fam_Context
+ * @param chunkSize - size of each chunk in bytes
+ * @param pipelineDepth - maximum number of chunks in flight
+ * @param write - write (true) or read (false)
+ * @return - {true(0), false(1), errNo(<0)}
+ */
+static int fabric_rma_pipelined(const Fabric_Rma_Segment *segments,
+                                size_t numSegments, Fam_Context *famCtx,
+                                size_t chunkSize, size_t pipelineDepth,
+                                bool write) {
+
+    uint64_t flags =
+        (write ? (FI_COMPLETION | FI_DELIVERY_COMPLETE) : FI_COMPLETION);
+    if (pipelineDepth == 0)
+        pipelineDepth = 1;
+    if (chunkSize == 0)
+        chunkSize = SIZE_MAX;
+
+    // One registration covers the local buffers of all the segments
+    uint64_t localStart = UINT64_MAX, localEnd = 0;
+    for (size_t i = 0; i < numSegments; i++) {
+        localStart = std::min(localStart, (uint64_t)segments[i].local);
+        localEnd = std::max(localEnd,
+                            (uint64_t)segments[i].local + segments[i].nbytes);
+    }
+    Fam_MR_Cache_Entry *mrEntry =
+        (numSegments ? famCtx->acquire_local_mr((void *)localStart,
+                                                localEnd - localStart)
+                     : NULL);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
+    // One context tracks all the chunks; internal[2] is raised as the
+    // window moves so that completion_wait returns once a slot is free.
+    struct fi_context *ctx = famCtx->get_fi_context();
+
+    ssize_t ret = 0;
+    uint64_t posted = 0;
+
+    // Take Fam_Context read lock
+    famCtx->aquire_RDLock();
+
+    try {
+        for (size_t i = 0; i < numSegments; i++) {
+            const Fabric_Rma_Segment *seg = &segments[i];
+            for (size_t chunkOffset = 0; chunkOffset < seg->nbytes;
+                 chunkOffset += chunkSize) {
+                if (posted >= pipelineDepth) {
+                    ctx->internal[2] = (void *)(posted - pipelineDepth + 1);
+                    fabric_completion_wait(famCtx, ctx, 0);
+                }
+
+                size_t len = std::min(chunkSize, seg->nbytes - chunkOffset);
+
+                struct iovec iov = {
+                    .iov_base = (void *)((uint64_t)seg->local + chunkOffset),
+                    .iov_len = len};
+
+                struct fi_rma_iov rma_iov = {.addr = seg->offset + chunkOffset,
+                                             .len = len,
+                                             .key = seg->key};
+
+                struct fi_msg_rma msg = {.msg_iov = &iov,
+                                         .desc = &desc,
+                                         .iov_count = 1,
+                                         .addr = seg->fiAddr,
+                                         .rma_iov = &rma_iov,
+                                         .rma_iov_count = 1,
+                                         .context = ctx,
+                                         .data = 0};
+
+                uint32_t retry_cnt = 0;
+                do {
+                    if (write) {
+                        FI_CALL(ret, fi_writemsg, famCtx->get_ep(), &msg,
+                                flags);
+                    } else {
+                        FI_CALL(ret, fi_readmsg, famCtx->get_ep(), &msg,
+                                flags);
+                    }
+                } while (fabric_retry(famCtx, ret, &retry_cnt));
+
+                if (write)
+                    famCtx->inc_num_tx_ops();
+                else
+                    famCtx->inc_num_rx_ops();
+                posted++;
+            }
+        }
+
+        ctx->internal[2] = (void *)posted;
+        if (posted)
+            ret = fabric_completion_wait(famCtx, ctx, 0);
+    } catch (...) {
+        uint64_t completed = (uint64_t)ctx->internal[0];
+        uint64_t failed = (posted > completed ? posted - completed : 0);
+        if (write)
+            famCtx->inc_num_tx_fail_cnt(failed);
+        else
+            famCtx->inc_num_rx_fail_cnt(failed);
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(mrEntry);
         throw;
     }
+
     // Release Fam_Context read lock
     famCtx->release_lock();
-    delete ctx;
+    famCtx->put_fi_context(ctx);
+    famCtx->release_local_mr(mrEntry);
+
     return (int)ret;
 }
 
+/*
+ * fabric write message blocking, pipelined in chunks
+ * @param key - key of the memory region
+ * @param local - pointer to the local memory region
+ * @param nbytes - number of the bytes to be written to memory region
+ *                 registered with key
+ * @param offset - offset to the remote memory address
+ * @param fiAddr - fi_addr_t address
+ * @param famCtx - Pointer to Fam_Context
+ * @param chunkSize - size of each chunk in bytes
+ * @param pipelineDepth - maximum number of chunks in flight
+ * @return - {true(0), false(1), errNo(<0)}
+ */
+int fabric_write_pipelined(uint64_t key, const void *local, size_t nbytes,
+                           uint64_t offset, fi_addr_t fiAddr,
+                           Fam_Context *famCtx, size_t chunkSize,
+                           size_t pipelineDepth) {
+    Fabric_Rma_Segment seg = {key, (void *)local, nbytes, offset, fiAddr};
+    return fabric_rma_pipelined(&seg, 1, famCtx, chunkSize, pipelineDepth,
+                                true);
+}
+
+/*
+ * Fabric read message blocking, pipelined in chunks
+ * @param key - key of the memory region
+ * @param local - pointer to the local memory region
+ * @param nbytes - number of the bytes to be read from memory region
+ *                 registered with key
+ * @param offset - offset to the remote memory address
+ * @param fiAddr - fi_addr_t address
+ * @param famCtx - Pointer to Fam_Context
+ * @param chunkSize - size of each chunk in bytes
+ * @param pipelineDepth - maximum number of chunks in flight
+ * @return - {true(0), false(1), errNo(<0)}
+ */
+int fabric_read_pipelined(uint64_t key, const void *local, size_t nbytes,
+                          uint64_t offset, fi_addr_t fiAddr,
+                          Fam_Context *famCtx, size_t chunkSize,
+                          size_t pipelineDepth) {
+    Fabric_Rma_Segment seg = {key, (void *)local, nbytes, offset, fiAddr};
+    return fabric_rma_pipelined(&seg, 1, famCtx, chunkSize, pipelineDepth,
+                                false);
+}
+
+/*
+ * fabric write of a list of segments, blocking
+ * @param segments - segments to be written
+ * @param famCtx - Pointer to Fam_Context
+ * @param chunkSize - size of each chunk in bytes
+ * @param pipelineDepth - maximum number of chunks in flight
+ * @return - {true(0), false(1), errNo(<0)}
+ */
+int fabric_write_segments(std::vector<Fabric_Rma_Segment> *segments,
+                          Fam_Context *famCtx, size_t chunkSize,
+                          size_t pipelineDepth) {
+    return fabric_rma_pipelined(segments->data(), segments->size(), famCtx,
+                                chunkSize, pipelineDepth, true);
+}
+
+/*
+ * fabric read of a list of segments, blocking
+ * @param segments - segments to be read
+ * @param famCtx - Pointer to Fam_Context
+ * @param chunkSize - size of each chunk in bytes
+ * @param pipelineDepth - maximum number of chunks in flight
+ * @return - {true(0), false(1), errNo(<0)}
+ */
+int fabric_read_segments(std::vector<Fabric_Rma_Segment> *segments,
+                         Fam_Context *famCtx, size_t chunkSize,
+                         size_t pipelineDepth) {
+    return fabric_rma_pipelined(segments->data(), segments->size(), famCtx,
+                                chunkSize, pipelineDepth, false);
+}
+
 int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
                                 fi_addr_t fiAddr, Fam_Context *famCtx,
                                 struct iovec *iov, struct fi_rma_iov *rma_iov,
@@ -873,9 +1116,18 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
     flags = (block ? FI_COMPLETION : 0);
     flags |= ((block && write) ? FI_DELIVERY_COMPLETE : 0);
 
-    struct fi_context *ctx = (block ? new struct fi_context() : NULL);
+    // The local elements are contiguous, so one registration covers them
+    Fam_MR_Cache_Entry *mrEntry =
+        (count ? famCtx->acquire_local_mr(iov[0].iov_base,
+                                          (uint64_t)iov[count - 1].iov_base +
+                                              iov[count - 1].iov_len -
+                                              (uint64_t)iov[0].iov_base)
+               : NULL);
+    std::vector<void *> desc(MIN(iov_limit, count),
+                             (mrEntry ? mrEntry->desc : NULL));
+
+    struct fi_context *ctx = (block ? famCtx->get_fi_context() : NULL);
     if (block) {
-        memset(ctx, 0, sizeof(struct fi_context));
         ctx->internal[2] = (void *)iteration;
     }
 
@@ -885,7 +1137,7 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
     for (int64_t j = 0; j < iteration; j++) {
 
         struct fi_msg_rma msg = {.msg_iov = &iov[j * iov_limit],
-                                 .desc = 0,
+                                 .desc = desc.data(),
                                  .iov_count = MIN(iov_limit, count_remain),
                                  .addr = fiAddr,
                                  .rma_iov = &rma_iov[j * iov_limit],
@@ -911,6 +1163,7 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
         } catch (...) {
             // Release Fam_Context read lock
             famCtx->release_lock();
+            famCtx->hold_local_mr(mrEntry);
             throw;
         }
         count_remain -= iov_limit;
@@ -926,14 +1179,20 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
                 famCtx->inc_num_rx_fail_cnt(1l);
             // Release Fam_Context read lock
             famCtx->release_lock();
+            famCtx->hold_local_mr(mrEntry);
             throw;
         }
     }
     // Release Fam_Context read lock
     famCtx->release_lock();
 
-    if (block)
-        delete ctx;
+    if (block) {
+        famCtx->put_fi_context(ctx);
+        famCtx->release_local_mr(mrEntry);
+    } else {
+        // The registration is kept until the operations are quiesced
+        famCtx->hold_local_mr(mrEntry);
+    }
     return (int)ret;
 }
 /*
@@ -1121,12 +1380,15 @@ void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
                               uint64_t offset, fi_addr_t fiAddr,
                               Fam_Context *famCtx) {
 
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(local, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
     struct fi_rma_iov rma_iov = {.addr = offset, .len = nbytes, .key = key};
 
     struct fi_msg_rma msg = {.msg_iov = &iov,
-                             .desc = 0,
+                             .desc = &desc,
                              .iov_count = 1,
                              .addr = fiAddr,
                              .rma_iov = &rma_iov,
@@ -1148,10 +1410,13 @@ void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
     } catch (...) {
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(mrEntry);
         throw;
     }
     // Release Fam_Context read lock
     famCtx->release_lock();
+    // The registration is kept until the operation is quiesced
+    famCtx->hold_local_mr(mrEntry);
     return;
 }
 
@@ -1170,12 +1435,15 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
                              uint64_t offset, fi_addr_t fiAddr,
                              Fam_Context *famCtx) {
 
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(local, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
     struct fi_rma_iov rma_iov = {.addr = offset, .len = nbytes, .key = key};
 
     struct fi_msg_rma msg = {.msg_iov = &iov,
-                             .desc = 0,
+                             .desc = &desc,
                              .iov_count = 1,
                              .addr = fiAddr,
                              .rma_iov = &rma_iov,
@@ -1197,10 +1465,13 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
     } catch (...) {
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(mrEntry);
         throw;
     }
     // Release Fam_Context read lock
     famCtx->release_lock();
+    // The registration is kept until the operation is quiesced
+    famCtx->hold_local_mr(mrEntry);
     return;
 }
 
@@ -1387,7 +1658,7 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
 
     struct fi_rma_iov rma_iov = {.addr = offset, .len = nbytes, .key = key};
 
-    struct fi_context *ctx = new struct fi_context();
+    struct fi_context *ctx = famCtx->get_fi_context();
 
     struct fi_msg_rma msg = {.msg_iov = &iov,
                              .desc = 0,
@@ -1416,11 +1687,71 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
 
     // Release Fam_Context Write lock
     famCtx->release_lock();
-    delete ctx;
+    famCtx->put_fi_context(ctx);
 
     return;
 }
 
+/*
+ * Check if the tx (or rx) operations issued on a context have completed
+ *  @param famCtx - Pointer to Fam_Context
+ *  @param tx - check tx operations if true, rx operations otherwise
+ *  @param opCnt - number of operations to wait for
+ *  @param lastFailCnt - failure count seen before the quiet started
+ *  @return - true if all the operations have completed
+ */
+static bool fabric_ops_completed(Fam_Context *famCtx, bool tx, uint64_t opCnt,
+                                 uint64_t lastFailCnt) {
+    uint64_t success = 0;
+    uint64_t fail = 0;
+    struct fi_cq_data_entry entry;
+    ssize_t ret = 0;
+    struct fid_cntr *cntr = (tx ? famCtx->get_txCntr() : famCtx->get_rxCntr());
+
+    FI_CALL(success, fi_cntr_read, cntr);
+    FI_CALL(fail, fi_cntr_readerr, cntr);
+    // New failure seen; Wait for cq_read and throw exception
+    if (fail > lastFailCnt) {
+        do {
+            memset(&entry, 0, sizeof(entry));
+            FI_CALL(ret, fi_cq_sread, famCtx->get_txcq(), &entry, 1, NULL,
+                    FABRIC_TIMEOUT);
+            if (ret < 0 && (ret != -FI_EAGAIN) && (ret != -FI_ETIMEDOUT)) {
+                // Flush all the errors from completion queue
+                struct fi_cq_err_entry err;
+                FI_CALL_NO_RETURN(fi_cq_readerr, famCtx->get_txcq(), &err, 0);
+                const char *errmsg =
+                    fi_cq_strerror(famCtx->get_txcq(), err.prov_errno,
+                                   err.err_data, NULL, 0);
+                if (tx)
+                    famCtx->inc_num_tx_fail_cnt(fail - lastFailCnt);
+                else
+                    famCtx->inc_num_rx_fail_cnt(fail - lastFailCnt);
+                THROW_ERRNO_MSG(Fam_Datapath_Exception, get_fam_error(err.err),
+                                errmsg);
+            }
+        } while (ret < 0 && ((ret == -FI_EAGAIN) || (ret == -FI_ETIMEDOUT)));
+    }
+
+    return ((success + fail) >= opCnt);
+}
+
+/*
+ * Back off between two polls of the context counters during quiet
+ */
+static void fabric_quiet_backoff(int *timeout_retry_cnt,
+                                 int *timeout_wait_retry_cnt) {
+    if (*timeout_retry_cnt < TIMEOUT_RETRY) {
+        (*timeout_retry_cnt)++;
+    } else if (*timeout_wait_retry_cnt < TIMEOUT_WAIT_RETRY) {
+        (*timeout_wait_retry_cnt)++;
+        usleep(FABRIC_TIMEOUT * 1000);
+    } else {
+        THROW_ERR_MSG(Fam_Timeout_Exception,
+                      "Timeout retry count exceeded INT_MAX");
+    }
+}
+
 /*
  * fabric quiet : check if all non-blocking operations have completed
  *  @param famCtx - Pointer to Fam_Context
@@ -1429,51 +1760,12 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
 void fabric_put_quiet(Fam_Context *famCtx) {
 
     int timeout_retry_cnt = 0;
-
-    uint64_t txsuccess = 0;
-    uint64_t txfail = 0;
-    uint64_t txcnt = 0;
-    struct fi_cq_data_entry entry;
-    ssize_t ret = 0;
-    uint64_t txLastFailCnt = famCtx->get_num_tx_fail_cnt();
     int timeout_wait_retry_cnt = 0;
+    uint64_t txLastFailCnt = famCtx->get_num_tx_fail_cnt();
+    uint64_t txcnt = famCtx->get_num_tx_ops();
 
-    txcnt = famCtx->get_num_tx_ops();
-    do {
-        FI_CALL(txsuccess, fi_cntr_read, famCtx->get_txCntr());
-        FI_CALL(txfail, fi_cntr_readerr, famCtx->get_txCntr());
-        // New failure seen; Wait for cq_read and throw exception
-        if (txfail > txLastFailCnt) {
-            do {
-                memset(&entry, 0, sizeof(entry));
-                FI_CALL(ret, fi_cq_sread, famCtx->get_txcq(), &entry, 1, NULL,
-                        FABRIC_TIMEOUT);
-                if (ret < 0 && (ret != -FI_EAGAIN) && (ret != -FI_ETIMEDOUT)) {
-                    // Flush all the errors from completion queue
-                    struct fi_cq_err_entry err;
-                    FI_CALL_NO_RETURN(fi_cq_readerr, famCtx->get_txcq(), &err,
-                                      0);
-                    const char *errmsg =
-                        fi_cq_strerror(famCtx->get_txcq(), err.prov_errno,
-                                       err.err_data, NULL, 0);
-                    famCtx->inc_num_tx_fail_cnt(txfail - txLastFailCnt);
-                    THROW_ERRNO_MSG(Fam_Datapath_Exception,
-                                    get_fam_error(err.err), errmsg);
-                }
-            } while (ret < 0 &&
-                     ((ret == -FI_EAGAIN) || (ret == -FI_ETIMEDOUT)));
-        }
-
-        if (timeout_retry_cnt < TIMEOUT_RETRY) {
-            timeout_retry_cnt++;
-        } else if (timeout_wait_retry_cnt < TIMEOUT_WAIT_RETRY) {
-            timeout_wait_retry_cnt++;
-            usleep(FABRIC_TIMEOUT * 1000);
-        } else {
-            THROW_ERR_MSG(Fam_Timeout_Exception,
-                          "Timeout retry count exceeded INT_MAX");
-        }
-    } while ((txsuccess + txfail) < txcnt);
+    while (!fabric_ops_completed(famCtx, true, txcnt, txLastFailCnt))
+        fabric_quiet_backoff(&timeout_retry_cnt, &timeout_wait_retry_cnt);
 
     return;
 }
@@ -1481,53 +1773,12 @@ void fabric_put_quiet(Fam_Context *famCtx) {
 void fabric_get_quiet(Fam_Context *famCtx) {
 
     int timeout_retry_cnt = 0;
-
-    uint64_t rxsuccess = 0;
-    uint64_t rxfail = 0;
-    uint64_t rxcnt = 0;
-    struct fi_cq_data_entry entry;
-    ssize_t ret = 0;
-    uint64_t rxLastFailCnt = famCtx->get_num_rx_fail_cnt();
     int timeout_wait_retry_cnt = 0;
-    rxcnt = famCtx->get_num_rx_ops();
-
-    do {
+    uint64_t rxLastFailCnt = famCtx->get_num_rx_fail_cnt();
+    uint64_t rxcnt = famCtx->get_num_rx_ops();
 
-        FI_CALL(rxsuccess, fi_cntr_read, famCtx->get_rxCntr());
-        FI_CALL(rxfail, fi_cntr_readerr, famCtx->get_rxCntr());
-
-        // New failure seen; Wait for cq_read and throw exception
-        if (rxfail > rxLastFailCnt) {
-            do {
-                memset(&entry, 0, sizeof(entry));
-                FI_CALL(ret, fi_cq_sread, famCtx->get_txcq(), &entry, 1, NULL,
-                        FABRIC_TIMEOUT);
-                if (ret < 0 && (ret != -FI_EAGAIN) && (ret != -FI_ETIMEDOUT)) {
-                    // Flush all the errors from completion queue
-                    struct fi_cq_err_entry err;
-                    FI_CALL_NO_RETURN(fi_cq_readerr, famCtx->get_txcq(), &err,
-                                      0);
-                    const char *errmsg =
-                        fi_cq_strerror(famCtx->get_txcq(), err.prov_errno,
-                                       err.err_data, NULL, 0);
-                    famCtx->inc_num_rx_fail_cnt(rxfail - rxLastFailCnt);
-                    THROW_ERRNO_MSG(Fam_Datapath_Exception,
-                                    get_fam_error(err.err), errmsg);
-                }
-            } while (ret < 0 &&
-                     ((ret == -FI_EAGAIN) || (ret == -FI_ETIMEDOUT)));
-        }
-
-        if (timeout_retry_cnt < TIMEOUT_RETRY) {
-            timeout_retry_cnt++;
-        } else if (timeout_wait_retry_cnt < TIMEOUT_WAIT_RETRY) {
-            timeout_wait_retry_cnt++;
-            usleep(FABRIC_TIMEOUT * 1000);
-        } else {
-            THROW_ERR_MSG(Fam_Timeout_Exception,
-                          "Timeout retry count exceeded INT_MAX");
-        }
-    } while ((rxsuccess + rxfail) < rxcnt);
+    while (!fabric_ops_completed(famCtx, false, rxcnt, rxLastFailCnt))
+        fabric_quiet_backoff(&timeout_retry_cnt, &timeout_wait_retry_cnt);
 
     return;
 }
@@ -1544,28 +1795,122 @@ void fabric_quiet(Fam_Context *famCtx) {
         throw;
     }
 
+    // All the operations of this context have completed. Nothing can be
+    // issued while the write lock is held.
+    famCtx->release_held_resources();
+
     // Release Fam_Context Write lock
     famCtx->release_lock();
     return;
 }
 
+/*
+ * fabric quiet on a set of contexts : the calling thread polls the counters
+ * of all the contexts in turn until each of them has completed its
+ * non-blocking operations. If any context reports an error, the remaining
+ * contexts are still drained before the error is thrown.
+ *  @param famCtxs - vector of Fam_Context pointers
+ */
+void fabric_quiet_contexts(std::vector<Fam_Context *> *famCtxs) {
+    size_t numCtx = famCtxs->size();
+    std::vector<uint64_t> txcnt(numCtx), rxcnt(numCtx);
+    std::vector<uint64_t> txLastFailCnt(numCtx), rxLastFailCnt(numCtx);
+    // 0 - tx pending, 1 - rx pending, 2 - done
+    std::vector<int> state(numCtx, 0);
+    size_t pending = numCtx;
+    int timeout_retry_cnt = 0;
+    int timeout_wait_retry_cnt = 0;
+    // First error reported by a context, thrown once all are drained
+    std::exception_ptr firstErr;
+
+    // Take Fam_Context Write locks
+    for (size_t i = 0; i < numCtx; i++) {
+        Fam_Context *famCtx = (*famCtxs)[i];
+        famCtx->aquire_WRLock();
+        txLastFailCnt[i] = famCtx->get_num_tx_fail_cnt();
+        rxLastFailCnt[i] = famCtx->get_num_rx_fail_cnt();
+        txcnt[i] = famCtx->get_num_tx_ops();
+        rxcnt[i] = famCtx->get_num_rx_ops();
+    }
+
+    try {
+        while (pending > 0) {
+            for (size_t i = 0; i < numCtx; i++) {
+                Fam_Context *famCtx = (*famCtxs)[i];
+                try {
+                    if (state[i] == 0 &&
+                        fabric_ops_completed(famCtx, true, txcnt[i],
+                                             txLastFailCnt[i]))
+                        state[i] = 1;
+                    if (state[i] == 1 &&
+                        fabric_ops_completed(famCtx, false, rxcnt[i],
+                                             rxLastFailCnt[i])) {
+                        state[i] = 2;
+                        pending--;
+                    }
+                } catch (Fam_Exception &e) {
+                    // Already converted with get_fam_error; keep it as is
+                    if (!firstErr)
+                        firstErr = std::current_exception();
+                    state[i] = 2;
+                    pending--;
+                }
+            }
+            if (pending > 0)
+                fabric_quiet_backoff(&timeout_retry_cnt,
+                                     &timeout_wait_retry_cnt);
+        }
+    } catch (...) {
+        // Release Fam_Context Write locks
+        for (auto famCtx : *famCtxs)
+            famCtx->release_lock();
+        throw;
+    }
+
+    // All the operations of these contexts have completed or failed.
+    // Nothing can be issued while the write locks are held.
+    for (auto famCtx : *famCtxs)
+        famCtx->release_held_resources();
+
+    // Release Fam_Context Write locks
+    for (auto famCtx : *famCtxs)
+        famCtx->release_lock();
+
+    if (firstErr)
+        std::rethrow_exception(firstErr);
+    return;
+}
+
+// Size of an operand of the given datatype
+static size_t fabric_atomic_size(enum fi_datatype datatype) {
+    return ((datatype == FI_INT32 || datatype == FI_UINT32 ||
+             datatype == FI_FLOAT)
+                ? sizeof(uint32_t)
+                : sizeof(uint64_t));
+}
+
 void fabric_atomic(uint64_t key, void *value, uint64_t offset, enum fi_op op,
                    enum fi_datatype datatype, fi_addr_t fiAddr,
                    Fam_Context *famCtx) {
+    size_t size = fabric_atomic_size(datatype);
+    Fam_MR_Cache_Entry *valueMr = famCtx->acquire_local_mr(value, size);
+    void *valueDesc = (valueMr ? valueMr->desc : NULL);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
 
-    struct fi_context *ctx = new struct fi_context();
+    // No completion is requested for this operation, so it does not need
+    // an fi_context
     struct fi_msg_atomic msg = {.msg_iov = &iov,
-                                .desc = 0,
+                                .desc = &valueDesc,
                                 .iov_count = 1,
                                 .addr = fiAddr,
                                 .rma_iov = &rma_iov,
                                 .rma_iov_count = 1,
                                 .datatype = datatype,
                                 .op = op,
-                                .context = ctx,
+                                .context = NULL,
                                 .data = 0};
 
     ssize_t ret;
@@ -1582,11 +1927,14 @@ void fabric_atomic(uint64_t key, void *value, uint64_t offset, enum fi_op op,
     } catch (...) {
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(valueMr);
         throw;
     }
 
     // Release Fam_Context read lock
     famCtx->release_lock();
+    // The operand is injected, its buffer is no longer used
+    famCtx->release_local_mr(valueMr);
 
     return;
 }
@@ -1595,18 +1943,23 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
                          uint64_t offset, enum fi_op op,
                          enum fi_datatype datatype, fi_addr_t fiAddr,
                          Fam_Context *famCtx) {
+    size_t size = fabric_atomic_size(datatype);
+    Fam_MR_Cache_Entry *valueMr = famCtx->acquire_local_mr(value, size);
+    Fam_MR_Cache_Entry *resultMr = famCtx->acquire_local_mr(result, size);
+    void *valueDesc = (valueMr ? valueMr->desc : NULL);
+    void *resultDesc = (resultMr ? resultMr->desc : NULL);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
 
     struct fi_ioc result_iov = {.addr = result, .count = 1};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
 
     struct fi_msg_atomic msg = {.msg_iov = &iov,
-                                .desc = 0,
+                                .desc = &valueDesc,
                                 .iov_count = 1,
                                 .addr = fiAddr,
                                 .rma_iov = &rma_iov,
@@ -1626,7 +1979,7 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
     try {
         do {
             FI_CALL(ret, fi_fetch_atomicmsg, famCtx->get_ep(), &msg,
-                    &result_iov, 0, 1, FI_COMPLETION);
+                    &result_iov, &resultDesc, 1, FI_COMPLETION);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
         famCtx->inc_num_rx_ops();
         incr++;
@@ -1635,13 +1988,126 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
         famCtx->inc_num_rx_fail_cnt(incr);
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(valueMr);
+        famCtx->hold_local_mr(resultMr);
         throw;
     }
 
     // Release Fam_Context read lock
     famCtx->release_lock();
 
-    delete ctx;
+    famCtx->put_fi_context(ctx);
+    famCtx->release_local_mr(valueMr);
+    famCtx->release_local_mr(resultMr);
+
+    return;
+}
+
+/*
+ * Wait for the operations in flight on famCtx and release the operands and
+ * registrations it holds for them, once it holds
+ * FAM_MAX_HELD_ATOMIC_OPERANDS operands, so that they do not grow without
+ * bound between two quiets. An error of an earlier operation is reported
+ * here, as by a quiet.
+ */
+static void fabric_limit_held_operands(Fam_Context *famCtx) {
+    if (famCtx->get_num_held_operands() < FAM_MAX_HELD_ATOMIC_OPERANDS)
+        return;
+
+    // Take Fam_Context Write lock
+    famCtx->aquire_WRLock();
+    try {
+        // Another thread may have released them in the meantime
+        if (famCtx->get_num_held_operands() >= FAM_MAX_HELD_ATOMIC_OPERANDS) {
+            fabric_put_quiet(famCtx);
+            fabric_get_quiet(famCtx);
+            famCtx->release_held_resources();
+        }
+    } catch (...) {
+        // Release Fam_Context Write lock
+        famCtx->release_lock();
+        throw;
+    }
+
+    // Release Fam_Context Write lock
+    famCtx->release_lock();
+}
+
+/*
+ * Fabric fetching atomic, nonblocking : the old value is stored in result,
+ * which must stay valid until the operation is quiesced.
+ * @param key - key of the memory region
+ * @param value - pointer to the operand, copied before returning
+ * @param result - pointer to the location receiving the old value
+ * @param offset - offset to the remote memory address
+ * @param op - atomic operation
+ * @param datatype - datatype of the operand
+ * @param fiAddr - fi_addr_t address
+ * @param famCtx - Pointer to Fam_Context
+ */
+void fabric_fetch_atomic_nonblocking(uint64_t key, void *value, void *result,
+                                     uint64_t offset, enum fi_op op,
+                                     enum fi_datatype datatype,
+                                     fi_addr_t fiAddr, Fam_Context *famCtx) {
+    struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
+
+    struct fi_ioc result_iov = {.addr = result, .count = 1};
+
+    size_t size = fabric_atomic_size(datatype);
+    fabric_limit_held_operands(famCtx);
+    Fam_MR_Cache_Entry *resultMr = famCtx->acquire_local_mr(result, size);
+    void *resultDesc = (resultMr ? resultMr->desc : NULL);
+
+    ssize_t ret;
+    uint32_t retry_cnt = 0;
+
+    // Take Fam_Context read lock
+    famCtx->aquire_RDLock();
+
+    // The operand and the registrations are kept by the context until the
+    // next quiet; they are taken under the read lock so that a concurrent
+    // quiet cannot release them before the operation is issued.
+    struct fi_ioc iov = {.addr = famCtx->hold_atomic_operand(value, size),
+                         .count = 1};
+    Fam_MR_Cache_Entry *valueMr = NULL;
+    try {
+        valueMr = famCtx->acquire_local_mr(iov.addr, size);
+    } catch (...) {
+        famCtx->release_lock();
+        famCtx->release_local_mr(resultMr);
+        throw;
+    }
+    famCtx->hold_local_mr(valueMr);
+    famCtx->hold_local_mr(resultMr);
+    void *valueDesc = (valueMr ? valueMr->desc : NULL);
+
+    // No completion is requested; the operation is counted and completed
+    // by quiet
+    struct fi_msg_atomic msg = {.msg_iov = &iov,
+                                .desc = &valueDesc,
+                                .iov_count = 1,
+                                .addr = fiAddr,
+                                .rma_iov = &rma_iov,
+                                .rma_iov_count = 1,
+                                .datatype = datatype,
+                                .op = op,
+                                .context = NULL,
+                                .data = 0};
+
+    try {
+        do {
+            FI_CALL(ret, fi_fetch_atomicmsg, famCtx->get_ep(), &msg,
+                    &result_iov, &resultDesc, 1, 0);
+        } while (fabric_retry(famCtx, ret, &retry_cnt));
+        famCtx->inc_num_rx_ops();
+    } catch (...) {
+        // Release Fam_Context read lock
+        famCtx->release_lock();
+        throw;
+    }
+
+    // Release Fam_Context read lock
+    famCtx->release_lock();
 
     return;
 }
@@ -1650,6 +2116,14 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
                            void *value, uint64_t offset, enum fi_op op,
                            enum fi_datatype datatype, fi_addr_t fiAddr,
                            Fam_Context *famCtx) {
+    size_t size = fabric_atomic_size(datatype);
+    Fam_MR_Cache_Entry *valueMr = famCtx->acquire_local_mr(value, size);
+    Fam_MR_Cache_Entry *compareMr = famCtx->acquire_local_mr(compare, size);
+    Fam_MR_Cache_Entry *resultMr = famCtx->acquire_local_mr(result, size);
+    void *valueDesc = (valueMr ? valueMr->desc : NULL);
+    void *compareDesc = (compareMr ? compareMr->desc : NULL);
+    void *resultDesc = (resultMr ? resultMr->desc : NULL);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
@@ -1658,12 +2132,11 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
 
     struct fi_ioc compare_iov = {.addr = compare, .count = 1};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
 
     struct fi_msg_atomic msg = {.msg_iov = &iov,
-                                .desc = 0,
+                                .desc = &valueDesc,
                                 .iov_count = 1,
                                 .addr = fiAddr,
                                 .rma_iov = &rma_iov,
@@ -1683,7 +2156,8 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
     try {
         do {
             FI_CALL(ret, fi_compare_atomicmsg, famCtx->get_ep(), &msg,
-                    &compare_iov, 0, 1, &result_iov, 0, 1, FI_COMPLETION);
+                    &compare_iov, &compareDesc, 1, &result_iov, &resultDesc,
+                    1, FI_COMPLETION);
 
         } while (fabric_retry(famCtx, ret, &retry_cnt));
         famCtx->inc_num_rx_ops();
@@ -1693,13 +2167,19 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
         famCtx->inc_num_rx_fail_cnt(incr);
         // Release Fam_Context read lock
         famCtx->release_lock();
+        famCtx->hold_local_mr(valueMr);
+        famCtx->hold_local_mr(compareMr);
+        famCtx->hold_local_mr(resultMr);
         throw;
     }
 
     // Release Fam_Context read lock
     famCtx->release_lock();
 
-    delete ctx;
+    famCtx->put_fi_context(ctx);
+    famCtx->release_local_mr(valueMr);
+    famCtx->release_local_mr(compareMr);
+    famCtx->release_local_mr(resultMr);
 
     return;
 }
@@ -1741,14 +2221,36 @@ enum Fam_Error get_fam_error(int fabErr) {
 
 void fabric_send_response(void *retStatus, fi_addr_t fiAddr,
                           Fam_Context *famCtx, size_t nbytes) {
+    fi_context *ctx =
+        fabric_post_send_response(retStatus, fiAddr, famCtx, nbytes);
+    fabric_send_response_wait(famCtx, ctx);
+}
+
+/*
+ * fabric post send response : send the response without waiting for it to
+ * complete, so that several responses can be in flight at once.
+ * @param retStatus - return status of the request; it must not be freed
+ * before the send completes
+ * @param fiAddr - fi_addr_t address
+ * @param famCtx - Pointer to Fam_Context
+ * @param nbytes - number of the bytes in retStatus
+ * @return - fi_context taken from the famCtx pool; wait for the send with
+ * fabric_send_response_wait.
+ */
+fi_context *fabric_post_send_response(void *retStatus, fi_addr_t fiAddr,
+                                      Fam_Context *famCtx, size_t nbytes) {
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(retStatus, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = (void *)retStatus, .iov_len = nbytes};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
+    // Released with ctx once the send has completed
+    famCtx->hold_local_mr(ctx, mrEntry);
 
     struct fi_msg msg = {.msg_iov = &iov,
-                         .desc = 0,
+                         .desc = &desc,
                          .iov_count = 1,
                          .addr = fiAddr,
                          .context = ctx,
@@ -1756,7 +2258,6 @@ void fabric_send_response(void *retStatus, fi_addr_t fiAddr,
 
     ssize_t ret;
     uint32_t retry_cnt = 0;
-    uint64_t incr = 0;
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
@@ -1765,19 +2266,38 @@ void fabric_send_response(void *retStatus, fi_addr_t fiAddr,
             FI_CALL(ret, fi_sendmsg, famCtx->get_ep(), &msg,
                     FI_COMPLETION | FI_DELIVERY_COMPLETE);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
+    } catch (...) {
+        // Release Fam_Context read lock
+        famCtx->release_lock();
+        throw;
+    }
 
-        famCtx->inc_num_tx_ops();
-        incr++;
-        ret = fabric_completion_wait(famCtx, ctx, 0);
+    famCtx->inc_num_tx_ops();
+    famCtx->release_lock();
+    return ctx;
+}
+
+/*
+ * fabric send response wait : wait for a send posted by
+ * fabric_post_send_response and return its fi_context to the pool.
+ * @param famCtx - Pointer to Fam_Context
+ * @param ctx - fi_context returned by fabric_post_send_response
+ */
+void fabric_send_response_wait(Fam_Context *famCtx, fi_context *ctx) {
+    // Take Fam_Context read lock
+    famCtx->aquire_RDLock();
+
+    try {
+        fabric_completion_wait(famCtx, ctx, 0);
     } catch (...) {
-        famCtx->inc_num_tx_fail_cnt(incr);
+        famCtx->inc_num_tx_fail_cnt(1);
         // Release Fam_Context read lock
         famCtx->release_lock();
         throw;
     }
 
     famCtx->release_lock();
-    delete ctx;
+    famCtx->put_fi_context(ctx);
 }
 /*
  * fabric post response buff
@@ -1785,17 +2305,22 @@ void fabric_send_response(void *retStatus, fi_addr_t fiAddr,
  * @param nbytes - number of the bytes in retStatus
  * @param fiAddr - fi_addr_t address
  * @param famCtx - Pointer to Fam_Context
- * @return - fi_context
+ * @return - fi_context taken from the famCtx pool; return it with
+ *           Fam_Context::put_fi_context() once the receive has completed
  */
 fi_context *fabric_post_response_buff(void *retStatus, fi_addr_t fiAddr,
                                       Fam_Context *famCtx, size_t nbytes) {
+    Fam_MR_Cache_Entry *mrEntry = famCtx->acquire_local_mr(retStatus, nbytes);
+    void *desc = (mrEntry ? mrEntry->desc : NULL);
+
     struct iovec iov = {.iov_base = retStatus, .iov_len = nbytes};
 
-    struct fi_context *ctx = new struct fi_context();
-    memset(ctx, 0, sizeof(struct fi_context));
+    struct fi_context *ctx = famCtx->get_fi_context();
     ctx->internal[2] = (void *)1;
+    // Released with ctx once the receive has completed
+    famCtx->hold_local_mr(ctx, mrEntry);
     struct fi_msg msg = {.msg_iov = &iov,
-                         .desc = 0,
+                         .desc = &desc,
                          .iov_count = 1,
                          .addr = fiAddr,
                          .context = ctx,
@@ -59,6 +59,18 @@
 #include "fam/fam_exception.h"
 
 namespace openfam {
+/*
+ * A contiguous piece of a transfer : nbytes at local are read from or
+ * written to offset within the memory registered with key at fiAddr.
+ */
+typedef struct {
+    uint64_t key;
+    void *local;
+    size_t nbytes;
+    uint64_t offset;
+    fi_addr_t fiAddr;
+} Fabric_Rma_Segment;
+
 int fabric_initialize(const char *name, const char *service, bool source,
                       char *provider, struct fi_info **fi,
                       struct fid_fabric **fabric, struct fid_eq **eq,
@@ -90,6 +102,24 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
 int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
                 fi_addr_t fiAddr, Fam_Context *famCtx);
 
+int fabric_write_pipelined(uint64_t key, const void *local, size_t nbytes,
+                           uint64_t offset, fi_addr_t fiAddr,
+                           Fam_Context *famCtx, size_t chunkSize,
+                           size_t pipelineDepth);
+
+int fabric_read_pipelined(uint64_t key, const void *local, size_t nbytes,
+                          uint64_t offset, fi_addr_t fiAddr,
+                          Fam_Context *famCtx, size_t chunkSize,
+                          size_t pipelineDepth);
+
+int fabric_write_segments(std::vector<Fabric_Rma_Segment> *segments,
+                          Fam_Context *famCtx, size_t chunkSize,
+                          size_t pipelineDepth);
+
+int fabric_read_segments(std::vector<Fabric_Rma_Segment> *segments,
+                         Fam_Context *famCtx, size_t chunkSize,
+                         size_t pipelineDepth);
+
 int fabric_scatter_stride_blocking(uint64_t key, const void *local,
                                    size_t nbytes, uint64_t first,
                                    uint64_t count, uint64_t stride,
@@ -148,6 +178,8 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *context);
 
 void fabric_quiet(Fam_Context *context);
 
+void fabric_quiet_contexts(std::vector<Fam_Context *> *contexts);
+
 int fabric_retry(Fam_Context *context, int ret, uint64_t *retry_cnt);
 
 int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx, int ioType);
@@ -161,6 +193,11 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
                          enum fi_datatype datatype, fi_addr_t fiAddr,
                          Fam_Context *famCtx);
 
+void fabric_fetch_atomic_nonblocking(uint64_t key, void *value, void *result,
+                                     uint64_t offset, enum fi_op op,
+                                     enum fi_datatype datatype,
+                                     fi_addr_t fiAddr, Fam_Context *famCtx);
+
 void fabric_compare_atomic(uint64_t key, void *value, void *result,
                            void *compare, uint64_t offset, enum fi_op op,
                            enum fi_datatype datatype, fi_addr_t fiAddr,
@@ -177,6 +214,11 @@ enum Fam_Error get_fam_error(int fabErr);
 void fabric_send_response(void *retStatus, fi_addr_t fiAddr,
                           Fam_Context *famCtx, size_t nbytes);
 
+fi_context *fabric_post_send_response(void *retStatus, fi_addr_t fiAddr,
+                                      Fam_Context *famCtx, size_t nbytes);
+
+void fabric_send_response_wait(Fam_Context *famCtx, fi_context *ctx);
+
 fi_context *fabric_post_response_buff(void *retStatus, fi_addr_t fiAddr,
                                       Fam_Context *famCtx, size_t nbytes);
 
@@ -60,11 +60,6 @@ typedef enum CIS_Direct_Counter_Enum {
     CIS_DIRECT_COUNTER_MAX
 } CIS_Direct_Counter_Enum_T;
 
-typedef enum CIS_Async_Counter_Enum {
-#include "cis/cis_async_counters.tbl"
-    CIS_ASYNC_COUNTER_MAX
-} CIS_Async_Counter_Enum_T;
-
 typedef enum Metadata_Server_Counter_Enum {
 #include "metadata_service/metadata_server_counters.tbl"
     METADATA_SERVER_COUNTER_MAX
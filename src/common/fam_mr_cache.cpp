@@ -0,0 +1,192 @@
+/*
+ * fam_mr_cache.cpp
+ * Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ * rights reserved. Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "common/fam_mr_cache.h"
+#include "common/fam_internal_exception.h"
+#include "fam/fam_exception.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+namespace openfam {
+
+// Requested keys for providers that do not generate keys (no FI_MR_PROV_KEY)
+static uint64_t nextMrCacheKey = 1;
+
+static uint64_t mr_cache_page_size() {
+    static uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+    return pageSize;
+}
+
+void set_libfabric_mr_cache_size(size_t cacheSize) {
+    setenv("FI_MR_CACHE_MAX_COUNT", to_string(cacheSize).c_str(), 0);
+}
+
+Fam_MR_Cache::Fam_MR_Cache(struct fid_domain *domain_) {
+    domain = domain_;
+    numHits = 0;
+    numMisses = 0;
+    (void)pthread_rwlock_init(&cacheLock, NULL);
+}
+
+Fam_MR_Cache::~Fam_MR_Cache() {
+    // All the operations have completed by now; close every registration
+    for (auto entry : entries)
+        close_entry(entry.second);
+    entries.clear();
+    pthread_rwlock_destroy(&cacheLock);
+}
+
+/*
+ * Returns the first entry which may overlap a range starting at start: the
+ * last one starting at or before start if it extends past it, otherwise the
+ * first one starting after it. Called with cacheLock held.
+ */
+std::map<uint64_t, Fam_MR_Cache_Entry *>::iterator
+Fam_MR_Cache::find_overlap(uint64_t start) {
+    auto it = entries.upper_bound(start);
+    if (it != entries.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second->end > start)
+            it = prev;
+    }
+    return it;
+}
+
+/*
+ * Returns the entry covering [start, end) with a reference taken on it,
+ * NULL if there is none. Called with cacheLock held, for reading at least.
+ */
+Fam_MR_Cache_Entry *Fam_MR_Cache::find_covering(uint64_t start,
+                                                uint64_t end) {
+    auto it = find_overlap(start);
+    if (it == entries.end() || it->second->start > start ||
+        it->second->end < end)
+        return NULL;
+    Fam_MR_Cache_Entry *entry = it->second;
+    entry->refCnt++;
+    numHits.fetch_add(1, std::memory_order_relaxed);
+    return entry;
+}
+
+Fam_MR_Cache_Entry *Fam_MR_Cache::acquire(const void *addr, size_t len) {
+    uint64_t pageSize = mr_cache_page_size();
+    uint64_t start = (uint64_t)addr & ~(pageSize - 1);
+    uint64_t end = ((uint64_t)addr + (len ? len : 1) + pageSize - 1) &
+                   ~(pageSize - 1);
+
+    pthread_rwlock_rdlock(&cacheLock);
+    Fam_MR_Cache_Entry *entry = find_covering(start, end);
+    pthread_rwlock_unlock(&cacheLock);
+    if (entry)
+        return entry;
+
+    pthread_rwlock_wrlock(&cacheLock);
+    // Another thread may have registered the range in the meantime
+    entry = find_covering(start, end);
+    if (entry) {
+        pthread_rwlock_unlock(&cacheLock);
+        return entry;
+    }
+    numMisses++;
+
+    // Merge the overlapping ranges in use into the new registration so that
+    // ranges never overlap; the old registrations are closed when their
+    // operations complete.
+    auto it = find_overlap(start);
+    while (it != entries.end() && it->second->start < end) {
+        Fam_MR_Cache_Entry *old = it->second;
+        ++it;
+        start = std::min(start, old->start);
+        end = std::max(end, old->end);
+        retire(old);
+    }
+
+    struct fid_mr *mr;
+    uint64_t requestedKey = __atomic_fetch_add(&nextMrCacheKey, 1,
+                                               __ATOMIC_RELAXED);
+    int ret = fi_mr_reg(domain, (void *)start, end - start, FI_READ | FI_WRITE,
+                        0, requestedKey, 0, &mr, NULL);
+    if (ret < 0) {
+        pthread_rwlock_unlock(&cacheLock);
+        std::ostringstream message;
+        message << "Registration of local buffer failed: " << fi_strerror(-ret);
+        THROW_ERR_MSG(Fam_Datapath_Exception, message.str().c_str());
+    }
+
+    entry = new Fam_MR_Cache_Entry();
+    entry->start = start;
+    entry->end = end;
+    entry->mr = mr;
+    entry->desc = fi_mr_desc(mr);
+    entry->refCnt = 1;
+    entry->cached = true;
+    entries.insert({start, entry});
+    pthread_rwlock_unlock(&cacheLock);
+    return entry;
+}
+
+void Fam_MR_Cache::release(Fam_MR_Cache_Entry *entry) {
+    // Hits take references under the read lock, so the last reference is
+    // only known to be the last one under the write lock.
+    pthread_rwlock_wrlock(&cacheLock);
+    if (entry->refCnt.fetch_sub(1) == 1) {
+        if (entry->cached)
+            entries.erase(entry->start);
+        close_entry(entry);
+    }
+    pthread_rwlock_unlock(&cacheLock);
+}
+
+/*
+ * Remove an entry replaced by a larger registration; it is closed now if
+ * idle, otherwise when its last user releases it. Called with cacheLock
+ * held for writing.
+ */
+void Fam_MR_Cache::retire(Fam_MR_Cache_Entry *entry) {
+    entries.erase(entry->start);
+    entry->cached = false;
+    if (entry->refCnt.load() == 0)
+        close_entry(entry);
+}
+
+void Fam_MR_Cache::close_entry(Fam_MR_Cache_Entry *entry) {
+    fi_close(&entry->mr->fid);
+    delete entry;
+}
+
+} // namespace openfam
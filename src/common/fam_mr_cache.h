@@ -0,0 +1,126 @@
+/*
+ * fam_mr_cache.h
+ * Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ * rights reserved. Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef FAM_MR_CACHE_H
+#define FAM_MR_CACHE_H
+
+#include <atomic>
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <rdma/fabric.h>
+#include <rdma/fi_domain.h>
+
+// Default number of registrations kept by the libfabric registration cache
+#define FAM_DEFAULT_LOCAL_MR_CACHE_SIZE 1024
+
+namespace openfam {
+
+/*
+ * A registration of a page aligned local address range. refCnt counts the
+ * operations using it; it is closed when the last of them releases it.
+ */
+typedef struct Fam_MR_Cache_Entry {
+    uint64_t start;
+    uint64_t end;
+    struct fid_mr *mr;
+    void *desc;
+    std::atomic<uint64_t> refCnt;
+    bool cached;
+} Fam_MR_Cache_Entry;
+
+/*
+ * Registrations of local buffers, used with providers that require
+ * descriptors for local buffers (FI_MR_LOCAL). A registration is shared by
+ * the operations in flight on the same range and closed once the last of
+ * them completes, so that no registration outlives the mapping it was made
+ * for. Registrations are reused across operations by the registration cache
+ * of the provider, which its memory monitor (FI_MR_CACHE_MONITOR) keeps
+ * coherent with munmap() and the other ways memory is given back; its size
+ * is FI_MR_CACHE_MAX_COUNT (see set_libfabric_mr_cache_size).
+ *
+ * Lookups only take cacheLock for reading; it is taken for writing when a
+ * range is registered or its last user releases it.
+ */
+class Fam_MR_Cache {
+  public:
+    Fam_MR_Cache(struct fid_domain *domain);
+
+    ~Fam_MR_Cache();
+
+    /**
+     * Get a registration covering [addr, addr + len), registering the range
+     * if no operation in flight uses a registration covering it.
+     * @param addr - start of the local buffer
+     * @param len - length of the local buffer
+     * @return - entry holding the descriptor; must be released with release()
+     */
+    Fam_MR_Cache_Entry *acquire(const void *addr, size_t len);
+
+    /**
+     * Release an entry obtained with acquire() once the operations using it
+     * have completed.
+     * @param entry - cache entry
+     */
+    void release(Fam_MR_Cache_Entry *entry);
+
+    uint64_t get_num_hits() { return numHits.load(); }
+
+    uint64_t get_num_misses() { return numMisses.load(); }
+
+  private:
+    std::map<uint64_t, Fam_MR_Cache_Entry *>::iterator
+    find_overlap(uint64_t start);
+
+    Fam_MR_Cache_Entry *find_covering(uint64_t start, uint64_t end);
+
+    void retire(Fam_MR_Cache_Entry *entry);
+
+    void close_entry(Fam_MR_Cache_Entry *entry);
+
+    struct fid_domain *domain;
+    pthread_rwlock_t cacheLock;
+    // Registrations in use keyed by start address; they never overlap
+    std::map<uint64_t, Fam_MR_Cache_Entry *> entries;
+    std::atomic<uint64_t> numHits;
+    std::atomic<uint64_t> numMisses;
+};
+
+/*
+ * Size the registration cache of the libfabric providers, unless set in
+ * the environment. Must be called before the first fi_getinfo().
+ * @param cacheSize - maximum number of cached registrations, 0 disables it
+ */
+void set_libfabric_mr_cache_size(size_t cacheSize);
+
+} // namespace openfam
+#endif
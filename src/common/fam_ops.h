@@ -312,6 +312,19 @@ class Fam_Ops {
                        uint64_t nbytes) = 0;
 
     virtual void wait_for_copy(void *waitObj) = 0;
+
+    /**
+     * Number of bytes copied so far by the copy of waitObj.
+     * @param waitObj - wait object returned by copy
+     */
+    virtual uint64_t copy_progress(void *waitObj) = 0;
+
+    /**
+     * Stop the copy of waitObj before its next chunk. wait_for_copy still
+     * has to be called; it reports the copy as cancelled.
+     * @param waitObj - wait object returned by copy
+     */
+    virtual void cancel_copy(void *waitObj) = 0;
     // ATOMICS Group
 
     // NON fetching routines
@@ -564,6 +577,36 @@ class Fam_Ops {
     virtual double atomic_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                     double value) = 0;
 
+    /**
+     * fetch and add nonblocking group - atomically add the given value to the
+     * value at the given offset within a data item in FAM; the old value is
+     * stored in result once the operation completes (see quiet)
+     * @param descriptor - valid descriptor to data item in FAM
+     * @param offset - byte offset within the data item of the value to be
+     * updated
+     * @param value - value to be added to the existing value at the given
+     * location
+     * @param result - location receiving the old value
+     */
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, int32_t value,
+                                              int32_t *result) = 0;
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, int64_t value,
+                                              int64_t *result) = 0;
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, uint32_t value,
+                                              uint32_t *result) = 0;
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, uint64_t value,
+                                              uint64_t *result) = 0;
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, float value,
+                                              float *result) = 0;
+    virtual void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                              uint64_t offset, double value,
+                                              double *result) = 0;
+
     /**
      * fetch and subtract group - atomically subtract the given value from the
      * value at the given offset within a data item in FAM, and return the old
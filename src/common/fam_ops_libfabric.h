@@ -32,6 +32,7 @@
 #define FAM_OPS_LIBFABRIC_H
 
 #include <iostream>
+#include <list>
 #include <map>
 #include <string.h>
 #include <sys/uio.h>
@@ -56,6 +57,11 @@
 
 using namespace std;
 
+// Blocking put/get larger than the chunk size are split into chunks with up
+// to pipeline depth chunks in flight
+#define FAM_DEFAULT_PUT_GET_CHUNK_SIZE (4 * 1024 * 1024)
+#define FAM_DEFAULT_PUT_GET_PIPELINE_DEPTH 8
+
 namespace openfam {
 
 class Fam_Allocator_Client;
@@ -101,6 +107,29 @@ class Fam_Ops_Libfabric : public Fam_Ops {
 
     void abort(int status);
 
+    /**
+     * Set the chunk size and pipeline depth used by large blocking put/get.
+     * Must be called before initialize(); the chunk size is capped at the
+     * provider's maximum message size.
+     * @param chunkSize - chunk size in bytes
+     * @param pipelineDepth - maximum number of chunks in flight
+     */
+    void set_put_get_chunking(size_t chunkSize, size_t pipelineDepth) {
+        putGetChunkSize = chunkSize;
+        putGetPipelineDepth = pipelineDepth;
+    }
+
+    /**
+     * Set the size of the provider's registration cache, which keeps the
+     * local buffer registrations when the provider requires local
+     * descriptors (FI_MR_LOCAL); 0 registers the buffers on every transfer.
+     * Must be called before initialize().
+     * @param cacheSize - maximum number of cached registrations
+     */
+    void set_local_mr_cache_size(size_t cacheSize) {
+        localMrCacheSize = cacheSize;
+    }
+
     int put_blocking(void *local, Fam_Descriptor *descriptor, uint64_t offset,
                      uint64_t nbytes);
     int get_blocking(void *local, Fam_Descriptor *descriptor, uint64_t offset,
@@ -148,6 +177,10 @@ class Fam_Ops_Libfabric : public Fam_Ops {
 
     void wait_for_copy(void *waitObj);
 
+    uint64_t copy_progress(void *waitObj);
+
+    void cancel_copy(void *waitObj);
+
     void fence(Fam_Region_Descriptor *descriptor = NULL);
 
     void quiet(Fam_Region_Descriptor *descriptor = NULL);
@@ -257,6 +290,25 @@ class Fam_Ops_Libfabric : public Fam_Ops {
     double atomic_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                             double value);
 
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, int32_t value,
+                                      int32_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, int64_t value,
+                                      int64_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, uint32_t value,
+                                      uint32_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, uint64_t value,
+                                      uint64_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, float value,
+                                      float *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, double value,
+                                      double *result);
+
     int32_t atomic_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                                   int32_t value);
     int64_t atomic_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
@@ -355,6 +407,37 @@ class Fam_Ops_Libfabric : public Fam_Ops {
 
     Fam_Context *get_context(Fam_Descriptor *descriptor);
 
+    /**
+     * Get the contexts of the calling thread, keyed by memory server id.
+     * Used with FAM_CONTEXT_THREAD; the map is only accessed by its thread.
+     * @param create - create the map if the thread has none yet
+     * @return - pointer to the context map of the calling thread, NULL if
+     * it has none and create is false
+     */
+    std::map<uint64_t, Fam_Context *> *get_thread_contexts(bool create = true);
+
+    /**
+     * Quiet and delete the contexts of a thread which exits.
+     * @param ctxMap - context map of the thread
+     */
+    void release_thread_contexts(std::map<uint64_t, Fam_Context *> *ctxMap);
+
+    /**
+     * Get a context for copies between memory servers. Used on the memory
+     * server, each copy worker uses the context of its own index.
+     * @param idx - index of the copy worker
+     * @return - pointer to the context
+     */
+    Fam_Context *get_copy_context(uint64_t idx);
+
+    /**
+     * Get a context for the Atomic Transfer Library. Used on the memory
+     * server, each ATL queue thread uses the context of its queue.
+     * @param idx - queue id
+     * @return - pointer to the context
+     */
+    Fam_Context *get_atl_context(uint64_t idx);
+
     void quiet_context(Fam_Context *context);
 
     size_t get_addr_size() { return serverAddrNameLen; };
@@ -374,6 +457,10 @@ class Fam_Ops_Libfabric : public Fam_Ops {
     std::map<uint64_t, fi_addr_t> *get_fiMemsrvMap() { return fiMemsrvMap; }
 
   protected:
+    // Context idx of workerCtxs, created on first use
+    Fam_Context *get_worker_context(std::vector<Fam_Context *> *workerCtxs,
+                                    uint64_t idx);
+
     // Server_Map name;
     char *memoryServerName;
     char *service;
@@ -386,6 +473,11 @@ class Fam_Ops_Libfabric : public Fam_Ops {
     struct fid_domain *domain;
     struct fid_av *av;
     size_t fabric_iov_limit;
+    size_t putGetChunkSize;
+    size_t putGetPipelineDepth;
+    // Cache of local buffer registrations, NULL unless FI_MR_LOCAL
+    Fam_MR_Cache *localMrCache;
+    size_t localMrCacheSize;
     size_t serverAddrNameLen;
     void *serverAddrName;
     std::map<uint64_t, std::pair<void *, size_t>> *memServerAddrs;
@@ -400,6 +492,13 @@ class Fam_Ops_Libfabric : public Fam_Ops {
 
     std::map<uint64_t, Fam_Context *> *contexts;
     std::map<uint64_t, Fam_Context *> *defContexts;
+    // Context maps of all application threads (FAM_CONTEXT_THREAD)
+    std::list<std::map<uint64_t, Fam_Context *> *> *threadContexts;
+    // Contexts of the memory server copy workers and ATL queue threads
+    std::vector<Fam_Context *> *copyContexts;
+    std::vector<Fam_Context *> *atlContexts;
+    // Identifies this instance in the per-thread context cache
+    uint64_t opsInstanceId;
     Fam_Thread_Model famThreadModel;
     Fam_Context_Model famContextModel;
     Fam_Allocator_Client *famAllocator;
@@ -111,6 +111,10 @@ class Fam_Ops_SHM : public Fam_Ops {
 
     void wait_for_copy(void *waitObj);
 
+    uint64_t copy_progress(void *waitObj);
+
+    void cancel_copy(void *waitObj);
+
     void fence(Fam_Region_Descriptor *descriptor = NULL);
 
     void quiet(Fam_Region_Descriptor *descriptor = NULL);
@@ -218,6 +222,25 @@ class Fam_Ops_SHM : public Fam_Ops {
     double atomic_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                             double value);
 
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, int32_t value,
+                                      int32_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, int64_t value,
+                                      int64_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, uint32_t value,
+                                      uint32_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, uint64_t value,
+                                      uint64_t *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, float value,
+                                      float *result);
+    void atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                      uint64_t offset, double value,
+                                      double *result);
+
     int32_t atomic_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                                   int32_t value);
     int64_t atomic_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
@@ -285,6 +308,11 @@ class Fam_Ops_SHM : public Fam_Ops {
 
     void quiet_context(Fam_Context *context);
 
+    // Chunking of large copies across the consumer threads
+    void set_copy_chunking(uint64_t chunkSize, uint64_t nonTemporalThreshold) {
+        asyncQHandler->set_chunking(chunkSize, nonTemporalThreshold);
+    }
+
   protected:
     Fam_Async_QHandler *asyncQHandler;
 
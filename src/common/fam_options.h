@@ -81,6 +81,7 @@ typedef enum {
 
 #define FAM_CONTEXT_DEFAULT_STR "FAM_CONTEXT_DEFAULT"
 #define FAM_CONTEXT_REGION_STR "FAM_CONTEXT_REGION"
+#define FAM_CONTEXT_THREAD_STR "FAM_CONTEXT_THREAD"
 
 #define FAM_OPTIONS_SHM_STR "shared_memory"
 #define FAM_OPTIONS_MEMSERV_STR "memory_server"
@@ -101,7 +102,9 @@ typedef enum {
 typedef enum {
     /** For single threaded applicaiton */
     FAM_CONTEXT_DEFAULT = 1,
-    FAM_CONTEXT_REGION
+    FAM_CONTEXT_REGION,
+    /** One context per memory server for each application thread */
+    FAM_CONTEXT_THREAD
 } Fam_Context_Model;
 
 #endif
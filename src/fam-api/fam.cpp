@@ -148,6 +148,16 @@ class fam::Impl_ {
 
     void fam_deallocate(Fam_Descriptor *descriptor);
 
+    void fam_allocate_batch(const char **names, const uint64_t *nbytes,
+                            uint64_t count, mode_t accessPermissions,
+                            Fam_Region_Descriptor *region,
+                            Fam_Descriptor **descriptors);
+
+    void fam_deallocate_batch(Fam_Descriptor **descriptors, uint64_t count);
+
+    void fam_lookup_batch(const char **itemNames, const char *regionName,
+                          uint64_t count, Fam_Descriptor **descriptors);
+
     void fam_change_permissions(Fam_Descriptor *descriptor,
                                 mode_t accessPermissions);
 
@@ -210,6 +220,10 @@ class fam::Impl_ {
 
     void fam_copy_wait(void *waitObj);
 
+    uint64_t fam_copy_progress(void *waitObj);
+
+    void fam_copy_cancel(void *waitObj);
+
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int32_t value);
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int64_t value);
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int128_t value);
@@ -303,6 +317,25 @@ class fam::Impl_ {
     double fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                          double value);
 
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, int32_t value,
+                                   int32_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, int64_t value,
+                                   int64_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, uint32_t value,
+                                   uint32_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, uint64_t value,
+                                   uint64_t *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, float value,
+                                   float *result);
+    void fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                   uint64_t offset, double value,
+                                   double *result);
+
     int32_t fam_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                                int32_t value);
     int64_t fam_fetch_subtract(Fam_Descriptor *descriptor, uint64_t offset,
@@ -362,6 +395,8 @@ class fam::Impl_ {
 
     int validate_fam_options(Fam_Options *options,
                              configFileParams config_file_fam_options);
+    size_t get_size_option(configFileParams &config_file_fam_options,
+                           const char *name, size_t defaultValue);
     void clean_fam_options();
     int validate_item(Fam_Descriptor *descriptor);
     configFileParams get_info_from_config_file(std::string filename);
@@ -380,6 +415,16 @@ class fam::Impl_ {
     Fam_Thread_Model famThreadModel;
     Fam_Context_Model famContextModel;
     Fam_Runtime *famRuntime;
+    // Chunking of large blocking put/get (libfabric datapath)
+    size_t putGetChunkSize;
+    size_t putGetPipelineDepth;
+    // Number of cached local buffer registrations (FI_MR_LOCAL providers)
+    size_t localMrCacheSize;
+    // Splitting of large copies across consumer threads (shared memory)
+    size_t shmCopyChunkSize;
+    size_t shmNonTemporalThreshold;
+    // Lease (ms) on cached lookup and permission results
+    uint64_t lookupLeaseTime;
 
 #ifdef FAM_PROFILE
     Fam_Counter_St profileData[fam_counter_max][FAM_CNTR_TYPE_MAX];
@@ -687,8 +732,13 @@ void fam::Impl_::fam_initialize(const char *grpName, Fam_Options *options) {
     if (strcmp(famOptions.openFamModel, FAM_OPTIONS_SHM_STR) == 0) {
         // initialize shared memory client
         famAllocator = new Fam_Allocator_Client(true);
-        famOps = new Fam_Ops_SHM(famThreadModel, famContextModel, famAllocator,
-                                 atoi(famOptions.numConsumer));
+        famAllocator->set_lookup_lease_time(lookupLeaseTime);
+        Fam_Ops_SHM *famOpsShm =
+            new Fam_Ops_SHM(famThreadModel, famContextModel, famAllocator,
+                            atoi(famOptions.numConsumer));
+        famOpsShm->set_copy_chunking(shmCopyChunkSize,
+                                     shmNonTemporalThreshold);
+        famOps = famOpsShm;
         ret = famOps->initialize();
     } else {
         if (strcmp(famOptions.cisInterfaceType, FAM_OPTIONS_RPC_STR) == 0) {
@@ -697,9 +747,14 @@ void fam::Impl_::fam_initialize(const char *grpName, Fam_Options *options) {
         } else {
             famAllocator = new Fam_Allocator_Client();
         }
-        famOps = new Fam_Ops_Libfabric(false, famOptions.libfabricProvider,
-                                       famThreadModel, famAllocator,
-                                       famContextModel);
+        famAllocator->set_lookup_lease_time(lookupLeaseTime);
+        Fam_Ops_Libfabric *famOpsLibfabric = new Fam_Ops_Libfabric(
+            false, famOptions.libfabricProvider, famThreadModel, famAllocator,
+            famContextModel);
+        famOpsLibfabric->set_put_get_chunking(putGetChunkSize,
+                                              putGetPipelineDepth);
+        famOpsLibfabric->set_local_mr_cache_size(localMrCacheSize);
+        famOps = famOpsLibfabric;
         ret = famOps->initialize();
         if (ret < 0) {
             message << "Fam libfabric initialization failed: "
@@ -836,6 +891,8 @@ int fam::Impl_::validate_fam_options(Fam_Options *options,
         famContextModel = FAM_CONTEXT_DEFAULT;
     else if (strcmp(famOptions.famContextModel, FAM_CONTEXT_REGION_STR) == 0)
         famContextModel = FAM_CONTEXT_REGION;
+    else if (strcmp(famOptions.famContextModel, FAM_CONTEXT_THREAD_STR) == 0)
+        famContextModel = FAM_CONTEXT_THREAD;
     else {
         message << "Invalid value specified for famContextModel: "
                 << famOptions.famContextModel;
@@ -869,9 +926,65 @@ int fam::Impl_::validate_fam_options(Fam_Options *options,
     optValueMap->insert(
         {supportedOptionList[NUM_CONSUMER], famOptions.numConsumer});
 
+    // Chunk size and pipeline depth of large blocking put/get are only read
+    // from the config file
+    putGetChunkSize =
+        get_size_option(config_file_fam_options, "putGetChunkSize",
+                        FAM_DEFAULT_PUT_GET_CHUNK_SIZE);
+
+    putGetPipelineDepth =
+        get_size_option(config_file_fam_options, "putGetPipelineDepth",
+                        FAM_DEFAULT_PUT_GET_PIPELINE_DEPTH);
+    if (putGetPipelineDepth == 0) {
+        message << "Invalid value specified for put_get_pipeline_depth: "
+                << putGetPipelineDepth;
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, message.str().c_str());
+    }
+
+    localMrCacheSize =
+        get_size_option(config_file_fam_options, "localMrCacheSize",
+                        FAM_DEFAULT_LOCAL_MR_CACHE_SIZE);
+
+    shmCopyChunkSize = get_size_option(config_file_fam_options,
+                                       "shmCopyChunkSize",
+                                       FAM_DEFAULT_SHM_COPY_CHUNK_SIZE);
+    shmNonTemporalThreshold = get_size_option(
+        config_file_fam_options, "shmNonTemporalThreshold", 0);
+
+    lookupLeaseTime =
+        get_size_option(config_file_fam_options, "lookupLeaseTime",
+                        FAM_DEFAULT_LOOKUP_LEASE_TIME);
+
     return ret;
 }
 
+/*
+ * get_size_option - Returns the value of the numeric option name of the
+ * config file, or defaultValue if it is not set.
+ * @throws: Fam_InvalidOption_Exception if the value is not a non negative
+ * number which fits in a size_t.
+ */
+size_t fam::Impl_::get_size_option(configFileParams &config_file_fam_options,
+                                   const char *name, size_t defaultValue) {
+    if (config_file_fam_options.empty() ||
+        config_file_fam_options.count(name) == 0)
+        return defaultValue;
+
+    std::string value = config_file_fam_options[name];
+    try {
+        size_t pos;
+        unsigned long long ret = stoull(value, &pos);
+        if ((pos == value.size()) && (value.find('-') == std::string::npos) &&
+            (ret <= SIZE_MAX))
+            return (size_t)ret;
+    } catch (std::invalid_argument &e) {
+    } catch (std::out_of_range &e) {
+    }
+    std::ostringstream message;
+    message << "Invalid value specified for " << name << ": " << value;
+    THROW_ERR_MSG(Fam_InvalidOption_Exception, message.str().c_str());
+}
+
 /**
  * Clean Fam_Options
  */
@@ -974,6 +1087,48 @@ configFileParams fam::Impl_::get_info_from_config_file(std::string filename) {
             // exception. This parameter will be obtained from
             // validate_fam_options function.
         }
+        try {
+            options["putGetChunkSize"] =
+                info->get_key_value("put_get_chunk_size");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter put_get_chunk_size is not present, then
+            // ignore the exception. Default value is used.
+        }
+        try {
+            options["putGetPipelineDepth"] =
+                info->get_key_value("put_get_pipeline_depth");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter put_get_pipeline_depth is not present, then
+            // ignore the exception. Default value is used.
+        }
+        try {
+            options["localMrCacheSize"] =
+                info->get_key_value("local_mr_cache_size");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter local_mr_cache_size is not present, then
+            // ignore the exception. Default value is used.
+        }
+        try {
+            options["shmCopyChunkSize"] =
+                info->get_key_value("shm_copy_chunk_size");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter shm_copy_chunk_size is not present, then
+            // ignore the exception. Default value is used.
+        }
+        try {
+            options["shmNonTemporalThreshold"] =
+                info->get_key_value("shm_nontemporal_threshold");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter shm_nontemporal_threshold is not present, then
+            // ignore the exception. Default value is used.
+        }
+        try {
+            options["lookupLeaseTime"] =
+                info->get_key_value("lookup_lease_time");
+        } catch (Fam_InvalidOption_Exception e) {
+            // If the parameter lookup_lease_time is not present, then
+            // ignore the exception. Default value is used.
+        }
     }
     return options;
 }
@@ -1225,6 +1380,64 @@ void fam::Impl_::fam_deallocate(Fam_Descriptor *descriptor) {
     return;
 }
 
+/**
+ * Allocate several data items within a region with a single request to the
+ * CIS. Either all data items are allocated or none is.
+ * @param names - names of the data items; NULL, or a NULL entry, for unnamed
+ * data items
+ * @param nbytes - size of each data item in bytes
+ * @param count - number of data items
+ * @param accessPermissions - permissions associated with the data items
+ * @param region - descriptor of the region within which the data items are
+ * allocated
+ * @param descriptors - array of count entries that receives the descriptors
+ * @see #fam_deallocate_batch()
+ */
+void fam::Impl_::fam_allocate_batch(const char **names, const uint64_t *nbytes,
+                                    uint64_t count, mode_t accessPermissions,
+                                    Fam_Region_Descriptor *region,
+                                    Fam_Descriptor **descriptors) {
+    FAM_CNTR_INC_API(fam_allocate_batch);
+    FAM_PROFILE_START_ALLOCATOR(fam_allocate_batch);
+    if (count)
+        famAllocator->allocate_batch(names, nbytes, count, accessPermissions,
+                                     region, descriptors);
+    FAM_PROFILE_END_ALLOCATOR(fam_allocate_batch);
+}
+
+/**
+ * Deallocate several data items with a single request to the CIS.
+ * @param descriptors - descriptors of the data items
+ * @param count - number of data items
+ * @see #fam_allocate_batch()
+ */
+void fam::Impl_::fam_deallocate_batch(Fam_Descriptor **descriptors,
+                                      uint64_t count) {
+    FAM_CNTR_INC_API(fam_deallocate_batch);
+    FAM_PROFILE_START_ALLOCATOR(fam_deallocate_batch);
+    if (count)
+        famAllocator->deallocate_batch(descriptors, count);
+    FAM_PROFILE_END_ALLOCATOR(fam_deallocate_batch);
+}
+
+/**
+ * Look up several data items of a region with a single request to the CIS.
+ * @param itemNames - names of the data items
+ * @param regionName - name of the region containing the data items
+ * @param count - number of data items
+ * @param descriptors - array of count entries that receives the descriptors
+ * @see #fam_lookup()
+ */
+void fam::Impl_::fam_lookup_batch(const char **itemNames,
+                                  const char *regionName, uint64_t count,
+                                  Fam_Descriptor **descriptors) {
+    FAM_CNTR_INC_API(fam_lookup_batch);
+    FAM_PROFILE_START_ALLOCATOR(fam_lookup_batch);
+    if (count)
+        famAllocator->lookup_batch(itemNames, regionName, count, descriptors);
+    FAM_PROFILE_END_ALLOCATOR(fam_lookup_batch);
+}
+
 /**
  * Change permissions associated with a data item descriptor.
  * @param descriptor - descriptor associated with some data item
@@ -1848,6 +2061,23 @@ void fam::Impl_::fam_copy_wait(void *waitObj) {
     return;
 }
 
+uint64_t fam::Impl_::fam_copy_progress(void *waitObj) {
+    if (waitObj == NULL) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    return famOps->copy_progress(waitObj);
+}
+
+void fam::Impl_::fam_copy_cancel(void *waitObj) {
+    if (waitObj == NULL) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    famOps->cancel_copy(waitObj);
+    return;
+}
+
 // ATOMICS Group
 
 // NON fetching routines
@@ -3153,6 +3383,132 @@ double fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     return old;
 }
 
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, int32_t value,
+                                           int32_t *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, int64_t value,
+                                           int64_t *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, uint32_t value,
+                                           uint32_t *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, uint64_t value,
+                                           uint64_t *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, float value,
+                                           float *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
+void fam::Impl_::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                           uint64_t offset, double value,
+                                           double *result) {
+    std::ostringstream message;
+    FAM_CNTR_INC_API(fam_fetch_add_nonblocking);
+    FAM_PROFILE_START_ALLOCATOR(fam_fetch_add_nonblocking);
+    if ((descriptor == NULL) || (result == NULL)) {
+        THROW_ERR_MSG(Fam_InvalidOption_Exception, "Invalid Options");
+    }
+
+    int ret = validate_item(descriptor);
+    FAM_PROFILE_END_ALLOCATOR(fam_fetch_add_nonblocking);
+
+    FAM_PROFILE_START_OPS(fam_fetch_add_nonblocking);
+    if (ret == 0) {
+        famOps->atomic_fetch_add_nonblocking(descriptor, offset, value, result);
+    }
+    FAM_PROFILE_END_OPS(fam_fetch_add_nonblocking);
+    return;
+}
+
 /**
  * fetch and subtract group - atomically subtract the given value from the value
  * at the given offset within a data item in FAM, and return the old value
@@ -3942,6 +4298,62 @@ void fam::fam_deallocate(Fam_Descriptor *descriptor) {
     RETURN_WITH_FAM_EXCEPTION
 }
 
+/**
+ * Allocate several data items within a region with a single request to the
+ * CIS. Either all data items are allocated or none is.
+ * @param names - names of the data items; NULL, or a NULL entry, for unnamed
+ * data items
+ * @param nbytes - size of each data item in bytes
+ * @param count - number of data items
+ * @param accessPermissions - permissions associated with the data items
+ * @param region - descriptor of the region within which the data items are
+ * allocated
+ * @param descriptors - array of count entries that receives the descriptors
+ * @throws Fam_Allocator_Exception - exceptionObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_ALREADYEXIST, FAM_ERR_RPC
+ * @see #fam_deallocate_batch()
+ */
+void fam::fam_allocate_batch(const char **names, const uint64_t *nbytes,
+                             uint64_t count, mode_t accessPermissions,
+                             Fam_Region_Descriptor *region,
+                             Fam_Descriptor **descriptors) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_allocate_batch(names, nbytes, count, accessPermissions, region,
+                               descriptors);
+    RETURN_WITH_FAM_EXCEPTION
+}
+
+/**
+ * Deallocate several data items with a single request to the CIS.
+ * @param descriptors - descriptors of the data items
+ * @param count - number of data items
+ * @throws Fam_Allocator_Exception - exceptionObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_RPC
+ * @see #fam_allocate_batch()
+ */
+void fam::fam_deallocate_batch(Fam_Descriptor **descriptors, uint64_t count) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_deallocate_batch(descriptors, count);
+    RETURN_WITH_FAM_EXCEPTION
+}
+
+/**
+ * Look up several data items of a region with a single request to the CIS.
+ * @param itemNames - names of the data items
+ * @param regionName - name of the region containing the data items
+ * @param count - number of data items
+ * @param descriptors - array of count entries that receives the descriptors
+ * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_RPC
+ * @see #fam_lookup()
+ */
+void fam::fam_lookup_batch(const char **itemNames, const char *regionName,
+                           uint64_t count, Fam_Descriptor **descriptors) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_lookup_batch(itemNames, regionName, count, descriptors);
+    RETURN_WITH_FAM_EXCEPTION
+}
+
 /**
  * Change permissions associated with a data item descriptor.
  * @param descriptor - descriptor associated with some data item
@@ -4395,6 +4807,18 @@ void fam::fam_copy_wait(void *waitObj) {
     RETURN_WITH_FAM_EXCEPTION
 }
 
+uint64_t fam::fam_copy_progress(void *waitObj) {
+    TRY_CATCH_BEGIN
+    return pimpl_->fam_copy_progress(waitObj);
+    RETURN_WITH_FAM_EXCEPTION
+}
+
+void fam::fam_copy_cancel(void *waitObj) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_copy_cancel(waitObj);
+    RETURN_WITH_FAM_EXCEPTION
+}
+
 // ATOMICS Group
 
 // NON fetching routines
@@ -4896,6 +5320,42 @@ double fam::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     return pimpl_->fam_fetch_add(descriptor, offset, value);
     RETURN_WITH_FAM_EXCEPTION
 }
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    int32_t value, int32_t *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    int64_t value, int64_t *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    uint32_t value, uint32_t *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    uint64_t value, uint64_t *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    float value, float *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
+void fam::fam_fetch_add_nonblocking(Fam_Descriptor *descriptor, uint64_t offset,
+                                    double value, double *result) {
+    TRY_CATCH_BEGIN
+    pimpl_->fam_fetch_add_nonblocking(descriptor, offset, value, result);
+    RETURN_WITH_FAM_EXCEPTION
+}
 
 /**
  * fetch and subtract group - atomically subtract the given value from the value
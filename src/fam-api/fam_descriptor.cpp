@@ -31,6 +31,7 @@
 #include <sstream>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 #include "common/fam_internal.h"
 #include "fam/fam.h"
@@ -51,6 +52,7 @@ class Fam_Descriptor::FamDescriptorImpl_ {
         size = itemSize;
         perm = 0;
         name = NULL;
+        interleaveSize = 0;
     }
 
     FamDescriptorImpl_(Fam_Global_Descriptor globalDesc) {
@@ -62,6 +64,7 @@ class Fam_Descriptor::FamDescriptorImpl_ {
         size = 0;
         perm = 0;
         name = NULL;
+        interleaveSize = 0;
     }
 
     FamDescriptorImpl_() {
@@ -73,6 +76,7 @@ class Fam_Descriptor::FamDescriptorImpl_ {
         size = 0;
         perm = 0;
         name = NULL;
+        interleaveSize = 0;
     }
 
     ~FamDescriptorImpl_() {
@@ -84,6 +88,7 @@ class Fam_Descriptor::FamDescriptorImpl_ {
         size = 0;
         perm = 0;
         name = NULL;
+        interleaveSize = 0;
     }
 
     Fam_Global_Descriptor get_global_descriptor() { return this->gDescriptor; }
@@ -135,6 +140,27 @@ class Fam_Descriptor::FamDescriptorImpl_ {
         return (gDescriptor.regionId) >> MEMSERVERID_SHIFT;
     }
 
+    void set_interleave_info(uint64_t stripeSize, uint64_t memsrvCnt,
+                             uint64_t *ids, uint64_t *stripeKeys,
+                             uint64_t *stripeBases) {
+        if (interleaveSize != 0)
+            return;
+        memServerIds.assign(ids, ids + memsrvCnt);
+        keys.assign(stripeKeys, stripeKeys + memsrvCnt);
+        bases.assign(stripeBases, stripeBases + memsrvCnt);
+        interleaveSize = stripeSize;
+    }
+
+    uint64_t get_interleave_size() { return interleaveSize; }
+
+    uint64_t get_used_memsrv_cnt() { return memServerIds.size(); }
+
+    uint64_t *get_memserver_ids() { return memServerIds.data(); }
+
+    uint64_t *get_keys() { return keys.data(); }
+
+    uint64_t *get_base_addresses() { return bases.data(); }
+
   private:
     Fam_Global_Descriptor gDescriptor;
     /* libfabric access key*/
@@ -145,6 +171,11 @@ class Fam_Descriptor::FamDescriptorImpl_ {
     mode_t perm;
     char *name;
     uint64_t size;
+    /* stripe layout of interleaved data items */
+    uint64_t interleaveSize;
+    std::vector<uint64_t> memServerIds;
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> bases;
 };
 
 Fam_Descriptor::Fam_Descriptor(Fam_Global_Descriptor gDescriptor,
@@ -192,6 +223,32 @@ uint64_t Fam_Descriptor::get_size() { return fdimpl_->get_size(); }
 uint64_t Fam_Descriptor::get_memserver_id() {
     return fdimpl_->get_memserver_id();
 }
+
+void Fam_Descriptor::set_interleave_info(uint64_t interleaveSize,
+                                         uint64_t memsrvCnt,
+                                         uint64_t *memServerIds,
+                                         uint64_t *keys, uint64_t *bases) {
+    fdimpl_->set_interleave_info(interleaveSize, memsrvCnt, memServerIds, keys,
+                                 bases);
+}
+
+uint64_t Fam_Descriptor::get_interleave_size() {
+    return fdimpl_->get_interleave_size();
+}
+
+uint64_t Fam_Descriptor::get_used_memsrv_cnt() {
+    return fdimpl_->get_used_memsrv_cnt();
+}
+
+uint64_t *Fam_Descriptor::get_memserver_ids() {
+    return fdimpl_->get_memserver_ids();
+}
+
+uint64_t *Fam_Descriptor::get_keys() { return fdimpl_->get_keys(); }
+
+uint64_t *Fam_Descriptor::get_base_addresses() {
+    return fdimpl_->get_base_addresses();
+}
 void Fam_Descriptor::set_perm(mode_t regionPerm) {
     fdimpl_->set_perm(regionPerm);
 }
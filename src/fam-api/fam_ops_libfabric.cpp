@@ -36,7 +36,6 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <future>
 
 #include "common/fam_internal.h"
 #include "common/fam_libfabric.h"
@@ -49,10 +48,125 @@ using namespace std;
 
 namespace openfam {
 
+// Per-thread cache of the context map used with FAM_CONTEXT_THREAD. The
+// instance id guards against a map left over from an earlier
+// Fam_Ops_Libfabric instance. The contexts are released when the thread
+// exits, if their instance is still live.
+struct Fam_Thread_Ctx_Cache {
+    uint64_t opsInstanceId;
+    std::map<uint64_t, Fam_Context *> *ctxMap;
+    ~Fam_Thread_Ctx_Cache();
+};
+static thread_local Fam_Thread_Ctx_Cache threadCtxCache = {0, NULL};
+static uint64_t nextOpsInstanceId = 1;
+
+// Live instances by id. The map is never freed since threads may exit
+// during process teardown.
+static pthread_mutex_t opsInstancesLock = PTHREAD_MUTEX_INITIALIZER;
+static std::map<uint64_t, Fam_Ops_Libfabric *> *opsInstances = NULL;
+
+static void ops_instance_register(uint64_t id, Fam_Ops_Libfabric *ops) {
+    (void)pthread_mutex_lock(&opsInstancesLock);
+    if (opsInstances == NULL)
+        opsInstances = new std::map<uint64_t, Fam_Ops_Libfabric *>();
+    opsInstances->insert({id, ops});
+    (void)pthread_mutex_unlock(&opsInstancesLock);
+}
+
+// Once this returns, no exiting thread uses the instance any more
+static void ops_instance_unregister(uint64_t id) {
+    (void)pthread_mutex_lock(&opsInstancesLock);
+    if (opsInstances != NULL)
+        opsInstances->erase(id);
+    (void)pthread_mutex_unlock(&opsInstancesLock);
+}
+
+Fam_Thread_Ctx_Cache::~Fam_Thread_Ctx_Cache() {
+    if (ctxMap == NULL)
+        return;
+    (void)pthread_mutex_lock(&opsInstancesLock);
+    if (opsInstances != NULL) {
+        auto obj = opsInstances->find(opsInstanceId);
+        if (obj != opsInstances->end())
+            obj->second->release_thread_contexts(ctxMap);
+    }
+    (void)pthread_mutex_unlock(&opsInstancesLock);
+    ctxMap = NULL;
+}
+
+/*
+ * Translate an offset within a data item into the offset within the extent,
+ * key and memory server id that hold it. Interleaved data items place stripe i
+ * on memory server (i % count), at (i / count) stripes into its extent.
+ * Returns the index of the extent.
+ */
+static inline uint64_t get_extent_location(Fam_Descriptor *descriptor,
+                                           uint64_t *offset, uint64_t *key,
+                                           uint64_t *nodeId) {
+    uint64_t stripeSize = descriptor->get_interleave_size();
+    if (stripeSize == 0) {
+        *key = descriptor->get_key();
+        *nodeId = descriptor->get_memserver_id();
+        return 0;
+    }
+    uint64_t count = descriptor->get_used_memsrv_cnt();
+    uint64_t stripe = *offset / stripeSize;
+    uint64_t idx = stripe % count;
+    *offset = (stripe / count) * stripeSize + *offset % stripeSize;
+    *key = descriptor->get_keys()[idx];
+    *nodeId = descriptor->get_memserver_ids()[idx];
+    return idx;
+}
+
+/*
+ * Translate an offset within a data item into the remote address, key and
+ * memory server id that hold it.
+ */
+static inline void get_stripe_location(Fam_Descriptor *descriptor,
+                                       uint64_t *offset, uint64_t *key,
+                                       uint64_t *nodeId) {
+    uint64_t idx = get_extent_location(descriptor, offset, key, nodeId);
+    if (descriptor->get_interleave_size() == 0)
+        *offset += (uint64_t)descriptor->get_base_address();
+    else
+        *offset += descriptor->get_base_addresses()[idx];
+}
+
+/*
+ * Split nbytes at offset of an interleaved data item into one segment per
+ * stripe touched, appending them to segments.
+ */
+static void get_stripe_segments(Fam_Descriptor *descriptor, void *local,
+                                uint64_t offset, uint64_t nbytes,
+                                std::vector<fi_addr_t> *fiAddr,
+                                std::vector<Fabric_Rma_Segment> *segments) {
+    uint64_t stripeSize = descriptor->get_interleave_size();
+    while (nbytes > 0) {
+        uint64_t len = stripeSize - offset % stripeSize;
+        if (len > nbytes)
+            len = nbytes;
+        Fabric_Rma_Segment seg;
+        uint64_t nodeId;
+        seg.offset = offset;
+        get_stripe_location(descriptor, &seg.offset, &seg.key, &nodeId);
+        seg.local = local;
+        seg.nbytes = len;
+        seg.fiAddr = (*fiAddr)[nodeId];
+        segments->push_back(seg);
+        local = (void *)((uint64_t)local + len);
+        offset += len;
+        nbytes -= len;
+    }
+}
+
 Fam_Ops_Libfabric::~Fam_Ops_Libfabric() {
+    ops_instance_unregister(opsInstanceId);
 
     delete contexts;
     delete defContexts;
+    delete threadContexts;
+    delete copyContexts;
+    delete atlContexts;
     delete fiAddrs;
     delete memServerAddrs;
     delete fiMemsrvMap;
@@ -81,6 +195,11 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(bool source, const char *libfabricProvider,
     fiMrs = new std::map<uint64_t, Fam_Region_Map_t *>();
     contexts = new std::map<uint64_t, Fam_Context *>();
     defContexts = new std::map<uint64_t, Fam_Context *>();
+    threadContexts = new std::list<std::map<uint64_t, Fam_Context *> *>();
+    copyContexts = new std::vector<Fam_Context *>();
+    atlContexts = new std::vector<Fam_Context *>();
+    opsInstanceId = __sync_fetch_and_add(&nextOpsInstanceId, 1);
+    ops_instance_register(opsInstanceId, this);
 
     fi = NULL;
     fabric = NULL;
@@ -89,6 +208,10 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(bool source, const char *libfabricProvider,
     av = NULL;
     serverAddrNameLen = 0;
     serverAddrName = NULL;
+    putGetChunkSize = FAM_DEFAULT_PUT_GET_CHUNK_SIZE;
+    putGetPipelineDepth = FAM_DEFAULT_PUT_GET_PIPELINE_DEPTH;
+    localMrCache = NULL;
+    localMrCacheSize = FAM_DEFAULT_LOCAL_MR_CACHE_SIZE;
 
     numMemoryNodes = 0;
     if (!isSource && famAllocator == NULL) {
@@ -119,6 +242,11 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(bool source, const char *libfabricProvider,
     fiMrs = new std::map<uint64_t, Fam_Region_Map_t *>();
     contexts = new std::map<uint64_t, Fam_Context *>();
     defContexts = new std::map<uint64_t, Fam_Context *>();
+    threadContexts = new std::list<std::map<uint64_t, Fam_Context *> *>();
+    copyContexts = new std::vector<Fam_Context *>();
+    atlContexts = new std::vector<Fam_Context *>();
+    opsInstanceId = __sync_fetch_and_add(&nextOpsInstanceId, 1);
+    ops_instance_register(opsInstanceId, this);
 
     fi = NULL;
     fabric = NULL;
@@ -127,6 +255,10 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(bool source, const char *libfabricProvider,
     av = NULL;
     serverAddrNameLen = 0;
     serverAddrName = NULL;
+    putGetChunkSize = FAM_DEFAULT_PUT_GET_CHUNK_SIZE;
+    putGetPipelineDepth = FAM_DEFAULT_PUT_GET_PIPELINE_DEPTH;
+    localMrCache = NULL;
+    localMrCacheSize = FAM_DEFAULT_LOCAL_MR_CACHE_SIZE;
 
     numMemoryNodes = 0;
     if (!isSource && famAllocator == NULL) {
@@ -147,9 +279,15 @@ int Fam_Ops_Libfabric::initialize() {
     (void)pthread_rwlock_init(&fiMemsrvAddrLock, NULL);
 
     // Initialize the mutex lock
-    if (famContextModel == FAM_CONTEXT_REGION)
+    if (famContextModel == FAM_CONTEXT_REGION ||
+        famContextModel == FAM_CONTEXT_THREAD)
         (void)pthread_mutex_init(&ctxLock, NULL);
 
+    // Registrations of local buffers are reused through the provider's
+    // registration cache, sized before libfabric reads its parameters
+    if (!isSource)
+        set_libfabric_mr_cache_size(localMrCacheSize);
+
     if ((ret = fabric_initialize(memoryServerName, service, isSource, provider,
                                  &fi, &fabric, &eq, &domain, famThreadModel)) <
         0) {
@@ -162,6 +300,10 @@ int Fam_Ops_Libfabric::initialize() {
         }
     }
 
+    // Providers requiring local descriptors get them from the cache
+    if (!isSource && (fi->domain_attr->mr_mode & FI_MR_LOCAL))
+        localMrCache = new Fam_MR_Cache(domain);
+
     // Insert the memory server address into address vector
     // Only if it is not source
     if (!isSource) {
@@ -213,6 +355,7 @@ int Fam_Ops_Libfabric::initialize() {
                 if (famContextModel == FAM_CONTEXT_DEFAULT) {
                     Fam_Context *defaultCtx =
                         new Fam_Context(fi, domain, famThreadModel);
+                    defaultCtx->set_mr_cache(localMrCache);
                     defContexts->insert({nodeId, defaultCtx});
                     ret =
                         fabric_enable_bind_ep(fi, av, eq, defaultCtx->get_ep());
@@ -270,10 +413,54 @@ int Fam_Ops_Libfabric::initialize() {
         defContexts->insert({0, tmpCtx});
     }
     fabric_iov_limit = fi->tx_attr->rma_iov_limit;
+    if (putGetChunkSize == 0 || putGetChunkSize > fi->ep_attr->max_msg_size)
+        putGetChunkSize = fi->ep_attr->max_msg_size;
 
     return 0;
 }
 
+/*
+ * Get the idx'th context for copies between memory servers, creating it on
+ * first use. Each copy worker reads through its own context, so that copies
+ * do not serialize on the default context.
+ */
+Fam_Context *Fam_Ops_Libfabric::get_copy_context(uint64_t idx) {
+    return get_worker_context(copyContexts, idx);
+}
+
+Fam_Context *Fam_Ops_Libfabric::get_atl_context(uint64_t idx) {
+    return get_worker_context(atlContexts, idx);
+}
+
+Fam_Context *
+Fam_Ops_Libfabric::get_worker_context(std::vector<Fam_Context *> *workerCtxs,
+                                      uint64_t idx) {
+    std::ostringstream message;
+    // ctx mutex lock
+    (void)pthread_mutex_lock(&ctxLock);
+    if (idx >= workerCtxs->size())
+        workerCtxs->resize(idx + 1, NULL);
+    Fam_Context *ctx = workerCtxs->at(idx);
+    if (!ctx) {
+        // Only the worker idx uses this context
+        ctx = new Fam_Context(fi, domain, FAM_THREAD_SERIALIZE);
+        ctx->set_mr_cache(localMrCache);
+        int ret = fabric_enable_bind_ep(fi, av, eq, ctx->get_ep());
+        if (ret < 0) {
+            // ctx mutex unlock
+            (void)pthread_mutex_unlock(&ctxLock);
+            delete ctx;
+            message << "Fam libfabric fabric_enable_bind_ep failed: "
+                    << fabric_strerror(ret);
+            THROW_ERR_MSG(Fam_Datapath_Exception, message.str().c_str());
+        }
+        workerCtxs->at(idx) = ctx;
+    }
+    // ctx mutex unlock
+    (void)pthread_mutex_unlock(&ctxLock);
+    return ctx;
+}
+
 Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
     std::ostringstream message;
     // Case - FAM_CONTEXT_DEFAULT
@@ -296,6 +483,7 @@ Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
         auto ctxObj = contexts->find(regionId);
         if (ctxObj == contexts->end()) {
             ctx = new Fam_Context(fi, domain, famThreadModel);
+            ctx->set_mr_cache(localMrCache);
             contexts->insert({regionId, ctx});
             ret = fabric_enable_bind_ep(fi, av, eq, ctx->get_ep());
             if (ret < 0) {
@@ -313,14 +501,107 @@ Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
         // ctx mutex unlock
         (void)pthread_mutex_unlock(&ctxLock);
         return ctx;
+    } else if (famContextModel == FAM_CONTEXT_THREAD) {
+        // Case - FAM_CONTEXT_THREAD
+        uint64_t nodeId = descriptor->get_memserver_id();
+        std::map<uint64_t, Fam_Context *> *ctxMap = get_thread_contexts();
+        auto ctxObj = ctxMap->find(nodeId);
+        if (ctxObj != ctxMap->end())
+            return ctxObj->second;
+
+        // The context is used only by this thread, so it is created with
+        // FAM_THREAD_SERIALIZE and the datapath takes no context locks.
+        // ctxLock serializes the endpoint creation, which updates fi.
+        (void)pthread_mutex_lock(&ctxLock);
+        Fam_Context *ctx = new Fam_Context(fi, domain, FAM_THREAD_SERIALIZE);
+        ctx->set_mr_cache(localMrCache);
+        int ret = fabric_enable_bind_ep(fi, av, eq, ctx->get_ep());
+        (void)pthread_mutex_unlock(&ctxLock);
+        if (ret < 0) {
+            delete ctx;
+            message << "Fam libfabric fabric_enable_bind_ep failed: "
+                    << fabric_strerror(ret);
+            THROW_ERR_MSG(Fam_Datapath_Exception, message.str().c_str());
+        }
+        ctxMap->insert({nodeId, ctx});
+        return ctx;
     } else {
         message << "Fam Invalid Option FAM_CONTEXT_MODEL: " << famContextModel;
         THROW_ERR_MSG(Fam_InvalidOption_Exception, message.str().c_str());
     }
 }
 
+std::map<uint64_t, Fam_Context *> *
+Fam_Ops_Libfabric::get_thread_contexts(bool create) {
+    if (threadCtxCache.opsInstanceId != opsInstanceId) {
+        if (!create)
+            return NULL;
+        std::map<uint64_t, Fam_Context *> *ctxMap =
+            new std::map<uint64_t, Fam_Context *>();
+        // ctx mutex lock
+        (void)pthread_mutex_lock(&ctxLock);
+        threadContexts->push_back(ctxMap);
+        // ctx mutex unlock
+        (void)pthread_mutex_unlock(&ctxLock);
+        threadCtxCache.opsInstanceId = opsInstanceId;
+        threadCtxCache.ctxMap = ctxMap;
+    }
+    return threadCtxCache.ctxMap;
+}
+
+void Fam_Ops_Libfabric::release_thread_contexts(
+    std::map<uint64_t, Fam_Context *> *ctxMap) {
+    // ctx mutex lock
+    (void)pthread_mutex_lock(&ctxLock);
+    threadContexts->remove(ctxMap);
+    // ctx mutex unlock
+    (void)pthread_mutex_unlock(&ctxLock);
+    for (auto fam_ctx : *ctxMap) {
+        // Complete what the thread left pending before closing the
+        // endpoint; errors can no longer be reported to it.
+        try {
+            fabric_quiet(fam_ctx.second);
+        } catch (...) {
+        }
+        delete fam_ctx.second;
+    }
+    delete ctxMap;
+}
+
 void Fam_Ops_Libfabric::finalize() {
+    // Exiting threads must not release contexts deleted below
+    ops_instance_unregister(opsInstanceId);
     fabric_finalize();
+#ifdef LIBFABRIC_PROFILE
+    {
+        uint64_t poolHits = 0, poolMisses = 0;
+        if (contexts != NULL) {
+            for (auto fam_ctx : *contexts) {
+                poolHits += fam_ctx.second->get_num_ctx_pool_hits();
+                poolMisses += fam_ctx.second->get_num_ctx_pool_misses();
+            }
+        }
+        if (defContexts != NULL) {
+            for (auto fam_ctx : *defContexts) {
+                poolHits += fam_ctx.second->get_num_ctx_pool_hits();
+                poolMisses += fam_ctx.second->get_num_ctx_pool_misses();
+            }
+        }
+        if (threadContexts != NULL) {
+            for (auto ctxMap : *threadContexts) {
+                for (auto fam_ctx : *ctxMap) {
+                    poolHits += fam_ctx.second->get_num_ctx_pool_hits();
+                    poolMisses += fam_ctx.second->get_num_ctx_pool_misses();
+                }
+            }
+        }
+        cout << "fi_context pool hits : " << poolHits
+             << ", misses : " << poolMisses << endl;
+        if (localMrCache)
+            cout << "local MR cache hits : " << localMrCache->get_num_hits()
+                 << ", misses : " << localMrCache->get_num_misses() << endl;
+    }
+#endif
     if (fiMrs != NULL) {
         for (auto mr : *fiMrs) {
             Fam_Region_Map_t *fiRegionMap = mr.second;
@@ -347,6 +628,36 @@ void Fam_Ops_Libfabric::finalize() {
         defContexts->clear();
     }
 
+    if (threadContexts != NULL) {
+        for (auto ctxMap : *threadContexts) {
+            for (auto fam_ctx : *ctxMap) {
+                delete fam_ctx.second;
+            }
+            delete ctxMap;
+        }
+        threadContexts->clear();
+    }
+
+    if (copyContexts != NULL) {
+        for (auto fam_ctx : *copyContexts) {
+            delete fam_ctx;
+        }
+        copyContexts->clear();
+    }
+
+    if (atlContexts != NULL) {
+        for (auto fam_ctx : *atlContexts) {
+            delete fam_ctx;
+        }
+        atlContexts->clear();
+    }
+
+    // The contexts have released their registrations
+    if (localMrCache) {
+        delete localMrCache;
+        localMrCache = NULL;
+    }
+
     if (fi) {
         fi_freeinfo(fi);
         fi = NULL;
@@ -376,13 +687,25 @@ void Fam_Ops_Libfabric::finalize() {
 int Fam_Ops_Libfabric::put_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t offset, uint64_t nbytes) {
     std::ostringstream message;
-    // Write data into memory region with this key
-    uint64_t key;
-    key = descriptor->get_key();
-    offset += (uint64_t)descriptor->get_base_address();
-    uint64_t nodeId = descriptor->get_memserver_id();
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    int ret = fabric_write(key, local, nbytes, offset, (*fiAddr)[nodeId],
+    int ret;
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_stripe_segments(descriptor, local, offset, nbytes, fiAddr,
+                            &segments);
+        return fabric_write_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
+    // Write data into memory region with this key
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+    if (nbytes > putGetChunkSize)
+        ret = fabric_write_pipelined(key, local, nbytes, offset,
+                                     (*fiAddr)[nodeId], get_context(descriptor),
+                                     putGetChunkSize, putGetPipelineDepth);
+    else
+        ret = fabric_write(key, local, nbytes, offset, (*fiAddr)[nodeId],
                            get_context(descriptor));
     return ret;
 }
@@ -390,28 +713,80 @@ int Fam_Ops_Libfabric::put_blocking(void *local, Fam_Descriptor *descriptor,
 int Fam_Ops_Libfabric::get_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t offset, uint64_t nbytes) {
     std::ostringstream message;
-    // Write data into memory region with this key
-    uint64_t key;
-    key = descriptor->get_key();
-    offset += (uint64_t)descriptor->get_base_address();
-    uint64_t nodeId = descriptor->get_memserver_id();
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    int ret = fabric_read(key, local, nbytes, offset, (*fiAddr)[nodeId],
+    int ret;
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_stripe_segments(descriptor, local, offset, nbytes, fiAddr,
+                            &segments);
+        return fabric_read_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
+    // Read data from memory region with this key
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+    if (nbytes > putGetChunkSize)
+        ret = fabric_read_pipelined(key, local, nbytes, offset,
+                                    (*fiAddr)[nodeId], get_context(descriptor),
+                                    putGetChunkSize, putGetPipelineDepth);
+    else
+        ret = fabric_read(key, local, nbytes, offset, (*fiAddr)[nodeId],
                           get_context(descriptor));
 
     return ret;
 }
 
+/*
+ * Build the segments of a strided or indexed gather/scatter on an
+ * interleaved data item; elements are not assumed to stay within a stripe.
+ */
+static void get_element_segments(Fam_Descriptor *descriptor, void *local,
+                                 uint64_t nElements, uint64_t firstElement,
+                                 uint64_t stride, uint64_t *elementIndex,
+                                 uint64_t elementSize,
+                                 std::vector<fi_addr_t> *fiAddr,
+                                 std::vector<Fabric_Rma_Segment> *segments) {
+    for (uint64_t i = 0; i < nElements; i++) {
+        uint64_t element =
+            (elementIndex ? elementIndex[i] : firstElement + i * stride);
+        get_stripe_segments(descriptor,
+                            (void *)((uint64_t)local + i * elementSize),
+                            element * elementSize, elementSize, fiAddr,
+                            segments);
+    }
+}
+
+static void post_segments_nonblocking(std::vector<Fabric_Rma_Segment> *segments,
+                                      Fam_Context *famCtx, bool write) {
+    for (auto &seg : *segments) {
+        if (write)
+            fabric_write_nonblocking(seg.key, seg.local, seg.nbytes,
+                                     seg.offset, seg.fiAddr, famCtx);
+        else
+            fabric_read_nonblocking(seg.key, seg.local, seg.nbytes, seg.offset,
+                                    seg.fiAddr, famCtx);
+    }
+}
+
 int Fam_Ops_Libfabric::gather_blocking(void *local, Fam_Descriptor *descriptor,
                                        uint64_t nElements,
                                        uint64_t firstElement, uint64_t stride,
                                        uint64_t elementSize) {
 
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, firstElement,
+                             stride, NULL, elementSize, fiAddr, &segments);
+        return fabric_read_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int ret = fabric_gather_stride_blocking(
         key, local, elementSize, firstElement, nElements, stride,
         (*fiAddr)[nodeId], get_context(descriptor), fabric_iov_limit,
@@ -424,10 +799,18 @@ int Fam_Ops_Libfabric::gather_blocking(void *local, Fam_Descriptor *descriptor,
                                        uint64_t *elementIndex,
                                        uint64_t elementSize) {
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, 0, 0, elementIndex,
+                             elementSize, fiAddr, &segments);
+        return fabric_read_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int ret = fabric_gather_index_blocking(
         key, local, elementSize, elementIndex, nElements, (*fiAddr)[nodeId],
         get_context(descriptor), fabric_iov_limit,
@@ -441,10 +824,18 @@ int Fam_Ops_Libfabric::scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t elementSize) {
 
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, firstElement,
+                             stride, NULL, elementSize, fiAddr, &segments);
+        return fabric_write_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int ret = fabric_scatter_stride_blocking(
         key, local, elementSize, firstElement, nElements, stride,
         (*fiAddr)[nodeId], get_context(descriptor), fabric_iov_limit,
@@ -457,10 +848,18 @@ int Fam_Ops_Libfabric::scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t *elementIndex,
                                         uint64_t elementSize) {
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, 0, 0, elementIndex,
+                             elementSize, fiAddr, &segments);
+        return fabric_write_segments(
+            &segments, get_context(descriptor), putGetChunkSize,
+            putGetPipelineDepth * descriptor->get_used_memsrv_cnt());
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int ret = fabric_scatter_index_blocking(
         key, local, elementSize, elementIndex, nElements, (*fiAddr)[nodeId],
         get_context(descriptor), fabric_iov_limit,
@@ -471,12 +870,17 @@ int Fam_Ops_Libfabric::scatter_blocking(void *local, Fam_Descriptor *descriptor,
 void Fam_Ops_Libfabric::put_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t offset, uint64_t nbytes) {
 
-    uint64_t key;
-
-    key = descriptor->get_key();
-    offset += (uint64_t)descriptor->get_base_address();
-    uint64_t nodeId = descriptor->get_memserver_id();
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_stripe_segments(descriptor, local, offset, nbytes, fiAddr,
+                            &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), true);
+        return;
+    }
+
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
     fabric_write_nonblocking(key, local, nbytes, offset, (*fiAddr)[nodeId],
                              get_context(descriptor));
     return;
@@ -484,12 +888,17 @@ void Fam_Ops_Libfabric::put_nonblocking(void *local, Fam_Descriptor *descriptor,
 
 void Fam_Ops_Libfabric::get_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t offset, uint64_t nbytes) {
-    uint64_t key;
-
-    key = descriptor->get_key();
-    offset += (uint64_t)descriptor->get_base_address();
-    uint64_t nodeId = descriptor->get_memserver_id();
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_stripe_segments(descriptor, local, offset, nbytes, fiAddr,
+                            &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), false);
+        return;
+    }
+
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
     fabric_read_nonblocking(key, local, nbytes, offset, (*fiAddr)[nodeId],
                             get_context(descriptor));
     return;
@@ -500,10 +909,17 @@ void Fam_Ops_Libfabric::gather_nonblocking(
     uint64_t firstElement, uint64_t stride, uint64_t elementSize) {
 
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, firstElement,
+                             stride, NULL, elementSize, fiAddr, &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), false);
+        return;
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_gather_stride_nonblocking(key, local, elementSize, firstElement,
                                      nElements, stride, (*fiAddr)[nodeId],
                                      get_context(descriptor), fabric_iov_limit,
@@ -517,10 +933,17 @@ void Fam_Ops_Libfabric::gather_nonblocking(void *local,
                                            uint64_t *elementIndex,
                                            uint64_t elementSize) {
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, 0, 0, elementIndex,
+                             elementSize, fiAddr, &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), false);
+        return;
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_gather_index_nonblocking(key, local, elementSize, elementIndex,
                                     nElements, (*fiAddr)[nodeId],
                                     get_context(descriptor), fabric_iov_limit,
@@ -533,10 +956,17 @@ void Fam_Ops_Libfabric::scatter_nonblocking(
     uint64_t firstElement, uint64_t stride, uint64_t elementSize) {
 
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, firstElement,
+                             stride, NULL, elementSize, fiAddr, &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), true);
+        return;
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_scatter_stride_nonblocking(key, local, elementSize, firstElement,
                                       nElements, stride, (*fiAddr)[nodeId],
                                       get_context(descriptor), fabric_iov_limit,
@@ -550,10 +980,17 @@ void Fam_Ops_Libfabric::scatter_nonblocking(void *local,
                                             uint64_t *elementIndex,
                                             uint64_t elementSize) {
     uint64_t key;
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    if (descriptor->get_interleave_size()) {
+        std::vector<Fabric_Rma_Segment> segments;
+        get_element_segments(descriptor, local, nElements, 0, 0, elementIndex,
+                             elementSize, fiAddr, &segments);
+        post_segments_nonblocking(&segments, get_context(descriptor), true);
+        return;
+    }
 
     key = descriptor->get_key();
     uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_scatter_index_nonblocking(key, local, elementSize, elementIndex,
                                      nElements, (*fiAddr)[nodeId],
                                      get_context(descriptor), fabric_iov_limit,
@@ -586,6 +1023,14 @@ void Fam_Ops_Libfabric::wait_for_copy(void *waitObj) {
     return famAllocator->wait_for_copy(waitObj);
 }
 
+uint64_t Fam_Ops_Libfabric::copy_progress(void *waitObj) {
+    return famAllocator->copy_progress(waitObj);
+}
+
+void Fam_Ops_Libfabric::cancel_copy(void *waitObj) {
+    return famAllocator->cancel_copy(waitObj);
+}
+
 void Fam_Ops_Libfabric::fence(Fam_Region_Descriptor *descriptor) {
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
 
@@ -629,6 +1074,15 @@ void Fam_Ops_Libfabric::fence(Fam_Region_Descriptor *descriptor) {
         }
         // ctx mutex unlock
         (void)pthread_mutex_unlock(&ctxLock);
+    } else if (famContextModel == FAM_CONTEXT_THREAD) {
+        // A thread which issued nothing has no contexts to fence
+        std::map<uint64_t, Fam_Context *> *ctxMap = get_thread_contexts(false);
+        if (ctxMap == NULL)
+            return;
+        for (auto fam_ctx : *ctxMap) {
+            nodeId = fam_ctx.first;
+            fabric_fence((*fiAddr)[nodeId], fam_ctx.second);
+        }
     }
 }
 
@@ -640,45 +1094,46 @@ void Fam_Ops_Libfabric::check_progress(Fam_Region_Descriptor *descriptor) {
             uint64_t success = fi_cntr_read(famCtx->get_txCntr());
             success += fi_cntr_read(famCtx->get_rxCntr());
         }
+    } else if (famContextModel == FAM_CONTEXT_THREAD) {
+        std::map<uint64_t, Fam_Context *> *ctxMap = get_thread_contexts(false);
+        if (ctxMap == NULL)
+            return;
+        for (auto context : *ctxMap) {
+            Fam_Context *famCtx = context.second;
+            uint64_t success = fi_cntr_read(famCtx->get_txCntr());
+            success += fi_cntr_read(famCtx->get_rxCntr());
+        }
     }
     return;
 }
 
 void Fam_Ops_Libfabric::quiet_context(Fam_Context *context = NULL) {
     if (famContextModel == FAM_CONTEXT_DEFAULT) {
-        std::list<std::shared_future<void>> resultList;
-        int err = 0;
-        std::string errmsg;
-        int exception_caught = 0;
-
-        for (auto context : *defContexts) {
-            std::future<void> result =
-                (std::async(std::launch::async, fabric_quiet, context.second));
-            resultList.push_back(result.share());
-        }
-        for (auto result : resultList) {
-
-            try {
-                result.get();
-            } catch (Fam_Exception &e) {
-                err = e.fam_error();
-                errmsg = e.fam_error_msg();
-                exception_caught = 1;
-            }
-        }
-
-        if (exception_caught == 1) {
-            THROW_ERRNO_MSG(Fam_Datapath_Exception, get_fam_error(err), errmsg);
-        }
-
+        // Poll the contexts of all memory servers from this thread
+        std::vector<Fam_Context *> ctxList;
+        ctxList.reserve(defContexts->size());
+        for (auto fam_ctx : *defContexts)
+            ctxList.push_back(fam_ctx.second);
+        fabric_quiet_contexts(&ctxList);
     } else if (famContextModel == FAM_CONTEXT_REGION) {
         fabric_quiet(context);
+    } else if (famContextModel == FAM_CONTEXT_THREAD) {
+        // Only the calling thread's contexts need to be drained
+        std::map<uint64_t, Fam_Context *> *ctxMap = get_thread_contexts(false);
+        if (ctxMap == NULL)
+            return;
+        std::vector<Fam_Context *> ctxList;
+        ctxList.reserve(ctxMap->size());
+        for (auto fam_ctx : *ctxMap)
+            ctxList.push_back(fam_ctx.second);
+        fabric_quiet_contexts(&ctxList);
     }
     return;
 }
 
 void Fam_Ops_Libfabric::quiet(Fam_Region_Descriptor *descriptor) {
-    if (famContextModel == FAM_CONTEXT_DEFAULT) {
+    if (famContextModel == FAM_CONTEXT_DEFAULT ||
+        famContextModel == FAM_CONTEXT_THREAD) {
         quiet_context();
         return;
     } else if (famContextModel == FAM_CONTEXT_REGION) {
@@ -716,9 +1171,8 @@ void Fam_Ops_Libfabric::quiet(Fam_Region_Descriptor *descriptor) {
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT32,
@@ -729,9 +1183,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT64,
@@ -742,9 +1195,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT32,
@@ -755,9 +1207,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT64,
@@ -768,9 +1219,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_FLOAT,
@@ -781,9 +1231,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_DOUBLE,
@@ -794,9 +1243,8 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_INT32,
@@ -807,9 +1255,8 @@ void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_INT64,
@@ -820,9 +1267,8 @@ void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_UINT32,
@@ -833,9 +1279,8 @@ void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_UINT64,
@@ -846,9 +1291,8 @@ void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_FLOAT,
@@ -859,9 +1303,8 @@ void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_DOUBLE,
@@ -908,9 +1351,8 @@ void Fam_Ops_Libfabric::atomic_subtract(Fam_Descriptor *descriptor,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_INT32,
@@ -921,9 +1363,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_INT64,
@@ -934,9 +1375,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_UINT32,
@@ -947,9 +1387,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_UINT64,
@@ -960,9 +1399,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_FLOAT,
@@ -973,9 +1411,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_DOUBLE,
@@ -986,9 +1423,8 @@ void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_INT32,
@@ -999,9 +1435,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_INT64,
@@ -1012,9 +1447,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_UINT32,
@@ -1025,9 +1459,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_UINT64,
@@ -1038,9 +1471,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_FLOAT,
@@ -1051,9 +1483,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_DOUBLE,
@@ -1064,9 +1495,8 @@ void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BAND, FI_UINT32,
@@ -1077,9 +1507,8 @@ void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BAND, FI_UINT64,
@@ -1090,9 +1519,8 @@ void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BOR, FI_UINT32,
@@ -1103,9 +1531,8 @@ void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BOR, FI_UINT64,
@@ -1116,9 +1543,8 @@ void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BXOR, FI_UINT32,
@@ -1129,9 +1555,8 @@ void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
 void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     fabric_atomic(key, (void *)&value, offset, FI_BXOR, FI_UINT64,
@@ -1142,9 +1567,8 @@ void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
 int32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                 int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t old;
@@ -1157,9 +1581,8 @@ int32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
 int64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                 int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t old;
@@ -1172,9 +1595,8 @@ int64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
 uint32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                  uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1187,9 +1609,8 @@ uint32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
 uint64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                  uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1202,9 +1623,8 @@ uint64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
 float Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                               float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     float old;
@@ -1217,9 +1637,8 @@ float Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
 double Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     double old;
@@ -1233,9 +1652,8 @@ int32_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                         uint64_t offset, int32_t oldValue,
                                         int32_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t old;
@@ -1249,9 +1667,8 @@ int64_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                         uint64_t offset, int64_t oldValue,
                                         int64_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t old;
@@ -1265,9 +1682,8 @@ uint32_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, uint32_t oldValue,
                                          uint32_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1281,9 +1697,8 @@ uint64_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, uint64_t oldValue,
                                          uint64_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1297,41 +1712,17 @@ int128_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, int128_t oldValue,
                                          int128_t newValue) {
 
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    int128_t local;
-
-    famAllocator->acquire_CAS_lock(descriptor);
-    try {
-        fabric_read(key, &local, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                    get_context(descriptor));
-    } catch (...) {
-        famAllocator->release_CAS_lock(descriptor);
-        throw;
-    }
-
-    if (local == oldValue) {
-        try {
-            fabric_write(key, &newValue, sizeof(int128_t), offset,
-                         (*fiAddr)[nodeId], get_context(descriptor));
-        } catch (...) {
-            famAllocator->release_CAS_lock(descriptor);
-            throw;
-        }
-    }
-    famAllocator->release_CAS_lock(descriptor);
-    return local;
+    // Libfabric has no 128-bit atomic datatype; the memory server performs
+    // the compare-and-swap under its CAS lock in a single request.
+    return famAllocator->atomic_int128(INT128_ATOMIC_CSWAP, descriptor, offset,
+                                       newValue, oldValue);
 }
 
 int32_t Fam_Ops_Libfabric::atomic_fetch_int32(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t result;
@@ -1344,9 +1735,8 @@ int32_t Fam_Ops_Libfabric::atomic_fetch_int32(Fam_Descriptor *descriptor,
 int64_t Fam_Ops_Libfabric::atomic_fetch_int64(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t result;
@@ -1359,9 +1749,8 @@ int64_t Fam_Ops_Libfabric::atomic_fetch_int64(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_uint32(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t result;
@@ -1374,9 +1763,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_uint32(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_uint64(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t result;
@@ -1389,9 +1777,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_uint64(Fam_Descriptor *descriptor,
 float Fam_Ops_Libfabric::atomic_fetch_float(Fam_Descriptor *descriptor,
                                             uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     float result;
@@ -1404,9 +1791,8 @@ float Fam_Ops_Libfabric::atomic_fetch_float(Fam_Descriptor *descriptor,
 double Fam_Ops_Libfabric::atomic_fetch_double(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     double result;
@@ -1419,9 +1805,8 @@ double Fam_Ops_Libfabric::atomic_fetch_double(Fam_Descriptor *descriptor,
 int32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t old;
@@ -1433,9 +1818,8 @@ int32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
 int64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t old;
@@ -1447,9 +1831,8 @@ int64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1461,9 +1844,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1475,9 +1857,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
 float Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     float old;
@@ -1489,9 +1870,8 @@ float Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
 double Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     double old;
@@ -1500,6 +1880,84 @@ double Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
     return old;
 }
 
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     int32_t value,
+                                                     int32_t *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_INT32, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     int64_t value,
+                                                     int64_t *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_INT64, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     uint32_t value,
+                                                     uint32_t *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_UINT32, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     uint64_t value,
+                                                     uint64_t *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_UINT64, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     float value,
+                                                     float *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_FLOAT, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
+void Fam_Ops_Libfabric::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                                     uint64_t offset,
+                                                     double value,
+                                                     double *result) {
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
+
+    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    fabric_fetch_atomic_nonblocking(key, (void *)&value, (void *)result, offset,
+                                    FI_SUM, FI_DOUBLE, (*fiAddr)[nodeId],
+                                    get_context(descriptor));
+}
+
 int32_t Fam_Ops_Libfabric::atomic_fetch_subtract(Fam_Descriptor *descriptor,
                                                  uint64_t offset,
                                                  int32_t value) {
@@ -1537,9 +1995,8 @@ double Fam_Ops_Libfabric::atomic_fetch_subtract(Fam_Descriptor *descriptor,
 int32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t old;
@@ -1551,9 +2008,8 @@ int32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 int64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t old;
@@ -1565,9 +2021,8 @@ int64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1579,9 +2034,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1593,9 +2047,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 float Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     float old;
@@ -1607,9 +2060,8 @@ float Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 double Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     double old;
@@ -1621,9 +2073,8 @@ double Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
 int32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int32_t old;
@@ -1635,9 +2086,8 @@ int32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 int64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     int64_t old;
@@ -1649,9 +2099,8 @@ int64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1663,9 +2112,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1677,9 +2125,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 float Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     float old;
@@ -1691,9 +2138,8 @@ float Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 double Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     double old;
@@ -1705,9 +2151,8 @@ double Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1719,9 +2164,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1733,9 +2177,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
                                             uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1747,9 +2190,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
                                             uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1761,9 +2203,8 @@ uint64_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
 uint32_t Fam_Ops_Libfabric::atomic_fetch_xor(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint32_t old;
@@ -1775,9 +2216,8 @@ uint32_t Fam_Ops_Libfabric::atomic_fetch_xor(Fam_Descriptor *descriptor,
 uint64_t Fam_Ops_Libfabric::atomic_fetch_xor(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
+    uint64_t key, nodeId;
+    get_stripe_location(descriptor, &offset, &key, &nodeId);
 
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     uint64_t old;
@@ -1790,40 +2230,14 @@ void Fam_Ops_Libfabric::abort(int status) FAM_OPS_UNIMPLEMENTED(void__);
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int128_t value) {
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    famAllocator->acquire_CAS_lock(descriptor);
-    try {
-        fabric_write(key, &value, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                     get_context(descriptor));
-    } catch (...) {
-        famAllocator->release_CAS_lock(descriptor);
-        throw;
-    }
-    famAllocator->release_CAS_lock(descriptor);
+    famAllocator->atomic_int128(INT128_ATOMIC_SET, descriptor, offset, value,
+                                0);
 }
 
 int128_t Fam_Ops_Libfabric::atomic_fetch_int128(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    offset += (uint64_t)descriptor->get_base_address();
-
-    int128_t local;
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    famAllocator->acquire_CAS_lock(descriptor);
-    try {
-        fabric_read(key, &local, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                    get_context(descriptor));
-    } catch (...) {
-        famAllocator->release_CAS_lock(descriptor);
-        throw;
-    }
-    famAllocator->release_CAS_lock(descriptor);
-    return local;
+    return famAllocator->atomic_int128(INT128_ATOMIC_FETCH, descriptor,
+                                       offset, 0, 0);
 }
 
 } // namespace openfam
@@ -52,7 +52,10 @@ Fam_Ops_SHM::Fam_Ops_SHM(Fam_Thread_Model famTM, Fam_Context_Model famCM,
                          Fam_Allocator_Client *famAlloc, uint64_t numConsumer) {
     asyncQHandler = new Fam_Async_QHandler(numConsumer);
     famThreadModel = famTM;
-    famContextModel = famCM;
+    // Shared memory model has no endpoints, so per-thread contexts are the
+    // same as the default context
+    famContextModel =
+        (famCM == FAM_CONTEXT_THREAD ? FAM_CONTEXT_DEFAULT : famCM);
     famAllocator = famAlloc;
     contexts = new std::map<uint64_t, Fam_Context *>();
 }
@@ -141,8 +144,7 @@ int Fam_Ops_SHM::put_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    memcpy(dest, local, nbytes);
-    openfam_persist(dest, nbytes);
+    asyncQHandler->blocking_copy(WRITE, local, dest, nbytes);
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -173,8 +175,7 @@ int Fam_Ops_SHM::get_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    openfam_invalidate(src, nbytes);
-    memcpy(local, src, nbytes);
+    asyncQHandler->blocking_copy(READ, src, local, nbytes);
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -366,7 +367,7 @@ void Fam_Ops_SHM::put_nonblocking(void *local, Fam_Descriptor *descriptor,
 
     void *dest = (void *)((uint64_t)base + offset);
     Fam_Ops_Info opsInfo = {WRITE,      local, dest,     nbytes, offset,
-                            upperBound, key,   itemSize, NULL};
+                            upperBound, key,   itemSize, NULL, famCtx, NULL};
     asyncQHandler->initiate_operation(opsInfo);
     famCtx->inc_num_tx_ops();
 
@@ -391,7 +392,7 @@ void Fam_Ops_SHM::get_nonblocking(void *local, Fam_Descriptor *descriptor,
     void *src = (void *)((uint64_t)base + offset);
 
     Fam_Ops_Info opsInfo = {READ,       src, local,    nbytes, offset,
-                            upperBound, key, itemSize, NULL};
+                            upperBound, key, itemSize, NULL, famCtx, NULL};
     asyncQHandler->initiate_operation(opsInfo);
     famCtx->inc_num_rx_ops();
 
@@ -423,7 +424,7 @@ void Fam_Ops_SHM::gather_nonblocking(void *local, Fam_Descriptor *descriptor,
                                          elementSize * stride * i));
         dest = (void *)((uint64_t)local + (i * elementSize));
         Fam_Ops_Info opsInfo = {READ,       src, dest,     elementSize, offset,
-                                upperBound, key, itemSize, NULL};
+                                upperBound, key, itemSize, NULL, famCtx, NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_rx_ops();
     }
@@ -456,7 +457,7 @@ void Fam_Ops_SHM::gather_nonblocking(void *local, Fam_Descriptor *descriptor,
         upperBound = elementIndex[i] + elementSize;
         Fam_Ops_Info opsInfo = {
             READ,       src, dest,     elementSize, elementIndex[i],
-            upperBound, key, itemSize, NULL};
+            upperBound, key, itemSize, NULL, famCtx, NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_rx_ops();
     }
@@ -489,7 +490,7 @@ void Fam_Ops_SHM::scatter_nonblocking(void *local, Fam_Descriptor *descriptor,
         dest = (void *)((uint64_t)base + ((firstElement * elementSize) +
                                           elementSize * stride * i));
         Fam_Ops_Info opsInfo = {WRITE,      src, dest,     elementSize, offset,
-                                upperBound, key, itemSize, NULL};
+                                upperBound, key, itemSize, NULL, famCtx, NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_tx_ops();
     }
@@ -521,7 +522,7 @@ void Fam_Ops_SHM::scatter_nonblocking(void *local, Fam_Descriptor *descriptor,
         upperBound = elementIndex[i] + elementSize;
         Fam_Ops_Info opsInfo = {
             WRITE,      src, dest,     elementSize, elementIndex[i],
-            upperBound, key, itemSize, NULL};
+            upperBound, key, itemSize, NULL, famCtx, NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_tx_ops();
     }
@@ -612,9 +613,14 @@ void *Fam_Ops_SHM::copy(Fam_Descriptor *src, uint64_t srcOffset,
 
     Fam_Copy_Tag *tag = new Fam_Copy_Tag();
     tag->copyDone.store(false, boost::memory_order_seq_cst);
+    tag->progress.bytesCopied.store(0);
+    tag->progress.cancelled.store(false);
+    tag->progress.copyId = 0;
     tag->memoryService = NULL;
+    tag->size = nbytes;
 
-    Fam_Ops_Info opsInfo = {COPY, baseSrc, baseDest, nbytes, 0, 0, 0, 0, tag};
+    Fam_Ops_Info opsInfo = {COPY, baseSrc, baseDest, nbytes, 0,   0,
+                            0,    0,       tag,      NULL,   NULL};
     asyncQHandler->initiate_operation(opsInfo);
 
     return (void *)tag;
@@ -624,6 +630,14 @@ void Fam_Ops_SHM::wait_for_copy(void *waitObj) {
     asyncQHandler->wait_for_copy(waitObj);
 }
 
+uint64_t Fam_Ops_SHM::copy_progress(void *waitObj) {
+    return asyncQHandler->copy_progress(waitObj);
+}
+
+void Fam_Ops_SHM::cancel_copy(void *waitObj) {
+    asyncQHandler->cancel_copy(waitObj);
+}
+
 void Fam_Ops_SHM::fence(Fam_Region_Descriptor *descriptor)
     FAM_OPS_UNIMPLEMENTED(void__);
 
@@ -1786,6 +1800,43 @@ double Fam_Ops_SHM::atomic_fetch_add(Fam_Descriptor *descriptor,
     return *oldValue;
 }
 
+// Shared memory atomics complete immediately
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, int32_t value,
+                                               int32_t *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, int64_t value,
+                                               int64_t *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, uint32_t value,
+                                               uint32_t *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, uint64_t value,
+                                               uint64_t *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, float value,
+                                               float *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
+void Fam_Ops_SHM::atomic_fetch_add_nonblocking(Fam_Descriptor *descriptor,
+                                               uint64_t offset, double value,
+                                               double *result) {
+    *result = atomic_fetch_add(descriptor, offset, value);
+}
+
 int32_t Fam_Ops_SHM::atomic_fetch_subtract(Fam_Descriptor *descriptor,
                                            uint64_t offset, int32_t value) {
     return atomic_fetch_add(descriptor, offset, -value);
@@ -64,6 +64,8 @@ void profile_dump_handler(int signum) {
 int main(int argc, char *argv[]) {
     uint64_t rpcPort = 8787;
     char *name = strdup("127.0.0.1");
+    Fam_Async_Rpc_Options rpcOptions;
+    init_async_rpc_options(rpcOptions);
 
     for (int i = 1; i < argc; i++) {
         if ((std::string(argv[i]) == "-v") ||
@@ -83,7 +85,7 @@ int main(int argc, char *argv[]) {
                  << "\n"
                  << "\t-v/--version        : Display CIS server version  \n"
                  << "\n"
-                 << endl;
+                 << FAM_ASYNC_RPC_OPTIONS_USAGE << endl;
             exit(0);
         } else if ((std::string(argv[i]) == "-a") ||
                    (std::string(argv[i]) == "--address")) {
@@ -91,6 +93,8 @@ int main(int argc, char *argv[]) {
         } else if ((std::string(argv[i]) == "-r") ||
                    (std::string(argv[i]) == "--rpcport")) {
             rpcPort = atoi(argv[++i]);
+        } else {
+            parse_async_rpc_option(argc, argv, i, rpcOptions);
         }
     }
 
@@ -105,7 +109,7 @@ int main(int argc, char *argv[]) {
 #endif
     cisServer = NULL;
     try {
-        cisServer = new Fam_CIS_Async_Handler(rpcPort, name);
+        cisServer = new Fam_CIS_Async_Handler(rpcPort, name, rpcOptions);
         cisServer->run();
     } catch (Fam_Exception &e) {
         if (cisServer) {
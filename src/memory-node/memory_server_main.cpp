@@ -56,6 +56,8 @@ Fam_Memory_Service_Server *memoryService;
 
 int main(int argc, char *argv[]) {
     uint64_t rpcPort = 8789;
+    Fam_Async_Rpc_Options rpcOptions;
+    init_async_rpc_options(rpcOptions);
     char *name = strdup("127.0.0.1");
     char *libfabricPort = strdup("7500");
     char *provider = strdup("");
@@ -92,7 +94,7 @@ int main(int argc, char *argv[]) {
                 << "\n"
 				<< "\t-i/--init			  : Initialize the root shelf \n"
 				<< "\n"
-                << endl;
+                << FAM_ASYNC_RPC_OPTIONS_USAGE << endl;
             exit(0);
 		} else if ((std::string(argv[i]) == "-i") ||
                    (std::string(argv[i]) == "--init")) {
@@ -112,6 +114,8 @@ int main(int argc, char *argv[]) {
         } else if ((std::string(argv[i]) == "-f") ||
                    (std::string(argv[i]) == "--fam_path")) {
             fam_path = strdup(argv[++i]);
+        } else {
+            parse_async_rpc_option(argc, argv, i, rpcOptions);
         }
     }
 
@@ -133,7 +137,7 @@ int main(int argc, char *argv[]) {
     try {
         memoryService = new Fam_Memory_Service_Server(
             rpcPort, name, libfabricPort, provider, fam_path);
-        memoryService->run();
+        memoryService->run(rpcOptions);
     } catch (Fam_Exception &e) {
         if (memoryService) {
             delete memoryService;
@@ -57,6 +57,8 @@ Fam_Metadata_Service_Server *metadataService;
 int main(int argc, char *argv[]) {
     uint64_t rpcPort = 8788;
     char *name = strdup("127.0.0.1");
+    Fam_Async_Rpc_Options rpcOptions;
+    init_async_rpc_options(rpcOptions);
 
     for (int i = 1; i < argc; i++) {
         if ((std::string(argv[i]) == "-v") ||
@@ -78,7 +80,7 @@ int main(int argc, char *argv[]) {
                 << "\n"
                 << "\t-v/--version        : Display metadata server version  \n"
                 << "\n"
-                << endl;
+                << FAM_ASYNC_RPC_OPTIONS_USAGE << endl;
             exit(0);
         } else if ((std::string(argv[i]) == "-a") ||
                    (std::string(argv[i]) == "--address")) {
@@ -86,6 +88,8 @@ int main(int argc, char *argv[]) {
         } else if ((std::string(argv[i]) == "-r") ||
                    (std::string(argv[i]) == "--rpcport")) {
             rpcPort = atoi(argv[++i]);
+        } else {
+            parse_async_rpc_option(argc, argv, i, rpcOptions);
         }
     }
 
@@ -98,7 +102,7 @@ int main(int argc, char *argv[]) {
     metadataService = NULL;
     try {
         metadataService = new Fam_Metadata_Service_Server(rpcPort, name);
-        metadataService->run();
+        metadataService->run(rpcOptions);
     } catch (Fam_Exception &e) {
         if (metadataService) {
             delete metadataService;
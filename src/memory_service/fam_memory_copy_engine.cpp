@@ -0,0 +1,150 @@
+/*
+ * fam_memory_copy_engine.cpp
+ * Copyright (c) 2020 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include "memory_service/fam_memory_copy_engine.h"
+
+#include <algorithm>
+
+namespace openfam {
+
+Fam_Memory_Copy_Engine::Fam_Memory_Copy_Engine(uint64_t numWorkers,
+                                               uint64_t chunkSize)
+    : numWorkers(numWorkers), chunkSize(chunkSize ? chunkSize : UINT64_MAX),
+      running(true) {
+    for (uint64_t i = 0; i < numWorkers; i++)
+        workers.push_back(
+            std::thread(&Fam_Memory_Copy_Engine::worker_th, this, i));
+}
+
+Fam_Memory_Copy_Engine::~Fam_Memory_Copy_Engine() {
+    {
+        std::lock_guard<std::mutex> guard(jobsLock);
+        running = false;
+    }
+    workCond.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void Fam_Memory_Copy_Engine::run(uint64_t size, Chunk_Fn chunkFn,
+                                 Fam_Copy_Progress *progress) {
+    if (size == 0)
+        return;
+
+    Copy_Job_t job;
+    job.chunkFn = chunkFn;
+    job.size = size;
+    job.nextOffset = 0;
+    job.inFlight = 0;
+    job.progress = progress;
+
+    if (numWorkers == 0) {
+        // No workers, copy the chunks in the calling thread
+        for (uint64_t offset = 0;
+             offset < size && !job.error && !is_cancelled(&job);
+             offset += chunkSize)
+            run_chunk(&job, 0, offset, std::min(chunkSize, size - offset));
+        if (job.error)
+            std::rethrow_exception(job.error);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lk(jobsLock);
+    jobs.push_back(&job);
+    workCond.notify_all();
+    doneCond.wait(lk, [&job] {
+        return job.nextOffset >= job.size && job.inFlight == 0;
+    });
+    lk.unlock();
+
+    if (job.error)
+        std::rethrow_exception(job.error);
+}
+
+void Fam_Memory_Copy_Engine::worker_th(uint64_t worker) {
+    std::unique_lock<std::mutex> lk(jobsLock);
+    while (running) {
+        if (jobs.empty()) {
+            workCond.wait(lk);
+            continue;
+        }
+        // Take the next chunk of the copy at the front and move that copy to
+        // the back, so that the copies take turns.
+        Copy_Job_t *job = jobs.front();
+        jobs.pop_front();
+        if (is_cancelled(job)) {
+            // Start no more chunks, wait for the ones in flight
+            job->nextOffset = job->size;
+            if (job->inFlight == 0)
+                doneCond.notify_all();
+            continue;
+        }
+        uint64_t offset = job->nextOffset;
+        uint64_t len = std::min(chunkSize, job->size - offset);
+        job->nextOffset += len;
+        job->inFlight++;
+        if (job->nextOffset < job->size)
+            jobs.push_back(job);
+        lk.unlock();
+
+        run_chunk(job, worker, offset, len);
+
+        lk.lock();
+        job->inFlight--;
+        if (job->nextOffset >= job->size && job->inFlight == 0)
+            doneCond.notify_all();
+    }
+}
+
+void Fam_Memory_Copy_Engine::run_chunk(Copy_Job_t *job, uint64_t worker,
+                                       uint64_t offset, uint64_t len) {
+    for (int attempt = 0;; attempt++) {
+        try {
+            job->chunkFn(worker, offset, len);
+            if (job->progress)
+                job->progress->bytesCopied.fetch_add(len,
+                                                     std::memory_order_acq_rel);
+            return;
+        } catch (...) {
+            if (attempt < COPY_CHUNK_RETRIES)
+                continue;
+            std::lock_guard<std::mutex> guard(jobsLock);
+            if (!job->error)
+                job->error = std::current_exception();
+            // Do not start the remaining chunks of a failed copy
+            if (job->nextOffset < job->size) {
+                job->nextOffset = job->size;
+                jobs.remove(job);
+            }
+            return;
+        }
+    }
+}
+
+} // namespace openfam
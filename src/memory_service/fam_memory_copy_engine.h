@@ -0,0 +1,110 @@
+/*
+ * fam_memory_copy_engine.h
+ * Copyright (c) 2020 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_MEMORY_COPY_ENGINE_H_
+#define FAM_MEMORY_COPY_ENGINE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/fam_internal.h"
+
+namespace openfam {
+
+// Number of times a failed chunk is retried before the copy fails
+#define COPY_CHUNK_RETRIES 3
+
+/*
+ * Fam_Memory_Copy_Engine splits copies into chunks and runs them on a pool
+ * of worker threads. Workers take chunks from the active copies in round
+ * robin order, so that concurrent copies share the workers fairly, and at
+ * most one chunk per worker is in flight. A failed chunk is retried on its
+ * own; the chunks already copied are not redone. The progress of a copy is
+ * reported, and its cancellation checked, at chunk boundaries.
+ */
+class Fam_Memory_Copy_Engine {
+  public:
+    /*
+     * Copies the chunk [offset, offset + len) of a copy. worker is the index
+     * of the calling worker, to select per worker resources. Throws on
+     * failure.
+     */
+    typedef std::function<void(uint64_t worker, uint64_t offset, uint64_t len)>
+        Chunk_Fn;
+
+    Fam_Memory_Copy_Engine(uint64_t numWorkers, uint64_t chunkSize);
+    ~Fam_Memory_Copy_Engine();
+
+    /*
+     * Runs chunkFn over [0, size) and waits until all the chunks are done.
+     * Rethrows the error of a chunk which failed all its retries. If
+     * progress is given, the bytes copied are added to it as chunks
+     * complete, and no more chunks are started once it is cancelled.
+     */
+    void run(uint64_t size, Chunk_Fn chunkFn,
+             Fam_Copy_Progress *progress = NULL);
+
+    uint64_t get_num_workers() { return numWorkers; }
+
+  private:
+    typedef struct Copy_Job {
+        Chunk_Fn chunkFn;
+        uint64_t size;
+        uint64_t nextOffset;
+        uint64_t inFlight;
+        Fam_Copy_Progress *progress;
+        std::exception_ptr error;
+    } Copy_Job_t;
+
+    bool is_cancelled(Copy_Job_t *job) {
+        return job->progress &&
+               job->progress->cancelled.load(std::memory_order_acquire);
+    }
+    void worker_th(uint64_t worker);
+    void run_chunk(Copy_Job_t *job, uint64_t worker, uint64_t offset,
+                   uint64_t len);
+
+    uint64_t numWorkers;
+    uint64_t chunkSize;
+    bool running;
+    std::list<Copy_Job_t *> jobs;
+    std::mutex jobsLock;
+    std::condition_variable workCond;
+    std::condition_variable doneCond;
+    std::vector<std::thread> workers;
+};
+
+} // namespace openfam
+#endif /* end of FAM_MEMORY_COPY_ENGINE_H_ */
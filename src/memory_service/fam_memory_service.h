@@ -32,6 +32,7 @@
 
 #include <string>
 #include <sys/types.h>
+#include <vector>
 
 #include "common/fam_internal.h"
 #include "common/fam_internal_exception.h"
@@ -59,16 +60,35 @@ class Fam_Memory_Service {
 
     virtual void deallocate(uint64_t regionId, uint64_t offset) = 0;
 
+    virtual std::vector<Fam_Region_Item_Info>
+    allocate_batch(uint64_t regionId, const std::vector<size_t> &sizes,
+                   bool rwFlag) = 0;
+
+    virtual void deallocate_batch(uint64_t regionId,
+                                  const std::vector<uint64_t> &offsets) = 0;
+
     virtual void copy(uint64_t srcRegionId, uint64_t srcOffset, uint64_t srcKey,
                       uint64_t srcCopyStart, const char *srcAddr,
                       uint32_t srcAddrLen, uint64_t destRegionId,
                       uint64_t destOffset, uint64_t nbytes,
-                      uint64_t srcMemserverId, uint64_t destMemserverId) = 0;
+                      uint64_t srcMemserverId, uint64_t destMemserverId,
+                      Fam_Copy_Progress *progress = NULL) = 0;
+
+    /*
+     * Bytes copied so far by the copy named copyId (see Fam_Copy_Progress),
+     * 0 if it has not started. cancel_copy stops it before its next chunk;
+     * the copy then fails with COPY_CANCELLED.
+     */
+    virtual uint64_t copy_progress(uint64_t copyId) = 0;
+    virtual void cancel_copy(uint64_t copyId) = 0;
 
     virtual void *get_local_pointer(uint64_t regionId, uint64_t offset) = 0;
 
     virtual void acquire_CAS_lock(uint64_t offset) = 0;
     virtual void release_CAS_lock(uint64_t offset) = 0;
+    virtual int128_t atomic_int128(uint32_t op, uint64_t regionId,
+                                   uint64_t offset, int128_t operand,
+                                   int128_t compare) = 0;
 
     virtual size_t get_addr_size() = 0;
     virtual void *get_addr() = 0;
@@ -100,14 +120,14 @@ class Fam_Memory_Service {
 
     virtual void scatter_indexed_atomic(uint64_t regionId, uint64_t offset,
                                         uint64_t nElements,
-                                        const void *elementIndex,
+                                        const uint64_t *elementIndex,
                                         uint64_t elementSize, uint64_t key,
                                         const char *nodeAddr,
                                         uint32_t nodeAddrSize) = 0;
 
     virtual void gather_indexed_atomic(uint64_t regionId, uint64_t offset,
                                        uint64_t nElements,
-                                       const void *elementIndex,
+                                       const uint64_t *elementIndex,
                                        uint64_t elementSize, uint64_t key,
                                        const char *nodeAddr,
                                        uint32_t nodeAddrSize) = 0;
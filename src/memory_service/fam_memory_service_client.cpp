@@ -247,12 +247,65 @@ void Fam_Memory_Service_Client::deallocate(uint64_t regionId, uint64_t offset) {
     MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_deallocate);
 }
 
+std::vector<Fam_Region_Item_Info>
+Fam_Memory_Service_Client::allocate_batch(uint64_t regionId,
+                                          const std::vector<size_t> &sizes,
+                                          bool rwFlag) {
+    Fam_Memory_Batch_Request req;
+    Fam_Memory_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    std::vector<Fam_Region_Item_Info> infos(sizes.size());
+
+    MEMORY_SERVICE_CLIENT_PROFILE_START_OPS()
+    req.set_region_id(regionId);
+    req.set_rw_flag(rwFlag);
+    for (auto size : sizes)
+        req.add_sizes(size);
+
+    ::grpc::Status status = stub->allocate_batch(&ctx, req, &res);
+
+    STATUS_CHECK(Memory_Service_Exception)
+
+    if ((size_t)res.offsets_size() != sizes.size() ||
+        res.keys_size() != res.offsets_size() ||
+        res.bases_size() != res.offsets_size()) {
+        throw Memory_Service_Exception(FAM_ERR_RPC,
+                                       "Incomplete batch allocate response");
+    }
+    for (int i = 0; i < res.offsets_size(); i++) {
+        infos[i].offset = res.offsets(i);
+        infos[i].key = res.keys(i);
+        infos[i].base = (void *)res.bases(i);
+    }
+    MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_allocate_batch);
+    return infos;
+}
+
+void Fam_Memory_Service_Client::deallocate_batch(
+    uint64_t regionId, const std::vector<uint64_t> &offsets) {
+    Fam_Memory_Batch_Request req;
+    Fam_Memory_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    MEMORY_SERVICE_CLIENT_PROFILE_START_OPS()
+    req.set_region_id(regionId);
+    for (auto offset : offsets)
+        req.add_offsets(offset);
+
+    ::grpc::Status status = stub->deallocate_batch(&ctx, req, &res);
+
+    STATUS_CHECK(Memory_Service_Exception)
+    MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_deallocate_batch);
+}
+
 void Fam_Memory_Service_Client::copy(uint64_t srcRegionId, uint64_t srcOffset,
                                      uint64_t srcKey, uint64_t srcCopyStart,
                                      const char *srcAddr, uint32_t srcAddrLen,
                                      uint64_t destRegionId, uint64_t destOffset,
                                      uint64_t size, uint64_t srcMemserverId,
-                                     uint64_t destMemserverId) {
+                                     uint64_t destMemserverId,
+                                     Fam_Copy_Progress *progress) {
     Fam_Memory_Copy_Request req;
     Fam_Memory_Copy_Response res;
     ::grpc::ClientContext ctx;
@@ -269,13 +322,49 @@ void Fam_Memory_Service_Client::copy(uint64_t srcRegionId, uint64_t srcOffset,
     req.set_size(size);
     req.set_src_memserver_id(srcMemserverId);
     req.set_dest_memserver_id(destMemserverId);
+    // A named copy can be followed and cancelled on the memory server with
+    // copy_progress and cancel_copy while it runs.
+    if (progress)
+        req.set_copy_id(progress->copyId);
 
     ::grpc::Status status = stub->copy(&ctx, req, &res);
 
+    if (progress && status.ok())
+        progress->bytesCopied.store(res.bytes_copied(),
+                                    std::memory_order_release);
     STATUS_CHECK(Memory_Service_Exception)
     MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_copy);
 }
 
+uint64_t Fam_Memory_Service_Client::copy_progress(uint64_t copyId) {
+    Fam_Memory_Copy_Control_Request req;
+    Fam_Memory_Copy_Control_Response res;
+    ::grpc::ClientContext ctx;
+
+    MEMORY_SERVICE_CLIENT_PROFILE_START_OPS()
+    req.set_copy_id(copyId);
+
+    ::grpc::Status status = stub->copy_progress(&ctx, req, &res);
+
+    STATUS_CHECK(Memory_Service_Exception)
+    MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_copy_progress);
+    return res.bytes_copied();
+}
+
+void Fam_Memory_Service_Client::cancel_copy(uint64_t copyId) {
+    Fam_Memory_Copy_Control_Request req;
+    Fam_Memory_Copy_Control_Response res;
+    ::grpc::ClientContext ctx;
+
+    MEMORY_SERVICE_CLIENT_PROFILE_START_OPS()
+    req.set_copy_id(copyId);
+
+    ::grpc::Status status = stub->cancel_copy(&ctx, req, &res);
+
+    STATUS_CHECK(Memory_Service_Exception)
+    MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_cancel_copy);
+}
+
 void Fam_Memory_Service_Client::acquire_CAS_lock(uint64_t offset) {
     Fam_Memory_Service_Request req;
     Fam_Memory_Service_Response res;
@@ -304,6 +393,34 @@ void Fam_Memory_Service_Client::release_CAS_lock(uint64_t offset) {
     MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_release_CAS_lock);
 }
 
+int128_t Fam_Memory_Service_Client::atomic_int128(uint32_t op,
+                                                  uint64_t regionId,
+                                                  uint64_t offset,
+                                                  int128_t operand,
+                                                  int128_t compare) {
+    Fam_Memory_Int128_Atomic_Request req;
+    Fam_Memory_Int128_Atomic_Response res;
+    ::grpc::ClientContext ctx;
+    uint64_t lo, hi;
+
+    MEMORY_SERVICE_CLIENT_PROFILE_START_OPS()
+    req.set_op(op);
+    req.set_regionid(regionId);
+    req.set_offset(offset);
+    int128_to_words(operand, &lo, &hi);
+    req.set_operand_lo(lo);
+    req.set_operand_hi(hi);
+    int128_to_words(compare, &lo, &hi);
+    req.set_compare_lo(lo);
+    req.set_compare_hi(hi);
+
+    ::grpc::Status status = stub->atomic_int128(&ctx, req, &res);
+
+    STATUS_CHECK(Memory_Service_Exception)
+    MEMORY_SERVICE_CLIENT_PROFILE_END_OPS(mem_client_atomic_int128);
+    return words_to_int128(res.result_lo(), res.result_hi());
+}
+
 size_t Fam_Memory_Service_Client::get_addr_size() {
     return memServerFabricAddrSize;
 }
@@ -449,7 +566,7 @@ void Fam_Memory_Service_Client::gather_strided_atomic(
 
 void Fam_Memory_Service_Client::scatter_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize) {
     Fam_Memory_Atomic_SG_Indexed_Request req;
     Fam_Memory_Atomic_Response res;
@@ -459,7 +576,10 @@ void Fam_Memory_Service_Client::scatter_indexed_atomic(
     req.set_regionid(regionId & REGIONID_MASK);
     req.set_offset(offset);
     req.set_nelements(nElements);
-    req.set_elementindex(elementIndex, strlen((char *)elementIndex));
+    std::string indexStr;
+    req.set_indexencoding(
+        encode_index_array(elementIndex, nElements, &indexStr));
+    req.set_elementindex(indexStr);
     req.set_elementsize(elementSize);
     req.set_key(key);
     req.set_nodeaddr(nodeAddr, nodeAddrSize);
@@ -473,7 +593,7 @@ void Fam_Memory_Service_Client::scatter_indexed_atomic(
 
 void Fam_Memory_Service_Client::gather_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize) {
     Fam_Memory_Atomic_SG_Indexed_Request req;
     Fam_Memory_Atomic_Response res;
@@ -483,7 +603,10 @@ void Fam_Memory_Service_Client::gather_indexed_atomic(
     req.set_regionid(regionId & REGIONID_MASK);
     req.set_offset(offset);
     req.set_nelements(nElements);
-    req.set_elementindex(elementIndex, strlen((char *)elementIndex));
+    std::string indexStr;
+    req.set_indexencoding(
+        encode_index_array(elementIndex, nElements, &indexStr));
+    req.set_elementindex(indexStr);
     req.set_elementsize(elementSize);
     req.set_key(key);
     req.set_nodeaddr(nodeAddr, nodeAddrSize);
@@ -66,15 +66,28 @@ class Fam_Memory_Service_Client : public Fam_Memory_Service {
 
     void deallocate(uint64_t regionId, uint64_t offset);
 
+    std::vector<Fam_Region_Item_Info>
+    allocate_batch(uint64_t regionId, const std::vector<size_t> &sizes,
+                   bool rwFlag);
+
+    void deallocate_batch(uint64_t regionId,
+                          const std::vector<uint64_t> &offsets);
+
     void copy(uint64_t srcRegionId, uint64_t srcOffset, uint64_t srcKey,
               uint64_t srcCopyStart, const char *srcAddr, uint32_t srcAddrLen,
               uint64_t destRegionId, uint64_t destOffset, uint64_t size,
-              uint64_t srcMemserverId, uint64_t destMemserverId);
+              uint64_t srcMemserverId, uint64_t destMemserverId,
+              Fam_Copy_Progress *progress = NULL);
+
+    uint64_t copy_progress(uint64_t copyId);
+    void cancel_copy(uint64_t copyId);
 
     void *get_local_pointer(uint64_t regionId, uint64_t offset);
 
     void acquire_CAS_lock(uint64_t offset);
     void release_CAS_lock(uint64_t offset);
+    int128_t atomic_int128(uint32_t op, uint64_t regionId, uint64_t offset,
+                           int128_t operand, int128_t compare);
 
     size_t get_addr_size();
     void *get_addr();
@@ -103,12 +116,13 @@ class Fam_Memory_Service_Client : public Fam_Memory_Service {
                                uint32_t nodeAddrSize);
 
     void scatter_indexed_atomic(uint64_t regionId, uint64_t offset,
-                                uint64_t nElements, const void *elementIndex,
+                                uint64_t nElements,
+                                const uint64_t *elementIndex,
                                 uint64_t elementSize, uint64_t key,
                                 const char *nodeAddr, uint32_t nodeAddrSize);
 
     void gather_indexed_atomic(uint64_t regionId, uint64_t offset,
-                               uint64_t nElements, const void *elementIndex,
+                               uint64_t nElements, const uint64_t *elementIndex,
                                uint64_t elementSize, uint64_t key,
                                const char *nodeAddr, uint32_t nodeAddrSize);
 
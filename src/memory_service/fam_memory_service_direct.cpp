@@ -120,6 +120,20 @@ Fam_Memory_Service_Direct::Fam_Memory_Service_Direct(
 
     allocator = new Memserver_Allocator(num_delayed_free_Threads, fam_path);
 
+    // Open the heaps of existing regions up front, in parallel, rather than
+    // on their first access
+    uint64_t heapOpenThreads =
+        strtoul(config_options["heap_open_threads"].c_str(), NULL, 10);
+    if (heapOpenThreads > 0)
+        allocator->open_heaps(heapOpenThreads);
+
+    // Copies from other memory servers are only possible over libfabric
+    copyEngine = new Fam_Memory_Copy_Engine(
+        isSharedMemory
+            ? 0
+            : strtoul(config_options["copy_threads"].c_str(), NULL, 10),
+        strtoul(config_options["copy_chunk_size"].c_str(), NULL, 10));
+
     if (isSharedMemory) {
         memoryRegistration = new Fam_Memory_Registration_SHM();
     } else {
@@ -138,10 +152,17 @@ Fam_Memory_Service_Direct::Fam_Memory_Service_Direct(
         1024 * 1024 *
         strtoul(config_options["ATL_data_size"].c_str(), &end, 10);
     queueCapacity = atoi(config_options["ATL_queue_size"].c_str());
+    slotPayloadSize =
+        strtoul(config_options["ATL_payload_size"].c_str(), &end, 10);
+    // Eager data always fits in the slot of its message
+    if (slotPayloadSize < MAX_DATA_IN_MSG)
+        slotPayloadSize = MAX_DATA_IN_MSG;
+    slotPayloadSize = (slotPayloadSize + 63) & ~63UL;
     init_atomic_queue();
 }
 
 Fam_Memory_Service_Direct::~Fam_Memory_Service_Direct() {
+    delete copyEngine;
     allocator->memserver_allocator_finalize();
     for (int i = 0; i < numAtomicThreads; i++)
         pthread_join(atid[i], NULL);
@@ -227,6 +248,69 @@ void Fam_Memory_Service_Direct::deallocate(uint64_t regionId, uint64_t offset) {
     return;
 }
 
+/*
+ * allocate_batch - Allocate several data items in a region and register each
+ * of them for access. Either all data items are allocated or, if one fails,
+ * the ones already allocated are released and the error is thrown.
+ */
+std::vector<Fam_Region_Item_Info>
+Fam_Memory_Service_Direct::allocate_batch(uint64_t regionId,
+                                          const std::vector<size_t> &sizes,
+                                          bool rwFlag) {
+    std::vector<Fam_Region_Item_Info> infos(sizes.size());
+    MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
+    size_t done = 0;
+    try {
+        for (; done < sizes.size(); done++) {
+            uint64_t offset = allocator->allocate(regionId, sizes[done]);
+            void *base = allocator->get_local_pointer(regionId, offset);
+            infos[done].offset = offset;
+            infos[done].base =
+                memoryRegistration->is_base_require() ? base : NULL;
+            infos[done].key = memoryRegistration->register_memory(
+                regionId, offset, base, sizes[done], rwFlag);
+        }
+    } catch (...) {
+        for (size_t i = 0; i < done; i++) {
+            try {
+                memoryRegistration->deregister_memory(regionId,
+                                                      infos[i].offset);
+                allocator->deallocate(regionId, infos[i].offset);
+            } catch (...) {
+            }
+        }
+        throw;
+    }
+    MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_allocate_batch);
+    return infos;
+}
+
+/*
+ * deallocate_batch - Deallocate several data items of a region. Every data
+ * item is attempted; the first error encountered is thrown afterwards.
+ */
+void Fam_Memory_Service_Direct::deallocate_batch(
+    uint64_t regionId, const std::vector<uint64_t> &offsets) {
+    MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
+    int error = 0;
+    std::string errorMsg;
+    for (auto offset : offsets) {
+        try {
+            allocator->deallocate(regionId, offset);
+            memoryRegistration->deregister_memory(regionId, offset);
+        } catch (Fam_Exception &e) {
+            if (!error) {
+                error = e.fam_error();
+                errorMsg = e.fam_error_msg();
+            }
+        }
+    }
+    if (error)
+        THROW_ERRNO_MSG(Memory_Service_Exception, (Fam_Error)error,
+                        errorMsg.c_str());
+    MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_deallocate_batch);
+}
+
 void *Fam_Memory_Service_Direct::get_local_pointer(uint64_t regionId,
                                                    uint64_t offset) {
     void *base;
@@ -244,7 +328,104 @@ void Fam_Memory_Service_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
                                      const char *srcAddr, uint32_t srcAddrLen,
                                      uint64_t destRegionId, uint64_t destOffset,
                                      uint64_t size, uint64_t srcMemserverId,
-                                     uint64_t destMemserverId) {
+                                     uint64_t destMemserverId,
+                                     Fam_Copy_Progress *progress) {
+    bool named = (progress && progress->copyId);
+    if (named)
+        start_copy(progress);
+    try {
+        run_copy(srcRegionId, srcOffset, srcKey, srcCopyStart, srcAddr,
+                 srcAddrLen, destRegionId, destOffset, size, srcMemserverId,
+                 destMemserverId, progress);
+    } catch (...) {
+        if (named)
+            end_copy(progress);
+        throw;
+    }
+    if (named)
+        end_copy(progress);
+
+    if (progress && progress->cancelled.load(std::memory_order_acquire) &&
+        (progress->bytesCopied.load(std::memory_order_acquire) < size)) {
+        ostringstream message;
+        message << "Copy was cancelled after "
+                << progress->bytesCopied.load(std::memory_order_acquire)
+                << " of " << size << " bytes";
+        THROW_ERRNO_MSG(Memory_Service_Exception, COPY_CANCELLED,
+                        message.str().c_str());
+    }
+}
+
+void Fam_Memory_Service_Direct::start_copy(Fam_Copy_Progress *progress) {
+    std::lock_guard<std::mutex> guard(copiesLock);
+    for (auto it = earlyCancels.begin(); it != earlyCancels.end(); ++it) {
+        if (*it == progress->copyId) {
+            progress->cancelled.store(true, std::memory_order_release);
+            earlyCancels.erase(it);
+            break;
+        }
+    }
+    runningCopies[progress->copyId] = progress;
+}
+
+void Fam_Memory_Service_Direct::end_copy(Fam_Copy_Progress *progress) {
+    std::lock_guard<std::mutex> guard(copiesLock);
+    runningCopies.erase(progress->copyId);
+    finishedCopies.push_back(std::make_pair(
+        progress->copyId,
+        progress->bytesCopied.load(std::memory_order_acquire)));
+    if (finishedCopies.size() > COPY_HISTORY_SIZE)
+        finishedCopies.pop_front();
+}
+
+uint64_t Fam_Memory_Service_Direct::copy_progress(uint64_t copyId) {
+    MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
+    uint64_t bytesCopied = 0;
+    {
+        std::lock_guard<std::mutex> guard(copiesLock);
+        auto copy = runningCopies.find(copyId);
+        if (copy != runningCopies.end()) {
+            bytesCopied =
+                copy->second->bytesCopied.load(std::memory_order_acquire);
+        } else {
+            for (auto &finished : finishedCopies)
+                if (finished.first == copyId)
+                    bytesCopied = finished.second;
+        }
+    }
+    MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_copy_progress);
+    return bytesCopied;
+}
+
+void Fam_Memory_Service_Direct::cancel_copy(uint64_t copyId) {
+    MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
+    {
+        std::lock_guard<std::mutex> guard(copiesLock);
+        auto copy = runningCopies.find(copyId);
+        if (copy != runningCopies.end()) {
+            copy->second->cancelled.store(true, std::memory_order_release);
+        } else {
+            bool finished = false;
+            for (auto &entry : finishedCopies)
+                if (entry.first == copyId)
+                    finished = true;
+            // Not started yet: cancel it when it starts
+            if (!finished) {
+                earlyCancels.push_back(copyId);
+                if (earlyCancels.size() > COPY_HISTORY_SIZE)
+                    earlyCancels.pop_front();
+            }
+        }
+    }
+    MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_cancel_copy);
+}
+
+void Fam_Memory_Service_Direct::run_copy(
+    uint64_t srcRegionId, uint64_t srcOffset, uint64_t srcKey,
+    uint64_t srcCopyStart, const char *srcAddr, uint32_t srcAddrLen,
+    uint64_t destRegionId, uint64_t destOffset, uint64_t size,
+    uint64_t srcMemserverId, uint64_t destMemserverId,
+    Fam_Copy_Progress *progress) {
     MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
     // srcOffset/destOffset - offset within the region, used only when src and
     // dest memory server are same.
@@ -253,9 +434,17 @@ void Fam_Memory_Service_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
     // to dest. It is used to read source data item from source memory server
     // using fabric_read, i.e, when src and dest memory server are different.
 
-    if (srcMemserverId == destMemserverId)
-        allocator->copy(srcRegionId, srcOffset, destRegionId, destOffset, size);
-    else {
+    if (srcMemserverId == destMemserverId) {
+        // Copy in chunks spread over the copy workers; each chunk is
+        // persisted as soon as it is copied.
+        copyEngine->run(
+            size,
+            [&](uint64_t worker, uint64_t offset, uint64_t len) {
+                allocator->copy(srcRegionId, srcOffset + offset, destRegionId,
+                                destOffset + offset, len);
+            },
+            progress);
+    } else {
         // Get memservermap
         ostringstream message;
         Fam_Ops_Libfabric *famOps =
@@ -339,16 +528,27 @@ void Fam_Memory_Service_Direct::copy(uint64_t srcRegionId, uint64_t srcOffset,
             pthread_rwlock_unlock(famOps->get_memsrvaddr_lock());
         }
 
-        // perform fabric_read (blocking) on the source data item
+        // perform fabric_read (blocking) on the source data item, in chunks
+        // spread over the copy workers and their contexts.
         // do mem copy - read directly to the destination location.
-        void *destPtr = allocator->get_local_pointer(destRegionId, destOffset);
-        if (fabric_read(srcKey, destPtr, size, srcCopyStart, srcFiAddr,
-                        famOps->get_defaultCtx(uint64_t(0))) != 0) {
-            // raise exception
-            message << "fabric_read failed: libfabric error";
-            THROW_ERRNO_MSG(Memory_Service_Exception, LIBFABRIC_ERROR,
-                            message.str().c_str());
-        }
+        char *destPtr =
+            (char *)allocator->get_local_pointer(destRegionId, destOffset);
+        copyEngine->run(
+            size,
+            [&](uint64_t worker, uint64_t offset, uint64_t len) {
+                Fam_Context *ctx = (copyEngine->get_num_workers()
+                                        ? famOps->get_copy_context(worker)
+                                        : famOps->get_defaultCtx(uint64_t(0)));
+                if (fabric_read(srcKey, destPtr + offset, len,
+                                srcCopyStart + offset, srcFiAddr, ctx) != 0) {
+                    // raise exception
+                    ostringstream message;
+                    message << "fabric_read failed: libfabric error";
+                    THROW_ERRNO_MSG(Memory_Service_Exception, LIBFABRIC_ERROR,
+                                    message.str().c_str());
+                }
+            },
+            progress);
     }
 
     MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_copy);
@@ -384,6 +584,40 @@ void Fam_Memory_Service_Direct::release_CAS_lock(uint64_t offset) {
     MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_release_CAS_lock);
 }
 
+/*
+ * Perform a 128-bit atomic operation on the value at offset within the data
+ * item (or, for interleaved data items, the extent) identified by key. The
+ * region and data item are recovered from the access key, so the operation
+ * completes in a single request instead of lock, read, write and unlock
+ * round trips from the client.
+ */
+int128_t Fam_Memory_Service_Direct::atomic_int128(uint32_t op,
+                                                  uint64_t regionId,
+                                                  uint64_t offset,
+                                                  int128_t operand,
+                                                  int128_t compare) {
+    int128_t old;
+    MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
+    ostringstream message;
+    message << "Error while performing 128-bit atomic operation : ";
+    if (op > INT128_ATOMIC_CSWAP) {
+        message << "invalid operation";
+        throw Memory_Service_Exception(UNIMPLEMENTED, message.str().c_str());
+    }
+    // CIS has checked the permission and the bounds of the data item.
+    void *value = allocator->get_local_pointer(regionId, offset);
+
+    int idx = LOCKHASH(offset);
+    pthread_mutex_lock(&casLock[idx]);
+    memcpy(&old, value, sizeof(int128_t));
+    if ((op == INT128_ATOMIC_SET) ||
+        ((op == INT128_ATOMIC_CSWAP) && (old == compare)))
+        memcpy(value, &operand, sizeof(int128_t));
+    pthread_mutex_unlock(&casLock[idx]);
+    MEMORY_SERVICE_DIRECT_PROFILE_END_OPS(mem_direct_atomic_int128);
+    return old;
+}
+
 uint64_t Fam_Memory_Service_Direct::get_key(uint64_t regionId, uint64_t offset,
                                             uint64_t size, bool rwFlag) {
     uint64_t key;
@@ -446,6 +680,14 @@ Fam_Memory_Service_Direct::get_config_info(std::string filename) {
             options["ATL_data_size"] = (char *)strdup("1073741824");
 	}
 
+        try {
+            options["ATL_payload_size"] = (char *)strdup(
+                (info->get_key_value("ATL_payload_size")).c_str());
+        } catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["ATL_payload_size"] = (char *)strdup("256");
+        }
+
 	try {
             options["fam_path"] =
                 (char *)strdup((info->get_key_value("fam_path")).c_str());
@@ -461,6 +703,30 @@ Fam_Memory_Service_Direct::get_config_info(std::string filename) {
             // If parameter is not present, then set the default.
             options["delayed_free_threads"] = (char *)strdup("0");
         }
+
+        try {
+            options["heap_open_threads"] = (char *)strdup(
+                (info->get_key_value("heap_open_threads")).c_str());
+        } catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["heap_open_threads"] = (char *)strdup("0");
+        }
+
+        try {
+            options["copy_threads"] = (char *)strdup(
+                (info->get_key_value("copy_threads")).c_str());
+        } catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["copy_threads"] = (char *)strdup("4");
+        }
+
+        try {
+            options["copy_chunk_size"] = (char *)strdup(
+                (info->get_key_value("copy_chunk_size")).c_str());
+        } catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["copy_chunk_size"] = (char *)strdup("4194304");
+        }
     }
     return options;
 }
@@ -674,7 +940,7 @@ void Fam_Memory_Service_Direct::gather_strided_atomic(
 
 void Fam_Memory_Service_Direct::scatter_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize) {
     MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
     ostringstream message;
@@ -715,7 +981,7 @@ void Fam_Memory_Service_Direct::scatter_indexed_atomic(
 
 void Fam_Memory_Service_Direct::gather_indexed_atomic(
     uint64_t regionId, uint64_t offset, uint64_t nElements,
-    const void *elementIndex, uint64_t elementSize, uint64_t key,
+    const uint64_t *elementIndex, uint64_t elementSize, uint64_t key,
     const char *nodeAddr, uint32_t nodeAddrSize) {
     MEMORY_SERVICE_DIRECT_PROFILE_START_OPS()
     ostringstream message;
@@ -30,9 +30,13 @@
 #ifndef FAM_MEMORY_SERVICE_DIRECT_H_
 #define FAM_MEMORY_SERVICE_DIRECT_H_
 
+#include <deque>
+#include <map>
+#include <mutex>
 #include <sys/types.h>
 
 #include "allocator/memserver_allocator.h"
+#include "memory_service/fam_memory_copy_engine.h"
 #include "memory_service/fam_memory_service.h"
 #include "memory_service/fam_memory_registration.h"
 #include "memory_service/fam_memory_registration_libfabric.h"
@@ -42,6 +46,8 @@ namespace openfam {
 
 #define CAS_LOCK_CNT 128
 #define LOCKHASH(offset) (offset >> 7) % CAS_LOCK_CNT
+// Number of finished copies and unmatched cancels remembered
+#define COPY_HISTORY_SIZE 1024
 
 class Fam_Memory_Service_Direct : public Fam_Memory_Service {
   public:
@@ -67,15 +73,28 @@ class Fam_Memory_Service_Direct : public Fam_Memory_Service {
 
     void deallocate(uint64_t regionId, uint64_t offset);
 
+    std::vector<Fam_Region_Item_Info>
+    allocate_batch(uint64_t regionId, const std::vector<size_t> &sizes,
+                   bool rwFlag);
+
+    void deallocate_batch(uint64_t regionId,
+                          const std::vector<uint64_t> &offsets);
+
     void copy(uint64_t srcRegionId, uint64_t srcOffset, uint64_t srcKey,
               uint64_t srcCopyStart, const char *srcAddr, uint32_t srcAddrLen,
               uint64_t destRegionId, uint64_t destOffset, uint64_t size,
-              uint64_t srcMemserverId, uint64_t destMemserverId);
+              uint64_t srcMemserverId, uint64_t destMemserverId,
+              Fam_Copy_Progress *progress = NULL);
+
+    uint64_t copy_progress(uint64_t copyId);
+    void cancel_copy(uint64_t copyId);
 
     void *get_local_pointer(uint64_t regionId, uint64_t offset);
 
     void acquire_CAS_lock(uint64_t offset);
     void release_CAS_lock(uint64_t offset);
+    int128_t atomic_int128(uint32_t op, uint64_t regionId, uint64_t offset,
+                           int128_t operand, int128_t compare);
 
     size_t get_addr_size();
     void *get_addr();
@@ -106,19 +125,38 @@ class Fam_Memory_Service_Direct : public Fam_Memory_Service {
                                uint32_t nodeAddrSize);
 
     void scatter_indexed_atomic(uint64_t regionId, uint64_t offset,
-                                uint64_t nElements, const void *elementIndex,
+                                uint64_t nElements,
+                                const uint64_t *elementIndex,
                                 uint64_t elementSize, uint64_t key,
                                 const char *nodeAddr, uint32_t nodeAddrSize);
 
     void gather_indexed_atomic(uint64_t regionId, uint64_t offset,
-                               uint64_t nElements, const void *elementIndex,
+                               uint64_t nElements, const uint64_t *elementIndex,
                                uint64_t elementSize, uint64_t key,
                                const char *nodeAddr, uint32_t nodeAddrSize);
 
   private:
+    void run_copy(uint64_t srcRegionId, uint64_t srcOffset, uint64_t srcKey,
+                  uint64_t srcCopyStart, const char *srcAddr,
+                  uint32_t srcAddrLen, uint64_t destRegionId,
+                  uint64_t destOffset, uint64_t size, uint64_t srcMemserverId,
+                  uint64_t destMemserverId, Fam_Copy_Progress *progress);
+    void start_copy(Fam_Copy_Progress *progress);
+    void end_copy(Fam_Copy_Progress *progress);
+
     Memserver_Allocator *allocator;
     pthread_mutex_t casLock[CAS_LOCK_CNT];
     Fam_Memory_Registration *memoryRegistration;
+    Fam_Memory_Copy_Engine *copyEngine;
+    /*
+     * Named copies running on this memory server, the bytes copied by the
+     * last ones which finished, and the cancels which found no copy running;
+     * a cancel may overtake its copy.
+     */
+    std::mutex copiesLock;
+    std::map<uint64_t, Fam_Copy_Progress *> runningCopies;
+    std::deque<std::pair<uint64_t, uint64_t> > finishedCopies;
+    std::deque<uint64_t> earlyCancels;
 };
 
 } // namespace openfam
@@ -90,24 +90,44 @@ Fam_Memory_Service_Server::Fam_Memory_Service_Server(uint64_t rpcPort,
                                                   libfabricProvider, fam_path);
 }
 
-void Fam_Memory_Service_Server::run() {
+void Fam_Memory_Service_Server::run(const Fam_Async_Rpc_Options &rpcOptions) {
     //    memoryService->init_atomic_queue();
     char address[ADDR_SIZE + sizeof(uint64_t)];
     sprintf(address, "%s:%lu", serverAddress, port);
     std::string serverAddress(address);
 
-    ::grpc::ServerBuilder builder;
-    // Listen on the given address without any authentication mechanism.
-    builder.AddListeningPort(serverAddress, grpc::InsecureServerCredentials());
-    // Register "service" as the instance through which we'll communicate
-    // with clients. In this case it corresponds to an *synchronous*
-    // service.
-    builder.RegisterService(this);
-
-    // Finally assemble the server.
-    server = builder.BuildAndStart();
-
-    server->Wait();
+    // Every method is served from the completion queues; region management
+    // and copies run on their worker pools so they do not delay the short
+    // ones.
+    typedef Fam_Memory_Service_Server S;
+    Fam_Async_Rpc_Server<S> rpcServer(this, rpcOptions);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, create_region, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, destroy_region, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, resize_region, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, allocate, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, deallocate, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, allocate_batch, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, deallocate_batch, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, copy, FAM_RPC_COPY);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, copy_progress, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, cancel_copy, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, acquire_CAS_lock, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, release_CAS_lock, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, atomic_int128, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, reset_profile, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, dump_profile, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, signal_start, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, signal_termination, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, get_local_pointer, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, get_key, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, get_atomic, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, put_atomic, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, scatter_strided_atomic, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, gather_strided_atomic, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, scatter_indexed_atomic, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, gather_indexed_atomic, FAM_RPC_INLINE);
+
+    rpcServer.run(serverAddress);
 }
 
 Fam_Memory_Service_Server::~Fam_Memory_Service_Server() {
@@ -265,29 +285,119 @@ Fam_Memory_Service_Server::allocate(::grpc::ServerContext *context,
     return ::grpc::Status::OK;
 }
 
+::grpc::Status Fam_Memory_Service_Server::allocate_batch(
+    ::grpc::ServerContext *context, const ::Fam_Memory_Batch_Request *request,
+    ::Fam_Memory_Batch_Response *response) {
+    MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    std::vector<Fam_Region_Item_Info> infos;
+    std::vector<size_t> sizes(request->sizes().begin(),
+                              request->sizes().end());
+    try {
+        infos = memoryService->allocate_batch(request->region_id(), sizes,
+                                              request->rw_flag());
+    } catch (Memory_Service_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    for (auto &info : infos) {
+        response->add_offsets(info.offset);
+        response->add_keys(info.key);
+        response->add_bases((uint64_t)info.base);
+    }
+
+    MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_allocate_batch);
+
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status Fam_Memory_Service_Server::deallocate_batch(
+    ::grpc::ServerContext *context, const ::Fam_Memory_Batch_Request *request,
+    ::Fam_Memory_Batch_Response *response) {
+    MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    std::vector<uint64_t> offsets(request->offsets().begin(),
+                                  request->offsets().end());
+    try {
+        memoryService->deallocate_batch(request->region_id(), offsets);
+    } catch (Memory_Service_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_deallocate_batch);
+
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status
 Fam_Memory_Service_Server::copy(::grpc::ServerContext *context,
                                 const ::Fam_Memory_Copy_Request *request,
                                 ::Fam_Memory_Copy_Response *response) {
     MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    Fam_Copy_Progress progress;
+    progress.bytesCopied.store(0);
+    progress.cancelled.store(false);
+    progress.copyId = request->copy_id();
     try {
         memoryService->copy(
             request->src_region_id(), request->src_offset(), request->src_key(),
             request->src_copy_start(), request->src_addr().c_str(),
             request->src_addr_len(), request->dest_region_id(),
             request->dest_offset(), request->size(),
-            request->src_memserver_id(), request->dest_memserver_id());
+            request->src_memserver_id(), request->dest_memserver_id(),
+            &progress);
     } catch (Memory_Service_Exception &e) {
         response->set_errorcode(e.fam_error());
         response->set_errormsg(e.fam_error_msg());
+        response->set_bytes_copied(progress.bytesCopied.load());
         return ::grpc::Status::OK;
     }
+    response->set_bytes_copied(progress.bytesCopied.load());
 
     MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_copy);
     // Return status OK
     return ::grpc::Status::OK;
 }
 
+::grpc::Status Fam_Memory_Service_Server::copy_progress(
+    ::grpc::ServerContext *context,
+    const ::Fam_Memory_Copy_Control_Request *request,
+    ::Fam_Memory_Copy_Control_Response *response) {
+    MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    try {
+        response->set_bytes_copied(
+            memoryService->copy_progress(request->copy_id()));
+    } catch (Memory_Service_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_copy_progress);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status Fam_Memory_Service_Server::cancel_copy(
+    ::grpc::ServerContext *context,
+    const ::Fam_Memory_Copy_Control_Request *request,
+    ::Fam_Memory_Copy_Control_Response *response) {
+    MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    try {
+        memoryService->cancel_copy(request->copy_id());
+    } catch (Memory_Service_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+
+    MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_cancel_copy);
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status Fam_Memory_Service_Server::acquire_CAS_lock(
     ::grpc::ServerContext *context, const ::Fam_Memory_Service_Request *request,
     ::Fam_Memory_Service_Response *response) {
@@ -320,6 +430,30 @@ Fam_Memory_Service_Server::copy(::grpc::ServerContext *context,
     return ::grpc::Status::OK;
 }
 
+::grpc::Status Fam_Memory_Service_Server::atomic_int128(
+    ::grpc::ServerContext *context,
+    const ::Fam_Memory_Int128_Atomic_Request *request,
+    ::Fam_Memory_Int128_Atomic_Response *response) {
+    MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
+    uint64_t lo = 0, hi = 0;
+    try {
+        int128_t old = memoryService->atomic_int128(
+            request->op(), request->regionid(), request->offset(),
+            words_to_int128(request->operand_lo(), request->operand_hi()),
+            words_to_int128(request->compare_lo(), request->compare_hi()));
+        int128_to_words(old, &lo, &hi);
+    } catch (Memory_Service_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    response->set_result_lo(lo);
+    response->set_result_hi(hi);
+    MEMORY_SERVICE_SERVER_PROFILE_END_OPS(mem_server_atomic_int128);
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status Fam_Memory_Service_Server::get_local_pointer(
     ::grpc::ServerContext *context, const ::Fam_Memory_Service_Request *request,
     ::Fam_Memory_Service_Response *response) {
@@ -443,9 +577,15 @@ Fam_Memory_Service_Server::get_key(::grpc::ServerContext *context,
     ::Fam_Memory_Atomic_Response *response) {
     MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
     try {
+        std::vector<uint64_t> elementIndex;
+        if (!decode_index_array(request->elementindex(),
+                                request->indexencoding(), request->nelements(),
+                                &elementIndex))
+            THROW_ERRNO_MSG(Memory_Service_Exception, OUT_OF_RANGE,
+                            "Invalid element index array");
         memoryService->scatter_indexed_atomic(
             request->regionid(), request->offset(), request->nelements(),
-            request->elementindex().c_str(), request->elementsize(),
+            elementIndex.data(), request->elementsize(),
             request->key(), request->nodeaddr().c_str(),
             request->nodeaddrsize());
     } catch (Memory_Service_Exception &e) {
@@ -463,9 +603,15 @@ Fam_Memory_Service_Server::get_key(::grpc::ServerContext *context,
     ::Fam_Memory_Atomic_Response *response) {
     MEMORY_SERVICE_SERVER_PROFILE_START_OPS()
     try {
+        std::vector<uint64_t> elementIndex;
+        if (!decode_index_array(request->elementindex(),
+                                request->indexencoding(), request->nelements(),
+                                &elementIndex))
+            THROW_ERRNO_MSG(Memory_Service_Exception, OUT_OF_RANGE,
+                            "Invalid element index array");
         memoryService->gather_indexed_atomic(
             request->regionid(), request->offset(), request->nelements(),
-            request->elementindex().c_str(), request->elementsize(),
+            elementIndex.data(), request->elementsize(),
             request->key(), request->nodeaddr().c_str(),
             request->nodeaddrsize());
     } catch (Memory_Service_Exception &e) {
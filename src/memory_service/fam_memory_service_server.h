@@ -39,6 +39,7 @@
 
 #include "grpcpp/grpcpp.h"
 
+#include "common/fam_async_rpc_server.h"
 #include "memory_service/fam_memory_service_direct.h"
 #include "memory_service/fam_memory_service_rpc.grpc.pb.h"
 
@@ -55,14 +56,15 @@ using grpc::ServerCompletionQueue;
 using grpc::ServerContext;
 using grpc::Status;
 
-class Fam_Memory_Service_Server : public Fam_Memory_Service_Rpc::Service {
+class Fam_Memory_Service_Server
+    : public Fam_Memory_Service_Rpc::AsyncService {
   public:
     Fam_Memory_Service_Server(uint64_t rpcPort, char *name, char *libfabricPort,
                               char *libfabricProvider, char *fam_path);
 
     ~Fam_Memory_Service_Server();
 
-    void run();
+    void run(const Fam_Async_Rpc_Options &rpcOptions);
 
     void reset_profile();
 
@@ -110,10 +112,30 @@ class Fam_Memory_Service_Server : public Fam_Memory_Service_Rpc::Service {
                               const ::Fam_Memory_Service_Request *request,
                               ::Fam_Memory_Service_Response *response) override;
 
+    ::grpc::Status
+    allocate_batch(::grpc::ServerContext *context,
+                   const ::Fam_Memory_Batch_Request *request,
+                   ::Fam_Memory_Batch_Response *response) override;
+
+    ::grpc::Status
+    deallocate_batch(::grpc::ServerContext *context,
+                     const ::Fam_Memory_Batch_Request *request,
+                     ::Fam_Memory_Batch_Response *response) override;
+
     ::grpc::Status copy(::grpc::ServerContext *context,
                         const ::Fam_Memory_Copy_Request *request,
                         ::Fam_Memory_Copy_Response *response) override;
 
+    ::grpc::Status
+    copy_progress(::grpc::ServerContext *context,
+                  const ::Fam_Memory_Copy_Control_Request *request,
+                  ::Fam_Memory_Copy_Control_Response *response) override;
+
+    ::grpc::Status
+    cancel_copy(::grpc::ServerContext *context,
+                const ::Fam_Memory_Copy_Control_Request *request,
+                ::Fam_Memory_Copy_Control_Response *response) override;
+
     ::grpc::Status
     acquire_CAS_lock(::grpc::ServerContext *context,
                      const ::Fam_Memory_Service_Request *request,
@@ -124,6 +146,11 @@ class Fam_Memory_Service_Server : public Fam_Memory_Service_Rpc::Service {
                      const ::Fam_Memory_Service_Request *request,
                      ::Fam_Memory_Service_Response *response) override;
 
+    ::grpc::Status
+    atomic_int128(::grpc::ServerContext *context,
+                  const ::Fam_Memory_Int128_Atomic_Request *request,
+                  ::Fam_Memory_Int128_Atomic_Response *response) override;
+
     ::grpc::Status
     get_local_pointer(::grpc::ServerContext *context,
                       const ::Fam_Memory_Service_Request *request,
@@ -166,7 +193,6 @@ class Fam_Memory_Service_Server : public Fam_Memory_Service_Rpc::Service {
     uint64_t port;
     int numClients;
     Fam_Memory_Service_Rpc::Service *service;
-    std::unique_ptr<Server> server;
     Fam_Memory_Service_Direct *memoryService;
 };
 
@@ -0,0 +1,253 @@
+/*
+ *   fam_metadata_record.h
+ *   Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ * rights reserved. Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef FAM_METADATA_RECORD_H
+#define FAM_METADATA_RECORD_H
+
+#include <sstream>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/fam_internal_exception.h"
+#include "metadata_service/fam_metadata_service.h"
+
+using namespace openfam;
+
+namespace metadata {
+
+/*
+ * Region and dataitem descriptors are stored in a versioned, variable length
+ * binary record instead of a raw copy of the structure : the name is stored
+ * with its length and only the used_memsrv_cnt entries of the memory server
+ * (and offset) arrays are stored. Records are decoded straight from the KVS
+ * value buffer into the caller's descriptor.
+ *
+ * Version 2 appends the placement policy to region records; version 1
+ * records are still read, with the default placement policy.
+ */
+#define METADATA_RECORD_VERSION 2
+#define METADATA_RECORD_MIN_VERSION 1
+
+class Metadata_Record_Writer {
+  public:
+    Metadata_Record_Writer(char *buf) : buf(buf), pos(0) {}
+
+    template <typename T> void put(const T &val) {
+        memcpy(buf + pos, &val, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    void put(const uint64_t *vals, uint64_t cnt) {
+        memcpy(buf + pos, vals, cnt * sizeof(uint64_t));
+        pos += cnt * sizeof(uint64_t);
+    }
+
+    void put_name(const char *name, size_t maxLen) {
+        uint16_t len = (uint16_t)strnlen(name, maxLen);
+        put(len);
+        memcpy(buf + pos, name, len);
+        pos += len;
+    }
+
+    size_t size() { return pos; }
+
+  private:
+    char *buf;
+    size_t pos;
+};
+
+class Metadata_Record_Reader {
+  public:
+    Metadata_Record_Reader(const char *buf, size_t len)
+        : buf(buf), len(len), pos(0) {}
+
+    template <typename T> void get(T &val) {
+        check(sizeof(T));
+        memcpy(&val, buf + pos, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    void get(uint64_t *vals, uint64_t cnt, uint64_t maxCnt) {
+        if (cnt > maxCnt)
+            corrupted();
+        check(cnt * sizeof(uint64_t));
+        memcpy(vals, buf + pos, cnt * sizeof(uint64_t));
+        pos += cnt * sizeof(uint64_t);
+    }
+
+    void get_name(char *name, size_t maxLen) {
+        uint16_t nameLen;
+        get(nameLen);
+        if (nameLen > maxLen)
+            corrupted();
+        check(nameLen);
+        memcpy(name, buf + pos, nameLen);
+        memset(name + nameLen, 0, maxLen - nameLen);
+        pos += nameLen;
+    }
+
+  private:
+    void check(size_t n) {
+        if (pos + n > len)
+            corrupted();
+    }
+
+    void corrupted() {
+        ostringstream message;
+        message << "Metadata record is corrupted";
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        message.str().c_str());
+    }
+
+    const char *buf;
+    size_t len;
+    size_t pos;
+};
+
+inline void check_record_version(uint8_t version) {
+    ostringstream message;
+    if (version < METADATA_RECORD_MIN_VERSION ||
+        version > METADATA_RECORD_VERSION) {
+        message << "Unsupported metadata record version "
+                << (uint32_t)version;
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        message.str().c_str());
+    }
+}
+
+/*
+ * encode_region - Serialize a region descriptor into buf, which must be at
+ * least 4 KB. Returns the length of the record.
+ */
+inline size_t encode_region(const Fam_Region_Metadata *region, char *buf) {
+    ostringstream message;
+    if (region->used_memsrv_cnt > MAX_MEMORY_SERVERS_CNT) {
+        message << "Invalid memory server count in region metadata";
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        message.str().c_str());
+    }
+    Metadata_Record_Writer record(buf);
+    record.put((uint8_t)METADATA_RECORD_VERSION);
+    record.put(region->regionId);
+    record.put(region->offset);
+    record.put(region->uid);
+    record.put(region->gid);
+    record.put(region->perm);
+    record.put(region->size);
+    record.put(region->isHeapCreated);
+    record.put(region->dataItemIdRoot);
+    record.put(region->dataItemNameRoot);
+    record.put_name(region->name, sizeof(region->name));
+    record.put(region->used_memsrv_cnt);
+    record.put(region->memServerIds, region->used_memsrv_cnt);
+    record.put(region->placementPolicy);
+    return record.size();
+}
+
+inline void decode_region(const char *buf, size_t len,
+                          Fam_Region_Metadata &region) {
+    Metadata_Record_Reader record(buf, len);
+    uint8_t version;
+    record.get(version);
+    check_record_version(version);
+    record.get(region.regionId);
+    record.get(region.offset);
+    record.get(region.uid);
+    record.get(region.gid);
+    record.get(region.perm);
+    record.get(region.size);
+    record.get(region.isHeapCreated);
+    record.get(region.dataItemIdRoot);
+    record.get(region.dataItemNameRoot);
+    record.get_name(region.name, sizeof(region.name));
+    record.get(region.used_memsrv_cnt);
+    record.get(region.memServerIds, region.used_memsrv_cnt,
+               MAX_MEMORY_SERVERS_CNT);
+    region.placementPolicy = META_PLACEMENT_DEFAULT;
+    if (version >= 2)
+        record.get(region.placementPolicy);
+}
+
+/*
+ * encode_dataitem - Serialize a dataitem descriptor into buf, which must be
+ * at least 4 KB. Returns the length of the record.
+ */
+inline size_t encode_dataitem(const Fam_DataItem_Metadata *dataitem,
+                              char *buf) {
+    ostringstream message;
+    if (dataitem->used_memsrv_cnt > MAX_INTERLEAVE_MEMSERVERS_CNT) {
+        message << "Invalid memory server count in dataitem metadata";
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        message.str().c_str());
+    }
+    Metadata_Record_Writer record(buf);
+    record.put((uint8_t)METADATA_RECORD_VERSION);
+    record.put(dataitem->regionId);
+    record.put(dataitem->offset);
+    record.put(dataitem->uid);
+    record.put(dataitem->gid);
+    record.put(dataitem->perm);
+    record.put(dataitem->size);
+    record.put(dataitem->memoryServerId);
+    record.put(dataitem->interleaveSize);
+    record.put_name(dataitem->name, sizeof(dataitem->name));
+    record.put(dataitem->used_memsrv_cnt);
+    record.put(dataitem->memServerIds, dataitem->used_memsrv_cnt);
+    record.put(dataitem->offsets, dataitem->used_memsrv_cnt);
+    return record.size();
+}
+
+inline void decode_dataitem(const char *buf, size_t len,
+                            Fam_DataItem_Metadata &dataitem) {
+    Metadata_Record_Reader record(buf, len);
+    uint8_t version;
+    record.get(version);
+    check_record_version(version);
+    record.get(dataitem.regionId);
+    record.get(dataitem.offset);
+    record.get(dataitem.uid);
+    record.get(dataitem.gid);
+    record.get(dataitem.perm);
+    record.get(dataitem.size);
+    record.get(dataitem.memoryServerId);
+    record.get(dataitem.interleaveSize);
+    record.get_name(dataitem.name, sizeof(dataitem.name));
+    record.get(dataitem.used_memsrv_cnt);
+    record.get(dataitem.memServerIds, dataitem.used_memsrv_cnt,
+               MAX_INTERLEAVE_MEMSERVERS_CNT);
+    record.get(dataitem.offsets, dataitem.used_memsrv_cnt,
+               MAX_INTERLEAVE_MEMSERVERS_CNT);
+}
+
+} // namespace metadata
+#endif
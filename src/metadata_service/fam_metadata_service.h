@@ -108,6 +108,9 @@ typedef struct {
     //   Fam_Redundancy_Level redundancyLevel;
     GlobalPtr dataItemIdRoot;
     GlobalPtr dataItemNameRoot;
+    // Placement policy of the data items of the region
+    // (metadata_placement_policy_t, META_PLACEMENT_DEFAULT : configured one)
+    uint32_t placementPolicy;
 } Fam_Region_Metadata;
 
 /**
@@ -126,6 +129,15 @@ typedef struct {
     char name[RadixTree::MAX_KEY_LEN];
     uint64_t size;
     uint64_t memoryServerId;
+    /*
+     * Interleaved data items : stripe size (0 if not interleaved) and the
+     * memory servers and offsets holding the stripes, in stripe order.
+     * memServerIds[0]/offsets[0] are the same as memoryServerId/offset.
+     */
+    uint64_t interleaveSize;
+    uint64_t used_memsrv_cnt;
+    uint64_t memServerIds[MAX_INTERLEAVE_MEMSERVERS_CNT];
+    uint64_t offsets[MAX_INTERLEAVE_MEMSERVERS_CNT];
 } Fam_DataItem_Metadata;
 
 typedef enum metadata_region_item_op {
@@ -140,6 +152,23 @@ typedef enum metadata_region_item_op {
 
 } metadata_region_item_op_t;
 
+/*
+ * Placement policies for regions and dataitems, passed as user_policy to
+ * metadata_validate_and_create_region. META_PLACEMENT_DEFAULT selects the
+ * policy configured in fam_metadata_config.yaml.
+ */
+typedef enum metadata_placement_policy {
+    META_PLACEMENT_DEFAULT = 0,
+    // Hash of the name (data items without a name : random)
+    META_PLACEMENT_HASH,
+    // Memory servers with the least bytes reserved / data items allocated
+    META_PLACEMENT_LEAST_LOADED,
+    // Random, weighted by the free capacity of each memory server
+    META_PLACEMENT_CAPACITY_WEIGHTED,
+    // Less loaded of two memory servers chosen at random
+    META_PLACEMENT_TWO_CHOICES
+} metadata_placement_policy_t;
+
 enum metadata_ErrorVal {
     META_NO_PERMISSION = -6,
     META_LARGE_NAME = -5,
@@ -221,11 +250,12 @@ class Fam_Metadata_Service {
                                           const std::string regionName,
                                           Fam_DataItem_Metadata *dataitem) = 0;
 
-    virtual bool metadata_check_permissions(Fam_DataItem_Metadata *dataitem,
-                                            metadata_region_item_op_t op,
-                                            uint32_t uid, uint32_t gid) = 0;
+    virtual bool
+    metadata_check_permissions(const Fam_DataItem_Metadata *dataitem,
+                               metadata_region_item_op_t op, uint32_t uid,
+                               uint32_t gid) = 0;
 
-    virtual bool metadata_check_permissions(Fam_Region_Metadata *region,
+    virtual bool metadata_check_permissions(const Fam_Region_Metadata *region,
                                             metadata_region_item_op_t op,
                                             uint32_t uid, uint32_t gid) = 0;
     virtual void
@@ -243,10 +273,9 @@ class Fam_Metadata_Service {
         const std::string dataitemName, const uint64_t regionId, uint32_t uid,
         uint32_t gid, uint64_t *memoryServerId) = 0;
 
-    virtual void
-    metadata_validate_and_deallocate_dataitem(const uint64_t regionId,
-                                              const uint64_t dataitemId,
-                                              uint32_t uid, uint32_t gid) = 0;
+    virtual void metadata_validate_and_deallocate_dataitem(
+        const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
+        uint32_t gid, Fam_DataItem_Metadata &dataitem) = 0;
 
     virtual size_t metadata_maxkeylen() = 0;
     virtual void metadata_find_region_and_check_permissions(
@@ -267,6 +296,25 @@ class Fam_Metadata_Service {
         const std::string regionName, uint32_t uid, uint32_t gid,
         Fam_DataItem_Metadata &dataitem) = 0;
 
+    virtual void metadata_validate_and_allocate_dataitem_batch(
+        const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+        uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds) = 0;
+
+    virtual void metadata_insert_dataitem_batch(
+        const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+        std::vector<Fam_DataItem_Metadata> &dataitems) = 0;
+
+    virtual void metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) = 0;
+
+    virtual void metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) = 0;
+
     virtual std::list<int> get_memory_server_list(uint64_t regionId) = 0;
 };
 
@@ -33,6 +33,8 @@
 
 #include "fam_metadata_service_client.h"
 #include "common/fam_memserver_profile.h"
+
+#include <algorithm>
 using namespace openfam;
 
 namespace metadata {
@@ -69,6 +71,33 @@ void metadata_client_profile_dump() {
     MEMSERVER_DUMP_PROFILE_SUMMARY(METADATA_CLIENT)
 }
 
+/*
+ * Copy the interleave layout of a dataitem to the request message.
+ */
+static void set_interleave_info(Fam_Metadata_Request &req,
+                                Fam_DataItem_Metadata *dataitem) {
+    req.set_interleave_size(dataitem->interleaveSize);
+    for (uint64_t i = 0; i < dataitem->used_memsrv_cnt; i++) {
+        req.add_memsrv_list(dataitem->memServerIds[i]);
+        req.add_offset_list(dataitem->offsets[i]);
+    }
+}
+
+/*
+ * Copy the interleave layout of a dataitem from the response message.
+ */
+static void get_interleave_info(Fam_Metadata_Response &res,
+                                Fam_DataItem_Metadata &dataitem) {
+    int cnt = std::min(res.memsrv_list_size(), res.offset_list_size());
+    cnt = std::min(cnt, MAX_INTERLEAVE_MEMSERVERS_CNT);
+    dataitem.interleaveSize = res.interleave_size();
+    dataitem.used_memsrv_cnt = (uint64_t)cnt;
+    for (int i = 0; i < cnt; i++) {
+        dataitem.memServerIds[i] = res.memsrv_list(i);
+        dataitem.offsets[i] = res.offset_list(i);
+    }
+}
+
 Fam_Metadata_Service_Client::Fam_Metadata_Service_Client(const char *name,
                                                          uint64_t port) {
     MEMSERVER_PROFILE_INIT(METADATA_CLIENT)
@@ -151,6 +180,7 @@ void Fam_Metadata_Service_Client::metadata_insert_region(
     req.set_uid(region->uid);
     req.set_gid(region->gid);
     req.set_memsrv_cnt(region->used_memsrv_cnt);
+    req.set_user_policy(region->placementPolicy);
     for (int i = 0; i < (int)region->used_memsrv_cnt; i++) {
         req.add_memsrv_list(region->memServerIds[i]);
     }
@@ -208,6 +238,7 @@ bool Fam_Metadata_Service_Client::metadata_find_region(
         region.uid = res.uid();
         region.gid = res.gid();
         region.used_memsrv_cnt = res.memsrv_cnt();
+        region.placementPolicy = res.user_policy();
         for (int i = 0; i < (int)region.used_memsrv_cnt; i++) {
             region.memServerIds[i] = res.memsrv_list(i);
         }
@@ -236,6 +267,7 @@ bool Fam_Metadata_Service_Client::metadata_find_region(
         region.uid = res.uid();
         region.gid = res.gid();
         region.used_memsrv_cnt = res.memsrv_cnt();
+        region.placementPolicy = res.user_policy();
         for (int i = 0; i < (int)region.used_memsrv_cnt; i++) {
             region.memServerIds[i] = res.memsrv_list(i);
         }
@@ -260,6 +292,7 @@ void Fam_Metadata_Service_Client::metadata_modify_region(
     req.set_uid(region->uid);
     req.set_gid(region->gid);
     req.set_memsrv_cnt(region->used_memsrv_cnt);
+    req.set_user_policy(region->placementPolicy);
     for (int i = 0; i < (int)region->used_memsrv_cnt; i++) {
         req.add_memsrv_list(region->memServerIds[i]);
     }
@@ -284,6 +317,7 @@ void Fam_Metadata_Service_Client::metadata_modify_region(
     req.set_uid(region->uid);
     req.set_gid(region->gid);
     req.set_memsrv_cnt(region->used_memsrv_cnt);
+    req.set_user_policy(region->placementPolicy);
     for (int i = 0; i < (int)region->used_memsrv_cnt; i++) {
         req.add_memsrv_list(region->memServerIds[i]);
     }
@@ -312,6 +346,7 @@ void Fam_Metadata_Service_Client::metadata_insert_dataitem(
     req.set_uid(dataitem->uid);
     req.set_gid(dataitem->gid);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_insert_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -337,6 +372,7 @@ void Fam_Metadata_Service_Client::metadata_insert_dataitem(
     req.set_uid(dataitem->uid);
     req.set_gid(dataitem->gid);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_insert_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -425,6 +461,7 @@ bool Fam_Metadata_Service_Client::metadata_find_dataitem(
         dataitem.uid = res.uid();
         dataitem.gid = res.gid();
         dataitem.memoryServerId = res.memsrv_id();
+        get_interleave_info(res, dataitem);
     }
     METADATA_CLIENT_PROFILE_END_OPS(client_metadata_find_dataitem);
     return res.isfound();
@@ -452,6 +489,7 @@ bool Fam_Metadata_Service_Client::metadata_find_dataitem(
         dataitem.uid = res.uid();
         dataitem.gid = res.gid();
         dataitem.memoryServerId = res.memsrv_id();
+        get_interleave_info(res, dataitem);
     }
     METADATA_CLIENT_PROFILE_END_OPS(client_metadata_find_dataitem);
     return res.isfound();
@@ -479,6 +517,7 @@ bool Fam_Metadata_Service_Client::metadata_find_dataitem(
         dataitem.uid = res.uid();
         dataitem.gid = res.gid();
         dataitem.memoryServerId = res.memsrv_id();
+        get_interleave_info(res, dataitem);
     }
     METADATA_CLIENT_PROFILE_END_OPS(client_metadata_find_dataitem);
     return res.isfound();
@@ -506,6 +545,7 @@ bool Fam_Metadata_Service_Client::metadata_find_dataitem(
         dataitem.uid = res.uid();
         dataitem.gid = res.gid();
         dataitem.memoryServerId = res.memsrv_id();
+        get_interleave_info(res, dataitem);
     }
     METADATA_CLIENT_PROFILE_END_OPS(client_metadata_find_dataitem);
     return res.isfound();
@@ -529,6 +569,7 @@ void Fam_Metadata_Service_Client::metadata_modify_dataitem(
     req.set_size(dataitem->size);
     req.set_perm(dataitem->perm);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_modify_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -553,6 +594,7 @@ void Fam_Metadata_Service_Client::metadata_modify_dataitem(
     req.set_size(dataitem->size);
     req.set_perm(dataitem->perm);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_modify_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -577,6 +619,7 @@ void Fam_Metadata_Service_Client::metadata_modify_dataitem(
     req.set_size(dataitem->size);
     req.set_perm(dataitem->perm);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_modify_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -601,6 +644,7 @@ void Fam_Metadata_Service_Client::metadata_modify_dataitem(
     req.set_size(dataitem->size);
     req.set_perm(dataitem->perm);
     req.set_memsrv_id(dataitem->memoryServerId);
+    set_interleave_info(req, dataitem);
 
     ::grpc::Status status = stub->metadata_modify_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
@@ -608,8 +652,8 @@ void Fam_Metadata_Service_Client::metadata_modify_dataitem(
 }
 
 bool Fam_Metadata_Service_Client::metadata_check_permissions(
-    Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
     Fam_Permission_Request req;
     Fam_Permission_Response res;
     ::grpc::ClientContext ctx;
@@ -629,8 +673,8 @@ bool Fam_Metadata_Service_Client::metadata_check_permissions(
 }
 
 bool Fam_Metadata_Service_Client::metadata_check_permissions(
-    Fam_Region_Metadata *region, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_Region_Metadata *region, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
     Fam_Permission_Request req;
     Fam_Permission_Response res;
     ::grpc::ClientContext ctx;
@@ -758,6 +802,7 @@ void Fam_Metadata_Service_Client::metadata_find_region_and_check_permissions(
     region.uid = res.uid();
     region.gid = res.gid();
     region.used_memsrv_cnt = res.memsrv_cnt();
+    region.placementPolicy = res.user_policy();
     for (int i = 0; i < (int)region.used_memsrv_cnt; i++) {
         region.memServerIds[i] = res.memsrv_list(i);
     }
@@ -789,6 +834,7 @@ void Fam_Metadata_Service_Client::metadata_find_region_and_check_permissions(
     region.uid = res.uid();
     region.gid = res.gid();
     region.used_memsrv_cnt = res.memsrv_cnt();
+    region.placementPolicy = res.user_policy();
     for (int i = 0; i < (int)region.used_memsrv_cnt; i++) {
         region.memServerIds[i] = res.memsrv_list(i);
     }
@@ -822,6 +868,7 @@ void Fam_Metadata_Service_Client::metadata_find_dataitem_and_check_permissions(
     dataitem.uid = res.uid();
     dataitem.gid = res.gid();
     dataitem.memoryServerId = res.memsrv_id();
+    get_interleave_info(res, dataitem);
     METADATA_CLIENT_PROFILE_END_OPS(
         client_metadata_find_dataitem_and_check_permissions);
 }
@@ -851,6 +898,7 @@ void Fam_Metadata_Service_Client::metadata_find_dataitem_and_check_permissions(
     dataitem.uid = res.uid();
     dataitem.gid = res.gid();
     dataitem.memoryServerId = res.memsrv_id();
+    get_interleave_info(res, dataitem);
     METADATA_CLIENT_PROFILE_END_OPS(
         client_metadata_find_dataitem_and_check_permissions);
 }
@@ -878,7 +926,7 @@ void Fam_Metadata_Service_Client::metadata_validate_and_allocate_dataitem(
 
 void Fam_Metadata_Service_Client::metadata_validate_and_deallocate_dataitem(
     const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
-    uint32_t gid) {
+    uint32_t gid, Fam_DataItem_Metadata &dataitem) {
 
     METADATA_CLIENT_PROFILE_START_OPS()
     Fam_Metadata_Request req;
@@ -892,10 +940,154 @@ void Fam_Metadata_Service_Client::metadata_validate_and_deallocate_dataitem(
     ::grpc::Status status =
         stub->metadata_validate_and_deallocate_dataitem(&ctx, req, &res);
     STATUS_CHECK(Metadata_Service_Exception)
+    dataitem.regionId = res.region_id();
+    dataitem.offset = res.offset();
+    dataitem.size = res.size();
+    dataitem.memoryServerId = res.memsrv_id();
+    get_interleave_info(res, dataitem);
     METADATA_CLIENT_PROFILE_END_OPS(
         client_metadata_validate_and_deallocate_dataitem);
 }
 
+void Fam_Metadata_Service_Client::metadata_validate_and_allocate_dataitem_batch(
+    const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+    uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds) {
+    METADATA_CLIENT_PROFILE_START_OPS()
+    Fam_Metadata_Batch_Request req;
+    Fam_Metadata_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_region_id(regionId);
+    req.set_uid(uid);
+    req.set_gid(gid);
+    for (auto &name : dataitemNames)
+        req.add_items()->set_key_dataitem_name(name);
+
+    ::grpc::Status status =
+        stub->metadata_validate_and_allocate_dataitem_batch(&ctx, req, &res);
+    STATUS_CHECK(Metadata_Service_Exception)
+    if ((size_t)res.items_size() != dataitemNames.size()) {
+        throw Metadata_Service_Exception(FAM_ERR_RPC,
+                                         "Incomplete batch response");
+    }
+    memoryServerIds.resize(dataitemNames.size());
+    for (int i = 0; i < res.items_size(); i++)
+        memoryServerIds[i] = res.items(i).memsrv_id();
+    METADATA_CLIENT_PROFILE_END_OPS(
+        client_metadata_validate_and_allocate_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Client::metadata_insert_dataitem_batch(
+    const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+    std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_CLIENT_PROFILE_START_OPS()
+    Fam_Metadata_Batch_Request req;
+    Fam_Metadata_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_region_id(regionId);
+    for (size_t i = 0; i < dataitemIds.size(); i++) {
+        Fam_Metadata_Request *item = req.add_items();
+        Fam_DataItem_Metadata *dataitem = &dataitems[i];
+        item->set_key_region_id(regionId);
+        item->set_key_dataitem_id(dataitemIds[i]);
+        item->set_key_dataitem_name(dataitem->name);
+        item->set_region_id(regionId);
+        item->set_name(dataitem->name);
+        item->set_offset(dataitem->offset);
+        item->set_size(dataitem->size);
+        item->set_perm(dataitem->perm);
+        item->set_uid(dataitem->uid);
+        item->set_gid(dataitem->gid);
+        item->set_memsrv_id(dataitem->memoryServerId);
+        set_interleave_info(*item, dataitem);
+    }
+
+    ::grpc::Status status =
+        stub->metadata_insert_dataitem_batch(&ctx, req, &res);
+    STATUS_CHECK(Metadata_Service_Exception)
+    METADATA_CLIENT_PROFILE_END_OPS(client_metadata_insert_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Client::
+    metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_CLIENT_PROFILE_START_OPS()
+    Fam_Metadata_Batch_Request req;
+    Fam_Metadata_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_region_id(regionId);
+    req.set_uid(uid);
+    req.set_gid(gid);
+    for (auto dataitemId : dataitemIds)
+        req.add_items()->set_key_dataitem_id(dataitemId);
+
+    ::grpc::Status status =
+        stub->metadata_validate_and_deallocate_dataitem_batch(&ctx, req, &res);
+    STATUS_CHECK(Metadata_Service_Exception)
+    if ((size_t)res.items_size() != dataitemIds.size()) {
+        throw Metadata_Service_Exception(FAM_ERR_RPC,
+                                         "Incomplete batch response");
+    }
+    dataitems.resize(dataitemIds.size());
+    for (int i = 0; i < res.items_size(); i++) {
+        Fam_Metadata_Response *item = res.mutable_items(i);
+        dataitems[i].regionId = item->region_id();
+        dataitems[i].offset = item->offset();
+        dataitems[i].size = item->size();
+        dataitems[i].memoryServerId = item->memsrv_id();
+        get_interleave_info(*item, dataitems[i]);
+    }
+    METADATA_CLIENT_PROFILE_END_OPS(
+        client_metadata_validate_and_deallocate_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Client::
+    metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_CLIENT_PROFILE_START_OPS()
+    Fam_Metadata_Batch_Request req;
+    Fam_Metadata_Batch_Response res;
+    ::grpc::ClientContext ctx;
+
+    req.set_region_name(regionName);
+    req.set_op(op);
+    req.set_uid(uid);
+    req.set_gid(gid);
+    for (auto &name : dataitemNames)
+        req.add_items()->set_key_dataitem_name(name);
+
+    ::grpc::Status status =
+        stub->metadata_find_dataitem_and_check_permissions_batch(&ctx, req,
+                                                                 &res);
+    STATUS_CHECK(Metadata_Service_Exception)
+    if ((size_t)res.items_size() != dataitemNames.size()) {
+        throw Metadata_Service_Exception(FAM_ERR_RPC,
+                                         "Incomplete batch response");
+    }
+    dataitems.resize(dataitemNames.size());
+    for (int i = 0; i < res.items_size(); i++) {
+        Fam_Metadata_Response *item = res.mutable_items(i);
+        dataitems[i].regionId = item->region_id();
+        dataitems[i].offset = item->offset();
+        dataitems[i].size = item->size();
+        dataitems[i].perm = (mode_t)item->perm();
+        strncpy(dataitems[i].name, item->name().c_str(), item->maxkeylen());
+        dataitems[i].uid = item->uid();
+        dataitems[i].gid = item->gid();
+        dataitems[i].memoryServerId = item->memsrv_id();
+        get_interleave_info(*item, dataitems[i]);
+    }
+    METADATA_CLIENT_PROFILE_END_OPS(
+        client_metadata_find_dataitem_and_check_permissions_batch);
+}
+
 std::list<int>
 Fam_Metadata_Service_Client::get_memory_server_list(uint64_t regionId) {
     std::list<int> memory_server_list;
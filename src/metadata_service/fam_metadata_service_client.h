@@ -119,11 +119,11 @@ class Fam_Metadata_Service_Client : public Fam_Metadata_Service {
                                   const std::string regionName,
                                   Fam_DataItem_Metadata *dataitem);
 
-    bool metadata_check_permissions(Fam_DataItem_Metadata *dataitem,
+    bool metadata_check_permissions(const Fam_DataItem_Metadata *dataitem,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
 
-    bool metadata_check_permissions(Fam_Region_Metadata *region,
+    bool metadata_check_permissions(const Fam_Region_Metadata *region,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
     size_t metadata_maxkeylen();
@@ -139,9 +139,9 @@ class Fam_Metadata_Service_Client : public Fam_Metadata_Service {
     metadata_validate_and_destroy_region(const uint64_t regionId, uint32_t uid,
                                          uint32_t gid,
                                          std::list<int> *memory_server_list);
-    void metadata_validate_and_deallocate_dataitem(const uint64_t regionId,
-                                                   const uint64_t dataitemId,
-                                                   uint32_t uid, uint32_t gid);
+    void metadata_validate_and_deallocate_dataitem(
+        const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
+        uint32_t gid, Fam_DataItem_Metadata &dataitem);
     void metadata_validate_and_allocate_dataitem(const std::string dataitemName,
                                                  const uint64_t regionId,
                                                  uint32_t uid, uint32_t gid,
@@ -165,6 +165,25 @@ class Fam_Metadata_Service_Client : public Fam_Metadata_Service {
         const std::string regionName, uint32_t uid, uint32_t gid,
         Fam_DataItem_Metadata &dataitem);
 
+    void metadata_validate_and_allocate_dataitem_batch(
+        const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+        uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds);
+
+    void metadata_insert_dataitem_batch(
+        const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
     std::list<int> get_memory_server_list(uint64_t region);
     Fam_Metadata_Service_Client(const char *name, uint64_t port);
     ~Fam_Metadata_Service_Client();
@@ -33,6 +33,7 @@
  */
 
 #include "fam_metadata_service_direct.h"
+#include "fam_metadata_record.h"
 
 #include <boost/atomic.hpp>
 
@@ -73,10 +74,13 @@ MEMSERVER_PROFILE_START(METADATA_DIRECT)
     Profile_Time total = METADATA_DIRECT_time_diff_nanoseconds(start, end);    \
     MEMSERVER_PROFILE_ADD_TO_TOTAL_OPS(METADATA_DIRECT, prof_##apiIdx, total)  \
     }
+#define METADATA_DIRECT_PROFILE_COUNT(apiIdx)                                  \
+    MEMSERVER_PROFILE_ADD_TO_TOTAL_OPS(METADATA_DIRECT, prof_##apiIdx, 0)
 #define METADATA_DIRECT_PROFILE_DUMP() metadata_direct_profile_dump()
 #else
 #define METADATA_DIRECT_PROFILE_START_OPS()
 #define METADATA_DIRECT_PROFILE_END_OPS(apiIdx)
+#define METADATA_DIRECT_PROFILE_COUNT(apiIdx)
 #define METADATA_DIRECT_PROFILE_DUMP()
 #endif
 
@@ -104,6 +108,263 @@ inline void ResetBuf(char *buf, size_t &len, size_t const max_len) {
     len = max_len;
 }
 
+/*
+ * Keys of the region and dataitem id KVS trees (and the values of the name
+ * KVS trees) are the id as a fixed-width, big-endian 8 byte string, so that
+ * keys are short, of equal length and sort in id order.
+ */
+size_t const METADATA_KEY_LEN = sizeof(uint64_t);
+
+inline std::string metadata_key(const uint64_t id) {
+    char key[METADATA_KEY_LEN];
+    for (size_t i = 0; i < METADATA_KEY_LEN; i++)
+        key[i] = (char)(id >> (8 * (METADATA_KEY_LEN - 1 - i)));
+    return std::string(key, METADATA_KEY_LEN);
+}
+
+inline uint64_t metadata_key_to_id(const char *key, size_t len) {
+    ostringstream message;
+    if (len != METADATA_KEY_LEN) {
+        message << "Invalid metadata key length";
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        message.str().c_str());
+    }
+    uint64_t id = 0;
+    for (size_t i = 0; i < METADATA_KEY_LEN; i++)
+        id = (id << 8) | (uint8_t)key[i];
+    return id;
+}
+
+inline uint64_t metadata_key_to_id(const std::string &key) {
+    return metadata_key_to_id(key.data(), key.size());
+}
+
+static_assert(MAX_MEMORY_SERVERS_CNT * sizeof(uint64_t) +
+                      RadixTree::MAX_KEY_LEN + 128 <=
+                  max_val_len,
+              "region metadata record does not fit in max_val_len");
+static_assert(2 * MAX_INTERLEAVE_MEMSERVERS_CNT * sizeof(uint64_t) +
+                      RadixTree::MAX_KEY_LEN + 128 <=
+                  max_val_len,
+              "dataitem metadata record does not fit in max_val_len");
+
+#define METADATA_CACHE_SHARDS 16
+
+inline size_t metadata_cache_hash(const std::pair<uint64_t, uint64_t> &key) {
+    return std::hash<uint64_t>{}(key.first * 0x9e3779b97f4a7c15ULL ^
+                                 key.second);
+}
+
+inline size_t
+metadata_cache_hash(const std::pair<uint64_t, std::string> &key) {
+    return std::hash<std::string>{}(key.second) ^
+           std::hash<uint64_t>{}(key.first);
+}
+
+/*
+ * A bounded map with LRU eviction, split into shards with their own lock.
+ * Entries are only inserted if no invalidation happened since the caller
+ * took its fill token (see Fam_Metadata_Cache), so a lookup that raced
+ * with a modify or delete never caches the old value.
+ */
+template <typename Key, typename Value> class Metadata_Cache_Map {
+  public:
+    Metadata_Cache_Map(size_t maxEntries, std::atomic<uint64_t> &generation)
+        : generation(generation) {
+        maxShardEntries = maxEntries / METADATA_CACHE_SHARDS;
+        if (maxShardEntries == 0)
+            maxShardEntries = 1;
+        for (int i = 0; i < METADATA_CACHE_SHARDS; i++)
+            pthread_mutex_init(&shards[i].lock, NULL);
+    }
+
+    ~Metadata_Cache_Map() {
+        for (int i = 0; i < METADATA_CACHE_SHARDS; i++)
+            pthread_mutex_destroy(&shards[i].lock);
+    }
+
+    bool find(const Key &key, Value &value) {
+        Shard &shard = get_shard(key);
+        pthread_mutex_lock(&shard.lock);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            pthread_mutex_unlock(&shard.lock);
+            return false;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.second);
+        value = it->second.first;
+        pthread_mutex_unlock(&shard.lock);
+        return true;
+    }
+
+    void insert(const Key &key, const Value &value, uint64_t token) {
+        Shard &shard = get_shard(key);
+        pthread_mutex_lock(&shard.lock);
+        if (generation.load() != token) {
+            pthread_mutex_unlock(&shard.lock);
+            return;
+        }
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            it->second.first = value;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.second);
+        } else {
+            if (shard.entries.size() >= maxShardEntries) {
+                shard.entries.erase(shard.lru.back());
+                shard.lru.pop_back();
+            }
+            shard.lru.push_front(key);
+            shard.entries.insert({ key, { value, shard.lru.begin() } });
+        }
+        pthread_mutex_unlock(&shard.lock);
+    }
+
+    void erase(const Key &key) {
+        Shard &shard = get_shard(key);
+        pthread_mutex_lock(&shard.lock);
+        erase_locked(shard, shard.entries.find(key));
+        pthread_mutex_unlock(&shard.lock);
+    }
+
+    // Erase the keys in [first, last)
+    void erase_range(const Key &first, const Key &last) {
+        for (int i = 0; i < METADATA_CACHE_SHARDS; i++) {
+            Shard &shard = shards[i];
+            pthread_mutex_lock(&shard.lock);
+            auto it = shard.entries.lower_bound(first);
+            while (it != shard.entries.end() && it->first < last)
+                it = erase_locked(shard, it);
+            pthread_mutex_unlock(&shard.lock);
+        }
+    }
+
+  private:
+    typedef std::list<Key> Lru_List;
+    typedef std::map<Key, std::pair<Value, typename Lru_List::iterator>>
+        Entry_Map;
+
+    struct Shard {
+        pthread_mutex_t lock;
+        // Keys, most recently used first
+        Lru_List lru;
+        Entry_Map entries;
+    };
+
+    Shard &get_shard(const Key &key) {
+        return shards[metadata_cache_hash(key) % METADATA_CACHE_SHARDS];
+    }
+
+    typename Entry_Map::iterator erase_locked(Shard &shard,
+                                              typename Entry_Map::iterator it) {
+        if (it == shard.entries.end())
+            return it;
+        shard.lru.erase(it->second.second);
+        return shard.entries.erase(it);
+    }
+
+    std::atomic<uint64_t> &generation;
+    size_t maxShardEntries;
+    Shard shards[METADATA_CACHE_SHARDS];
+};
+
+/*
+ * In-memory cache of region and dataitem records in front of the metadata
+ * KVS, keyed by id and by name. Records are kept in their compact encoded
+ * form and decoded on a hit. A name only maps to an id; a name hit is used
+ * only if the cached record for that id still carries the same name, so
+ * name entries never need to be invalidated.
+ *
+ * A lookup that misses takes a fill token before reading the KVS and fills
+ * the cache with it; every invalidation advances the generation first, which
+ * makes fills started before it a no-op.
+ */
+class Fam_Metadata_Cache {
+  public:
+    Fam_Metadata_Cache(size_t maxEntries)
+        : generation(0), regions(maxEntries, generation),
+          regionNames(maxEntries, generation),
+          dataitems(maxEntries, generation),
+          dataitemNames(maxEntries, generation) {}
+
+    uint64_t fill_token() { return generation.load(); }
+
+    bool find_region(const uint64_t regionId, Fam_Region_Metadata &region) {
+        std::string record;
+        if (!regions.find({ 0, regionId }, record))
+            return false;
+        decode_region(record.data(), record.size(), region);
+        return true;
+    }
+
+    bool find_region(const std::string &regionName,
+                     Fam_Region_Metadata &region) {
+        uint64_t regionId;
+        if (!regionNames.find({ 0, regionName }, regionId) ||
+            !find_region(regionId, region))
+            return false;
+        return regionName == region.name;
+    }
+
+    void fill_region(const char *record, size_t len,
+                     const Fam_Region_Metadata &region, uint64_t token) {
+        regions.insert({ 0, region.regionId }, std::string(record, len),
+                       token);
+        regionNames.insert({ 0, region.name }, region.regionId, token);
+    }
+
+    bool find_dataitem(const uint64_t regionId, const uint64_t dataitemId,
+                       Fam_DataItem_Metadata &dataitem) {
+        std::string record;
+        if (!dataitems.find({ regionId, dataitemId }, record))
+            return false;
+        decode_dataitem(record.data(), record.size(), dataitem);
+        return true;
+    }
+
+    bool find_dataitem(const uint64_t regionId, const std::string &name,
+                       Fam_DataItem_Metadata &dataitem) {
+        uint64_t dataitemId;
+        if (!dataitemNames.find({ regionId, name }, dataitemId) ||
+            !find_dataitem(regionId, dataitemId, dataitem))
+            return false;
+        return name == dataitem.name;
+    }
+
+    void fill_dataitem(const uint64_t regionId, const uint64_t dataitemId,
+                       const char *record, size_t len,
+                       const Fam_DataItem_Metadata &dataitem, uint64_t token) {
+        dataitems.insert({ regionId, dataitemId }, std::string(record, len),
+                         token);
+        if (dataitem.name[0] != '\0')
+            dataitemNames.insert({ regionId, dataitem.name }, dataitemId,
+                                 token);
+    }
+
+    // Drop a region record, and the records of all its dataitems if
+    // the region is being deleted
+    void invalidate_region(const uint64_t regionId, bool deleted) {
+        generation++;
+        regions.erase({ 0, regionId });
+        if (deleted)
+            dataitems.erase_range({ regionId, 0 }, { regionId + 1, 0 });
+    }
+
+    void invalidate_dataitem(const uint64_t regionId,
+                             const uint64_t dataitemId) {
+        generation++;
+        dataitems.erase({ regionId, dataitemId });
+    }
+
+  private:
+    std::atomic<uint64_t> generation;
+    Metadata_Cache_Map<std::pair<uint64_t, uint64_t>, std::string> regions;
+    Metadata_Cache_Map<std::pair<uint64_t, std::string>, uint64_t>
+        regionNames;
+    Metadata_Cache_Map<std::pair<uint64_t, uint64_t>, std::string> dataitems;
+    Metadata_Cache_Map<std::pair<uint64_t, std::string>, uint64_t>
+        dataitemNames;
+};
+
 /*
  * Internal implementation of Fam_Metadata_Service_Direct
  */
@@ -114,7 +375,9 @@ class Fam_Metadata_Service_Direct::Impl_ {
     ~Impl_() {}
 
     int Init(bool use_meta_reg, bool enable_region_spanning,
-             size_t region_span_size_per_memoryserver);
+             size_t region_span_size_per_memoryserver, size_t cache_size,
+             metadata_placement_policy_t placement_policy,
+             size_t memory_server_capacity);
 
     int Final();
 
@@ -192,11 +455,11 @@ class Fam_Metadata_Service_Direct::Impl_ {
                                   const std::string regionName,
                                   Fam_DataItem_Metadata *dataitem);
 
-    bool metadata_check_permissions(Fam_DataItem_Metadata *dataitem,
+    bool metadata_check_permissions(const Fam_DataItem_Metadata *dataitem,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
 
-    bool metadata_check_permissions(Fam_Region_Metadata *region,
+    bool metadata_check_permissions(const Fam_Region_Metadata *region,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
 
@@ -214,9 +477,9 @@ class Fam_Metadata_Service_Direct::Impl_ {
                                                  uint32_t uid, uint32_t gid,
                                                  uint64_t *memoryServerId);
 
-    void metadata_validate_and_deallocate_dataitem(const uint64_t regionId,
-                                                   const uint64_t dataitemId,
-                                                   uint32_t uid, uint32_t gid);
+    void metadata_validate_and_deallocate_dataitem(
+        const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
+        uint32_t gid, Fam_DataItem_Metadata &dataitem);
     size_t metadata_maxkeylen();
     void metadata_update_memoryserver(int nmemServers,
                                       std::vector<uint64_t> memsrv_id_list);
@@ -240,6 +503,25 @@ class Fam_Metadata_Service_Direct::Impl_ {
         const std::string regionName, uint32_t uid, uint32_t gid,
         Fam_DataItem_Metadata &dataitem);
 
+    void metadata_validate_and_allocate_dataitem_batch(
+        const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+        uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds);
+
+    void metadata_insert_dataitem_batch(
+        const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
     std::list<int> get_memory_server_list(uint64_t regionId);
 
   private:
@@ -261,6 +543,86 @@ class Fam_Metadata_Service_Direct::Impl_ {
     MemoryManager *memoryManager;
     bool enable_region_spanning;
     size_t region_span_size_per_memoryserver;
+    // Cache of region and dataitem records, nullptr if disabled
+    Fam_Metadata_Cache *cache;
+
+    /*
+     * Placement statistics of a memory server, maintained from the region
+     * and dataitem metadata updates made through this service.
+     */
+    typedef struct {
+        // Bytes of the regions placed on the memory server
+        uint64_t reservedBytes;
+        // Bytes and number of the data items allocated on it
+        uint64_t allocatedBytes;
+        uint64_t numDataitems;
+        // Data items placed on it recently, halved every second
+        double recentPlacements;
+        steady_clock::time_point lastDecay;
+    } Memory_Server_Stats;
+
+    // Data item bytes and count per (region, memory server), released
+    // when the region is deleted
+    typedef std::map<std::pair<uint64_t, uint64_t>,
+                     std::pair<uint64_t, uint64_t>>
+        Region_Usage_Map;
+
+    metadata_placement_policy_t placementPolicy;
+    // Capacity of a memory server in bytes, 0 if unknown
+    size_t memoryServerCapacity;
+    std::map<uint64_t, Memory_Server_Stats> memoryServerStats;
+    Region_Usage_Map regionUsage;
+    pthread_mutex_t placementLock;
+
+    void account_region(const Fam_Region_Metadata &region, bool add);
+    void account_dataitem(const Fam_DataItem_Metadata &dataitem, bool add);
+    void release_region_dataitems(const uint64_t regionId);
+    void rebuild_placement_stats();
+    std::vector<uint64_t> place(const std::vector<uint64_t> &candidates,
+                                size_t count,
+                                metadata_placement_policy_t policy,
+                                bool dataitem);
+    uint64_t select_dataitem_memory_server(const Fam_Region_Metadata &region,
+                                           const std::string &dataitemName);
+
+    void invalidate_region(const uint64_t regionId, bool deleted) {
+        if (cache)
+            cache->invalidate_region(regionId, deleted);
+    }
+
+    void invalidate_dataitem(const uint64_t regionId,
+                             const std::string &dataitemKey) {
+        if (cache)
+            cache->invalidate_dataitem(regionId,
+                                       metadata_key_to_id(dataitemKey));
+    }
+
+    // Look up a dataitem by id or name in the cache. On a miss, token is
+    // set for filling the cache once the record is read from the KVS.
+    template <typename Key>
+    bool find_cached_dataitem(const uint64_t regionId, const Key &key,
+                              Fam_DataItem_Metadata &dataitem,
+                              uint64_t &token) {
+        if (!cache)
+            return false;
+        if (cache->find_dataitem(regionId, key, dataitem)) {
+            METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_hit);
+            return true;
+        }
+        METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_miss);
+        token = cache->fill_token();
+        return false;
+    }
+
+    void fill_cached_dataitem(const uint64_t regionId,
+                              const std::string &dataitemKey,
+                              const char *record, size_t len,
+                              const Fam_DataItem_Metadata &dataitem,
+                              uint64_t token) {
+        if (cache)
+            cache->fill_dataitem(regionId, metadata_key_to_id(dataitemKey),
+                                 record, len, dataitem, token);
+    }
 
     GlobalPtr create_metadata_kvs_tree(size_t heap_size = METADATA_HEAP_SIZE,
                                        nvmm::PoolId heap_id = METADATA_HEAP_ID);
@@ -294,14 +656,16 @@ class Fam_Metadata_Service_Direct::Impl_ {
     bool create_heap_for_dataitem_metadata_KVS(const uint64_t regionId,
                                                size_t heap_size);
     void destroy_dataitem_metadata_KVS(const uint64_t regionId,
-                                       Fam_Region_Metadata regNode);
+                                       const Fam_Region_Metadata &regNode);
 };
 
 /*
  * Initialize the FAM metadata manager
  */
-int Fam_Metadata_Service_Direct::Impl_::Init(bool use_meta_reg, bool flag,
-                                             size_t size) {
+int Fam_Metadata_Service_Direct::Impl_::Init(
+    bool use_meta_reg, bool flag, size_t size, size_t cache_size,
+    metadata_placement_policy_t placement_policy,
+    size_t memory_server_capacity) {
 
     memoryManager = MemoryManager::GetInstance();
     enable_region_spanning = flag;
@@ -309,6 +673,10 @@ int Fam_Metadata_Service_Direct::Impl_::Init(bool use_meta_reg, bool flag,
     metadataKvsMap = new KvsMap();
     pthread_rwlock_init(&kvsMapLock, NULL);
     use_meta_region = use_meta_reg;
+    cache = cache_size ? new Fam_Metadata_Cache(cache_size) : nullptr;
+    placementPolicy = placement_policy;
+    memoryServerCapacity = memory_server_capacity;
+    pthread_mutex_init(&placementLock, NULL);
 
     // Create the KVS tree for Region ID
     // Get the regionIdRoot from NVMM root-shelf
@@ -350,6 +718,10 @@ int Fam_Metadata_Service_Direct::Impl_::Init(bool use_meta_reg, bool flag,
     // As of now set memory server count as 1 in init.
     memoryServerCount = 1;
 
+    // Placement statistics are not persistent, rebuild them from the
+    // region and dataitem records
+    rebuild_placement_stats();
+
     return META_NO_ERROR;
 }
 
@@ -359,6 +731,8 @@ int Fam_Metadata_Service_Direct::Impl_::Final() {
     delete regionNameKVS;
     delete metadataKvsMap;
     pthread_rwlock_destroy(&kvsMapLock);
+    delete cache;
+    pthread_mutex_destroy(&placementLock);
 
     return META_NO_ERROR;
 }
@@ -372,6 +746,10 @@ void Fam_Metadata_Service_Direct::Impl_::init_poolid_bmap() {
     bmap = new bitmap();
     bmap->size = (ShelfId::kMaxPoolCount * BITSIZE) / sizeof(uint64_t);
     bmap->map = memoryManager->GetRegionIdBitmapAddr();
+    // Let region Id searches skip the full words of the bitmap
+    if (bitmap_enable_summary(bmap))
+        THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
+                        "Failed to allocate region Id bitmap summary");
 }
 
 /**
@@ -496,15 +874,26 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_region(
 
     ostringstream message;
     int ret;
-    std::string regionKey = std::to_string(regionId);
+    std::string regionKey = metadata_key(regionId);
     char val_buf[max_val_len];
-    size_t val_len;
+    size_t val_len = max_val_len;
+    uint64_t token = 0;
+
+    if (cache) {
+        if (cache->find_region(regionId, region)) {
+            METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_hit);
+            return true;
+        }
+        METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_miss);
+        token = cache->fill_token();
+    }
 
-    ResetBuf(val_buf, val_len, max_val_len);
     ret =
         regionIdKVS->Get(regionKey.c_str(), regionKey.size(), val_buf, val_len);
     if (ret == META_NO_ERROR) {
-        memcpy((char *)&region, val_buf, sizeof(Fam_Region_Metadata));
+        decode_region(val_buf, val_len, region);
+        if (cache)
+            cache->fill_region(val_buf, val_len, region, token);
         return true;
     } else if (ret == META_KEY_DOES_NOT_EXIST) {
         return false;
@@ -533,9 +922,15 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_region(
     int ret;
 
     char val_buf[max_val_len];
-    size_t val_len;
+    size_t val_len = max_val_len;
 
-    ResetBuf(val_buf, val_len, max_val_len);
+    if (cache) {
+        if (cache->find_region(regionName, region)) {
+            METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_hit);
+            return true;
+        }
+        METADATA_DIRECT_PROFILE_COUNT(direct_metadata_cache_miss);
+    }
 
     ret = regionNameKVS->Get(regionName.c_str(), regionName.size(), val_buf,
                              val_len);
@@ -544,7 +939,7 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_region(
         return false;
     } else if (ret == META_NO_ERROR) {
 
-        uint64_t regionID = strtoul(val_buf, NULL, 0);
+        uint64_t regionID = metadata_key_to_id(val_buf, val_len);
 
         return metadata_find_region(regionID, region);
 
@@ -600,8 +995,8 @@ int Fam_Metadata_Service_Direct::Impl_::insert_in_regionid_kvs(
     const std::string regionName, Fam_Region_Metadata *region, bool insert) {
 
     int ret;
-    char val_node[sizeof(Fam_Region_Metadata) + 1];
-    memcpy((char *)val_node, (char const *)region, sizeof(Fam_Region_Metadata));
+    char val_node[max_val_len];
+    size_t node_len = encode_region(region, val_node);
 
     char val_buf[max_val_len];
     size_t val_len;
@@ -612,11 +1007,10 @@ int Fam_Metadata_Service_Direct::Impl_::insert_in_regionid_kvs(
     // metadata modify.
     if (insert) {
         ret = regionIdKVS->FindOrCreate(regionName.c_str(), regionName.size(),
-                                        val_node, sizeof(Fam_Region_Metadata),
-                                        val_buf, val_len);
+                                        val_node, node_len, val_buf, val_len);
     } else {
         ret = regionIdKVS->Put(regionName.c_str(), regionName.size(), val_node,
-                               sizeof(Fam_Region_Metadata));
+                               node_len);
     }
 
     if (ret == META_NO_ERROR) {
@@ -700,7 +1094,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_region(
     ostringstream message;
     int ret;
 
-    std::string regionKey = std::to_string(regionId);
+    std::string regionKey = metadata_key(regionId);
 
     // Insert region name -> region id mapping in regionDataKVS
     ret = insert_in_regionname_kvs(regionName, regionKey);
@@ -780,6 +1174,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_region(
                             message.str().c_str());
         }
         pthread_rwlock_unlock(&kvsMapLock);
+        account_region(*region, true);
     } else if (ret == META_KEY_ALREADY_EXIST) {
         message << "Region already exist";
         THROW_ERRNO_MSG(Metadata_Service_Exception, REGION_EXIST,
@@ -816,18 +1211,22 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_region(
                         message.str().c_str());
     } else {
         // KVS found... update the value of dataitem root from the region node
-        std::string regionKey = std::to_string(regionId);
+        std::string regionKey = metadata_key(regionId);
         region->isHeapCreated = regNode.isHeapCreated;
         region->dataItemIdRoot = regNode.dataItemIdRoot;
         region->dataItemNameRoot = regNode.dataItemNameRoot;
+        region->placementPolicy = regNode.placementPolicy;
 
         // Insert the Region metadata descriptor in the region ID KVS
         ret = insert_in_regionid_kvs(regionKey, region, 0);
+        invalidate_region(regionId, false);
         if (ret != META_NO_ERROR) {
             message << "Region metadata modification failed";
             THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                             message.str().c_str());
         }
+        account_region(regNode, false);
+        account_region(*region, true);
     }
 }
 
@@ -850,18 +1249,22 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_region(
     if (metadata_find_region(regionName, regNode)) {
         // KVS found... update the value of dataitem root from the region node
 
-        std::string regionKey = std::to_string(regNode.regionId);
+        std::string regionKey = metadata_key(regNode.regionId);
         region->isHeapCreated = regNode.isHeapCreated;
         region->dataItemIdRoot = regNode.dataItemIdRoot;
         region->dataItemNameRoot = regNode.dataItemNameRoot;
+        region->placementPolicy = regNode.placementPolicy;
 
         // Insert the Region metadata descriptor in the region ID KVS
         ret = insert_in_regionid_kvs(regionKey, region, 0);
+        invalidate_region(regNode.regionId, false);
         if (ret != META_NO_ERROR) {
             message << "Region metadata modification failed";
             THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                             message.str().c_str());
         }
+        account_region(regNode, false);
+        account_region(*region, true);
     } else {
         // Region key does not exist
         DEBUG_STDOUT(regionName, "Region not found.");
@@ -872,7 +1275,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_region(
 }
 
 inline void Fam_Metadata_Service_Direct::Impl_::destroy_dataitem_metadata_KVS(
-    const uint64_t regionId, Fam_Region_Metadata regNode) {
+    const uint64_t regionId, const Fam_Region_Metadata &regNode) {
     ostringstream message;
     // Destroying heap incase heap is created by metadata service
     // which is used for dataitem metadata KVS
@@ -922,6 +1325,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_region(
 
         // Delete the entry from region ID KVS
         ret = regionIdKVS->Del(regionId.c_str(), regionId.size());
+        invalidate_region(metadata_key_to_id(regionId), true);
         if (ret != META_NO_ERROR) {
             if (ret == META_KEY_DOES_NOT_EXIST) {
                 DEBUG_STDOUT(regionName, "Region id not found.");
@@ -951,7 +1355,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_region(
             }
         }
         pthread_rwlock_wrlock(&kvsMapLock);
-        regionid = stoull(regionId);
+        regionid = metadata_key_to_id(regionId);
         auto kvsObj = metadataKvsMap->find(regionid);
         if (kvsObj != metadataKvsMap->end()) {
             diKVS *kvs = kvsObj->second;
@@ -967,6 +1371,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_region(
             pthread_rwlock_unlock(&kvsMapLock);
         }
 
+        account_region(regNode, false);
+        release_region_dataitems(regionid);
         destroy_dataitem_metadata_KVS(regionid, regNode);
     }
 }
@@ -1005,8 +1411,9 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_region(
         }
 
         // delete the region id for region ID KVS
-        std::string regionKey = std::to_string(regionId);
+        std::string regionKey = metadata_key(regionId);
         ret = regionIdKVS->Del(regionKey.c_str(), regionKey.size());
+        invalidate_region(regionId, true);
         if (ret == META_KEY_DOES_NOT_EXIST) {
             DEBUG_STDOUT(regionId, "Region not found");
             message << "Region does not exist";
@@ -1037,6 +1444,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_region(
 
         // Destroying heap incase heap is created by metadata service
         // which is used for dataitem metadata KVS
+        account_region(regNode, false);
+        release_region_dataitems(regionId);
         destroy_dataitem_metadata_KVS(regionId, regNode);
     } else {
         DEBUG_STDOUT(regionId, "Region lookup failed.");
@@ -1065,9 +1474,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
 
     Fam_Region_Metadata regNode;
     if (metadata_find_region(regionName.c_str(), regNode)) {
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
@@ -1080,7 +1488,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
         char val_buf[max_val_len];
         size_t val_len;
 
@@ -1112,8 +1520,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
         ResetBuf(val_buf, val_len, max_val_len);
 
         ret = dataitemIdKVS->FindOrCreate(
-            dataitemKey.c_str(), dataitemKey.size(), val_node,
-            sizeof(Fam_DataItem_Metadata), val_buf, val_len);
+            dataitemKey.c_str(), dataitemKey.size(), val_node, node_len,
+            val_buf, val_len);
 
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
@@ -1141,6 +1549,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
             }
         }
         release_kvs_lock(kvsLock);
+        account_dataitem(*dataitem, true);
     } else {
         DEBUG_STDOUT(regionName, "region not found");
         message << "Region does not exist";
@@ -1178,11 +1587,10 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
                             message.str().c_str());
         }
 
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
         char val_buf[max_val_len];
         size_t val_len;
 
@@ -1213,8 +1621,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
         ResetBuf(val_buf, val_len, max_val_len);
 
         ret = dataitemIdKVS->FindOrCreate(
-            dataitemKey.c_str(), dataitemKey.size(), val_node,
-            sizeof(Fam_DataItem_Metadata), val_buf, val_len);
+            dataitemKey.c_str(), dataitemKey.size(), val_node, node_len,
+            val_buf, val_len);
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
             DEBUG_STDERR(dataitemKey, "FindOrCreate failed.");
@@ -1241,6 +1649,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem(
             }
         }
         release_kvs_lock(kvsLock);
+        account_dataitem(*dataitem, true);
     } else {
         DEBUG_STDOUT(regionId, "region not found");
         message << "Region does not exist";
@@ -1270,9 +1679,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
     Fam_DataItem_Metadata dataitemNode;
     if (metadata_find_dataitem(dataitemId, regionId, dataitemNode)) {
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
@@ -1285,10 +1693,11 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
 
         ret = dataitemIdKVS->Put(dataitemKey.c_str(), dataitemKey.size(),
-                                 val_node, sizeof(Fam_DataItem_Metadata));
+                                 val_node, node_len);
+        invalidate_dataitem(regionId, dataitemKey);
 
         if (ret == META_ERROR) {
             release_kvs_lock(kvsLock);
@@ -1343,9 +1752,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
     Fam_DataItem_Metadata dataitemNode;
     if (metadata_find_dataitem(dataitemId, regionName, dataitemNode)) {
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
         // Get the regionID from the region Name KVS
         std::string regionId;
@@ -1360,8 +1768,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
-        ret = get_dataitem_KVS(stoull(regionId), dataitemIdKVS, dataitemNameKVS,
-                               &kvsLock);
+        ret = get_dataitem_KVS(metadata_key_to_id(regionId), dataitemIdKVS,
+                               dataitemNameKVS, &kvsLock);
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
             message << "Failed to get dataitem KVS";
@@ -1369,10 +1777,11 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
 
         ret = dataitemIdKVS->Put(dataitemKey.c_str(), dataitemKey.size(),
-                                 val_node, sizeof(Fam_DataItem_Metadata));
+                                 val_node, node_len);
+        invalidate_dataitem(metadata_key_to_id(regionId), dataitemKey);
 
         if (ret == META_ERROR) {
             release_kvs_lock(kvsLock);
@@ -1436,9 +1845,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
     Fam_DataItem_Metadata dataitemNode;
     if (metadata_find_dataitem(dataitemName, regionId, dataitemNode)) {
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
@@ -1466,7 +1874,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
             dataitemKey.assign(val_buf, val_len);
 
             ret = dataitemIdKVS->Put(dataitemKey.c_str(), dataitemKey.size(),
-                                     val_node, sizeof(Fam_DataItem_Metadata));
+                                     val_node, node_len);
+            invalidate_dataitem(regionId, dataitemKey);
             if (ret == META_ERROR) {
                 release_kvs_lock(kvsLock);
                 DEBUG_STDERR(dataitemName, "Put failed");
@@ -1504,9 +1913,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
     Fam_DataItem_Metadata dataitemNode;
     if (metadata_find_dataitem(dataitemName, regionName, dataitemNode)) {
-        char val_node[sizeof(Fam_DataItem_Metadata) + 1];
-        memcpy((char *)val_node, (char const *)dataitem,
-               sizeof(Fam_DataItem_Metadata));
+        char val_node[max_val_len];
+        size_t node_len = encode_dataitem(dataitem, val_node);
 
         // Get the regionID from the region Name KVS
         std::string regionId;
@@ -1520,8 +1928,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
-        ret = get_dataitem_KVS(stoull(regionId), dataitemIdKVS, dataitemNameKVS,
-                               &kvsLock);
+        ret = get_dataitem_KVS(metadata_key_to_id(regionId), dataitemIdKVS,
+                               dataitemNameKVS, &kvsLock);
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
             message << "Failed to get dataitem KVS";
@@ -1543,7 +1951,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_modify_dataitem(
             dataitemKey.assign(val_buf, val_len);
 
             ret = dataitemIdKVS->Put(dataitemKey.c_str(), dataitemKey.size(),
-                                     val_node, sizeof(Fam_DataItem_Metadata));
+                                     val_node, node_len);
+            invalidate_dataitem(metadata_key_to_id(regionId), dataitemKey);
             if (ret == META_ERROR) {
                 release_kvs_lock(kvsLock);
                 DEBUG_STDERR(dataitemName, "Put failed.");
@@ -1588,8 +1997,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
-        ret = get_dataitem_KVS(stoull(regionId), dataitemIdKVS, dataitemNameKVS,
-                               &kvsLock);
+        ret = get_dataitem_KVS(metadata_key_to_id(regionId), dataitemIdKVS,
+                               dataitemNameKVS, &kvsLock);
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
             message << "Failed to get dataitem KVS";
@@ -1597,8 +2006,9 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
         ret = dataitemIdKVS->Del(dataitemKey.c_str(), dataitemKey.size());
+        invalidate_dataitem(metadata_key_to_id(regionId), dataitemKey);
         if (ret == META_ERROR) {
             release_kvs_lock(kvsLock);
             DEBUG_STDERR(dataitemId, "Del failed.");
@@ -1606,6 +2016,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
             THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                             message.str().c_str());
         }
+        account_dataitem(dataitemNode, false);
 
         std::string dataitemName = dataitemNode.name;
         if (!dataitemName.empty()) {
@@ -1653,8 +2064,9 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
         ret = dataitemIdKVS->Del(dataitemKey.c_str(), dataitemKey.size());
+        invalidate_dataitem(regionId, dataitemKey);
         if (ret == META_ERROR) {
             release_kvs_lock(kvsLock);
             DEBUG_STDERR(dataitemId, "Del failed.");
@@ -1662,6 +2074,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
             THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                             message.str().c_str());
         }
+        account_dataitem(dataitemNode, false);
 
         std::string dataitemName = dataitemNode.name;
         if (!dataitemName.empty()) {
@@ -1722,6 +2135,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
         if (ret == META_NO_ERROR) {
             dataitemKey.assign(val_buf, val_len);
             ret = dataitemIdKVS->Del(dataitemKey.c_str(), dataitemKey.size());
+            invalidate_dataitem(regionId, dataitemKey);
             if (ret == META_ERROR) {
                 release_kvs_lock(kvsLock);
                 DEBUG_STDERR(dataitemName, "Del failed.");
@@ -1729,6 +2143,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
                 THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                                 message.str().c_str());
             }
+            account_dataitem(dataitemNode, false);
         }
 
         ret = dataitemNameKVS->Del(dataitemName.c_str(), dataitemName.size());
@@ -1775,8 +2190,8 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
 
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
-        ret = get_dataitem_KVS(stoull(regionId), dataitemIdKVS, dataitemNameKVS,
-                               &kvsLock);
+        ret = get_dataitem_KVS(metadata_key_to_id(regionId), dataitemIdKVS,
+                               dataitemNameKVS, &kvsLock);
         if (ret != META_NO_ERROR) {
             release_kvs_lock(kvsLock);
             message << "Failed to get dataitem KVS";
@@ -1797,6 +2212,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
         if (ret == META_NO_ERROR) {
             dataitemKey.assign(val_buf, val_len);
             ret = dataitemIdKVS->Del(dataitemKey.c_str(), dataitemKey.size());
+            invalidate_dataitem(metadata_key_to_id(regionId), dataitemKey);
             if (ret == META_ERROR) {
                 release_kvs_lock(kvsLock);
                 DEBUG_STDERR(dataitemName, "Del failed.");
@@ -1804,6 +2220,7 @@ void Fam_Metadata_Service_Direct::Impl_::metadata_delete_dataitem(
                 THROW_ERRNO_MSG(Metadata_Service_Exception, METADATA_ERROR,
                                 message.str().c_str());
             }
+            account_dataitem(dataitemNode, false);
         }
 
         ret = dataitemNameKVS->Del(dataitemName.c_str(), dataitemName.size());
@@ -1841,6 +2258,10 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
     size_t val_len;
 
     Fam_Region_Metadata regNode;
+    uint64_t token = 0;
+
+    if (find_cached_dataitem(regionId, dataitemId, dataitem, token))
+        return true;
 
     if (metadata_find_region(regionId, regNode)) {
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
@@ -1854,16 +2275,17 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
 
-        ResetBuf(val_buf, val_len, max_val_len);
+        val_len = max_val_len;
 
         ret = dataitemIdKVS->Get(dataitemKey.c_str(), dataitemKey.size(),
                                  val_buf, val_len);
         release_kvs_lock(kvsLock);
         if (ret == META_NO_ERROR) {
-            memcpy((char *)&dataitem, (char const *)val_buf,
-                   sizeof(Fam_DataItem_Metadata));
+            decode_dataitem(val_buf, val_len, dataitem);
+            fill_cached_dataitem(regionId, dataitemKey, val_buf, val_len,
+                                 dataitem, token);
             return true;
         } else if (ret == META_KEY_DOES_NOT_EXIST) {
             DEBUG_STDERR(dataitemId, "Get failed.");
@@ -1900,8 +2322,12 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
     size_t val_len;
 
     Fam_Region_Metadata regNode;
+    uint64_t token = 0;
 
     if (metadata_find_region(regionName, regNode)) {
+        if (find_cached_dataitem(regNode.regionId, dataitemId, dataitem, token))
+            return true;
+
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
         ret = get_dataitem_KVS(regNode.regionId, dataitemIdKVS, dataitemNameKVS,
@@ -1913,16 +2339,17 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
                             message.str().c_str());
         }
 
-        std::string dataitemKey = std::to_string(dataitemId);
+        std::string dataitemKey = metadata_key(dataitemId);
 
-        ResetBuf(val_buf, val_len, max_val_len);
+        val_len = max_val_len;
 
         ret = dataitemIdKVS->Get(dataitemKey.c_str(), dataitemKey.size(),
                                  val_buf, val_len);
         release_kvs_lock(kvsLock);
         if (ret == META_NO_ERROR) {
-            memcpy((char *)&dataitem, (char const *)val_buf,
-                   sizeof(Fam_DataItem_Metadata));
+            decode_dataitem(val_buf, val_len, dataitem);
+            fill_cached_dataitem(regNode.regionId, dataitemKey, val_buf,
+                                 val_len, dataitem, token);
             return true;
         } else if (ret == META_KEY_DOES_NOT_EXIST) {
             DEBUG_STDERR(dataitemId, "Get failed.");
@@ -1956,6 +2383,10 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
 
     int ret;
     Fam_Region_Metadata regNode;
+    uint64_t token = 0;
+
+    if (find_cached_dataitem(regionId, dataitemName, dataitem, token))
+        return true;
 
     if (metadata_find_region(regionId, regNode)) {
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
@@ -1971,22 +2402,22 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
 
         std::string dataitemKey;
         char val_buf[max_val_len];
-        size_t val_len;
-        ResetBuf(val_buf, val_len, max_val_len);
+        size_t val_len = max_val_len;
 
         ret = dataitemNameKVS->Get(dataitemName.c_str(), dataitemName.size(),
                                    val_buf, val_len);
 
         if (ret == META_NO_ERROR) {
             dataitemKey.assign(val_buf, val_len);
-            ResetBuf(val_buf, val_len, max_val_len);
+            val_len = max_val_len;
 
             ret = dataitemIdKVS->Get(dataitemKey.c_str(), dataitemKey.size(),
                                      val_buf, val_len);
             release_kvs_lock(kvsLock);
             if (ret == META_NO_ERROR) {
-                memcpy((char *)&dataitem, (char const *)val_buf,
-                       sizeof(Fam_DataItem_Metadata));
+                decode_dataitem(val_buf, val_len, dataitem);
+                fill_cached_dataitem(regionId, dataitemKey, val_buf, val_len,
+                                     dataitem, token);
                 return true;
             } else if (ret == META_KEY_DOES_NOT_EXIST) {
                 DEBUG_STDERR(dataitemId, "Get failed.");
@@ -2033,8 +2464,13 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
     size_t val_len;
 
     Fam_Region_Metadata regNode;
+    uint64_t token = 0;
 
     if (metadata_find_region(regionName, regNode)) {
+        if (find_cached_dataitem(regNode.regionId, dataitemName, dataitem,
+                                 token))
+            return true;
+
         KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
         pthread_rwlock_t *kvsLock;
         ret = get_dataitem_KVS(regNode.regionId, dataitemIdKVS, dataitemNameKVS,
@@ -2047,7 +2483,7 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
         }
         std::string dataitemKey;
 
-        ResetBuf(val_buf, val_len, max_val_len);
+        val_len = max_val_len;
 
         ret = dataitemNameKVS->Get(dataitemName.c_str(), dataitemName.size(),
                                    val_buf, val_len);
@@ -2056,14 +2492,15 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
 
             dataitemKey.assign(val_buf, val_len);
 
-            ResetBuf(val_buf, val_len, max_val_len);
+            val_len = max_val_len;
 
             ret = dataitemIdKVS->Get(dataitemKey.c_str(), dataitemKey.size(),
                                      val_buf, val_len);
             release_kvs_lock(kvsLock);
             if (ret == META_NO_ERROR) {
-                memcpy((char *)&dataitem, (char const *)val_buf,
-                       sizeof(Fam_DataItem_Metadata));
+                decode_dataitem(val_buf, val_len, dataitem);
+                fill_cached_dataitem(regNode.regionId, dataitemKey, val_buf,
+                                     val_len, dataitem, token);
                 return true;
             } else if (ret == META_KEY_DOES_NOT_EXIST) {
                 DEBUG_STDERR(dataitemId, "Get failed.");
@@ -2102,8 +2539,8 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_find_dataitem(
  *
  */
 bool Fam_Metadata_Service_Direct::Impl_::metadata_check_permissions(
-    Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
 
     bool write = false, read = false, exec = false;
     if (dataitem->uid == uid) {
@@ -2183,8 +2620,8 @@ bool Fam_Metadata_Service_Direct::Impl_::metadata_check_permissions(
  *
  */
 bool Fam_Metadata_Service_Direct::Impl_::metadata_check_permissions(
-    Fam_Region_Metadata *region, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_Region_Metadata *region, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
 
     bool write = false, read = false, exec = false;
     if (region->uid == uid) {
@@ -2431,24 +2868,16 @@ Fam_Metadata_Service_Direct::Impl_::metadata_validate_and_allocate_dataitem(
                             message.str().c_str());
         }
     }
-    uint64_t id =  0;
-    if (!dataitemName.empty()) {
-	id = (std::hash<std::string>{}(dataitemName) % region.used_memsrv_cnt);
-    } else {
-	id = rand() % region.used_memsrv_cnt;
-    }
-	*memoryServerId = region.memServerIds[id];
-
+    *memoryServerId = select_dataitem_memory_server(region, dataitemName);
 }
 
 void
 Fam_Metadata_Service_Direct::Impl_::metadata_validate_and_deallocate_dataitem(
     const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
-    uint32_t gid) {
+    uint32_t gid, Fam_DataItem_Metadata &dataitem) {
     ostringstream message;
     // Check with metadata service if data item with the requested name
     // is already exist, if not return error
-    Fam_DataItem_Metadata dataitem;
     bool ret = metadata_find_dataitem(dataitemId, regionId, dataitem);
     if (ret == 0) {
         message << "Deallocate Dataitem error : Dataitem does not exist";
@@ -2479,6 +2908,133 @@ Fam_Metadata_Service_Direct::Impl_::metadata_validate_and_deallocate_dataitem(
     }
 }
 
+/*
+ * Batch form of metadata_validate_and_allocate_dataitem: the region and the
+ * caller's permission are checked once, then every name is validated. No
+ * memory server is chosen unless all data items can be allocated.
+ */
+void Fam_Metadata_Service_Direct::Impl_::
+    metadata_validate_and_allocate_dataitem_batch(
+        const std::vector<std::string> &dataitemNames,
+        const uint64_t regionId, uint32_t uid, uint32_t gid,
+        std::vector<uint64_t> &memoryServerIds) {
+    ostringstream message;
+
+    Fam_Region_Metadata region;
+    if (!metadata_find_region(regionId, region)) {
+        message << "Allocate Dataitem error : Specified Region not found.";
+        THROW_ERRNO_MSG(Metadata_Service_Exception, REGION_NOT_FOUND,
+                        message.str().c_str());
+    }
+    if (uid != region.uid) {
+        bool isPermitted = metadata_check_permissions(
+            &region, META_REGION_ITEM_WRITE, uid, gid);
+        if (!isPermitted) {
+            message << "Allocate Dataitem error : Insufficient Permissions";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, NO_PERMISSION,
+                            message.str().c_str());
+        }
+    }
+
+    std::set<std::string> batchNames;
+    Fam_DataItem_Metadata dataitem;
+    for (auto &name : dataitemNames) {
+        if (name.size() > metadata_maxkeylen()) {
+            message << "Allocate Dataitem error : Dataitem name is too long.";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, DATAITEM_NAME_TOO_LONG,
+                            message.str().c_str());
+        }
+        if (name.empty())
+            continue;
+        if (!batchNames.insert(name).second ||
+            metadata_find_dataitem(name, regionId, dataitem)) {
+            message << "Allocate Dataitem error : Dataitem already exists";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, DATAITEM_EXIST,
+                            message.str().c_str());
+        }
+    }
+
+    memoryServerIds.resize(dataitemNames.size());
+    for (size_t i = 0; i < dataitemNames.size(); i++)
+        memoryServerIds[i] =
+            select_dataitem_memory_server(region, dataitemNames[i]);
+}
+
+/*
+ * Batch form of metadata_insert_dataitem. Each data item is inserted under
+ * the name held in its metadata, if any. If one insertion fails, the
+ * entries already inserted by this call are removed before the error is
+ * thrown.
+ */
+void Fam_Metadata_Service_Direct::Impl_::metadata_insert_dataitem_batch(
+    const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+    std::vector<Fam_DataItem_Metadata> &dataitems) {
+    size_t done = 0;
+    try {
+        for (; done < dataitemIds.size(); done++)
+            metadata_insert_dataitem(dataitemIds[done], regionId,
+                                     &dataitems[done],
+                                     std::string(dataitems[done].name));
+    } catch (...) {
+        for (size_t i = 0; i < done; i++) {
+            try {
+                metadata_delete_dataitem(dataitemIds[i], regionId);
+            } catch (...) {
+            }
+        }
+        throw;
+    }
+}
+
+/*
+ * Batch form of metadata_validate_and_deallocate_dataitem. Every data item
+ * is looked up and permission checked before any of them is removed, so a
+ * failure leaves the metadata untouched.
+ */
+void Fam_Metadata_Service_Direct::Impl_::
+    metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    ostringstream message;
+    dataitems.resize(dataitemIds.size());
+    for (size_t i = 0; i < dataitemIds.size(); i++) {
+        if (!metadata_find_dataitem(dataitemIds[i], regionId, dataitems[i])) {
+            message << "Deallocate Dataitem error : Dataitem does not exist";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, DATAITEM_NOT_FOUND,
+                            message.str().c_str());
+        }
+        if (uid != dataitems[i].uid &&
+            !metadata_check_permissions(&dataitems[i], META_REGION_ITEM_WRITE,
+                                        uid, gid)) {
+            message << "Deallocate dataitem error : Insufficient Permissions";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, NO_PERMISSION,
+                            message.str().c_str());
+        }
+    }
+    for (size_t i = 0; i < dataitemIds.size(); i++) {
+        try {
+            metadata_delete_dataitem(dataitemIds[i], regionId);
+        } catch (Fam_Exception &e) {
+            message << "Deallocate dataitem error : Couldnt delete dataitem";
+            THROW_ERRNO_MSG(Metadata_Service_Exception, DATAITEM_NOT_REMOVED,
+                            message.str().c_str());
+        }
+    }
+}
+
+void Fam_Metadata_Service_Direct::Impl_::
+    metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    dataitems.resize(dataitemNames.size());
+    for (size_t i = 0; i < dataitemNames.size(); i++)
+        metadata_find_dataitem_and_check_permissions(
+            op, dataitemNames[i], regionName, uid, gid, dataitems[i]);
+}
+
 void
 Fam_Metadata_Service_Direct::Impl_::metadata_find_region_and_check_permissions(
     metadata_region_item_op_t op, const uint64_t regionId, uint32_t uid,
@@ -2578,40 +3134,265 @@ std::list<int> Fam_Metadata_Service_Direct::Impl_::find_memory_server_list(
     std::uint64_t hashVal = std::hash<std::string> {}
     (regionname);
     unsigned int id = (int)(hashVal % memoryServerCount);
-    unsigned int i = 0;
+    unsigned int numServers = 1;
     uint64_t aligned_size = align_to_address(size, 64);
     size = (aligned_size > size ? aligned_size : size);
-    if (enable_region_spanning == 1) {
-        if (size <= region_span_size_per_memoryserver) {
-            // Size is smaller than region_span_size_per_memoryserver and hence
-            // using single memory server.
-            memsrv_list.push_back((int)memoryServerList[id]);
+    if (enable_region_spanning == 1 &&
+        size > region_span_size_per_memoryserver) {
+        // Size is bigger than region_span_size_per_memoryserver, span the
+        // region over as many memory servers as needed
+        numServers =
+            ((unsigned int)(size / region_span_size_per_memoryserver)) +
+            ((size % region_span_size_per_memoryserver) == 0 ? 0 : 1);
+        if (numServers > (unsigned int)memoryServerCount)
+            numServers = (unsigned int)memoryServerCount;
+    }
+
+    metadata_placement_policy_t policy = placementPolicy;
+    if (user_policy > META_PLACEMENT_DEFAULT &&
+        user_policy <= META_PLACEMENT_TWO_CHOICES)
+        policy = (metadata_placement_policy_t)user_policy;
+
+    if (policy == META_PLACEMENT_HASH) {
+        for (unsigned int i = 0; i < numServers; i++, id++)
+            memsrv_list.push_back(
+                (int)memoryServerList[id % memoryServerCount]);
+    } else {
+        std::vector<uint64_t> candidates(memoryServerList.begin(),
+                                         memoryServerList.begin() +
+                                             memoryServerCount);
+        for (auto memsrvId : place(candidates, numServers, policy, false))
+            memsrv_list.push_back((int)memsrvId);
+    }
+    return memsrv_list;
+}
+
+/*
+ * place - Choose count distinct memory servers out of candidates with the
+ * given placement policy. Regions are balanced on the bytes reserved on
+ * each memory server; data items on the number of data items, counting
+ * the recent placements which may not be inserted yet.
+ */
+std::vector<uint64_t> Fam_Metadata_Service_Direct::Impl_::place(
+    const std::vector<uint64_t> &candidates, size_t count,
+    metadata_placement_policy_t policy, bool dataitem) {
+    std::vector<uint64_t> chosen;
+    std::vector<size_t> remaining;
+    std::vector<double> load(candidates.size());
+    std::vector<uint64_t> bytes(candidates.size());
+    uint64_t maxBytes = 0;
+    steady_clock::time_point now = steady_clock::now();
+
+    pthread_mutex_lock(&placementLock);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        Memory_Server_Stats &stats = memoryServerStats[candidates[i]];
+        if (dataitem) {
+            double secs = duration<double>(now - stats.lastDecay).count();
+            stats.recentPlacements *= pow(0.5, secs);
+            stats.lastDecay = now;
+            load[i] = (double)stats.numDataitems + stats.recentPlacements;
+            bytes[i] = stats.allocatedBytes;
         } else {
-            if ((size /
-                     (region_span_size_per_memoryserver * memoryServerCount) <
-                 1)) {
-                unsigned int numServers =
-                    ((unsigned int)(size / region_span_size_per_memoryserver)) +
-                    ((size % region_span_size_per_memoryserver) == 0 ? 0 : 1);
-                while (i < numServers) {
-                    memsrv_list.push_back(
-                        (int)memoryServerList[id % memoryServerCount]);
-                    i++;
-                    id++;
-                }
-            } else {
-                while (i < (unsigned int)memoryServerCount) {
-                    memsrv_list.push_back(
-                        (int)memoryServerList[id % memoryServerCount]);
-                    i++;
-                    id++;
-                }
+            load[i] = (double)stats.reservedBytes;
+            bytes[i] = stats.reservedBytes;
+        }
+        maxBytes = std::max(maxBytes, bytes[i]);
+        remaining.push_back(i);
+    }
+
+    // Without a configured capacity, weigh memory servers by how far
+    // they are below the most used one
+    uint64_t capacity = memoryServerCapacity
+                            ? memoryServerCapacity
+                            : maxBytes + region_span_size_per_memoryserver;
+
+    while (chosen.size() < count && !remaining.empty()) {
+        size_t pick = 0;
+        size_t n = remaining.size();
+        double totalWeight = 0;
+        if (policy == META_PLACEMENT_CAPACITY_WEIGHTED) {
+            for (auto i : remaining)
+                totalWeight +=
+                    (double)(capacity > bytes[i] ? capacity - bytes[i] : 0);
+        }
+        if (totalWeight > 0) {
+            double r = totalWeight * ((double)rand() / RAND_MAX);
+            for (pick = 0; pick < n - 1; pick++) {
+                size_t i = remaining[pick];
+                r -= (double)(capacity > bytes[i] ? capacity - bytes[i] : 0);
+                if (r < 0)
+                    break;
+            }
+        } else if (policy == META_PLACEMENT_TWO_CHOICES && n > 1) {
+            size_t a = (size_t)rand() % n;
+            size_t b = (size_t)rand() % (n - 1);
+            if (b >= a)
+                b++;
+            pick = (load[remaining[a]] <= load[remaining[b]]) ? a : b;
+        } else {
+            // Least loaded; start at a random position so that ties do not
+            // always go to the same memory server
+            size_t start = (size_t)rand() % n;
+            pick = start;
+            for (size_t j = 1; j < n; j++) {
+                size_t k = (start + j) % n;
+                if (load[remaining[k]] < load[remaining[pick]])
+                    pick = k;
             }
         }
-    } else {
-        memsrv_list.push_back((int)memoryServerList[id]);
+        chosen.push_back(candidates[remaining[pick]]);
+        remaining.erase(remaining.begin() + pick);
+    }
+
+    if (dataitem) {
+        for (auto memsrvId : chosen)
+            memoryServerStats[memsrvId].recentPlacements += 1;
+    }
+    pthread_mutex_unlock(&placementLock);
+    return chosen;
+}
+
+/*
+ * select_dataitem_memory_server - Choose the memory server of the region on
+ * which a data item is allocated, with the placement policy of the region
+ * if it has one, else the configured one.
+ */
+uint64_t Fam_Metadata_Service_Direct::Impl_::select_dataitem_memory_server(
+    const Fam_Region_Metadata &region, const std::string &dataitemName) {
+    if (region.used_memsrv_cnt == 1)
+        return region.memServerIds[0];
+    metadata_placement_policy_t policy = placementPolicy;
+    if (region.placementPolicy > META_PLACEMENT_DEFAULT &&
+        region.placementPolicy <= META_PLACEMENT_TWO_CHOICES)
+        policy = (metadata_placement_policy_t)region.placementPolicy;
+    if (policy == META_PLACEMENT_HASH) {
+        uint64_t id;
+        if (!dataitemName.empty())
+            id = (std::hash<std::string>{}(dataitemName) %
+                  region.used_memsrv_cnt);
+        else
+            id = rand() % region.used_memsrv_cnt;
+        return region.memServerIds[id];
+    }
+    std::vector<uint64_t> candidates(region.memServerIds,
+                                     region.memServerIds +
+                                         region.used_memsrv_cnt);
+    return place(candidates, 1, policy, true)[0];
+}
+
+inline void update_placement_count(uint64_t &counter, uint64_t value,
+                                   bool add) {
+    if (add)
+        counter += value;
+    else
+        counter -= std::min(counter, value);
+}
+
+void Fam_Metadata_Service_Direct::Impl_::account_region(
+    const Fam_Region_Metadata &region, bool add) {
+    if (region.used_memsrv_cnt == 0)
+        return;
+    uint64_t share = region.size / region.used_memsrv_cnt;
+    pthread_mutex_lock(&placementLock);
+    for (uint64_t i = 0; i < region.used_memsrv_cnt; i++)
+        update_placement_count(
+            memoryServerStats[region.memServerIds[i]].reservedBytes, share,
+            add);
+    pthread_mutex_unlock(&placementLock);
+}
+
+void Fam_Metadata_Service_Direct::Impl_::account_dataitem(
+    const Fam_DataItem_Metadata &dataitem, bool add) {
+    uint64_t cnt = dataitem.interleaveSize ? dataitem.used_memsrv_cnt : 1;
+    if (cnt == 0)
+        return;
+    uint64_t share = dataitem.size / cnt;
+    pthread_mutex_lock(&placementLock);
+    for (uint64_t i = 0; i < cnt; i++) {
+        uint64_t memsrvId = dataitem.interleaveSize ? dataitem.memServerIds[i]
+                                                    : dataitem.memoryServerId;
+        Memory_Server_Stats &stats = memoryServerStats[memsrvId];
+        update_placement_count(stats.allocatedBytes, share, add);
+        update_placement_count(stats.numDataitems, 1, add);
+        auto &usage = regionUsage[{ dataitem.regionId, memsrvId }];
+        update_placement_count(usage.first, share, add);
+        update_placement_count(usage.second, 1, add);
+    }
+    pthread_mutex_unlock(&placementLock);
+}
+
+/*
+ * release_region_dataitems - Remove the data items of a deleted region from
+ * the placement statistics.
+ */
+void Fam_Metadata_Service_Direct::Impl_::release_region_dataitems(
+    const uint64_t regionId) {
+    pthread_mutex_lock(&placementLock);
+    auto it = regionUsage.lower_bound({ regionId, 0 });
+    while (it != regionUsage.end() && it->first.first == regionId) {
+        Memory_Server_Stats &stats = memoryServerStats[it->first.second];
+        update_placement_count(stats.allocatedBytes, it->second.first, false);
+        update_placement_count(stats.numDataitems, it->second.second, false);
+        it = regionUsage.erase(it);
+    }
+    pthread_mutex_unlock(&placementLock);
+}
+
+/*
+ * for_each_metadata_record - Call fn with the value of each record of a
+ * region or dataitem id KVS tree, in id order.
+ */
+template <typename Fn>
+static void for_each_metadata_record(KeyValueStore *kvs, Fn fn) {
+    std::string firstKey = metadata_key(0);
+    std::string lastKey = metadata_key(UINT64_MAX);
+    char key_buf[RadixTree::MAX_KEY_LEN];
+    char val_buf[max_val_len];
+    size_t key_len = sizeof(key_buf);
+    size_t val_len = max_val_len;
+    int iter;
+    int ret = kvs->Scan(iter, key_buf, key_len, val_buf, val_len,
+                        firstKey.c_str(), firstKey.size(), true,
+                        lastKey.c_str(), lastKey.size(), true);
+    while (ret == META_NO_ERROR) {
+        fn(val_buf, val_len);
+        key_len = sizeof(key_buf);
+        val_len = max_val_len;
+        ret = kvs->GetNext(iter, key_buf, key_len, val_buf, val_len);
+    }
+}
+
+/*
+ * rebuild_placement_stats - Account the regions and data items found in the
+ * metadata KVS trees, so that placement decisions made after a restart see
+ * the memory already in use.
+ */
+void Fam_Metadata_Service_Direct::Impl_::rebuild_placement_stats() {
+    std::vector<uint64_t> regionIds;
+    for_each_metadata_record(regionIdKVS, [&](const char *val, size_t len) {
+        Fam_Region_Metadata region;
+        decode_region(val, len, region);
+        account_region(region, true);
+        regionIds.push_back(region.regionId);
+    });
+
+    for (auto regionId : regionIds) {
+        KeyValueStore *dataitemIdKVS, *dataitemNameKVS;
+        pthread_rwlock_t *kvsLock;
+        if (get_dataitem_KVS(regionId, dataitemIdKVS, dataitemNameKVS,
+                             &kvsLock) != META_NO_ERROR) {
+            release_kvs_lock(kvsLock);
+            DEBUG_STDERR(regionId, "Dataitem KVS not found, not accounted");
+            continue;
+        }
+        for_each_metadata_record(dataitemIdKVS,
+                                 [&](const char *val, size_t len) {
+                                     Fam_DataItem_Metadata dataitem;
+                                     decode_dataitem(val, len, dataitem);
+                                     account_dataitem(dataitem, true);
+                                 });
+        release_kvs_lock(kvsLock);
     }
-    return memsrv_list;
 }
 
 std::list<int>
@@ -2630,13 +3411,17 @@ Fam_Metadata_Service_Direct::Impl_::get_memory_server_list(uint64_t regionId) {
     return memsrv_list;
 }
 
-Fam_Metadata_Service_Direct::Fam_Metadata_Service_Direct(bool use_meta_reg) {
+Fam_Metadata_Service_Direct::Fam_Metadata_Service_Direct(bool use_meta_reg,
+                                                         bool enable_cache) {
     // Look for options information from config file.
     // Use config file options only if NULL is passed.
     std::string config_file_path;
     configFileParams config_options;
     bool enable_region_spanning;
     size_t region_span_size_per_memoryserver;
+    size_t cache_size = 0;
+    metadata_placement_policy_t placement_policy;
+    size_t memory_server_capacity;
 
     // Check for config file in or in path mentioned
     // by OPENFAM_ROOT environment variable or in /opt/OpenFAM.
@@ -2659,8 +3444,26 @@ Fam_Metadata_Service_Direct::Fam_Metadata_Service_Direct(bool use_meta_reg) {
         atoi((const char *)(config_options["region_span_size_per_memoryserver"]
                                 .c_str()));
 
+    if (enable_cache) {
+        cache_size =
+            strtoul(config_options["metadata_cache_size"].c_str(), NULL, 0);
+    }
+
+    if (config_options["placement_policy"] == "hash") {
+        placement_policy = META_PLACEMENT_HASH;
+    } else if (config_options["placement_policy"] == "capacity_weighted") {
+        placement_policy = META_PLACEMENT_CAPACITY_WEIGHTED;
+    } else if (config_options["placement_policy"] == "two_choices") {
+        placement_policy = META_PLACEMENT_TWO_CHOICES;
+    } else {
+        placement_policy = META_PLACEMENT_LEAST_LOADED;
+    }
+    memory_server_capacity =
+        strtoul(config_options["memory_server_capacity"].c_str(), NULL, 0);
+
     Start(use_meta_reg, enable_region_spanning,
-          region_span_size_per_memoryserver);
+          region_span_size_per_memoryserver, cache_size, placement_policy,
+          memory_server_capacity);
 }
 
 Fam_Metadata_Service_Direct::~Fam_Metadata_Service_Direct() { Stop(); }
@@ -2675,7 +3478,10 @@ void Fam_Metadata_Service_Direct::Stop() {
 void
 Fam_Metadata_Service_Direct::Start(bool use_meta_reg,
                                    bool enable_region_spanning,
-                                   size_t region_span_size_per_memoryserver) {
+                                   size_t region_span_size_per_memoryserver,
+                                   size_t cache_size,
+                                   metadata_placement_policy_t placement_policy,
+                                   size_t memory_server_capacity) {
 
     MEMSERVER_PROFILE_INIT(METADATA_DIRECT)
     MEMSERVER_PROFILE_START_TIME(METADATA_DIRECT)
@@ -2683,7 +3489,8 @@ Fam_Metadata_Service_Direct::Start(bool use_meta_reg,
     pimpl_ = new Impl_;
     assert(pimpl_);
     int ret = pimpl_->Init(use_meta_reg, enable_region_spanning,
-                           region_span_size_per_memoryserver);
+                           region_span_size_per_memoryserver, cache_size,
+                           placement_policy, memory_server_capacity);
     assert(ret == META_NO_ERROR);
 }
 
@@ -2879,8 +3686,8 @@ void Fam_Metadata_Service_Direct::metadata_modify_dataitem(
 }
 
 bool Fam_Metadata_Service_Direct::metadata_check_permissions(
-    Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_DataItem_Metadata *dataitem, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
     bool ret;
     METADATA_DIRECT_PROFILE_START_OPS()
     ret = pimpl_->metadata_check_permissions(dataitem, op, uid, gid);
@@ -2889,8 +3696,8 @@ bool Fam_Metadata_Service_Direct::metadata_check_permissions(
 }
 
 bool Fam_Metadata_Service_Direct::metadata_check_permissions(
-    Fam_Region_Metadata *region, metadata_region_item_op_t op, uint32_t uid,
-    uint32_t gid) {
+    const Fam_Region_Metadata *region, metadata_region_item_op_t op,
+    uint32_t uid, uint32_t gid) {
     bool ret;
     METADATA_DIRECT_PROFILE_START_OPS()
     ret = pimpl_->metadata_check_permissions(region, op, uid, gid);
@@ -2953,6 +3760,30 @@ Fam_Metadata_Service_Direct::get_config_info(std::string filename) {
             options["region_span_size_per_memoryserver"] =
                 (char *)strdup("1073741824");
         }
+        try {
+            options["metadata_cache_size"] = (char *)strdup(
+                (info->get_key_value("metadata_cache_size")).c_str());
+        }
+        catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["metadata_cache_size"] = (char *)strdup("65536");
+        }
+        try {
+            options["placement_policy"] = (char *)strdup(
+                (info->get_key_value("placement_policy")).c_str());
+        }
+        catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["placement_policy"] = (char *)strdup("least_loaded");
+        }
+        try {
+            options["memory_server_capacity"] = (char *)strdup(
+                (info->get_key_value("memory_server_capacity")).c_str());
+        }
+        catch (Fam_InvalidOption_Exception e) {
+            // If parameter is not present, then set the default.
+            options["memory_server_capacity"] = (char *)strdup("0");
+        }
     }
     return options;
 }
@@ -3001,10 +3832,10 @@ void Fam_Metadata_Service_Direct::metadata_validate_and_allocate_dataitem(
 
 void Fam_Metadata_Service_Direct::metadata_validate_and_deallocate_dataitem(
     const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
-    uint32_t gid) {
+    uint32_t gid, Fam_DataItem_Metadata &dataitem) {
     METADATA_DIRECT_PROFILE_START_OPS()
     pimpl_->metadata_validate_and_deallocate_dataitem(regionId, dataitemId, uid,
-                                                      gid);
+                                                      gid, dataitem);
     METADATA_DIRECT_PROFILE_END_OPS(
         direct_metadata_validate_and_deallocate_dataitem);
 }
@@ -3051,6 +3882,49 @@ void Fam_Metadata_Service_Direct::metadata_find_dataitem_and_check_permissions(
         direct_metadata_find_dataitem_and_check_permissions);
 }
 
+void Fam_Metadata_Service_Direct::metadata_validate_and_allocate_dataitem_batch(
+    const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+    uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds) {
+    METADATA_DIRECT_PROFILE_START_OPS()
+    pimpl_->metadata_validate_and_allocate_dataitem_batch(
+        dataitemNames, regionId, uid, gid, memoryServerIds);
+    METADATA_DIRECT_PROFILE_END_OPS(
+        direct_metadata_validate_and_allocate_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Direct::metadata_insert_dataitem_batch(
+    const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+    std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_DIRECT_PROFILE_START_OPS()
+    pimpl_->metadata_insert_dataitem_batch(dataitemIds, regionId, dataitems);
+    METADATA_DIRECT_PROFILE_END_OPS(direct_metadata_insert_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Direct::
+    metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_DIRECT_PROFILE_START_OPS()
+    pimpl_->metadata_validate_and_deallocate_dataitem_batch(
+        regionId, dataitemIds, uid, gid, dataitems);
+    METADATA_DIRECT_PROFILE_END_OPS(
+        direct_metadata_validate_and_deallocate_dataitem_batch);
+}
+
+void Fam_Metadata_Service_Direct::
+    metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems) {
+    METADATA_DIRECT_PROFILE_START_OPS()
+    pimpl_->metadata_find_dataitem_and_check_permissions_batch(
+        op, dataitemNames, regionName, uid, gid, dataitems);
+    METADATA_DIRECT_PROFILE_END_OPS(
+        direct_metadata_find_dataitem_and_check_permissions_batch);
+}
+
 std::list<int>
 Fam_Metadata_Service_Direct::get_memory_server_list(uint64_t regionId) {
     std::list<int> memServerList;
@@ -60,7 +60,10 @@ namespace metadata {
 class Fam_Metadata_Service_Direct : public Fam_Metadata_Service {
   public:
     void Start(bool use_meta_reg, bool enable_region_spanning,
-               size_t size_per_memoryserver);
+               size_t size_per_memoryserver, size_t cache_size = 0,
+               metadata_placement_policy_t placement_policy =
+                   META_PLACEMENT_LEAST_LOADED,
+               size_t memory_server_capacity = 0);
     void Stop();
 
     void reset_profile();
@@ -128,11 +131,11 @@ class Fam_Metadata_Service_Direct : public Fam_Metadata_Service {
                                   const std::string regionName,
                                   Fam_DataItem_Metadata *dataitem);
 
-    bool metadata_check_permissions(Fam_DataItem_Metadata *dataitem,
+    bool metadata_check_permissions(const Fam_DataItem_Metadata *dataitem,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
 
-    bool metadata_check_permissions(Fam_Region_Metadata *region,
+    bool metadata_check_permissions(const Fam_Region_Metadata *region,
                                     metadata_region_item_op_t op, uint32_t uid,
                                     uint32_t gid);
     size_t metadata_maxkeylen();
@@ -153,9 +156,9 @@ class Fam_Metadata_Service_Direct : public Fam_Metadata_Service {
                                                  uint32_t uid, uint32_t gid,
                                                  uint64_t *memoryServerId);
 
-    void metadata_validate_and_deallocate_dataitem(const uint64_t regionId,
-                                                   const uint64_t dataitemId,
-                                                   uint32_t uid, uint32_t gid);
+    void metadata_validate_and_deallocate_dataitem(
+        const uint64_t regionId, const uint64_t dataitemId, uint32_t uid,
+        uint32_t gid, Fam_DataItem_Metadata &dataitem);
     void metadata_find_region_and_check_permissions(
         metadata_region_item_op_t op, const uint64_t regionId, uint32_t uid,
         uint32_t gid, Fam_Region_Metadata &region);
@@ -174,9 +177,34 @@ class Fam_Metadata_Service_Direct : public Fam_Metadata_Service {
         const std::string regionName, uint32_t uid, uint32_t gid,
         Fam_DataItem_Metadata &dataitem);
 
+    void metadata_validate_and_allocate_dataitem_batch(
+        const std::vector<std::string> &dataitemNames, const uint64_t regionId,
+        uint32_t uid, uint32_t gid, std::vector<uint64_t> &memoryServerIds);
+
+    void metadata_insert_dataitem_batch(
+        const std::vector<uint64_t> &dataitemIds, const uint64_t regionId,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_validate_and_deallocate_dataitem_batch(
+        const uint64_t regionId, const std::vector<uint64_t> &dataitemIds,
+        uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
+    void metadata_find_dataitem_and_check_permissions_batch(
+        metadata_region_item_op_t op,
+        const std::vector<std::string> &dataitemNames,
+        const std::string regionName, uint32_t uid, uint32_t gid,
+        std::vector<Fam_DataItem_Metadata> &dataitems);
+
     std::list<int> get_memory_server_list(uint64_t regionId);
 
-    Fam_Metadata_Service_Direct(bool use_meta_reg = 0);
+    /**
+     * @param use_meta_reg - keep dataitem KVS trees in the metadata heap
+     * @param enable_cache - cache region and dataitem records in memory;
+     * only valid if this is the only instance accessing the metadata KVS
+     */
+    Fam_Metadata_Service_Direct(bool use_meta_reg = 0,
+                                bool enable_cache = false);
     void metadata_reset_bitmap(uint64_t regionID);
     ~Fam_Metadata_Service_Direct();
 
@@ -35,6 +35,8 @@
 #include "common/fam_config_info.h"
 #include "common/fam_memserver_profile.h"
 
+#include <algorithm>
+
 namespace metadata {
 MEMSERVER_PROFILE_START(METADATA_SERVER)
 #ifdef MEMSERVER_PROFILE
@@ -69,10 +71,40 @@ void metadata_server_profile_dump() {
     MEMSERVER_DUMP_PROFILE_SUMMARY(METADATA_SERVER)
 }
 
+/*
+ * Copy the interleave layout of a dataitem from the request message.
+ */
+static void get_interleave_info(const ::Fam_Metadata_Request *request,
+                                Fam_DataItem_Metadata *dataitem) {
+    int cnt = std::min(request->memsrv_list_size(),
+                       request->offset_list_size());
+    cnt = std::min(cnt, MAX_INTERLEAVE_MEMSERVERS_CNT);
+    dataitem->interleaveSize = request->interleave_size();
+    dataitem->used_memsrv_cnt = (uint64_t)cnt;
+    for (int i = 0; i < cnt; i++) {
+        dataitem->memServerIds[i] = request->memsrv_list(i);
+        dataitem->offsets[i] = request->offset_list(i);
+    }
+}
+
+/*
+ * Copy the interleave layout of a dataitem to the response message.
+ */
+static void set_interleave_info(::Fam_Metadata_Response *response,
+                                Fam_DataItem_Metadata &dataitem) {
+    response->set_interleave_size(dataitem.interleaveSize);
+    for (uint64_t i = 0; i < dataitem.used_memsrv_cnt; i++) {
+        response->add_memsrv_list(dataitem.memServerIds[i]);
+        response->add_offset_list(dataitem.offsets[i]);
+    }
+}
+
 Fam_Metadata_Service_Server::Fam_Metadata_Service_Server(uint64_t rpcPort,
                                                          char *name)
     : serverAddress(name), port(rpcPort) {
-    metadataService = new Fam_Metadata_Service_Direct();
+    // The metadata server is the only user of its metadata KVS, so the
+    // records can be cached
+    metadataService = new Fam_Metadata_Service_Direct(false, true);
     numClients = 0;
     MEMSERVER_PROFILE_INIT(METADATA_SERVER)
     MEMSERVER_PROFILE_START_TIME(METADATA_SERVER)
@@ -99,23 +131,69 @@ Fam_Metadata_Service_Server::~Fam_Metadata_Service_Server() {
     return ::grpc::Status::OK;
 }
 
-void Fam_Metadata_Service_Server::run() {
+void Fam_Metadata_Service_Server::run(
+    const Fam_Async_Rpc_Options &rpcOptions) {
     char address[ADDR_SIZE + sizeof(uint64_t)];
     sprintf(address, "%s:%lu", serverAddress, port);
     std::string serverAddress(address);
 
-    ::grpc::ServerBuilder builder;
-    // Listen on the given address without any authentication mechanism.
-    builder.AddListeningPort(serverAddress, grpc::InsecureServerCredentials());
-    // Register "service" as the instance through which we'll communicate
-    // with clients. In this case it corresponds to an *synchronous*
-    // service.
-    builder.RegisterService(this);
-
-    // Finally assemble the server.
-    server = builder.BuildAndStart();
-
-    server->Wait();
+    // Every method is served from the completion queues; region creation,
+    // destruction and the batch calls run on the long method pool so they
+    // do not delay the short lookups.
+    typedef Fam_Metadata_Service_Server S;
+    Fam_Async_Rpc_Server<S> rpcServer(this, rpcOptions);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, signal_start, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, signal_termination, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_insert_region, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_delete_region, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_find_region, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_modify_region, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_insert_dataitem,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_delete_dataitem,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_find_dataitem, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_modify_dataitem,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_check_region_permissions,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_check_item_permissions,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_maxkeylen, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, reset_profile, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, dump_profile, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_update_memoryserver,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_reset_bitmap, FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_validate_and_create_region,
+                         FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_validate_and_destroy_region,
+                         FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_validate_and_allocate_dataitem,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_validate_and_deallocate_dataitem,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_find_region_and_check_permissions,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_find_dataitem_and_check_permissions,
+                         FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, get_memory_server_list, FAM_RPC_INLINE);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_validate_and_allocate_dataitem_batch,
+                         FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S, metadata_insert_dataitem_batch,
+                         FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_validate_and_deallocate_dataitem_batch,
+                         FAM_RPC_LONG);
+    FAM_ASYNC_RPC_METHOD(rpcServer, S,
+                         metadata_find_dataitem_and_check_permissions_batch,
+                         FAM_RPC_LONG);
+
+    rpcServer.run(serverAddress);
 }
 
 ::grpc::Status Fam_Metadata_Service_Server::signal_start(
@@ -147,6 +225,7 @@ void Fam_Metadata_Service_Server::run() {
     region->uid = request->uid();
     region->gid = request->gid();
     region->used_memsrv_cnt = request->memsrv_cnt();
+    region->placementPolicy = request->user_policy();
     for (int ndx = 0; ndx < (int)region->used_memsrv_cnt; ndx++) {
         region->memServerIds[ndx] = request->memsrv_list(ndx);
     }
@@ -210,6 +289,7 @@ void Fam_Metadata_Service_Server::run() {
         response->set_gid(region.gid);
         response->set_maxkeylen(metadataService->metadata_maxkeylen());
         response->set_memsrv_cnt(region.used_memsrv_cnt);
+        response->set_user_policy(region.placementPolicy);
 
         for (int id = 0; id < (int)region.used_memsrv_cnt; ++id) {
             response->add_memsrv_list(region.memServerIds[id]);
@@ -234,6 +314,7 @@ void Fam_Metadata_Service_Server::run() {
     region->uid = request->uid();
     region->gid = request->gid();
     region->used_memsrv_cnt = request->memsrv_cnt();
+    region->placementPolicy = request->user_policy();
     for (int id = 0; id < (int)region->used_memsrv_cnt; ++id) {
         region->memServerIds[id] = request->memsrv_list(id);
     }
@@ -267,6 +348,7 @@ void Fam_Metadata_Service_Server::run() {
     dataitem->uid = request->uid();
     dataitem->gid = request->gid();
     dataitem->memoryServerId = request->memsrv_id();
+    get_interleave_info(request, dataitem);
 
     try {
         if (request->has_key_region_id())
@@ -354,6 +436,7 @@ void Fam_Metadata_Service_Server::run() {
         response->set_gid(dataitem.gid);
         response->set_maxkeylen(metadataService->metadata_maxkeylen());
         response->set_memsrv_id(dataitem.memoryServerId);
+        set_interleave_info(response, dataitem);
     }
     METADATA_SERVER_PROFILE_END_OPS(server_metadata_find_dataitem);
     return ::grpc::Status::OK;
@@ -373,6 +456,7 @@ void Fam_Metadata_Service_Server::run() {
     dataitem->uid = request->uid();
     dataitem->gid = request->gid();
     dataitem->memoryServerId = request->memsrv_id();
+    get_interleave_info(request, dataitem);
     try {
         if (request->has_key_dataitem_id() && request->has_key_region_id()) {
             metadataService->metadata_modify_dataitem(
@@ -563,16 +647,22 @@ Fam_Metadata_Service_Server::metadata_validate_and_deallocate_dataitem(
     ::grpc::ServerContext *context, const ::Fam_Metadata_Request *request,
     ::Fam_Metadata_Response *response) {
     METADATA_SERVER_PROFILE_START_OPS();
+    Fam_DataItem_Metadata dataitem;
 
     try {
         metadataService->metadata_validate_and_deallocate_dataitem(
             request->region_id(), request->key_dataitem_id(), request->uid(),
-            request->gid());
+            request->gid(), dataitem);
     } catch (Fam_Exception &e) {
         response->set_errorcode(e.fam_error());
         response->set_errormsg(e.fam_error_msg());
         return ::grpc::Status::OK;
     }
+    response->set_region_id(dataitem.regionId);
+    response->set_offset(dataitem.offset);
+    response->set_size(dataitem.size);
+    response->set_memsrv_id(dataitem.memoryServerId);
+    set_interleave_info(response, dataitem);
 
     METADATA_SERVER_PROFILE_END_OPS(
         server_metadata_validate_and_deallocate_dataitem);
@@ -611,6 +701,7 @@ Fam_Metadata_Service_Server::metadata_find_region_and_check_permissions(
     response->set_gid(region.gid);
     response->set_maxkeylen(metadataService->metadata_maxkeylen());
     response->set_memsrv_cnt(region.used_memsrv_cnt);
+    response->set_user_policy(region.placementPolicy);
 
     for (int id = 0; id < (int)region.used_memsrv_cnt; ++id) {
         response->add_memsrv_list(region.memServerIds[id]);
@@ -653,6 +744,7 @@ Fam_Metadata_Service_Server::metadata_find_dataitem_and_check_permissions(
     response->set_gid(dataitem.gid);
     response->set_maxkeylen(metadataService->metadata_maxkeylen());
     response->set_memsrv_id(dataitem.memoryServerId);
+    set_interleave_info(response, dataitem);
 
     METADATA_SERVER_PROFILE_END_OPS(
         server_metadata_find_dataitem_and_check_permissions);
@@ -680,4 +772,133 @@ Fam_Metadata_Service_Server::metadata_find_dataitem_and_check_permissions(
     return ::grpc::Status::OK;
 }
 
+::grpc::Status
+Fam_Metadata_Service_Server::metadata_validate_and_allocate_dataitem_batch(
+    ::grpc::ServerContext *context, const ::Fam_Metadata_Batch_Request *request,
+    ::Fam_Metadata_Batch_Response *response) {
+    METADATA_SERVER_PROFILE_START_OPS();
+    std::vector<std::string> dataitemNames;
+    std::vector<uint64_t> memoryServerIds;
+    for (auto &item : request->items())
+        dataitemNames.push_back(item.key_dataitem_name());
+    try {
+        metadataService->metadata_validate_and_allocate_dataitem_batch(
+            dataitemNames, request->region_id(), request->uid(),
+            request->gid(), memoryServerIds);
+    } catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    for (auto memoryServerId : memoryServerIds)
+        response->add_items()->set_memsrv_id(memoryServerId);
+
+    METADATA_SERVER_PROFILE_END_OPS(
+        server_metadata_validate_and_allocate_dataitem_batch);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status Fam_Metadata_Service_Server::metadata_insert_dataitem_batch(
+    ::grpc::ServerContext *context, const ::Fam_Metadata_Batch_Request *request,
+    ::Fam_Metadata_Batch_Response *response) {
+    METADATA_SERVER_PROFILE_START_OPS();
+    std::vector<uint64_t> dataitemIds;
+    std::vector<Fam_DataItem_Metadata> dataitems(request->items_size());
+    for (int i = 0; i < request->items_size(); i++) {
+        const ::Fam_Metadata_Request &item = request->items(i);
+        Fam_DataItem_Metadata *dataitem = &dataitems[i];
+        dataitemIds.push_back(item.key_dataitem_id());
+        dataitem->regionId = item.region_id();
+        strncpy(dataitem->name, item.name().c_str(),
+                metadataService->metadata_maxkeylen());
+        dataitem->offset = item.offset();
+        dataitem->size = item.size();
+        dataitem->perm = (mode_t)item.perm();
+        dataitem->uid = item.uid();
+        dataitem->gid = item.gid();
+        dataitem->memoryServerId = item.memsrv_id();
+        get_interleave_info(&item, dataitem);
+    }
+    try {
+        metadataService->metadata_insert_dataitem_batch(
+            dataitemIds, request->region_id(), dataitems);
+    } catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    METADATA_SERVER_PROFILE_END_OPS(server_metadata_insert_dataitem_batch);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_Metadata_Service_Server::metadata_validate_and_deallocate_dataitem_batch(
+    ::grpc::ServerContext *context, const ::Fam_Metadata_Batch_Request *request,
+    ::Fam_Metadata_Batch_Response *response) {
+    METADATA_SERVER_PROFILE_START_OPS();
+    std::vector<uint64_t> dataitemIds;
+    std::vector<Fam_DataItem_Metadata> dataitems;
+    for (auto &item : request->items())
+        dataitemIds.push_back(item.key_dataitem_id());
+    try {
+        metadataService->metadata_validate_and_deallocate_dataitem_batch(
+            request->region_id(), dataitemIds, request->uid(), request->gid(),
+            dataitems);
+    } catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    for (auto &dataitem : dataitems) {
+        ::Fam_Metadata_Response *item = response->add_items();
+        item->set_region_id(dataitem.regionId);
+        item->set_offset(dataitem.offset);
+        item->set_size(dataitem.size);
+        item->set_memsrv_id(dataitem.memoryServerId);
+        set_interleave_info(item, dataitem);
+    }
+
+    METADATA_SERVER_PROFILE_END_OPS(
+        server_metadata_validate_and_deallocate_dataitem_batch);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_Metadata_Service_Server::metadata_find_dataitem_and_check_permissions_batch(
+    ::grpc::ServerContext *context, const ::Fam_Metadata_Batch_Request *request,
+    ::Fam_Metadata_Batch_Response *response) {
+    METADATA_SERVER_PROFILE_START_OPS();
+    std::vector<std::string> dataitemNames;
+    std::vector<Fam_DataItem_Metadata> dataitems;
+    for (auto &item : request->items())
+        dataitemNames.push_back(item.key_dataitem_name());
+    try {
+        metadataService->metadata_find_dataitem_and_check_permissions_batch(
+            (metadata_region_item_op_t)request->op(), dataitemNames,
+            request->region_name(), request->uid(), request->gid(), dataitems);
+    } catch (Fam_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    size_t maxKeyLen = metadataService->metadata_maxkeylen();
+    for (auto &dataitem : dataitems) {
+        ::Fam_Metadata_Response *item = response->add_items();
+        item->set_region_id(dataitem.regionId);
+        item->set_name(dataitem.name);
+        item->set_offset(dataitem.offset);
+        item->set_size(dataitem.size);
+        item->set_perm(dataitem.perm);
+        item->set_uid(dataitem.uid);
+        item->set_gid(dataitem.gid);
+        item->set_maxkeylen(maxKeyLen);
+        item->set_memsrv_id(dataitem.memoryServerId);
+        set_interleave_info(item, dataitem);
+    }
+
+    METADATA_SERVER_PROFILE_END_OPS(
+        server_metadata_find_dataitem_and_check_permissions_batch);
+    return ::grpc::Status::OK;
+}
+
 } // namespace metadata
@@ -41,6 +41,8 @@
 #include "fam_metadata_rpc.grpc.pb.h"
 #include "fam_metadata_service_direct.h"
 
+#include "common/fam_async_rpc_server.h"
+
 using namespace openfam;
 
 namespace metadata {
@@ -52,13 +54,13 @@ using grpc::ServerCompletionQueue;
 using grpc::ServerContext;
 using grpc::Status;
 
-class Fam_Metadata_Service_Server : public Fam_Metadata_Rpc::Service {
+class Fam_Metadata_Service_Server : public Fam_Metadata_Rpc::AsyncService {
   public:
     Fam_Metadata_Service_Server(uint64_t rpcPort, char *name);
 
     ~Fam_Metadata_Service_Server();
 
-    void run();
+    void run(const Fam_Async_Rpc_Options &rpcOptions);
 
     ::grpc::Status signal_start(::grpc::ServerContext *context,
                                 const ::Fam_Metadata_Gen_Request *request,
@@ -169,12 +171,31 @@ class Fam_Metadata_Service_Server : public Fam_Metadata_Rpc::Service {
         ::grpc::ServerContext *context, const ::Fam_Metadata_Request *request,
         ::Fam_Metadata_Region_Info_Response *response) override;
 
+    ::grpc::Status metadata_validate_and_allocate_dataitem_batch(
+        ::grpc::ServerContext *context,
+        const ::Fam_Metadata_Batch_Request *request,
+        ::Fam_Metadata_Batch_Response *response) override;
+
+    ::grpc::Status metadata_insert_dataitem_batch(
+        ::grpc::ServerContext *context,
+        const ::Fam_Metadata_Batch_Request *request,
+        ::Fam_Metadata_Batch_Response *response) override;
+
+    ::grpc::Status metadata_validate_and_deallocate_dataitem_batch(
+        ::grpc::ServerContext *context,
+        const ::Fam_Metadata_Batch_Request *request,
+        ::Fam_Metadata_Batch_Response *response) override;
+
+    ::grpc::Status metadata_find_dataitem_and_check_permissions_batch(
+        ::grpc::ServerContext *context,
+        const ::Fam_Metadata_Batch_Request *request,
+        ::Fam_Metadata_Batch_Response *response) override;
+
   private:
     char *serverAddress;
     uint64_t port;
     int numClients;
     Fam_Metadata_Rpc::Service *service;
-    std::unique_ptr<Server> server;
     Fam_Metadata_Service_Direct *metadataService;
 };
 
@@ -177,6 +177,32 @@ int main(int argc, char *argv[]) {
         fail++;
     }
 
+    // Reserve every free bit with the summary level enabled, then check
+    // that a freed bit is found again.
+    if (bitmap_enable_summary(bmap)) {
+        cout << "bitmap summary allocation failed" << endl;
+        fail++;
+    }
+    for (i = 0; i < 64 * 10; i++) {
+        if (!bitmap_get(bmap, i) &&
+            (pos = bitmap_find_and_reserve(bmap, 0, 0)) != (int64_t)i) {
+            cout << "Expected reserve at " << i << ", but got at " << pos
+                 << endl;
+            fail++;
+        }
+    }
+    pos = bitmap_find_and_reserve(bmap, 0, 0);
+    if (pos != -1) {
+        cout << "Expected full bitmap, but got free bit at " << pos << endl;
+        fail++;
+    }
+    bitmap_reset(bmap, 300);
+    pos = bitmap_find_and_reserve(bmap, 0, 0);
+    if (pos != 300) {
+        cout << "Expected reserve at 300, but got at " << pos << endl;
+        fail++;
+    }
+
     cout << "Test completed" << endl;
 
     if (fail != 0) {
@@ -0,0 +1,99 @@
+/*
+ *   fam_atl_batch_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+
+/* Test Case Description: a get which follows a put on the same ATL queue
+ * is not taken into the batch of the put, so that it reads the data the
+ * put wrote.
+ */
+#include "common/atomic_queue.h"
+
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+int main() {
+    atomicMsg put, eagerPut, get, scatter, gather;
+    memset(&put, 0, sizeof(put));
+    memset(&eagerPut, 0, sizeof(eagerPut));
+    memset(&get, 0, sizeof(get));
+    memset(&scatter, 0, sizeof(scatter));
+    memset(&gather, 0, sizeof(gather));
+    put.flag = ATOMIC_WRITE;
+    eagerPut.flag = ATOMIC_WRITE | ATOMIC_CONTAIN_DATA;
+    get.flag = ATOMIC_READ;
+    scatter.flag = ATOMIC_SCATTER_INDEX;
+    gather.flag = ATOMIC_GATHER_STRIDE;
+
+    // Put then get : the get starts the next batch
+    atomicMsg *putGet[] = {&put, &get};
+    CHECK(atl_batch_size(putGet, 2) == 1);
+    atomicMsg *eagerPutGet[] = {&eagerPut, &put, &get, &put};
+    CHECK(atl_batch_size(eagerPutGet, 4) == 2);
+    atomicMsg *scatterGather[] = {&gather, &scatter, &gather};
+    CHECK(atl_batch_size(scatterGather, 3) == 2);
+
+    // Get then put, and puts only, go together
+    atomicMsg *getPut[] = {&get, &gather, &put, &scatter};
+    CHECK(atl_batch_size(getPut, 4) == 4);
+    atomicMsg *writes[] = {&put, &eagerPut, &scatter};
+    CHECK(atl_batch_size(writes, 3) == 3);
+
+    // A put already applied, or already done, does not hold back the get
+    put.flag |= ATOMIC_WRITE_COMPLETED;
+    CHECK(atl_batch_size(putGet, 2) == 2);
+    put.flag = ATOMIC_WRITE | ATOMIC_REQUEST_DONE;
+    CHECK(atl_batch_size(putGet, 2) == 2);
+
+    CHECK(atl_batch_size(putGet, 0) == 0);
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_atl_batch_test passed" << endl;
+    return 0;
+}
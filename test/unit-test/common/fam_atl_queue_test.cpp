@@ -0,0 +1,205 @@
+/*
+ *   fam_atl_queue_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+
+/* Test Case Description: the requests of an ATL queue keep their order
+ * when its ring wraps around and when it is opened again, a request whose
+ * push did not complete is dropped when the queue is opened, and a queue of
+ * the layout before the ring is recovered before it is replaced.
+ */
+#include "common/atomic_queue.h"
+
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+// Last queue of the ATL region, which a memory server with fewer processing
+// threads does not use
+#define TEST_QID (MAX_ATOMIC_THREADS - 1)
+#define TEST_CAPACITY 4
+
+static Memserver_Allocator *alloc;
+
+// Request index places after the head of the queue, NULL if there is none
+static atomicMsg *get_msg(atomicQueue *queue, uint32_t index) {
+    Fam_Global_Descriptor item;
+    if (queue->read(&item, index) == ATOMIC_QUEUE_EMPTY)
+        return NULL;
+    return (atomicMsg *)alloc->get_local_pointer(item.regionId, item.offset);
+}
+
+// Push a read request, tagged with its number in its offset
+static int push_read(atomicQueue *queue, uint64_t tag) {
+    atomicMsg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.flag = ATOMIC_READ;
+    msg.offset = tag;
+    return queue->push(&msg, NULL);
+}
+
+static atomicQueue *open_queue() {
+    atomicQueue *queue = new atomicQueue();
+    CHECK(queue->create(alloc, TEST_QID) == 0);
+    return queue;
+}
+
+int main() {
+    alloc = new Memserver_Allocator(0, "");
+    alloc->create_ATL_root(MIN_REGION_SIZE);
+    queueCapacity = TEST_CAPACITY;
+    slotPayloadSize = MAX_DATA_IN_MSG;
+    memoryPerThread = 0;
+    uint64_t *rootEntry = (uint64_t *)atomicRegionIdRoot + TEST_QID;
+
+    // Start from a new ring
+    *rootEntry = 0;
+    atomicQueue *queue = open_queue();
+
+    // Keep the queue almost full while the ring wraps around several times
+    uint64_t pushed = 0, popped = 0;
+    for (int i = 0; i < 3 * TEST_CAPACITY; i++) {
+        while (pushed - popped < TEST_CAPACITY - 1)
+            CHECK(push_read(queue, pushed++) == 0);
+        atomicMsg *msgPointer = get_msg(queue, 0);
+        CHECK(msgPointer && (msgPointer->offset == popped));
+        CHECK(queue->pop() == 0);
+        popped++;
+    }
+    CHECK(push_read(queue, pushed++) == 0);
+    CHECK(push_read(queue, pushed) == ATL_QUEUE_FULL);
+    for (uint32_t i = 0; i < TEST_CAPACITY; i++) {
+        atomicMsg *msgPointer = get_msg(queue, i);
+        CHECK(msgPointer && (msgPointer->offset == popped + i));
+    }
+    CHECK(get_msg(queue, TEST_CAPACITY) == NULL);
+
+    // The queue is found again, in order, when it is opened again
+    CHECK(queue->pop(2) == 0);
+    popped += 2;
+    delete queue;
+    queue = open_queue();
+    for (uint32_t i = 0; i < pushed - popped; i++) {
+        atomicMsg *msgPointer = get_msg(queue, i);
+        CHECK(msgPointer && (msgPointer->offset == popped + i));
+    }
+
+    // A request whose sequence number was not written when the memory
+    // server stopped is not in the queue when it is opened again, and its
+    // slot is reused
+    uint32_t queued = (uint32_t)(pushed - popped);
+    CHECK(push_read(queue, pushed) == 0);
+    Fam_Global_Descriptor item;
+    CHECK(queue->read(&item, queued) == 0);
+    atomicSlot *slot =
+        (atomicSlot *)alloc->get_local_pointer(item.regionId, item.offset);
+    slot->seq -= TEST_CAPACITY;
+    openfam_persist(&slot->seq, sizeof(slot->seq));
+    delete queue;
+    queue = open_queue();
+    CHECK(get_msg(queue, queued) == NULL);
+    for (uint32_t i = 0; i < queued; i++) {
+        atomicMsg *msgPointer = get_msg(queue, i);
+        CHECK(msgPointer && (msgPointer->offset == popped + i));
+    }
+    CHECK(push_read(queue, pushed + 1) == 0);
+    atomicMsg *msgPointer = get_msg(queue, queued);
+    CHECK(msgPointer && (msgPointer->offset == pushed + 1));
+
+    // Queue of the layout before the ring, with a write in progress after a
+    // pending read
+    const char data[] = "0123456789abcdef";
+    uint64_t dst = alloc->allocate(ATOMIC_REGION_ID, 64);
+    char *dstPointer = (char *)alloc->get_local_pointer(ATOMIC_REGION_ID, dst);
+    memset(dstPointer, 0, 64);
+    uint64_t buffer = alloc->allocate(ATOMIC_REGION_ID, sizeof(data));
+    memcpy(alloc->get_local_pointer(ATOMIC_REGION_ID, buffer), data,
+           sizeof(data));
+    uint64_t offsetArray =
+        alloc->allocate(ATOMIC_REGION_ID, 2 * sizeof(uint64_t));
+    uint64_t *offsets =
+        (uint64_t *)alloc->get_local_pointer(ATOMIC_REGION_ID, offsetArray);
+    atomicMsg *msgs[2];
+    for (int i = 0; i < 2; i++) {
+        offsets[i] = alloc->allocate(ATOMIC_REGION_ID, sizeof(atomicMsg));
+        msgs[i] = (atomicMsg *)alloc->get_local_pointer(ATOMIC_REGION_ID,
+                                                        offsets[i]);
+        memset(msgs[i], 0, sizeof(atomicMsg));
+    }
+    msgs[1]->flag = ATOMIC_READ;
+    msgs[0]->flag =
+        ATOMIC_WRITE | ATOMIC_BUFFER_ALLOCATED | ATOMIC_WRITE_IN_PROGRESS;
+    msgs[0]->dstDataGdesc.regionId = ATOMIC_REGION_ID;
+    msgs[0]->dstDataGdesc.offset = dst;
+    msgs[0]->offsetBuffer = buffer;
+    msgs[0]->offset = 8;
+    msgs[0]->size = sizeof(data);
+    uint64_t offsetQ = alloc->allocate(ATOMIC_REGION_ID, sizeof(qDataV1));
+    struct qDataV1 *legacy =
+        (struct qDataV1 *)alloc->get_local_pointer(ATOMIC_REGION_ID, offsetQ);
+    legacy->front = 1;
+    legacy->rear = 1;
+    legacy->capacity = 2;
+    legacy->size = 2;
+    legacy->offsetArray = offsetArray;
+    *rootEntry = offsetQ;
+
+    delete queue;
+    queue = open_queue();
+    CHECK(memcmp(dstPointer + 8, data, sizeof(data)) == 0);
+    CHECK(*rootEntry != offsetQ);
+    struct qRing *ring = (struct qRing *)alloc->get_local_pointer(
+        ATOMIC_REGION_ID, *rootEntry);
+    CHECK(ring->magic == ATL_RING_MAGIC);
+    CHECK(queue->isQempty());
+    alloc->deallocate(ATOMIC_REGION_ID, dst);
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_atl_queue_test passed" << endl;
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ *   fam_heap_table_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: threads allocating, accessing and freeing data
+ * items in several regions at once, while another region is created and
+ * destroyed over and over, see only their own data. Heaps opened on first
+ * access by concurrent threads, and heaps opened in bulk with open_heaps,
+ * map the data written before.
+ */
+#include "allocator/memserver_allocator.h"
+#include "common/fam_internal.h"
+
+#include <atomic>
+#include <iostream>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define NUM_REGIONS 16
+#define NUM_THREADS 8
+#define NUM_ROUNDS 2000
+#define ITEM_SIZE 256
+// Regions at the top of the region Id range, not used by other tests
+#define TEST_REGION_BASE (REGIONID_MASK - NUM_REGIONS)
+#define CHURN_REGION_ID REGIONID_MASK
+
+static uint64_t region_id(uint64_t i) { return TEST_REGION_BASE + i; }
+
+static void destroy_if_exists(Memserver_Allocator *alloc, uint64_t regionId) {
+    try {
+        alloc->destroy_region(regionId);
+    } catch (Memory_Service_Exception &e) {
+    }
+}
+
+// Allocate, fill, check and free data items in all regions
+static void churn_items(Memserver_Allocator *alloc, uint64_t tid,
+                        std::atomic<uint64_t> *errors) {
+    for (uint64_t i = 0; i < NUM_ROUNDS; i++) {
+        uint64_t regionId = region_id((tid + i) % NUM_REGIONS);
+        try {
+            uint64_t offset = alloc->allocate(regionId, ITEM_SIZE);
+            char *ptr = (char *)alloc->get_local_pointer(regionId, offset);
+            memset(ptr, (int)(tid + 1), ITEM_SIZE);
+            std::this_thread::yield();
+            for (uint64_t j = 0; j < ITEM_SIZE; j++)
+                if (ptr[j] != (char)(tid + 1)) {
+                    (*errors)++;
+                    break;
+                }
+            alloc->deallocate(regionId, offset);
+        } catch (Fam_Exception &e) {
+            cout << "region " << regionId << ": " << e.fam_error_msg()
+                 << endl;
+            (*errors)++;
+        }
+    }
+}
+
+// Create and destroy one more region while the other threads run
+static void churn_region(Memserver_Allocator *alloc, std::atomic<bool> *stop,
+                         std::atomic<uint64_t> *errors) {
+    while (!stop->load()) {
+        try {
+            alloc->create_region(CHURN_REGION_ID, MIN_REGION_SIZE);
+            alloc->get_local_pointer(CHURN_REGION_ID,
+                                     alloc->allocate(CHURN_REGION_ID, 64));
+            alloc->destroy_region(CHURN_REGION_ID);
+        } catch (Fam_Exception &e) {
+            cout << "churn region: " << e.fam_error_msg() << endl;
+            (*errors)++;
+            return;
+        }
+    }
+}
+
+// Check that the tagged data item of each region is mapped with its tag
+static void check_tags(Memserver_Allocator *alloc, uint64_t *offsets,
+                       void **ptrs, std::atomic<uint64_t> *errors) {
+    for (uint64_t i = 0; i < NUM_REGIONS; i++) {
+        try {
+            ptrs[i] = alloc->get_local_pointer(region_id(i), offsets[i]);
+            if (*(uint64_t *)ptrs[i] != region_id(i))
+                (*errors)++;
+        } catch (Fam_Exception &e) {
+            (*errors)++;
+        }
+    }
+}
+
+int main() {
+    Memserver_Allocator *alloc = new Memserver_Allocator(0, "");
+    std::atomic<uint64_t> errors(0);
+    std::vector<std::thread> threads;
+
+    for (uint64_t i = 0; i < NUM_REGIONS; i++) {
+        destroy_if_exists(alloc, region_id(i));
+        alloc->create_region(region_id(i), MIN_REGION_SIZE);
+    }
+    destroy_if_exists(alloc, CHURN_REGION_ID);
+
+    // Lookups in all regions while one region comes and goes
+    std::atomic<bool> stop(false);
+    std::thread churner(churn_region, alloc, &stop, &errors);
+    for (uint64_t t = 0; t < NUM_THREADS; t++)
+        threads.push_back(std::thread(churn_items, alloc, t, &errors));
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+    stop = true;
+    churner.join();
+    CHECK(errors == 0);
+
+    // Tag one data item of each region
+    uint64_t offsets[NUM_REGIONS];
+    for (uint64_t i = 0; i < NUM_REGIONS; i++) {
+        offsets[i] = alloc->allocate(region_id(i), ITEM_SIZE);
+        *(uint64_t *)alloc->get_local_pointer(region_id(i), offsets[i]) =
+            region_id(i);
+    }
+
+    // Another allocator opens the heaps on first access, from all threads
+    // at once; all of them must get the same mapping
+    Memserver_Allocator *reopened = new Memserver_Allocator(0, "");
+    void *ptrs[NUM_THREADS][NUM_REGIONS];
+    errors = 0;
+    for (uint64_t t = 0; t < NUM_THREADS; t++)
+        threads.push_back(
+            std::thread(check_tags, reopened, offsets, ptrs[t], &errors));
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+    CHECK(errors == 0);
+    for (uint64_t t = 1; t < NUM_THREADS; t++)
+        CHECK(memcmp(ptrs[t], ptrs[0], sizeof(ptrs[0])) == 0);
+    reopened->memserver_allocator_finalize();
+    delete reopened;
+
+    // Heaps opened in bulk map the same data
+    reopened = new Memserver_Allocator(0, "");
+    reopened->open_heaps(4);
+    errors = 0;
+    check_tags(reopened, offsets, ptrs[0], &errors);
+    CHECK(errors == 0);
+    reopened->memserver_allocator_finalize();
+    delete reopened;
+
+    for (uint64_t i = 0; i < NUM_REGIONS; i++)
+        alloc->destroy_region(region_id(i));
+    alloc->memserver_allocator_finalize();
+    delete alloc;
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_heap_table_test passed" << endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ *   fam_index_encoding_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: element indexes of indexed atomic scatter/gather
+ * survive encode_index_array/decode_index_array, and malformed encodings
+ * are rejected.
+ */
+#include "common/fam_internal.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+// Encode index, decode it back and compare; returns the encoding
+static uint32_t round_trip(const vector<uint64_t> &index) {
+    string encoded;
+    vector<uint64_t> decoded;
+    uint32_t encoding =
+        encode_index_array(index.data(), index.size(), &encoded);
+    CHECK(decode_index_array(encoded, encoding, index.size(), &decoded));
+    CHECK(decoded == index);
+    return encoding;
+}
+
+int main() {
+    vector<uint64_t> decoded;
+    string encoded;
+
+    // nElements = 0
+    CHECK(encode_index_array(NULL, 0, &encoded) == FAM_INDEX_PACKED);
+    CHECK(encoded.empty());
+    CHECK(decode_index_array(encoded, FAM_INDEX_PACKED, 0, &decoded));
+    CHECK(decoded.empty());
+    CHECK(decode_index_array("", FAM_INDEX_DELTA_VARINT, 0, &decoded));
+    CHECK(!decode_index_array("", FAM_INDEX_PACKED, 1, &decoded));
+
+    // Sorted, close indexes take the varint encoding, a byte each
+    vector<uint64_t> sorted;
+    for (uint64_t i = 0; i < 1000; i++)
+        sorted.push_back(10 + 3 * i);
+    CHECK(round_trip(sorted) == FAM_INDEX_DELTA_VARINT);
+    encode_index_array(sorted.data(), sorted.size(), &encoded);
+    CHECK(encoded.size() == 1000);
+
+    // Unsorted indexes : negative deltas
+    vector<uint64_t> unsorted = {50, 10, 40, 0, 7, 3, 100, 1};
+    CHECK(round_trip(unsorted) == FAM_INDEX_DELTA_VARINT);
+
+    // Indexes spread over the whole range take the packed encoding
+    vector<uint64_t> spread = {0x7000000000000000ULL, 0x0123456789abcdefULL,
+                               0x6fedcba987654321ULL, 1};
+    CHECK(round_trip(spread) == FAM_INDEX_PACKED);
+    encode_index_array(spread.data(), spread.size(), &encoded);
+    CHECK(encoded.size() == spread.size() * sizeof(uint64_t));
+    // Little-endian layout
+    CHECK((unsigned char)encoded[sizeof(uint64_t)] == 0xef);
+
+    // Wrong packed length
+    CHECK(!decode_index_array(encoded, FAM_INDEX_PACKED, spread.size() - 1,
+                              &decoded));
+    CHECK(!decode_index_array(encoded.substr(0, encoded.size() - 1),
+                              FAM_INDEX_PACKED, spread.size(), &decoded));
+
+    // Truncated varint : last byte has its continuation bit set
+    vector<uint64_t> large = {1000000};
+    CHECK(round_trip(large) == FAM_INDEX_DELTA_VARINT);
+    encode_index_array(large.data(), large.size(), &encoded);
+    CHECK(encoded.size() > 1);
+    CHECK(!decode_index_array(encoded.substr(0, encoded.size() - 1),
+                              FAM_INDEX_DELTA_VARINT, 1, &decoded));
+
+    // Trailing bytes, and fewer indexes than nElements
+    encode_index_array(unsorted.data(), unsorted.size(), &encoded);
+    CHECK(!decode_index_array(encoded + '\x01', FAM_INDEX_DELTA_VARINT,
+                              unsorted.size(), &decoded));
+    CHECK(!decode_index_array(encoded, FAM_INDEX_DELTA_VARINT,
+                              unsorted.size() + 1, &decoded));
+
+    // Varint longer than 64 bits
+    string overlong(11, '\xff');
+    overlong += '\x01';
+    CHECK(!decode_index_array(overlong, FAM_INDEX_DELTA_VARINT, 1, &decoded));
+
+    // Unknown encoding
+    CHECK(!decode_index_array(encoded, 7, unsorted.size(), &decoded));
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_index_encoding_test passed" << endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ *   fam_shm_chunked_copy_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: shared memory puts and gets whose size is not a
+ * multiple of the copy chunk size are split into chunks and copied with and
+ * without non-temporal stores, both blocking and nonblocking, to and from
+ * buffers that are not aligned. The bytes around the destination range must
+ * be left untouched.
+ */
+#include "common/fam_async_qhandler.h"
+#include "common/fam_context.h"
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define CHUNK_SIZE 4096
+// Bytes before and after the destination range that must not be written
+#define GUARD 64
+#define GUARD_BYTE 0x5a
+
+static const uint64_t sizes[] = {1,
+                                 100,
+                                 CHUNK_SIZE - 1,
+                                 CHUNK_SIZE + 1,
+                                 3 * CHUNK_SIZE + 123,
+                                 17 * CHUNK_SIZE + CHUNK_SIZE / 2 + 7};
+
+// Misalignment of the source and destination buffers
+static const uint64_t skews[] = {0, 3};
+
+static void fill(char *buf, uint64_t nbytes, unsigned seed) {
+    for (uint64_t i = 0; i < nbytes; i++)
+        buf[i] = (char)((i * 31 + seed) & 0xff);
+}
+
+static void check_copy(const char *src, char *destBuf, uint64_t skew,
+                       uint64_t nbytes) {
+    const char *dest = destBuf + GUARD + skew;
+    CHECK(memcmp(src, dest, nbytes) == 0);
+    for (uint64_t i = 0; i < GUARD + skew; i++)
+        if (destBuf[i] != GUARD_BYTE) {
+            cout << "byte before destination written, size " << nbytes
+                 << endl;
+            fail++;
+            break;
+        }
+    for (uint64_t i = 0; i < GUARD; i++)
+        if (dest[nbytes + i] != GUARD_BYTE) {
+            cout << "byte after destination written, size " << nbytes
+                 << endl;
+            fail++;
+            break;
+        }
+}
+
+static void run_copies(Fam_Async_QHandler *handler, Fam_Context *famCtx,
+                       bool nonblocking) {
+    uint64_t maxSize = 18 * CHUNK_SIZE;
+    char *srcBuf = (char *)malloc(maxSize + GUARD);
+    char *destBuf = (char *)malloc(maxSize + 3 * GUARD);
+
+    for (uint64_t nbytes : sizes) {
+        for (uint64_t skew : skews) {
+            for (Fam_Ops_Type op : {WRITE, READ}) {
+                char *src = srcBuf + skew;
+                char *dest = destBuf + GUARD + skew;
+                fill(src, nbytes, (unsigned)(nbytes + skew + op));
+                memset(destBuf, GUARD_BYTE, maxSize + 3 * GUARD);
+
+                if (nonblocking) {
+                    Fam_Ops_Info opsInfo = {
+                        op,     src,    dest, nbytes, 0, nbytes, FAM_RW_KEY_SHM,
+                        nbytes, NULL, famCtx, NULL};
+                    handler->initiate_operation(opsInfo);
+                    if (op == WRITE)
+                        famCtx->inc_num_tx_ops();
+                    else
+                        famCtx->inc_num_rx_ops();
+                    handler->quiet(famCtx);
+                } else {
+                    handler->blocking_copy(op, src, dest, nbytes);
+                }
+                check_copy(src, destBuf, skew, nbytes);
+            }
+        }
+    }
+
+    free(srcBuf);
+    free(destBuf);
+}
+
+int main() {
+    // Chunk size, non-temporal threshold
+    static const uint64_t configs[][2] = {
+        {CHUNK_SIZE, 0},              // chunked, regular stores
+        {CHUNK_SIZE, 1},              // chunked, non-temporal stores
+        {CHUNK_SIZE, 2 * CHUNK_SIZE}, // both, depending on the size
+        {0, 1},                       // not chunked, non-temporal stores
+    };
+
+    Fam_Async_QHandler handler(4);
+    Fam_Context famCtx(FAM_THREAD_MULTIPLE);
+
+    for (auto &config : configs) {
+        handler.set_chunking(config[0], config[1]);
+        try {
+            run_copies(&handler, &famCtx, false);
+            run_copies(&handler, &famCtx, true);
+        } catch (Fam_Exception &e) {
+            cout << "copy failed: " << e.fam_error_msg() << endl;
+            fail++;
+        }
+    }
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_shm_chunked_copy_test passed" << endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ *   fam_shm_context_quiet_test.cpp
+ *   Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: two threads issue nonblocking shared memory puts
+ * on two contexts concurrently and quiet them; each quiet must return once
+ * the puts of its own context are done. A quiet of one context must also
+ * return while the other context still has an operation outstanding.
+ */
+#include "common/fam_async_qhandler.h"
+#include "common/fam_context.h"
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace openfam;
+
+static int fail = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+            fail++;                                                            \
+        }                                                                      \
+    } while (0)
+
+#define NUM_PUTS 2000
+#define PUT_SIZE 256
+#define QUIET_TIMEOUT_SEC 30
+
+static Fam_Async_QHandler *handler;
+
+static void put_nonblocking(Fam_Context *famCtx, void *src, void *dest,
+                            uint64_t nbytes) {
+    Fam_Ops_Info opsInfo = {WRITE,  src,  dest,   nbytes, 0, nbytes,
+                            FAM_RW_KEY_SHM, nbytes, NULL, famCtx, NULL};
+    handler->initiate_operation(opsInfo);
+    famCtx->inc_num_tx_ops();
+}
+
+// Issue NUM_PUTS puts on famCtx, quiet it and return the number of puts
+// whose data did not arrive
+static int put_and_quiet(Fam_Context *famCtx, unsigned seed) {
+    char *src = (char *)malloc(NUM_PUTS * PUT_SIZE);
+    char *dest = (char *)calloc(NUM_PUTS, PUT_SIZE);
+    for (uint64_t i = 0; i < NUM_PUTS * PUT_SIZE; i++)
+        src[i] = (char)((i + seed) & 0xff);
+
+    for (uint64_t i = 0; i < NUM_PUTS; i++)
+        put_nonblocking(famCtx, src + i * PUT_SIZE, dest + i * PUT_SIZE,
+                        PUT_SIZE);
+    handler->quiet(famCtx);
+
+    int missing = 0;
+    for (uint64_t i = 0; i < NUM_PUTS; i++)
+        if (memcmp(src + i * PUT_SIZE, dest + i * PUT_SIZE, PUT_SIZE))
+            missing++;
+    free(src);
+    free(dest);
+    return missing;
+}
+
+// Wait for the puts and quiet running in the background. A quiet that hangs
+// leaves its thread behind, so the test exits at once.
+static int wait_quiet(std::future<int> &result, const char *what) {
+    if (result.wait_for(std::chrono::seconds(QUIET_TIMEOUT_SEC)) !=
+        std::future_status::ready) {
+        cout << what << " did not return" << endl;
+        _exit(-1);
+    }
+    return result.get();
+}
+
+int main() {
+    handler = new Fam_Async_QHandler(4);
+    Fam_Context ctxA(FAM_THREAD_MULTIPLE);
+    Fam_Context ctxB(FAM_THREAD_MULTIPLE);
+
+    // Both contexts busy at the same time
+    for (int round = 0; round < 10; round++) {
+        auto putsA = std::async(std::launch::async, put_and_quiet, &ctxA, 1);
+        auto putsB = std::async(std::launch::async, put_and_quiet, &ctxB, 2);
+        CHECK(wait_quiet(putsA, "quiet of A") == 0);
+        CHECK(wait_quiet(putsB, "quiet of B") == 0);
+    }
+    CHECK(ctxA.get_num_tx_done() == ctxA.get_num_tx_ops());
+    CHECK(ctxB.get_num_tx_done() == ctxB.get_num_tx_ops());
+
+    // Context B has an operation it issued that never completes; quiet of
+    // context A must not wait for it.
+    ctxB.inc_num_tx_ops();
+    auto putsA = std::async(std::launch::async, put_and_quiet, &ctxA, 3);
+    CHECK(wait_quiet(putsA, "quiet of A with B outstanding") == 0);
+    CHECK(ctxB.get_num_tx_done() + 1 == ctxB.get_num_tx_ops());
+
+    delete handler;
+
+    if (fail) {
+        cout << fail << " checks failed" << endl;
+        return -1;
+    }
+    cout << "fam_shm_context_quiet_test passed" << endl;
+    return 0;
+}
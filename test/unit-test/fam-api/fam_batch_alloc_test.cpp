@@ -0,0 +1,140 @@
+/*
+ * fam_batch_alloc_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: data items allocated with fam_allocate_batch are
+ * usable and found by fam_lookup_batch; a batch with a duplicate name fails
+ * without allocating anything; fam_deallocate_batch removes all the items.
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define NUM_ITEMS 16
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *items[NUM_ITEMS], *found[NUM_ITEMS];
+    const char *names[NUM_ITEMS];
+    char nameBuf[NUM_ITEMS][16];
+    uint64_t sizes[NUM_ITEMS];
+    int ret = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test_batch", 1048576, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        snprintf(nameBuf[i], sizeof(nameBuf[i]), "item%d", i);
+        names[i] = nameBuf[i];
+        sizes[i] = 1024 * (i + 1);
+    }
+
+    try {
+        my_fam->fam_allocate_batch(names, sizes, NUM_ITEMS, 0777, desc, items);
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            uint64_t val = i;
+            my_fam->fam_put_blocking(&val, items[i], 0, sizeof(val));
+        }
+
+        my_fam->fam_lookup_batch(names, "test_batch", NUM_ITEMS, found);
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            uint64_t val = 0;
+            if (found[i]->get_size() != sizes[i]) {
+                cout << "Unexpected size returned by fam_lookup_batch" << endl;
+                ret = -1;
+            }
+            my_fam->fam_get_blocking(&val, found[i], 0, sizeof(val));
+            if (val != (uint64_t)i) {
+                cout << "Unexpected data read through looked up item" << endl;
+                ret = -1;
+            }
+            delete found[i];
+        }
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // A batch repeating a name must fail as a whole
+    const char *dupNames[2] = {"dup", "dup"};
+    uint64_t dupSizes[2] = {1024, 1024};
+    Fam_Descriptor *dupItems[2];
+    try {
+        my_fam->fam_allocate_batch(dupNames, dupSizes, 2, 0777, desc,
+                                   dupItems);
+        cout << "fam_allocate_batch accepted a duplicate name" << endl;
+        ret = -1;
+    } catch (Fam_Exception &e) {
+        // Expected: the data item already exists
+    }
+    try {
+        delete my_fam->fam_lookup("dup", "test_batch");
+        cout << "Failed fam_allocate_batch left a data item behind" << endl;
+        ret = -1;
+    } catch (Fam_Exception &e) {
+        // Expected: nothing was allocated
+    }
+
+    my_fam->fam_deallocate_batch(items, NUM_ITEMS);
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        try {
+            delete my_fam->fam_lookup(names[i], "test_batch");
+            cout << "fam_lookup found a deallocated item" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            // Expected: the item no longer exists
+        }
+        delete items[i];
+    }
+
+    my_fam->fam_destroy_region(desc);
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
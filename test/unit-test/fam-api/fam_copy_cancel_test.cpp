@@ -0,0 +1,146 @@
+/*
+ * fam_copy_cancel_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define ITEM_SIZE (16UL << 20)
+// Copies must end before the end of the data item
+#define COPY_SIZE (ITEM_SIZE / 2)
+
+static bool check_copy(fam *my_fam, Fam_Descriptor *item,
+                       const vector<char> &expected) {
+    vector<char> local(COPY_SIZE);
+    my_fam->fam_get_blocking(local.data(), item, 0, COPY_SIZE);
+    return (memcmp(local.data(), expected.data(), COPY_SIZE) == 0);
+}
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *src, *dest1, *dest2;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test1", 4 * ITEM_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    src = my_fam->fam_allocate("src", ITEM_SIZE, 0777, desc);
+    dest1 = my_fam->fam_allocate("dest1", ITEM_SIZE, 0777, desc);
+    dest2 = my_fam->fam_allocate("dest2", ITEM_SIZE, 0777, desc);
+
+    vector<char> data(COPY_SIZE);
+    for (uint64_t i = 0; i < COPY_SIZE; i++)
+        data[i] = (char)(i % 251);
+    my_fam->fam_put_blocking(data.data(), src, 0, COPY_SIZE);
+
+    // The progress of a copy never goes back nor beyond its size
+    try {
+        void *waitObj = my_fam->fam_copy(src, 0, dest1, 0, COPY_SIZE);
+        uint64_t last = 0;
+        bool monotonic = true;
+        for (int i = 0; i < 100; i++) {
+            uint64_t progress = my_fam->fam_copy_progress(waitObj);
+            if (progress < last || progress > COPY_SIZE)
+                monotonic = false;
+            last = progress;
+        }
+        my_fam->fam_copy_wait(waitObj);
+        if (monotonic && check_copy(my_fam, dest1, data))
+            pass++;
+        else
+            fail++;
+    } catch (Fam_Exception &e) {
+        fail++;
+        cout << "Copy failed: " << e.fam_error_msg() << endl;
+    }
+
+    // A cancelled copy is reported by fam_copy_wait, unless it completed
+    // before the cancel got to it.
+    try {
+        void *waitObj = my_fam->fam_copy(src, 0, dest2, 0, COPY_SIZE);
+        my_fam->fam_copy_cancel(waitObj);
+        my_fam->fam_copy_wait(waitObj);
+        cout << "Copy completed before it was cancelled" << endl;
+        if (check_copy(my_fam, dest2, data))
+            pass++;
+        else
+            fail++;
+    } catch (Fam_Exception &e) {
+        if (e.fam_error() == FAM_ERR_CANCELED) {
+            pass++;
+        } else {
+            fail++;
+            cout << "Cancelled copy failed: " << e.fam_error_msg() << endl;
+        }
+    }
+
+    // A null wait object is rejected
+    try {
+        my_fam->fam_copy_cancel(NULL);
+        fail++;
+    } catch (Fam_Exception &e) {
+        pass++;
+    }
+
+    my_fam->fam_deallocate(src);
+    my_fam->fam_deallocate(dest1);
+    my_fam->fam_deallocate(dest2);
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (pass == 3 && fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,185 @@
+/*
+ * fam_copy_cross_server_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: fam_copy between data items on different memory
+ * servers, of sizes spanning several copy chunks and not a multiple of the
+ * chunk size, at unaligned offsets, and with two copies in flight at once.
+ * The bytes around the destination range must be left untouched.
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+// Default copy_chunk_size of the memory server
+#define COPY_CHUNK_SIZE (4UL << 20)
+#define ITEM_SIZE (16UL << 20)
+// Regions created to find one on another memory server than the source
+#define MAX_DEST_REGIONS 8
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (cond) {                                                            \
+            pass++;                                                            \
+        } else {                                                               \
+            fail++;                                                            \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+        }                                                                      \
+    } while (0)
+
+// Check that dest holds src[srcOffset, srcOffset + len) at destOffset and
+// zeros around it
+bool copied(vector<char> &src, vector<char> &dest, uint64_t srcOffset,
+            uint64_t destOffset, uint64_t len) {
+    if (memcmp(&src[srcOffset], &dest[destOffset], len) != 0)
+        return false;
+    for (uint64_t i = 0; i < destOffset; i++)
+        if (dest[i] != 0)
+            return false;
+    for (uint64_t i = destOffset + len; i < dest.size(); i++)
+        if (dest[i] != 0)
+            return false;
+    return true;
+}
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *srcDesc, *destDesc = NULL;
+    Fam_Descriptor *srcItem, *destItem = NULL;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    srcDesc = my_fam->fam_create_region("xcopySrc", 2 * ITEM_SIZE, 0777,
+                                        RAID1);
+    if (srcDesc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    srcItem = my_fam->fam_allocate("src", ITEM_SIZE, 0777, srcDesc);
+
+    // Find a destination on another memory server than the source
+    vector<Fam_Region_Descriptor *> others;
+    for (int i = 0; i < MAX_DEST_REGIONS && !destItem; i++) {
+        char name[32];
+        sprintf(name, "xcopyDest%d", i);
+        Fam_Region_Descriptor *desc =
+            my_fam->fam_create_region(name, 2 * ITEM_SIZE, 0777, RAID1);
+        Fam_Descriptor *item = my_fam->fam_allocate("dest", ITEM_SIZE, 0777,
+                                                    desc);
+        if (srcItem->get_used_memsrv_cnt() <= 1 &&
+            item->get_used_memsrv_cnt() <= 1 &&
+            item->get_memserver_id() != srcItem->get_memserver_id()) {
+            destDesc = desc;
+            destItem = item;
+        } else {
+            my_fam->fam_deallocate(item);
+            others.push_back(desc);
+        }
+    }
+    for (auto desc : others)
+        my_fam->fam_destroy_region(desc);
+    if (!destItem) {
+        my_fam->fam_deallocate(srcItem);
+        my_fam->fam_destroy_region(srcDesc);
+        my_fam->fam_finalize("default");
+        cout << "Test case valid only with data items placed on several "
+                "memory servers, skipping with status : "
+             << TEST_SKIP_STATUS << endl;
+        return TEST_SKIP_STATUS;
+    }
+    cout << "Copying from memory server " << srcItem->get_memserver_id()
+         << " to " << destItem->get_memserver_id() << endl;
+
+    vector<char> data(ITEM_SIZE), zeros(ITEM_SIZE, 0), local(ITEM_SIZE);
+    for (uint64_t i = 0; i < ITEM_SIZE; i++)
+        data[i] = (char)((i * 13 + i / 4096) & 0xff);
+    my_fam->fam_put_blocking(data.data(), srcItem, 0, ITEM_SIZE);
+
+    // Several chunks and a partial one, from the start of the data items
+    uint64_t len = 3 * COPY_CHUNK_SIZE + 4096 + 123;
+    my_fam->fam_put_blocking(zeros.data(), destItem, 0, ITEM_SIZE);
+    my_fam->fam_copy_wait(my_fam->fam_copy(srcItem, 0, destItem, 0, len));
+    my_fam->fam_get_blocking(local.data(), destItem, 0, ITEM_SIZE);
+    CHECK(copied(data, local, 0, 0, len));
+
+    // Unaligned offsets on both sides
+    uint64_t srcOffset = 1000, destOffset = 333;
+    len = 2 * COPY_CHUNK_SIZE + 77;
+    my_fam->fam_put_blocking(zeros.data(), destItem, 0, ITEM_SIZE);
+    my_fam->fam_copy_wait(
+        my_fam->fam_copy(srcItem, srcOffset, destItem, destOffset, len));
+    my_fam->fam_get_blocking(local.data(), destItem, 0, ITEM_SIZE);
+    CHECK(copied(data, local, srcOffset, destOffset, len));
+
+    // Two copies in flight at once, into the two halves of the destination
+    uint64_t half = ITEM_SIZE / 2;
+    len = half - 4096 - 5;
+    my_fam->fam_put_blocking(zeros.data(), destItem, 0, ITEM_SIZE);
+    void *first = my_fam->fam_copy(srcItem, half, destItem, 0, len);
+    void *second = my_fam->fam_copy(srcItem, 0, destItem, half, len);
+    my_fam->fam_copy_wait(second);
+    my_fam->fam_copy_wait(first);
+    my_fam->fam_get_blocking(local.data(), destItem, 0, ITEM_SIZE);
+    CHECK(memcmp(&local[0], &data[half], len) == 0);
+    CHECK(memcmp(&local[half], &data[0], len) == 0);
+    bool untouched = true;
+    for (uint64_t i = len; i < half; i++)
+        untouched &= (local[i] == 0) && (local[half + i] == 0);
+    CHECK(untouched);
+
+    my_fam->fam_deallocate(destItem);
+    my_fam->fam_deallocate(srcItem);
+    my_fam->fam_destroy_region(destDesc);
+    my_fam->fam_destroy_region(srcDesc);
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
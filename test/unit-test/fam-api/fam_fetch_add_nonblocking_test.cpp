@@ -0,0 +1,120 @@
+/*
+ * fam_fetch_add_nonblocking_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: many nonblocking fetch-and-add operations are kept
+ * in flight and completed by fam_quiet, more than a context holds operands
+ * for at once; every old value must be returned exactly once.
+ */
+#include <algorithm>
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define NUM_OPS 4096
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test", 8192, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    // Allocating data items in the created region
+    item = my_fam->fam_allocate("first", 1024, 0777, desc);
+    if (item == NULL) {
+        cout << "fam allocation of data item 'first' failed" << endl;
+        exit(1);
+    }
+
+    uint64_t *results = new uint64_t[NUM_OPS];
+    int32_t result32 = 0;
+    try {
+        my_fam->fam_set(item, 0, (uint64_t)0);
+        my_fam->fam_set(item, 8, (int32_t)100);
+        my_fam->fam_quiet();
+
+        for (uint64_t i = 0; i < NUM_OPS; i++)
+            my_fam->fam_fetch_add_nonblocking(item, 0, (uint64_t)1,
+                                              &results[i]);
+        my_fam->fam_fetch_add_nonblocking(item, 8, (int32_t)-1, &result32);
+        my_fam->fam_quiet();
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    if (ret == 0) {
+        std::sort(results, results + NUM_OPS);
+        for (uint64_t i = 0; i < NUM_OPS; i++) {
+            if (results[i] != i) {
+                cout << "Unexpected old value " << results[i] << endl;
+                ret = -1;
+                break;
+            }
+        }
+        if (result32 != 100) {
+            cout << "Unexpected old value " << result32 << endl;
+            ret = -1;
+        }
+        if (my_fam->fam_fetch_uint64(item, 0) != NUM_OPS ||
+            my_fam->fam_fetch_int32(item, 8) != 99) {
+            cout << "Unexpected final value" << endl;
+            ret = -1;
+        }
+    }
+
+    delete[] results;
+    my_fam->fam_deallocate(item);
+    my_fam->fam_destroy_region(desc);
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
@@ -0,0 +1,146 @@
+/*
+ * fam_int128_atomics_check_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item, *roItem;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test1", 8192, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    item = my_fam->fam_allocate("first", 1024, 0777, desc);
+    // Data item with READ perm only
+    roItem = my_fam->fam_allocate("second", 1024, 0444, desc);
+    if (item == NULL || roItem == NULL) {
+        cout << "fam allocation of data items failed" << endl;
+        exit(1);
+    }
+
+    int128_t value = 1;
+    try {
+        my_fam->fam_set(item, 1008, value);
+        if (my_fam->fam_compare_swap(item, 1008, value, (int128_t)2) == value)
+            pass++;
+        else
+            fail++;
+    } catch (Fam_Exception &e) {
+        fail++;
+        cout << "128-bit atomics within the data item failed" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+    }
+
+    // The value would extend past the end of the data item
+    try {
+        my_fam->fam_compare_swap(item, 1016, value, value);
+        fail++;
+    } catch (Fam_Exception &e) {
+        cout << "fam_compare_swap failed as expected with bad offset" << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        pass++;
+    }
+
+    // The offset wraps around when the size is added
+    try {
+        my_fam->fam_fetch_int128(item, (uint64_t)-8);
+        fail++;
+    } catch (Fam_Exception &e) {
+        cout << "fam_fetch_int128 failed as expected with bad offset" << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        pass++;
+    }
+
+    // Reading is permitted, writing is not
+    try {
+        my_fam->fam_fetch_int128(roItem, 0);
+        pass++;
+    } catch (Fam_Exception &e) {
+        fail++;
+        cout << "fam_fetch_int128 on read-only data item failed" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+    }
+    try {
+        my_fam->fam_set(roItem, 0, value);
+        fail++;
+    } catch (Fam_Exception &e) {
+        cout << "fam_set failed as expected with no permission" << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        pass++;
+    }
+
+    // A key forged with the write bit set must not grant write access
+    roItem->bind_key(roItem->get_key() | 1);
+    try {
+        my_fam->fam_compare_swap(roItem, 0, (int128_t)0, value);
+        fail++;
+    } catch (Fam_Exception &e) {
+        cout << "fam_compare_swap failed as expected with forged key" << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        pass++;
+    }
+
+    my_fam->fam_deallocate(roItem);
+    my_fam->fam_deallocate(item);
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (pass == 6 && fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * fam_interleave_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: put/get, strided and indexed scatter/gather across
+ * the stripe boundaries of a data item interleaved over the memory servers
+ * of its region, the stripe layout found by a lookup, and deallocation of
+ * the stripes on all the memory servers.
+ */
+#include <algorithm>
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define ITEM_SIZE (16UL << 20)
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (cond) {                                                            \
+            pass++;                                                            \
+        } else {                                                               \
+            fail++;                                                            \
+            cout << __LINE__ << ": check failed: " #cond << endl;              \
+        }                                                                      \
+    } while (0)
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item, *found = NULL;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("interleave", 4 * ITEM_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    item = my_fam->fam_allocate("item", ITEM_SIZE, 0777, desc);
+
+    // Interleaving is enabled by interleave_size in the CIS configuration
+    uint64_t stripe = item->get_interleave_size();
+    if (stripe == 0 || 4 * stripe > ITEM_SIZE) {
+        my_fam->fam_deallocate(item);
+        my_fam->fam_destroy_region(desc);
+        my_fam->fam_finalize("default");
+        cout << "Test case valid only with interleave_size of at most "
+             << ITEM_SIZE / 4 << ", skipping with status : "
+             << TEST_SKIP_STATUS << endl;
+        return TEST_SKIP_STATUS;
+    }
+    uint64_t cnt = item->get_used_memsrv_cnt();
+    cout << "Data item interleaved over " << cnt << " memory servers, stripe "
+         << stripe << endl;
+
+    // put/get across two stripe boundaries
+    uint64_t offset = stripe - 64;
+    uint64_t len = stripe + 128;
+    vector<char> data(len), local(len);
+    for (uint64_t i = 0; i < len; i++)
+        data[i] = (char)(i * 7 + 1);
+    my_fam->fam_put_blocking(data.data(), item, offset, len);
+    my_fam->fam_get_blocking(local.data(), item, offset, len);
+    CHECK(local == data);
+    // Each side of the second boundary is read alone
+    char edge[16];
+    my_fam->fam_get_blocking(edge, item, 2 * stripe - 8, sizeof(edge));
+    CHECK(memcmp(edge, &data[stripe + 56], sizeof(edge)) == 0);
+
+    // Strided scatter/gather, one element in each stripe
+    const uint64_t elementSize = 16;
+    const uint64_t nElements = 4;
+    uint64_t stride = stripe / elementSize + 1;
+    uint64_t first = 1;
+    uint64_t values[nElements * 2], gathered[nElements * 2];
+    for (uint64_t i = 0; i < nElements * 2; i++)
+        values[i] = 0x1000 + i;
+    my_fam->fam_scatter_blocking(values, item, nElements, first, stride,
+                                 elementSize);
+    memset(gathered, 0, sizeof(gathered));
+    my_fam->fam_gather_blocking(gathered, item, nElements, first, stride,
+                                elementSize);
+    CHECK(memcmp(values, gathered, sizeof(values)) == 0);
+    uint64_t element[2];
+    my_fam->fam_get_blocking(element, item,
+                             (first + 2 * stride) * elementSize,
+                             elementSize);
+    CHECK(memcmp(element, &values[4], elementSize) == 0);
+
+    // Indexed scatter/gather on both sides of each stripe boundary
+    uint64_t perStripe = stripe / elementSize;
+    uint64_t indexes[nElements] = {perStripe - 1, perStripe,
+                                   2 * perStripe - 1, 3 * perStripe};
+    for (uint64_t i = 0; i < nElements * 2; i++)
+        values[i] = 0x2000 + i;
+    my_fam->fam_scatter_blocking(values, item, nElements, indexes,
+                                 elementSize);
+    memset(gathered, 0, sizeof(gathered));
+    my_fam->fam_gather_blocking(gathered, item, nElements, indexes,
+                                elementSize);
+    CHECK(memcmp(values, gathered, sizeof(values)) == 0);
+    my_fam->fam_get_blocking(element, item, perStripe * elementSize,
+                             elementSize);
+    CHECK(memcmp(element, &values[2], elementSize) == 0);
+
+    // The lookup finds the stripe layout the allocation returned, and
+    // reads the data through it
+    try {
+        found = my_fam->fam_lookup("item", "interleave");
+    } catch (Fam_Exception &e) {
+        cout << "Lookup failed: " << e.fam_error_msg() << endl;
+    }
+    CHECK(found != NULL);
+    if (found != NULL) {
+        CHECK(found->get_interleave_size() == stripe);
+        CHECK(found->get_used_memsrv_cnt() == cnt);
+        bool same = true;
+        for (uint64_t i = 0; i < cnt && i < found->get_used_memsrv_cnt();
+             i++) {
+            same = same &&
+                   (found->get_memserver_ids()[i] ==
+                    item->get_memserver_ids()[i]) &&
+                   (found->get_keys()[i] == item->get_keys()[i]) &&
+                   (found->get_base_addresses()[i] ==
+                    item->get_base_addresses()[i]);
+        }
+        CHECK(same);
+        fill(local.begin(), local.end(), 0);
+        my_fam->fam_get_blocking(local.data(), found, offset, len);
+        CHECK(local == data);
+        delete found;
+    }
+
+    // Deallocation releases the stripes on every memory server : items of
+    // half the size of the region are allocated and deallocated in turn,
+    // which runs a memory server out of space if its stripes leak
+    my_fam->fam_deallocate(item);
+    bool notFound = false;
+    try {
+        found = my_fam->fam_lookup("item", "interleave");
+        delete found;
+    } catch (Fam_Exception &e) {
+        notFound = true;
+    }
+    CHECK(notFound);
+    bool reallocated = true;
+    for (int i = 0; i < 8; i++) {
+        try {
+            item = my_fam->fam_allocate("item", 2 * ITEM_SIZE, 0777, desc);
+            my_fam->fam_deallocate(item);
+        } catch (Fam_Exception &e) {
+            cout << "Allocation " << i << " failed: " << e.fam_error_msg()
+                 << endl;
+            reallocated = false;
+            break;
+        }
+    }
+    CHECK(reallocated);
+
+    my_fam->fam_destroy_region(desc);
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * fam_lookup_during_copy_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: lookups and copy progress queries are served while
+ * more copies than the copy workers of the servers are in flight, which
+ * they must not wait for.
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define ITEM_SIZE (64UL << 20)
+// More copies than the default number of copy workers (4)
+#define NUM_COPIES 16
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *src, *dest, *item;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    char *openfam_model = (char *)my_fam->fam_get_option(
+        strdup("OPENFAM_MODEL"));
+    // Copies are only served by the RPC servers in the memory server model
+    if (strcmp(openfam_model, "memory_server") != 0) {
+        my_fam->fam_finalize("default");
+        cout << "Test case valid only in memory server model, "
+                "skipping with status : "
+             << TEST_SKIP_STATUS << endl;
+        return TEST_SKIP_STATUS;
+    }
+
+    desc = my_fam->fam_create_region("test1", 3 * ITEM_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    src = my_fam->fam_allocate("src", ITEM_SIZE, 0777, desc);
+    dest = my_fam->fam_allocate("dest", ITEM_SIZE, 0777, desc);
+    item = my_fam->fam_allocate("item", 4096, 0777, desc);
+
+    vector<char> data(ITEM_SIZE, 'c');
+    my_fam->fam_put_blocking(data.data(), src, 0, ITEM_SIZE);
+
+    // Copies of the whole item, which all write the same data to dest
+    vector<void *> waitObjs;
+    for (int i = 0; i < NUM_COPIES; i++)
+        waitObjs.push_back(my_fam->fam_copy(src, 0, dest, 0, ITEM_SIZE));
+
+    // The copy workers are busy with the first copies and the last one is
+    // queued behind them: the lookup and the progress query of the last
+    // copy must complete before it.
+    Fam_Descriptor *found = NULL;
+    uint64_t progress = ITEM_SIZE;
+    try {
+        found = my_fam->fam_lookup("item", "test1");
+        progress = my_fam->fam_copy_progress(waitObjs.back());
+    } catch (Fam_Exception &e) {
+        cout << "Lookup failed: " << e.fam_error_msg() << endl;
+    }
+    if (found != NULL && progress < ITEM_SIZE) {
+        pass++;
+    } else {
+        fail++;
+        cout << "Lookup waited for the copies" << endl;
+    }
+
+    for (auto waitObj : waitObjs) {
+        try {
+            my_fam->fam_copy_wait(waitObj);
+            pass++;
+        } catch (Fam_Exception &e) {
+            fail++;
+            cout << "Copy failed: " << e.fam_error_msg() << endl;
+        }
+    }
+
+    vector<char> local(ITEM_SIZE);
+    my_fam->fam_get_blocking(local.data(), dest, 0, ITEM_SIZE);
+    if (local == data)
+        pass++;
+    else
+        fail++;
+
+    delete found;
+    my_fam->fam_deallocate(src);
+    my_fam->fam_deallocate(dest);
+    my_fam->fam_deallocate(item);
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (pass == NUM_COPIES + 2 && fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * fam_lookup_lease_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: lookups are served from the client lease cache;
+ * deallocation, permission changes and region destruction done by this PE
+ * must be visible to the very next lookup.
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define NUM_LOOKUPS 1000
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test_lease", 8192, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    item = my_fam->fam_allocate("first", 1024, 0777, desc);
+    if (item == NULL) {
+        cout << "fam allocation of data item 'first' failed" << endl;
+        exit(1);
+    }
+
+    try {
+        my_fam->fam_put_blocking((void *)"lease", item, 0, 6);
+        // Repeated lookups must keep resolving to the same, usable item
+        for (int i = 0; i < NUM_LOOKUPS; i++) {
+            Fam_Descriptor *found = my_fam->fam_lookup("first", "test_lease");
+            char buf[6];
+            my_fam->fam_get_blocking(buf, found, 0, 6);
+            if (strcmp(buf, "lease") != 0) {
+                cout << "Unexpected data read through looked up item" << endl;
+                ret = -1;
+            }
+            delete found;
+            if (ret)
+                break;
+        }
+
+        my_fam->fam_change_permissions(item, 0400);
+        Fam_Descriptor *found = my_fam->fam_lookup("first", "test_lease");
+        if (found->get_perm() != 0400) {
+            cout << "Stale permissions returned by fam_lookup" << endl;
+            ret = -1;
+        }
+        delete found;
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    my_fam->fam_deallocate(item);
+    try {
+        delete my_fam->fam_lookup("first", "test_lease");
+        cout << "fam_lookup found a deallocated item" << endl;
+        ret = -1;
+    } catch (Fam_Exception &e) {
+        // Expected: the item or region no longer exists
+    }
+
+    delete my_fam->fam_lookup_region("test_lease");
+    my_fam->fam_destroy_region(desc);
+    try {
+        delete my_fam->fam_lookup_region("test_lease");
+        cout << "fam_lookup_region found a destroyed region" << endl;
+        ret = -1;
+    } catch (Fam_Exception &e) {
+        // Expected: the item or region no longer exists
+    }
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
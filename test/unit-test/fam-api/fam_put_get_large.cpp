@@ -0,0 +1,102 @@
+/*
+ * fam_put_get_large.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+/* Test Case Description: blocking put/get of a data item larger than the
+ * default put/get chunk size, so that the transfer is pipelined in chunks.
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+// Not a multiple of the default chunk size, so the last chunk is partial
+#define DATA_SIZE (10 * 1024 * 1024 + 123)
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test", 2 * DATA_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+    // Allocating data items in the created region
+    item = my_fam->fam_allocate("first", DATA_SIZE, 0777, desc);
+    if (item == NULL) {
+        cout << "fam allocation of data item 'first' failed" << endl;
+        exit(1);
+    }
+
+    char *local = (char *)malloc(DATA_SIZE);
+    char *local2 = (char *)calloc(1, DATA_SIZE);
+    for (uint64_t i = 0; i < DATA_SIZE; i++)
+        local[i] = (char)(i % 251);
+
+    try {
+        my_fam->fam_put_blocking(local, item, 0, DATA_SIZE);
+        my_fam->fam_get_blocking(local2, item, 0, DATA_SIZE);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    if (ret == 0 && memcmp(local, local2, DATA_SIZE) != 0) {
+        cout << "Read and Written Data are different" << endl;
+        ret = -1;
+    }
+
+    free(local);
+    free(local2);
+    my_fam->fam_deallocate(item);
+    my_fam->fam_destroy_region(desc);
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
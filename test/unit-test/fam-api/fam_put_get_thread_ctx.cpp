@@ -0,0 +1,137 @@
+/*
+ * fam_put_get_thread_ctx.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+#define NUM_THREADS 8
+#define MSG_SIZE 16
+
+fam *my_fam;
+Fam_Descriptor *item = NULL;
+int failed = 0;
+
+void *thr_func(void *arg) {
+    uint64_t tid = (uint64_t)arg;
+    uint64_t offset = tid * MSG_SIZE;
+    char local[MSG_SIZE];
+    char local2[MSG_SIZE];
+    snprintf(local, MSG_SIZE, "Thread %lu", tid);
+    memset(local2, 0, MSG_SIZE);
+
+    try {
+        // Each thread uses and quiets its own context
+        my_fam->fam_put_nonblocking(local, item, offset, MSG_SIZE);
+        my_fam->fam_quiet();
+        my_fam->fam_get_blocking(local2, item, offset, MSG_SIZE);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        __sync_fetch_and_add(&failed, 1);
+    }
+    if (strncmp(local, local2, MSG_SIZE) != 0)
+        __sync_fetch_and_add(&failed, 1);
+    pthread_exit(NULL);
+}
+
+int main() {
+    my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc = NULL;
+    pthread_t thr[NUM_THREADS];
+
+    init_fam_options(&fam_opts);
+    fam_opts.famThreadModel = strdup("FAM_THREAD_MULTIPLE");
+    fam_opts.famContextModel = strdup("FAM_CONTEXT_THREAD");
+
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+    }
+
+    try {
+        desc = my_fam->fam_create_region("test", 8192, 0777, RAID1);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+    }
+
+    // Allocating data items in the created region
+    try {
+        item = my_fam->fam_allocate("first", 1024, 0777, desc);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+    }
+
+    for (uint64_t i = 0; i < NUM_THREADS; i++) {
+        if (pthread_create(&thr[i], NULL, thr_func, (void *)i)) {
+            fprintf(stderr, "error: pthread_create\n");
+            exit(1);
+        }
+    }
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(thr[i], NULL);
+    }
+
+    // Deallocating data items
+    if (item != NULL)
+        my_fam->fam_deallocate(item);
+
+    // Destroying the region
+    if (desc != NULL)
+        my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    if (failed == 0) {
+        cout << "Data read is same is as written" << endl;
+        return 0;
+    } else {
+        cout << "Read and Written Data are different" << endl;
+        return -1;
+    }
+}
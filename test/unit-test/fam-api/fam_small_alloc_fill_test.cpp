@@ -0,0 +1,133 @@
+/*
+ * fam_small_alloc_fill_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam.h>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+// Smallest region the memory server creates
+#define REGION_SIZE (1UL << 20)
+
+/*
+ * Allocates data items of itemSize until the region is full, and returns
+ * them in items.
+ */
+static void fill_region(fam *my_fam, Fam_Region_Descriptor *desc,
+                        uint64_t itemSize, vector<Fam_Descriptor *> &items) {
+    char name[64];
+    for (;;) {
+        snprintf(name, sizeof(name), "item_%lu_%zu", itemSize, items.size());
+        try {
+            items.push_back(my_fam->fam_allocate(name, itemSize, 0777, desc));
+        } catch (Fam_Exception &e) {
+            break;
+        }
+    }
+}
+
+static void free_items(fam *my_fam, vector<Fam_Descriptor *> &items) {
+    for (auto item : items)
+        my_fam->fam_deallocate(item);
+    items.clear();
+}
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    vector<Fam_Descriptor *> items;
+    int pass = 0, fail = 0;
+
+    init_fam_options(&fam_opts);
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    desc = my_fam->fam_create_region("test1", REGION_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    // The offsets cached for small data items must not use up the region
+    fill_region(my_fam, desc, 1024, items);
+    uint64_t smallBytes = items.size() * 1024;
+    cout << "Allocated " << items.size() << " items of 1024 bytes" << endl;
+    if (smallBytes >= REGION_SIZE / 2)
+        pass++;
+    else
+        fail++;
+
+    // Once they are freed, their space is available to another size class
+    free_items(my_fam, items);
+    fill_region(my_fam, desc, 4096, items);
+    cout << "Allocated " << items.size() << " items of 4096 bytes" << endl;
+    if (items.size() * 4096 >= smallBytes / 2)
+        pass++;
+    else
+        fail++;
+
+    // and to data items which are not cached at all
+    free_items(my_fam, items);
+    try {
+        items.push_back(
+            my_fam->fam_allocate("large", REGION_SIZE / 4, 0777, desc));
+        pass++;
+    } catch (Fam_Exception &e) {
+        fail++;
+        cout << "fam_allocate of a large data item failed" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+    }
+    free_items(my_fam, items);
+
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+
+    if (pass == 3 && fail == 0) {
+        cout << "Test passed. Pass=" << pass << endl;
+        return 0;
+    } else {
+        cout << "Test failed. Pass=" << pass << " Fail=" << fail << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ *   fam_metadata_cache_test.cpp
+ *   Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: with the record cache enabled, finds of regions
+ * and dataitems by id and by name return the new record after a modify and
+ * no record after a delete, including dataitems of a deleted region and a
+ * name reused by another dataitem.
+ */
+#include "common/fam_test_config.h"
+#include "metadata_service/fam_metadata_service.h"
+#include "metadata_service/fam_metadata_service_direct.h"
+
+#include <fam/fam.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace radixtree;
+using namespace nvmm;
+using namespace metadata;
+using namespace openfam;
+
+#define REGION_SIZE (16 * 1024 * 1024)
+#define MEMSRV_ID 0
+
+uint64_t create_region(Fam_Metadata_Service *manager, std::string name) {
+    uint64_t regionId;
+    std::list<int> memsrvList;
+    manager->metadata_validate_and_create_region(name, REGION_SIZE,
+                                                 &regionId, &memsrvList,
+                                                 META_PLACEMENT_DEFAULT);
+
+    Fam_Region_Metadata region;
+    memset(&region, 0, sizeof(Fam_Region_Metadata));
+    region.regionId = regionId;
+    strncpy(region.name, name.c_str(), manager->metadata_maxkeylen());
+    region.offset = INVALID_OFFSET;
+    region.perm = 0777;
+    region.uid = getuid();
+    region.gid = getgid();
+    region.size = REGION_SIZE;
+    region.used_memsrv_cnt = 1;
+    region.memServerIds[0] = MEMSRV_ID;
+    manager->metadata_insert_region(regionId, name, &region);
+    return regionId;
+}
+
+void destroy_region(Fam_Metadata_Service *manager, uint64_t regionId) {
+    std::list<int> memsrvList;
+    manager->metadata_validate_and_destroy_region(regionId, getuid(),
+                                                  getgid(), &memsrvList);
+    manager->metadata_reset_bitmap(regionId);
+}
+
+void insert_dataitem(Fam_Metadata_Service *manager, uint64_t regionId,
+                     uint64_t dataitemId, std::string name, uint64_t size) {
+    Fam_DataItem_Metadata dataitem;
+    memset(&dataitem, 0, sizeof(Fam_DataItem_Metadata));
+    dataitem.regionId = regionId;
+    dataitem.offset = dataitemId * 4096;
+    dataitem.uid = getuid();
+    dataitem.gid = getgid();
+    dataitem.perm = 0777;
+    dataitem.size = size;
+    dataitem.memoryServerId = MEMSRV_ID;
+    strncpy(dataitem.name, name.c_str(), manager->metadata_maxkeylen());
+    dataitem.used_memsrv_cnt = 1;
+    dataitem.memServerIds[0] = MEMSRV_ID;
+    dataitem.offsets[0] = dataitem.offset;
+    manager->metadata_insert_dataitem(dataitemId, regionId, &dataitem, name);
+}
+
+// A dataitem of a region that no longer exists may also be reported by an
+// exception
+template <typename Key>
+bool dataitem_found(Fam_Metadata_Service *manager, Key key,
+                    uint64_t regionId, Fam_DataItem_Metadata &dataitem) {
+    try {
+        return manager->metadata_find_dataitem(key, regionId, dataitem);
+    } catch (Fam_Exception &e) {
+        return false;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t count = 0, fail = 0;
+
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    init_fam_options(&fam_opts);
+
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    char *openfam_model;
+    openfam_model = (char *)my_fam->fam_get_option(strdup("OPENFAM_MODEL"));
+    // Skip test case if it is not shared memory model
+    if (strcmp(openfam_model, "shared_memory") != 0) {
+        my_fam->fam_finalize("default");
+        std::cout << "Test case valid only in shared_memory model, "
+                     "skipping with status : "
+                  << TEST_SKIP_STATUS << std::endl;
+        return TEST_SKIP_STATUS;
+    }
+
+    Fam_Metadata_Service *manager =
+        new Fam_Metadata_Service_Direct(true, true);
+    Fam_Region_Metadata node;
+    Fam_DataItem_Metadata dataitem;
+
+    // Region modified after it is cached by id and by name
+    uint64_t regionId = create_region(manager, "cache_test_region");
+    manager->metadata_find_region(regionId, node);
+    manager->metadata_find_region("cache_test_region", node);
+    node.perm = 0700;
+    manager->metadata_modify_region(regionId, &node);
+    if (!manager->metadata_find_region(regionId, node) || node.perm != 0700) {
+        cout << "Cached region by id not updated on modify" << endl;
+        fail++;
+    }
+    count++;
+    if (!manager->metadata_find_region("cache_test_region", node) ||
+        node.perm != 0700) {
+        cout << "Cached region by name not updated on modify" << endl;
+        fail++;
+    }
+    count++;
+
+    // Dataitem modified after it is cached, by id and by name
+    insert_dataitem(manager, regionId, 1, "cache_test_item", 4096);
+    manager->metadata_find_dataitem(1, regionId, dataitem);
+    manager->metadata_find_dataitem("cache_test_item", regionId, dataitem);
+    dataitem.perm = 0600;
+    manager->metadata_modify_dataitem(1, regionId, &dataitem);
+    if (!manager->metadata_find_dataitem(1, regionId, dataitem) ||
+        dataitem.perm != 0600) {
+        cout << "Cached dataitem by id not updated on modify" << endl;
+        fail++;
+    }
+    count++;
+    dataitem.perm = 0640;
+    manager->metadata_modify_dataitem("cache_test_item", regionId, &dataitem);
+    if (!manager->metadata_find_dataitem("cache_test_item", regionId,
+                                         dataitem) ||
+        dataitem.perm != 0640) {
+        cout << "Cached dataitem by name not updated on modify" << endl;
+        fail++;
+    }
+    count++;
+
+    // Deleted dataitem is no longer found, by id or by name
+    manager->metadata_delete_dataitem(1, regionId);
+    if (manager->metadata_find_dataitem(1, regionId, dataitem) ||
+        manager->metadata_find_dataitem("cache_test_item", regionId,
+                                        dataitem)) {
+        cout << "Deleted dataitem still found" << endl;
+        fail++;
+    }
+    count++;
+
+    // The name of a deleted dataitem reused by another one resolves to the
+    // new dataitem
+    insert_dataitem(manager, regionId, 2, "cache_test_item", 8192);
+    if (!manager->metadata_find_dataitem("cache_test_item", regionId,
+                                         dataitem) ||
+        dataitem.offset != 2 * 4096 || dataitem.size != 8192) {
+        cout << "Reused dataitem name resolves to the deleted dataitem"
+             << endl;
+        fail++;
+    }
+    count++;
+
+    // Deleting a region drops its cached dataitems as well
+    insert_dataitem(manager, regionId, 3, "cache_test_other", 4096);
+    manager->metadata_find_dataitem(3, regionId, dataitem);
+    manager->metadata_find_dataitem("cache_test_other", regionId, dataitem);
+    manager->metadata_delete_dataitem(2, regionId);
+    manager->metadata_delete_dataitem(3, regionId);
+    destroy_region(manager, regionId);
+    if (manager->metadata_find_region(regionId, node) ||
+        manager->metadata_find_region("cache_test_region", node)) {
+        cout << "Deleted region still found" << endl;
+        fail++;
+    }
+    count++;
+    if (dataitem_found(manager, (uint64_t)3, regionId, dataitem) ||
+        dataitem_found(manager, std::string("cache_test_other"), regionId,
+                       dataitem)) {
+        cout << "Dataitem of a deleted region still found" << endl;
+        fail++;
+    }
+    count++;
+
+    if (fail == 0)
+        std::cout << "fam_metadata_cache_test test passed:" << std::endl;
+    else
+        std::cout << "fam_metadata_cache_test test failed:" << std::endl;
+
+    std::cout << "Total tests run    : " << count << std::endl;
+    std::cout << "Total tests passed : " << count - fail << std::endl;
+    std::cout << "Total tests failed : " << fail << std::endl;
+
+    my_fam->fam_finalize("default");
+
+    delete manager;
+    delete my_fam;
+
+    if (fail) {
+        return 1;
+    } else
+        return 0;
+}
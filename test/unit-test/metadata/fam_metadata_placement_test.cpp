@@ -0,0 +1,211 @@
+/*
+ *   fam_metadata_placement_test.cpp
+ *   Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "common/fam_test_config.h"
+#include "metadata_service/fam_metadata_service.h"
+#include "metadata_service/fam_metadata_service_direct.h"
+
+#include <fam/fam.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace radixtree;
+using namespace nvmm;
+using namespace metadata;
+using namespace openfam;
+
+#define REGION_SIZE (16 * 1024 * 1024)
+#define NUM_DATAITEMS 8
+
+// Register a region spanning the given (fake) memory servers, with the
+// given placement policy
+uint64_t create_region(Fam_Metadata_Service *manager, std::string name,
+                       std::vector<uint64_t> memsrvIds, uint32_t policy) {
+    uint64_t regionId;
+    std::list<int> memsrvList;
+    manager->metadata_validate_and_create_region(name, REGION_SIZE,
+                                                 &regionId, &memsrvList,
+                                                 policy);
+
+    Fam_Region_Metadata region;
+    memset(&region, 0, sizeof(Fam_Region_Metadata));
+    region.regionId = regionId;
+    strncpy(region.name, name.c_str(), manager->metadata_maxkeylen());
+    region.offset = INVALID_OFFSET;
+    region.perm = 0777;
+    region.uid = getuid();
+    region.gid = getgid();
+    region.size = REGION_SIZE;
+    region.used_memsrv_cnt = memsrvIds.size();
+    for (uint64_t i = 0; i < memsrvIds.size(); i++)
+        region.memServerIds[i] = memsrvIds[i];
+    region.placementPolicy = policy;
+    manager->metadata_insert_region(regionId, name, &region);
+    return regionId;
+}
+
+void destroy_region(Fam_Metadata_Service *manager, uint64_t regionId) {
+    std::list<int> memsrvList;
+    manager->metadata_validate_and_destroy_region(regionId, getuid(),
+                                                  getgid(), &memsrvList);
+    manager->metadata_reset_bitmap(regionId);
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t count = 0, fail = 0;
+
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    init_fam_options(&fam_opts);
+
+    try {
+        my_fam->fam_initialize("default", &fam_opts);
+    } catch (Fam_Exception &e) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    }
+
+    char *openfam_model;
+    openfam_model = (char *)my_fam->fam_get_option(strdup("OPENFAM_MODEL"));
+    // Skip test case if it is not shared memory model
+    if (strcmp(openfam_model, "shared_memory") != 0) {
+        my_fam->fam_finalize("default");
+        std::cout << "Test case valid only in shared_memory model, "
+                     "skipping with status : "
+                  << TEST_SKIP_STATUS << std::endl;
+        return TEST_SKIP_STATUS;
+    }
+
+    Fam_Metadata_Service *manager = new Fam_Metadata_Service_Direct(true);
+    Fam_Region_Metadata node;
+    uint64_t memsrvId;
+
+    // The placement policy of a region is kept in its metadata, also
+    // when the region is modified
+    std::vector<uint64_t> hashIds = { 100, 101, 102, 103 };
+    uint64_t hashRegion =
+        create_region(manager, "placement_hash", hashIds, META_PLACEMENT_HASH);
+    if (!manager->metadata_find_region(hashRegion, node) ||
+        node.placementPolicy != META_PLACEMENT_HASH) {
+        cout << "Placement policy of the region not stored" << endl;
+        fail++;
+    }
+    count++;
+
+    node.perm = 0700;
+    node.placementPolicy = META_PLACEMENT_DEFAULT;
+    manager->metadata_modify_region(hashRegion, &node);
+    if (!manager->metadata_find_region(hashRegion, node) ||
+        node.placementPolicy != META_PLACEMENT_HASH || node.perm != 0700) {
+        cout << "Placement policy of the region lost on modify" << endl;
+        fail++;
+    }
+    count++;
+
+    // Data items of the region are placed with its policy, whatever the
+    // configured one
+    for (int i = 0; i < NUM_DATAITEMS; i++) {
+        std::string name = "item" + to_string(i);
+        manager->metadata_validate_and_allocate_dataitem(
+            name, hashRegion, getuid(), getgid(), &memsrvId);
+        if (memsrvId !=
+            hashIds[std::hash<std::string>{}(name) % hashIds.size()]) {
+            cout << "Dataitem " << name << " not placed by name hash"
+                 << endl;
+            fail++;
+        }
+        count++;
+    }
+    destroy_region(manager, hashRegion);
+
+    // Placement statistics are rebuilt from the metadata when the service
+    // starts : data items already on a memory server are accounted for
+    std::vector<uint64_t> loadIds = { 110, 111 };
+    uint64_t loadRegion = create_region(manager, "placement_least_loaded",
+                                        loadIds, META_PLACEMENT_LEAST_LOADED);
+    Fam_DataItem_Metadata dataitem;
+    for (uint64_t i = 0; i < NUM_DATAITEMS; i++) {
+        memset(&dataitem, 0, sizeof(Fam_DataItem_Metadata));
+        std::string name = "loaded" + to_string(i);
+        dataitem.regionId = loadRegion;
+        dataitem.offset = i * 4096;
+        dataitem.uid = getuid();
+        dataitem.gid = getgid();
+        dataitem.perm = 0777;
+        dataitem.size = 4096;
+        dataitem.memoryServerId = loadIds[0];
+        strncpy(dataitem.name, name.c_str(), manager->metadata_maxkeylen());
+        dataitem.used_memsrv_cnt = 1;
+        dataitem.memServerIds[0] = loadIds[0];
+        dataitem.offsets[0] = dataitem.offset;
+        manager->metadata_insert_dataitem(i + 1, loadRegion, &dataitem, name);
+    }
+
+    delete manager;
+    manager = new Fam_Metadata_Service_Direct(true);
+
+    manager->metadata_validate_and_allocate_dataitem(
+        "fresh", loadRegion, getuid(), getgid(), &memsrvId);
+    if (memsrvId != loadIds[1]) {
+        cout << "Dataitem placed on the loaded memory server" << endl;
+        fail++;
+    }
+    count++;
+
+    for (uint64_t i = 0; i < NUM_DATAITEMS; i++)
+        manager->metadata_delete_dataitem(i + 1, loadRegion);
+    destroy_region(manager, loadRegion);
+
+    if (fail == 0)
+        std::cout << "fam_metadata_placement_test test passed:" << std::endl;
+    else
+        std::cout << "fam_metadata_placement_test test failed:" << std::endl;
+
+    std::cout << "Total tests run    : " << count << std::endl;
+    std::cout << "Total tests passed : " << count - fail << std::endl;
+    std::cout << "Total tests failed : " << fail << std::endl;
+
+    my_fam->fam_finalize("default");
+
+    delete manager;
+    delete my_fam;
+
+    if (fail) {
+        return 1;
+    } else
+        return 0;
+}
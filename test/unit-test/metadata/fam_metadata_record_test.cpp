@@ -0,0 +1,286 @@
+/*
+ *   fam_metadata_record_test.cpp
+ *   Copyright (c) 2019-2020 Hewlett Packard Enterprise Development, LP. All
+ *   rights reserved.
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *   1. Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+ *      BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *      FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ *      SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *      INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *      DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *      OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ *      OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ *      IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+/* Test Case Description: region and dataitem descriptors encoded into
+ * metadata records decode back to the same descriptors, version 1 region
+ * records decode with the default placement policy, and truncated records
+ * or records of an unknown version are rejected.
+ */
+#include "metadata_service/fam_metadata_record.h"
+#include "metadata_service/fam_metadata_service.h"
+
+#include <string.h>
+
+using namespace metadata;
+
+#define RECORD_BUF_SIZE 4096
+
+void fill_region(Fam_Region_Metadata &region, uint64_t memsrvCnt) {
+    memset(&region, 0, sizeof(Fam_Region_Metadata));
+    region.regionId = 42;
+    region.offset = INVALID_OFFSET;
+    region.uid = 1000;
+    region.gid = 100;
+    region.perm = 0750;
+    strncpy(region.name, "record_test_region", sizeof(region.name) - 1);
+    region.size = 1UL << 30;
+    region.used_memsrv_cnt = memsrvCnt;
+    for (uint64_t i = 0; i < memsrvCnt; i++)
+        region.memServerIds[i] = 3 * i + 1;
+    region.isHeapCreated = true;
+    region.dataItemIdRoot = GlobalPtr((uint64_t)0x51000);
+    region.dataItemNameRoot = GlobalPtr((uint64_t)0x52000);
+    region.placementPolicy = META_PLACEMENT_HASH;
+}
+
+void fill_dataitem(Fam_DataItem_Metadata &dataitem, uint64_t memsrvCnt) {
+    memset(&dataitem, 0, sizeof(Fam_DataItem_Metadata));
+    dataitem.regionId = 42;
+    dataitem.offset = 0x40000;
+    dataitem.uid = 1000;
+    dataitem.gid = 100;
+    dataitem.perm = 0640;
+    // Name of the maximum length, without a terminating null
+    memset(dataitem.name, 'd', sizeof(dataitem.name));
+    dataitem.size = 3 * 1024 * 1024;
+    dataitem.memoryServerId = 7;
+    dataitem.interleaveSize = memsrvCnt > 1 ? 65536 : 0;
+    dataitem.used_memsrv_cnt = memsrvCnt;
+    for (uint64_t i = 0; i < memsrvCnt; i++) {
+        dataitem.memServerIds[i] = 7 + i;
+        dataitem.offsets[i] = 0x40000 + i * 0x1000;
+    }
+}
+
+bool same_region(Fam_Region_Metadata &a, Fam_Region_Metadata &b) {
+    return a.regionId == b.regionId && a.offset == b.offset &&
+           a.uid == b.uid && a.gid == b.gid && a.perm == b.perm &&
+           strncmp(a.name, b.name, sizeof(a.name)) == 0 && a.size == b.size &&
+           a.used_memsrv_cnt == b.used_memsrv_cnt &&
+           memcmp(a.memServerIds, b.memServerIds,
+                  a.used_memsrv_cnt * sizeof(uint64_t)) == 0 &&
+           a.isHeapCreated == b.isHeapCreated &&
+           memcmp(&a.dataItemIdRoot, &b.dataItemIdRoot, sizeof(GlobalPtr)) ==
+               0 &&
+           memcmp(&a.dataItemNameRoot, &b.dataItemNameRoot,
+                  sizeof(GlobalPtr)) == 0 &&
+           a.placementPolicy == b.placementPolicy;
+}
+
+bool same_dataitem(Fam_DataItem_Metadata &a, Fam_DataItem_Metadata &b) {
+    return a.regionId == b.regionId && a.offset == b.offset &&
+           a.uid == b.uid && a.gid == b.gid && a.perm == b.perm &&
+           memcmp(a.name, b.name, sizeof(a.name)) == 0 && a.size == b.size &&
+           a.memoryServerId == b.memoryServerId &&
+           a.interleaveSize == b.interleaveSize &&
+           a.used_memsrv_cnt == b.used_memsrv_cnt &&
+           memcmp(a.memServerIds, b.memServerIds,
+                  a.used_memsrv_cnt * sizeof(uint64_t)) == 0 &&
+           memcmp(a.offsets, b.offsets,
+                  a.used_memsrv_cnt * sizeof(uint64_t)) == 0;
+}
+
+// Region record as written before the placement policy was added
+size_t encode_region_v1(const Fam_Region_Metadata *region, char *buf) {
+    Metadata_Record_Writer record(buf);
+    record.put((uint8_t)1);
+    record.put(region->regionId);
+    record.put(region->offset);
+    record.put(region->uid);
+    record.put(region->gid);
+    record.put(region->perm);
+    record.put(region->size);
+    record.put(region->isHeapCreated);
+    record.put(region->dataItemIdRoot);
+    record.put(region->dataItemNameRoot);
+    record.put_name(region->name, sizeof(region->name));
+    record.put(region->used_memsrv_cnt);
+    record.put(region->memServerIds, region->used_memsrv_cnt);
+    return record.size();
+}
+
+// Returns true if decoding the record throws
+template <typename T>
+bool rejected(void (*decode)(const char *, size_t, T &), const char *buf,
+              size_t len) {
+    T node;
+    try {
+        decode(buf, len, node);
+    } catch (Metadata_Service_Exception &e) {
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t count = 0, fail = 0;
+    char buf[RECORD_BUF_SIZE];
+    size_t len;
+
+    // Regions on one, several and the maximum number of memory servers
+    for (uint64_t memsrvCnt : {(uint64_t)1, (uint64_t)4,
+                               (uint64_t)MAX_MEMORY_SERVERS_CNT}) {
+        Fam_Region_Metadata region, decoded;
+        fill_region(region, memsrvCnt);
+        len = encode_region(&region, buf);
+        memset(&decoded, 0xff, sizeof(decoded));
+        decode_region(buf, len, decoded);
+        if (!same_region(region, decoded)) {
+            cout << "Region record of " << memsrvCnt
+                 << " memory servers not decoded back" << endl;
+            fail++;
+        }
+        count++;
+
+        // Only the used entries of the memory server array are stored
+        if (len >= sizeof(Fam_Region_Metadata) &&
+            memsrvCnt < MAX_MEMORY_SERVERS_CNT) {
+            cout << "Region record is not compact : " << len << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    // Dataitems, interleaved or not
+    for (uint64_t memsrvCnt : {(uint64_t)1, (uint64_t)3,
+                               (uint64_t)MAX_INTERLEAVE_MEMSERVERS_CNT}) {
+        Fam_DataItem_Metadata dataitem, decoded;
+        fill_dataitem(dataitem, memsrvCnt);
+        len = encode_dataitem(&dataitem, buf);
+        memset(&decoded, 0xff, sizeof(decoded));
+        decode_dataitem(buf, len, decoded);
+        if (!same_dataitem(dataitem, decoded)) {
+            cout << "Dataitem record of " << memsrvCnt
+                 << " memory servers not decoded back" << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    // A version 1 region record has no placement policy and gets the
+    // default one
+    {
+        Fam_Region_Metadata region, decoded;
+        fill_region(region, 2);
+        len = encode_region_v1(&region, buf);
+        decode_region(buf, len, decoded);
+        region.placementPolicy = META_PLACEMENT_DEFAULT;
+        if (!same_region(region, decoded)) {
+            cout << "Version 1 region record not decoded" << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    // Version 1 dataitem records have the same layout as version 2 ones
+    {
+        Fam_DataItem_Metadata dataitem, decoded;
+        fill_dataitem(dataitem, 2);
+        len = encode_dataitem(&dataitem, buf);
+        buf[0] = 1;
+        decode_dataitem(buf, len, decoded);
+        if (!same_dataitem(dataitem, decoded)) {
+            cout << "Version 1 dataitem record not decoded" << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    // Truncated records and unknown versions are rejected
+    {
+        Fam_Region_Metadata region;
+        fill_region(region, 4);
+        len = encode_region(&region, buf);
+        bool allRejected = true;
+        for (size_t cut = 0; cut < len; cut++)
+            allRejected &= rejected(decode_region, buf, cut);
+        if (!allRejected) {
+            cout << "Truncated region record accepted" << endl;
+            fail++;
+        }
+        count++;
+
+        Fam_DataItem_Metadata dataitem;
+        fill_dataitem(dataitem, 4);
+        len = encode_dataitem(&dataitem, buf);
+        allRejected = true;
+        for (size_t cut = 0; cut < len; cut++)
+            allRejected &= rejected(decode_dataitem, buf, cut);
+        if (!allRejected) {
+            cout << "Truncated dataitem record accepted" << endl;
+            fail++;
+        }
+        count++;
+
+        buf[0] = 0;
+        bool v0 = rejected(decode_dataitem, buf, len);
+        buf[0] = METADATA_RECORD_VERSION + 1;
+        if (!v0 || !rejected(decode_dataitem, buf, len)) {
+            cout << "Record of an unknown version accepted" << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    // A memory server count larger than the descriptor holds is rejected
+    {
+        Fam_Region_Metadata region;
+        fill_region(region, 1);
+        len = encode_region(&region, buf);
+        // The count follows the name, which has a 2 byte length prefix
+        size_t cntPos = len - sizeof(uint32_t) - sizeof(uint64_t) -
+                        sizeof(uint64_t);
+        uint64_t badCnt = MAX_MEMORY_SERVERS_CNT + 1;
+        memcpy(buf + cntPos, &badCnt, sizeof(badCnt));
+        if (!rejected(decode_region, buf, len)) {
+            cout << "Oversized memory server count accepted" << endl;
+            fail++;
+        }
+        count++;
+    }
+
+    if (fail == 0)
+        std::cout << "fam_metadata_record_test test passed:" << std::endl;
+    else
+        std::cout << "fam_metadata_record_test test failed:" << std::endl;
+
+    std::cout << "Total tests run    : " << count << std::endl;
+    std::cout << "Total tests passed : " << count - fail << std::endl;
+    std::cout << "Total tests failed : " << fail << std::endl;
+
+    if (fail) {
+        return 1;
+    } else
+        return 0;
+}